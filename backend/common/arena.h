@@ -0,0 +1,184 @@
+/*
+ * Copyright © 2018-2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef BACKEND_COMMON_ARENA_H_
+#define BACKEND_COMMON_ARENA_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Bump allocator for short-lived objects that all die at the same time.
+ * Allocations are carved from a list of chunks and never freed individually;
+ * dbBE_Arena_reset() releases everything at once and keeps the chunks for reuse.
+ * Requests larger than the chunk size get a chunk of their own.
+ * Not thread-safe: an arena belongs to a single thread (e.g. the receiver).
+ */
+
+#define DBBE_ARENA_ALIGN ( 16 )
+
+typedef struct dbBE_Arena_chunk
+{
+  struct dbBE_Arena_chunk *_next;
+  size_t _size;   ///< usable bytes in _mem
+  size_t _used;
+  char _mem[] __attribute__((aligned( DBBE_ARENA_ALIGN )));
+} dbBE_Arena_chunk_t;
+
+typedef struct
+{
+  dbBE_Arena_chunk_t *_first;
+  dbBE_Arena_chunk_t *_current;  ///< chunk to allocate from
+  size_t _chunk_size;
+  size_t _keep;       ///< chunk bytes to keep for reuse on reset; the rest is freed
+  size_t _allocated;  ///< bytes handed out since the last reset
+} dbBE_Arena_t;
+
+
+/*
+ * create an arena with chunks of chunk_size bytes
+ * that keeps up to keep bytes of chunks across resets
+ */
+static inline
+dbBE_Arena_t* dbBE_Arena_create( const size_t chunk_size, const size_t keep )
+{
+  if( chunk_size == 0 )
+  {
+    errno = EINVAL;
+    return NULL;
+  }
+  dbBE_Arena_t *arena = (dbBE_Arena_t*)calloc( 1, sizeof( dbBE_Arena_t ) );
+  if( arena == NULL )
+    return NULL;
+  arena->_chunk_size = chunk_size;
+  arena->_keep = keep;
+  return arena;
+}
+
+static inline
+int dbBE_Arena_destroy( dbBE_Arena_t *arena )
+{
+  if( arena == NULL )
+    return EINVAL;
+  while( arena->_first != NULL )
+  {
+    dbBE_Arena_chunk_t *chunk = arena->_first;
+    arena->_first = chunk->_next;
+    free( chunk );
+  }
+  free( arena );
+  return 0;
+}
+
+/*
+ * release all allocations at once
+ * chunks are kept up to the configured number of bytes, oversized chunks are always freed
+ */
+static inline
+void dbBE_Arena_reset( dbBE_Arena_t *arena )
+{
+  if( arena == NULL )
+    return;
+  size_t kept = 0;
+  dbBE_Arena_chunk_t **link = &arena->_first;
+  while( *link != NULL )
+  {
+    dbBE_Arena_chunk_t *chunk = *link;
+    if(( chunk->_size > arena->_chunk_size ) || ( kept + chunk->_size > arena->_keep ))
+    {
+      *link = chunk->_next;
+      free( chunk );
+      continue;
+    }
+    chunk->_used = 0;
+    kept += chunk->_size;
+    link = &chunk->_next;
+  }
+  arena->_current = arena->_first;
+  arena->_allocated = 0;
+}
+
+/*
+ * return size bytes of uninitialized memory that stays valid until the next reset
+ */
+static inline
+void* dbBE_Arena_alloc( dbBE_Arena_t *arena, const size_t size )
+{
+  if(( arena == NULL ) || ( size == 0 ))
+    return NULL;
+
+  size_t aligned = ( size + DBBE_ARENA_ALIGN - 1 ) & ~( (size_t)DBBE_ARENA_ALIGN - 1 );
+  if( aligned < size )
+    return NULL;
+
+  // move on to the next kept chunk that fits
+  dbBE_Arena_chunk_t *chunk = arena->_current;
+  while(( chunk != NULL ) && ( chunk->_size - chunk->_used < aligned ))
+  {
+    chunk = chunk->_next;
+    if( chunk != NULL )
+      arena->_current = chunk;
+  }
+
+  if( chunk == NULL )
+  {
+    size_t csize = ( aligned > arena->_chunk_size ) ? aligned : arena->_chunk_size;
+    chunk = (dbBE_Arena_chunk_t*)malloc( sizeof( dbBE_Arena_chunk_t ) + csize );
+    if( chunk == NULL )
+      return NULL;
+    chunk->_size = csize;
+    chunk->_used = 0;
+    chunk->_next = NULL;
+
+    // append behind the current chunk to keep the order of reuse
+    if( arena->_current == NULL )
+    {
+      chunk->_next = arena->_first;
+      arena->_first = chunk;
+    }
+    else
+    {
+      chunk->_next = arena->_current->_next;
+      arena->_current->_next = chunk;
+    }
+    arena->_current = chunk;
+  }
+
+  void *mem = chunk->_mem + chunk->_used;
+  chunk->_used += aligned;
+  arena->_allocated += aligned;
+  return mem;
+}
+
+/*
+ * return zeroed memory for n objects of size bytes (like calloc)
+ */
+static inline
+void* dbBE_Arena_calloc( dbBE_Arena_t *arena, const size_t n, const size_t size )
+{
+  if(( size != 0 ) && ( n > SIZE_MAX / size ))
+    return NULL;
+  void *mem = dbBE_Arena_alloc( arena, n * size );
+  if( mem != NULL )
+    memset( mem, 0, n * size );
+  return mem;
+}
+
+#endif /* BACKEND_COMMON_ARENA_H_ */
@@ -123,6 +123,8 @@ typedef struct dbBE_Data_transport
    * the amount of input data.
    * The device is required to provide a recv() call that supports SGEs.
    * The recv() call is called to retrieve potentially not-yet-received data
+   * If recv() returns -EAGAIN, scatter returns the amount that arrived so far and
+   * leaves the remaining destination SGEs in _rSGE to continue later
    *
    * @param [in] device     ptr to the device information to handle the gather process (requires a recv() callback that supports SGE)
    * @param [in] recv_cb    callback function of the device to retrieve additional data (requires support for SGEs)
@@ -92,7 +92,9 @@ typedef enum
    * *  param[in] @ref DBR_Group_t          _group = pointer or definition of source storage group
    * *  param[in] @ref DBR_Tuple_name_t     _key = pointer to string with tuple name
    * *  param[in] @ref DBR_Tuple_template_t _match = pattern to match when looking for the key
-   * *  param[in]      int64_t              _flags ignored
+   * *  param[in]      int64_t              _flags behavior control as follows:
+   *    *  @ref DBBE_OPCODE_FLAGS_HEAD       insert in front of existing tuples (returned by the next get)
+   *
    * *  param[in]      int                  _sge_count = number of SGEs in _sge
    * *  param[in] @ref dbBE_sge_t[]         _sge[] = SGE list pointing to (potentially non-contiguous value data)
    *
@@ -415,6 +417,30 @@ typedef enum
    * *  param[out] @ref dbBE_Completion_t*  _next = NULL unless multiple completions are created at the same time
    */
   DBBE_OPCODE_ITERATOR, /**< Iteration over existing keys */
+
+  /** @brief Check the existence of a tuple without retrieving its data
+   *
+   * The specs of the request are:
+   * *  param[in] _opcode = DBBE_OPCODE_TESTKEY
+   * *  param[in] @ref dbBE_NS_Handle_t     _ns_hdl a valid handle to an attached namespace
+   * *  param[in]      void*                _user = pointer to anything, will be returned with completion without change
+   * *  param[in] @ref dbBE_Request_t*      _next = NULL unless this is a chained request
+   * *  param[in] @ref DBR_Group_t          _group = pointer or definition of source storage group
+   * *  param[in] @ref DBR_Tuple_name_t     _key = pointer to string with tuple name
+   * *  param[in] @ref DBR_Tuple_template_t _match = ignored
+   * *  param[in]      int64_t              _flags ignored
+   * *  param[in]      int                  _sge_count = 0
+   * *  param[in] @ref dbBE_sge_t[]         _sge[] = nothing
+   *
+   * The specs for the completion are:
+   * *  param[out] _status = @ref DBR_SUCCESS if the tuple exists or error code indicating issues:
+   *    * @ref DBR_ERR_UNAVAIL  the tuple does not exist
+   *    * for status codes see @ref DBBE_OPCODE_UNSPEC
+   * *  param[out] void*                    _user = unmodified ptr provided in request
+   * *  param[out] int64_t                  _rc = 0; nothing useful will be returned here
+   * *  param[out] @ref dbBE_Completion_t*  _next = NULL unless multiple completions are created at the same time
+   */
+  DBBE_OPCODE_TESTKEY,
   DBBE_OPCODE_MAX  /**< Non-implemented operation to simplify range checks for opcodes  */
 } dbBE_Opcode;
 
@@ -422,7 +448,8 @@ enum
 {
   DBBE_OPCODE_FLAGS_NONE = 0,
   DBBE_OPCODE_FLAGS_IMMEDIATE = 0x1,
-  DBBE_OPCODE_FLAGS_PARTIAL = 0x2
+  DBBE_OPCODE_FLAGS_PARTIAL = 0x2,
+  DBBE_OPCODE_FLAGS_HEAD = 0x4  ///< put only: not exposed to users, the library uses it to return a tuple it took
 };
 
 
@@ -562,6 +589,35 @@ typedef struct dbBE_api
    * @return pointer to a completion or NULL if no request is complete
    */
   dbBE_Completion_t* (*test_any)( dbBE_Handle_t );
+
+  /**
+   * @brief return a processed completion to the back-end
+   *
+   * Optional. Allows the back-end to recycle completions instead of
+   * allocating a new one for every request.
+   * If not implemented (NULL), the client releases completions with free().
+   *
+   * @param [in] back-end handle  pointing to an initialized back-end
+   * @param [in] completion       completion that was returned by test or test_any
+   */
+  void (*release)( dbBE_Handle_t, dbBE_Completion_t* );
+
+  /**
+   * @brief file descriptor to block on until new completions may be available
+   *
+   * Optional. Called by a thread that is about to block after test_any()
+   * returned NULL (with the same serialization as the other calls).
+   * The returned fd becomes readable once test_any() may find new completions
+   * (e.g. socket events or completions of a back-end progress thread). It is
+   * polled without serialization while other threads keep calling the back-end.
+   * If not implemented (NULL), the client blocks with bounded intervals.
+   *
+   * @param [in] back-end handle  pointing to an initialized back-end
+   *
+   * @return the fd to poll, -EAGAIN if test_any() should be called again
+   *         without blocking, or -ENOTSUP if there's no such fd
+   */
+  int (*event_fd)( dbBE_Handle_t );
 } dbBE_api_t;
 
 
@@ -0,0 +1,164 @@
+/*
+ * Copyright © 2018-2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef BACKEND_COMMON_OBJECT_POOL_H_
+#define BACKEND_COMMON_OBJECT_POOL_H_
+
+#include <stddef.h>
+#include <inttypes.h>
+#include <errno.h>
+#ifdef __APPLE__
+#include <stdlib.h>
+#else
+#include <malloc.h>
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+/*
+ * Cache of fixed-size objects to avoid a malloc/free round-trip for
+ * every short-lived request or completion.
+ * Objects are regular heap allocations that are kept for reuse instead of
+ * being freed. This keeps them interchangeable with malloc/free:
+ *   - put() with a NULL pool falls back to free()
+ *   - objects allocated with malloc can be returned to a pool of the same object size
+ *   - objects from a pool can be released with free()
+ * The pool is thread-safe because objects are often allocated by one thread
+ * (e.g. a progress thread) and returned by another.
+ */
+typedef struct dbBE_Object_pool
+{
+  pthread_mutex_t _lock;
+  size_t _obj_size;      ///< size of each object
+  size_t _capacity;      ///< max number of cached objects
+  size_t _count;         ///< number of currently cached objects
+  uint64_t _allocated;   ///< number of objects that had to be allocated from the heap
+  void **_objs;          ///< stack of cached objects
+} dbBE_Object_pool_t;
+
+
+/*
+ * create a pool for objects of obj_size that caches up to capacity objects
+ */
+static inline
+dbBE_Object_pool_t* dbBE_Object_pool_create( const size_t obj_size,
+                                             const size_t capacity )
+{
+  if(( obj_size == 0 ) || ( capacity == 0 ))
+  {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  dbBE_Object_pool_t *pool = (dbBE_Object_pool_t*)calloc( 1, sizeof( dbBE_Object_pool_t ) );
+  if( pool == NULL )
+    return NULL;
+
+  pool->_objs = (void**)calloc( capacity, sizeof( void* ) );
+  if( pool->_objs == NULL )
+  {
+    free( pool );
+    return NULL;
+  }
+
+  pthread_mutex_init( &pool->_lock, NULL );
+  pool->_obj_size = obj_size;
+  pool->_capacity = capacity;
+  return pool;
+}
+
+/*
+ * release all cached objects and the pool
+ * objects that are still in use are not affected and can be released with free()
+ */
+static inline
+int dbBE_Object_pool_destroy( dbBE_Object_pool_t *pool )
+{
+  if( pool == NULL )
+    return -EINVAL;
+
+  size_t n;
+  for( n = 0; n < pool->_count; ++n )
+    free( pool->_objs[ n ] );
+  free( pool->_objs );
+  pthread_mutex_destroy( &pool->_lock );
+  memset( pool, 0, sizeof( dbBE_Object_pool_t ) );
+  free( pool );
+  return 0;
+}
+
+/*
+ * get an object (uninitialized memory)
+ */
+static inline
+void* dbBE_Object_pool_get( dbBE_Object_pool_t *pool )
+{
+  if( pool == NULL )
+    return NULL;
+
+  void *obj = NULL;
+  pthread_mutex_lock( &pool->_lock );
+  if( pool->_count > 0 )
+    obj = pool->_objs[ --pool->_count ];
+  else
+    ++pool->_allocated;
+  pthread_mutex_unlock( &pool->_lock );
+
+  if( obj == NULL )
+    obj = malloc( pool->_obj_size );
+  return obj;
+}
+
+/*
+ * return an object to the pool (or free it if the pool is full)
+ */
+static inline
+void dbBE_Object_pool_put( dbBE_Object_pool_t *pool, void *obj )
+{
+  if( obj == NULL )
+    return;
+  if( pool == NULL )
+  {
+    free( obj );
+    return;
+  }
+
+  pthread_mutex_lock( &pool->_lock );
+  if( pool->_count < pool->_capacity )
+  {
+    pool->_objs[ pool->_count++ ] = obj;
+    obj = NULL;
+  }
+  pthread_mutex_unlock( &pool->_lock );
+
+  if( obj != NULL )
+    free( obj );
+}
+
+/*
+ * number of objects the pool had to allocate from the heap so far
+ */
+static inline
+uint64_t dbBE_Object_pool_allocated( dbBE_Object_pool_t *pool )
+{
+  if( pool == NULL )
+    return 0;
+  return pool->_allocated;
+}
+
+#endif /* BACKEND_COMMON_OBJECT_POOL_H_ */
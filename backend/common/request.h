@@ -116,6 +116,7 @@ ssize_t dbBE_Request_serialize(const dbBE_Request_t *req, char *data, size_t spa
       sge_total = snprintf( data, space, "%p\n%p", req->_sge[0].iov_base, req->_sge[1].iov_base );
       break;
     case DBBE_OPCODE_REMOVE:
+    case DBBE_OPCODE_TESTKEY:
     case DBBE_OPCODE_CANCEL:
     case DBBE_OPCODE_NSATTACH:
     case DBBE_OPCODE_NSDETACH:
@@ -320,6 +321,7 @@ ssize_t dbBE_Request_deserialize( char *data, size_t space, dbBE_Request_t **req
       break;
     }
     case DBBE_OPCODE_REMOVE:
+    case DBBE_OPCODE_TESTKEY:
     case DBBE_OPCODE_CANCEL:
     case DBBE_OPCODE_NSATTACH:
     case DBBE_OPCODE_NSDETACH:
@@ -26,19 +26,45 @@
 #include <stdlib.h>
 #include <errno.h>
 #include <string.h>
+#include <sys/types.h>  // ssize_t
 
 #include <pthread.h>
 
 #include "../common/dbbe_api.h"
 
+/*
+ * Set of request pointers (e.g. cancelled requests) that can be modified from
+ * multiple threads. It's an open-addressing hash table with linear probing and
+ * at least twice as many slots as entries. Deleted entries are closed by
+ * shifting the following entries of the probe sequence back (no tombstones).
+ * The fill level is readable without the lock: lookups into an empty set,
+ * by far the most common case, only cost a single atomic load.
+ * Inserting the same request twice creates two entries (like before).
+ * Entries remember their insertion order so that pop() returns the oldest one.
+ */
 typedef struct
 {
-  dbBE_Request_t **_set;  // holding the data
-  size_t _size;             // amount of available space
-  size_t _fill;             // actually occupied space
+  dbBE_Request_t **_set;  // hash table slots
+  uint64_t *_order;         // insertion number of each occupied slot
+  uint64_t _inserted;       // number of insertions so far
+  size_t _size;             // max number of entries
+  size_t _mask;             // number of slots - 1
+  size_t _fill;             // actually occupied slots
   pthread_mutex_t _mutex;  // for any multithreaded locking
 } dbBE_Request_set_t;
 
+/*
+ * home slot of a request; the low bits of heap pointers are always 0
+ */
+static inline
+size_t dbBE_Request_set_hash( const dbBE_Request_set_t *set,
+                              const dbBE_Request_t *request )
+{
+  uint64_t h = (uint64_t)(uintptr_t)request >> 4;
+  h *= 0x9E3779B97F4A7C15ull;
+  return (size_t)( h >> 32 ) & set->_mask;
+}
+
 /*
  * create and initialize the set
  */
@@ -49,35 +75,42 @@ dbBE_Request_set_t* dbBE_Request_set_create( const size_t size )
   if( set == NULL )
     return NULL;
 
-  pthread_mutex_init( &set->_mutex, NULL );
+  size_t slots = 2;
+  while( slots < 2 * size )
+    slots <<= 1;
 
-  set->_set = (dbBE_Request_t**)calloc( sizeof( dbBE_Request_t* ), size );
-  if( set->_set == NULL )
+  set->_set = (dbBE_Request_t**)calloc( sizeof( dbBE_Request_t* ), slots );
+  set->_order = (uint64_t*)calloc( sizeof( uint64_t ), slots );
+  if(( set->_set == NULL ) || ( set->_order == NULL ))
   {
+    free( set->_set );
+    free( set->_order );
     free( set );
     return NULL;
   }
 
+  pthread_mutex_init( &set->_mutex, NULL );
   set->_size = size;
+  set->_mask = slots - 1;
   set->_fill = 0;
   return set;
 }
 
 /*
- * returns 0 if there are no requests in the set
- * returns 1 if there are requests in the set (or set == NULL )
+ * returns 0 if there are requests in the set
+ * returns 1 if there are no requests in the set (or set == NULL )
  */
 static inline
 size_t dbBE_Request_set_empty( const dbBE_Request_set_t *set )
 {
-  return (set == NULL ) || ( set->_fill == 0 );
+  return (set == NULL ) || ( __atomic_load_n( &set->_fill, __ATOMIC_ACQUIRE ) == 0 );
 }
 
 static inline
 size_t dbBE_Request_set_get_len( const dbBE_Request_set_t *set )
 {
   if( set != NULL )
-    return set->_fill;
+    return __atomic_load_n( &set->_fill, __ATOMIC_ACQUIRE );
   return 0;
 }
 
@@ -91,12 +124,8 @@ int dbBE_Request_set_clear( dbBE_Request_set_t *set )
     return EINVAL;
 
   pthread_mutex_lock( &set->_mutex );
-  size_t slot;
-  for( slot = 0; slot < set->_size; ++slot )
-  {
-    set->_set[ slot ] = NULL;
-    --set->_fill;
-  }
+  memset( set->_set, 0, ( set->_mask + 1 ) * sizeof( dbBE_Request_t* ) );
+  __atomic_store_n( &set->_fill, 0, __ATOMIC_RELEASE );
   pthread_mutex_unlock( &set->_mutex );
   return 0;
 }
@@ -115,6 +144,7 @@ int dbBE_Request_set_destroy( dbBE_Request_set_t *set )
   pthread_mutex_destroy( &set->_mutex );
 
   free( set->_set );
+  free( set->_order );
   memset( set, 0, sizeof( dbBE_Request_set_t ) );
   free( set );
   return 0;
@@ -132,15 +162,68 @@ int dbBE_Request_set_insert( dbBE_Request_set_t *set,
   if(( set == NULL ) || ( request == NULL ))
     return EINVAL;
 
-  size_t slot;
-  for( slot = 0; slot < set->_size; ++slot )
-    if( set->_set[ slot ] == NULL )
+  pthread_mutex_lock( &set->_mutex );
+  if( set->_fill >= set->_size )
+  {
+    pthread_mutex_unlock( &set->_mutex );
+    return ENOSPC;
+  }
+
+  size_t slot = dbBE_Request_set_hash( set, request );
+  while( set->_set[ slot ] != NULL )
+    slot = ( slot + 1 ) & set->_mask;
+  set->_set[ slot ] = request;
+  set->_order[ slot ] = set->_inserted++;
+  __atomic_store_n( &set->_fill, set->_fill + 1, __ATOMIC_RELEASE );
+  pthread_mutex_unlock( &set->_mutex );
+  return 0;
+}
+
+/*
+ * returns the slot of the request or -1 if not found (lock held by caller)
+ */
+static inline
+ssize_t dbBE_Request_set_lookup( dbBE_Request_set_t *set,
+                                 dbBE_Request_t *request )
+{
+  size_t slot = dbBE_Request_set_hash( set, request );
+  while( set->_set[ slot ] != NULL )
+  {
+    if( set->_set[ slot ] == request )
+      return (ssize_t)slot;
+    slot = ( slot + 1 ) & set->_mask;
+  }
+  return -1;
+}
+
+/*
+ * removes the entry in slot and closes the gap in the probe sequence (lock held by caller)
+ */
+static inline
+dbBE_Request_t* dbBE_Request_set_remove_slot( dbBE_Request_set_t *set,
+                                              size_t slot )
+{
+  dbBE_Request_t *request = set->_set[ slot ];
+  set->_set[ slot ] = NULL;
+  __atomic_store_n( &set->_fill, set->_fill - 1, __ATOMIC_RELEASE );
+
+  size_t next = slot;
+  while( 1 )
+  {
+    next = ( next + 1 ) & set->_mask;
+    if( set->_set[ next ] == NULL )
+      break;
+    // the entry can move into the gap unless its home slot is cyclically in (slot, next]
+    size_t home = dbBE_Request_set_hash( set, set->_set[ next ] );
+    if((( next - home ) & set->_mask ) >= (( next - slot ) & set->_mask ))
     {
-      set->_set[ slot ] = request;
-      ++set->_fill;
-      return 0;
+      set->_set[ slot ] = set->_set[ next ];
+      set->_order[ slot ] = set->_order[ next ];
+      set->_set[ next ] = NULL;
+      slot = next;
     }
-  return ENOSPC;
+  }
+  return request;
 }
 
 /*
@@ -154,12 +237,14 @@ int dbBE_Request_set_find( dbBE_Request_set_t *set,
 {
   if(( set == NULL ) || ( request == NULL ))
     return 0;
-  size_t slot;
-  for( slot = 0; slot < set->_size; ++slot )
-    if( set->_set[ slot ] == request )
-      return 1;
 
-  return 0;
+  if( dbBE_Request_set_empty( set ) )
+    return 0;
+
+  pthread_mutex_lock( &set->_mutex );
+  int found = ( dbBE_Request_set_lookup( set, request ) >= 0 );
+  pthread_mutex_unlock( &set->_mutex );
+  return found;
 }
 
 /*
@@ -177,36 +262,43 @@ int dbBE_Request_set_delete( dbBE_Request_set_t *set,
   if( dbBE_Request_set_empty( set ) )
     return 0;
 
-  size_t slot;
-  for( slot = 0; slot < set->_size; ++slot )
-    if( set->_set[ slot ] == request )
-    {
-      set->_set[ slot ] = NULL;
-      --set->_fill;
-      return 1;
-    }
-
-
-  return 0;
+  int deleted = 0;
+  pthread_mutex_lock( &set->_mutex );
+  ssize_t slot = dbBE_Request_set_lookup( set, request );
+  if( slot >= 0 )
+  {
+    dbBE_Request_set_remove_slot( set, (size_t)slot );
+    deleted = 1;
+  }
+  pthread_mutex_unlock( &set->_mutex );
+  return deleted;
 }
 
+/*
+ * removes and returns the oldest entry of the set
+ * (scans the whole table, not meant for the fast path)
+ */
 static inline
 dbBE_Request_t* dbBE_Request_set_pop( dbBE_Request_set_t *set )
 {
   if( set == NULL )
     return NULL;
 
-  size_t slot;
-  for( slot = 0; slot < set->_size; ++slot )
-    if( set->_set[ slot ] != NULL )
-    {
-      dbBE_Request_t *request = set->_set[ slot ];
-      set->_set[ slot ] = NULL;
-      --set->_fill;
-      return request;
-    }
+  if( dbBE_Request_set_empty( set ) )
+    return NULL;
 
-  return NULL;
+  dbBE_Request_t *request = NULL;
+  pthread_mutex_lock( &set->_mutex );
+  size_t slot;
+  ssize_t oldest = -1;
+  for( slot = 0; slot <= set->_mask; ++slot )
+    if(( set->_set[ slot ] != NULL ) &&
+       (( oldest < 0 ) || ( set->_order[ slot ] < set->_order[ oldest ] )))
+      oldest = (ssize_t)slot;
+  if( oldest >= 0 )
+    request = dbBE_Request_set_remove_slot( set, (size_t)oldest );
+  pthread_mutex_unlock( &set->_mutex );
+  return request;
 }
 
 #endif /* BACKEND_COMMON_REQUEST_SET_H_ */
@@ -0,0 +1,215 @@
+/*
+ * Copyright © 2018-2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef BACKEND_COMMON_RING_H_
+#define BACKEND_COMMON_RING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Bounded lock-free rings of pointers for hand-offs between threads.
+ * Unlike the intrusive queues, the queued objects are not modified and
+ * producers and consumers only share the ring's own cache lines.
+ *
+ *  - dbBE_Ring_t: multi-producer ring (Vyukov's per-slot sequence numbers)
+ *      dbBE_Ring_pop() for multiple consumers (MPMC)
+ *      dbBE_Ring_pop_single() if only one thread consumes (MPSC)
+ *
+ * The capacity is rounded up to the next power of 2.
+ * push() returns ENOSPC if the ring is full, pop() returns NULL if it's empty.
+ */
+
+#define DBBE_RING_CACHELINE ( 64 )
+#define DBBE_RING_ALIGNED __attribute__((aligned( DBBE_RING_CACHELINE )))
+
+typedef struct
+{
+  size_t _seq;   ///< position that may access the slot next
+  void *_data;
+} dbBE_Ring_slot_t;
+
+typedef struct
+{
+  size_t _tail DBBE_RING_ALIGNED;   ///< next position to push (producers)
+  size_t _head DBBE_RING_ALIGNED;   ///< next position to pop (consumers)
+  size_t _mask DBBE_RING_ALIGNED;
+  dbBE_Ring_slot_t *_slots;
+} dbBE_Ring_t;
+
+
+static inline
+size_t dbBE_Ring_capacity_for( const size_t size )
+{
+  size_t cap = 2;
+  while( cap < size )
+    cap <<= 1;
+  return cap;
+}
+
+static inline
+void* dbBE_Ring_aligned_alloc( const size_t size )
+{
+  void *mem = NULL;
+  if( posix_memalign( &mem, DBBE_RING_CACHELINE, size ) != 0 )
+    return NULL;
+  memset( mem, 0, size );
+  return mem;
+}
+
+/*
+ * create a multi-producer ring with space for at least size entries
+ */
+static inline
+dbBE_Ring_t* dbBE_Ring_create( const size_t size )
+{
+  if( size == 0 )
+  {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  dbBE_Ring_t *ring = (dbBE_Ring_t*)dbBE_Ring_aligned_alloc( sizeof( dbBE_Ring_t ) );
+  if( ring == NULL )
+    return NULL;
+
+  size_t cap = dbBE_Ring_capacity_for( size );
+  ring->_slots = (dbBE_Ring_slot_t*)dbBE_Ring_aligned_alloc( cap * sizeof( dbBE_Ring_slot_t ) );
+  if( ring->_slots == NULL )
+  {
+    free( ring );
+    return NULL;
+  }
+
+  size_t n;
+  for( n = 0; n < cap; ++n )
+    ring->_slots[ n ]._seq = n;
+  ring->_mask = cap - 1;
+  return ring;
+}
+
+static inline
+int dbBE_Ring_destroy( dbBE_Ring_t *ring )
+{
+  if( ring == NULL )
+    return EINVAL;
+  free( ring->_slots );
+  free( ring );
+  return 0;
+}
+
+/*
+ * number of queued entries (a snapshot if other threads are active)
+ */
+static inline
+size_t dbBE_Ring_len( dbBE_Ring_t *ring )
+{
+  if( ring == NULL )
+    return 0;
+  size_t head = __atomic_load_n( &ring->_head, __ATOMIC_ACQUIRE );
+  size_t tail = __atomic_load_n( &ring->_tail, __ATOMIC_ACQUIRE );
+  return ( tail > head ) ? tail - head : 0;
+}
+
+/*
+ * append an entry; safe for any number of concurrent producers
+ */
+static inline
+int dbBE_Ring_push( dbBE_Ring_t *ring, void *data )
+{
+  if(( ring == NULL ) || ( data == NULL ))
+    return EINVAL;
+
+  size_t pos = __atomic_load_n( &ring->_tail, __ATOMIC_RELAXED );
+  dbBE_Ring_slot_t *slot;
+  while( 1 )
+  {
+    slot = &ring->_slots[ pos & ring->_mask ];
+    size_t seq = __atomic_load_n( &slot->_seq, __ATOMIC_ACQUIRE );
+    intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+    if( diff == 0 )
+    {
+      if( __atomic_compare_exchange_n( &ring->_tail, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) )
+        break;
+    }
+    else if( diff < 0 )
+      return ENOSPC; // slot still holds the entry from one round ago
+    else
+      pos = __atomic_load_n( &ring->_tail, __ATOMIC_RELAXED );
+  }
+  slot->_data = data;
+  __atomic_store_n( &slot->_seq, pos + 1, __ATOMIC_RELEASE );
+  return 0;
+}
+
+/*
+ * remove and return the first entry; safe for any number of concurrent consumers
+ */
+static inline
+void* dbBE_Ring_pop( dbBE_Ring_t *ring )
+{
+  if( ring == NULL )
+    return NULL;
+
+  size_t pos = __atomic_load_n( &ring->_head, __ATOMIC_RELAXED );
+  dbBE_Ring_slot_t *slot;
+  while( 1 )
+  {
+    slot = &ring->_slots[ pos & ring->_mask ];
+    size_t seq = __atomic_load_n( &slot->_seq, __ATOMIC_ACQUIRE );
+    intptr_t diff = (intptr_t)seq - (intptr_t)( pos + 1 );
+    if( diff == 0 )
+    {
+      if( __atomic_compare_exchange_n( &ring->_head, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) )
+        break;
+    }
+    else if( diff < 0 )
+      return NULL; // not yet filled
+    else
+      pos = __atomic_load_n( &ring->_head, __ATOMIC_RELAXED );
+  }
+  void *data = slot->_data;
+  __atomic_store_n( &slot->_seq, pos + ring->_mask + 1, __ATOMIC_RELEASE );
+  return data;
+}
+
+/*
+ * remove and return the first entry; only one thread may use this at a time
+ * (and no thread may use dbBE_Ring_pop() concurrently)
+ */
+static inline
+void* dbBE_Ring_pop_single( dbBE_Ring_t *ring )
+{
+  if( ring == NULL )
+    return NULL;
+
+  size_t pos = ring->_head;
+  dbBE_Ring_slot_t *slot = &ring->_slots[ pos & ring->_mask ];
+  if( __atomic_load_n( &slot->_seq, __ATOMIC_ACQUIRE ) != pos + 1 )
+    return NULL;
+
+  void *data = slot->_data;
+  __atomic_store_n( &ring->_head, pos + 1, __ATOMIC_RELEASE );
+  __atomic_store_n( &slot->_seq, pos + ring->_mask + 1, __ATOMIC_RELEASE );
+  return data;
+}
+
+
+#endif /* BACKEND_COMMON_RING_H_ */
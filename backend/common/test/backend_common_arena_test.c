@@ -0,0 +1,123 @@
+/*
+ * Copyright © 2018-2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifdef __APPLE__
+#include <stdlib.h>
+#else
+#include <malloc.h>
+#endif
+#include <stdio.h>
+#include <string.h>
+
+#include <libdatabroker.h>
+#include "../backend/common/arena.h"
+#include "test_utils.h"
+
+#define TEST_ARENA_CHUNK ( 1024 )
+#define TEST_ARENA_KEEP ( 2 * TEST_ARENA_CHUNK )
+
+static
+int count_chunks( dbBE_Arena_t *arena )
+{
+  int n = 0;
+  dbBE_Arena_chunk_t *chunk;
+  for( chunk = arena->_first; chunk != NULL; chunk = chunk->_next )
+    ++n;
+  return n;
+}
+
+int main( int argc, char *argv[] )
+{
+  int rc = 0;
+  int n;
+
+  rc += TEST( dbBE_Arena_create( 0, 0 ), NULL );
+  rc += TEST( dbBE_Arena_destroy( NULL ), EINVAL );
+  rc += TEST( dbBE_Arena_alloc( NULL, 8 ), NULL );
+  dbBE_Arena_reset( NULL );
+
+  dbBE_Arena_t *arena = dbBE_Arena_create( TEST_ARENA_CHUNK, TEST_ARENA_KEEP );
+  rc += TEST_NOT( arena, NULL );
+  TEST_BREAK( rc, "Failed to create arena" );
+
+  // nothing allocated until first use
+  rc += TEST( arena->_first, NULL );
+  rc += TEST( dbBE_Arena_alloc( arena, 0 ), NULL );
+  rc += TEST( dbBE_Arena_calloc( arena, (size_t)-1, 16 ), NULL );
+
+  // allocations are aligned and consecutive within a chunk
+  char *a = (char*)dbBE_Arena_alloc( arena, 1 );
+  char *b = (char*)dbBE_Arena_alloc( arena, 17 );
+  char *c = (char*)dbBE_Arena_alloc( arena, 16 );
+  rc += TEST_NOT( a, NULL );
+  rc += TEST( (uintptr_t)a % DBBE_ARENA_ALIGN, 0 );
+  rc += TEST( b - a, DBBE_ARENA_ALIGN );
+  rc += TEST( c - b, 2 * DBBE_ARENA_ALIGN );
+  rc += TEST( arena->_allocated, 4 * DBBE_ARENA_ALIGN );
+  rc += TEST( count_chunks( arena ), 1 );
+
+  // calloc returns zeroed memory even from a reused chunk
+  memset( a, 0xff, 4 * DBBE_ARENA_ALIGN );
+  dbBE_Arena_reset( arena );
+  rc += TEST( arena->_allocated, 0 );
+  int64_t *z = (int64_t*)dbBE_Arena_calloc( arena, 4, sizeof( int64_t ) );
+  rc += TEST( (char*)z, a );
+  for( n = 0; n < 4; ++n )
+    rc += TEST( z[ n ], 0 );
+
+  // fill more than one chunk: new chunks are appended
+  dbBE_Arena_reset( arena );
+  for( n = 0; n < 3 * TEST_ARENA_CHUNK / 64; ++n )
+  {
+    char *p = (char*)dbBE_Arena_alloc( arena, 64 );
+    rc += TEST_NOT( p, NULL );
+    memset( p, n, 64 );
+  }
+  rc += TEST( count_chunks( arena ), 3 );
+
+  // oversized requests get their own chunk
+  char *big = (char*)dbBE_Arena_alloc( arena, 4 * TEST_ARENA_CHUNK );
+  rc += TEST_NOT( big, NULL );
+  memset( big, 0, 4 * TEST_ARENA_CHUNK );
+  rc += TEST( count_chunks( arena ), 4 );
+
+  // reset keeps up to TEST_ARENA_KEEP bytes of regular chunks; the first one is reused first
+  dbBE_Arena_reset( arena );
+  rc += TEST( count_chunks( arena ), TEST_ARENA_KEEP / TEST_ARENA_CHUNK );
+  rc += TEST( (char*)dbBE_Arena_alloc( arena, 8 ), a );
+
+  // a request that doesn't fit the current chunk moves on to the next kept chunk
+  rc += TEST_NOT( dbBE_Arena_alloc( arena, TEST_ARENA_CHUNK ), NULL );
+  rc += TEST( arena->_current, arena->_first->_next );
+  rc += TEST( count_chunks( arena ), 2 );
+
+  rc += TEST( dbBE_Arena_destroy( arena ), 0 );
+
+  // an arena that keeps nothing frees all chunks on reset
+  arena = dbBE_Arena_create( TEST_ARENA_CHUNK, 0 );
+  rc += TEST_NOT( arena, NULL );
+  TEST_BREAK( rc, "Failed to create arena" );
+  rc += TEST_NOT( dbBE_Arena_alloc( arena, 8 ), NULL );
+  dbBE_Arena_reset( arena );
+  rc += TEST( arena->_first, NULL );
+  rc += TEST( arena->_current, NULL );
+  rc += TEST_NOT( dbBE_Arena_alloc( arena, 8 ), NULL );
+  rc += TEST( dbBE_Arena_destroy( arena ), 0 );
+
+  printf( "Test exiting with rc=%d\n", rc );
+  return rc;
+}
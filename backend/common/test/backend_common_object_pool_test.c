@@ -0,0 +1,125 @@
+/*
+ * Copyright © 2018 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifdef __APPLE__
+#include <stdlib.h>
+#else
+#include <malloc.h>
+#endif
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <libdatabroker.h>
+#include "../backend/common/object_pool.h"
+#include "test_utils.h"
+
+#define TEST_POOL_CAPACITY ( 8 )
+#define TEST_POOL_OBJ_SIZE ( 64 )
+#define TEST_POOL_THREAD_LOOPS ( 100000 )
+
+/*
+ * get/put objects concurrently to stress the pool lock
+ */
+void* pool_worker( void *arg )
+{
+  dbBE_Object_pool_t *pool = (dbBE_Object_pool_t*)arg;
+  int64_t errors = 0;
+  int n;
+  for( n = 0; n < TEST_POOL_THREAD_LOOPS; ++n )
+  {
+    char *obj = (char*)dbBE_Object_pool_get( pool );
+    if( obj == NULL )
+    {
+      ++errors;
+      continue;
+    }
+    memset( obj, n & 0xff, TEST_POOL_OBJ_SIZE );
+    dbBE_Object_pool_put( pool, obj );
+  }
+  return (void*)errors;
+}
+
+int main( int argc, char *argv[] )
+{
+  int rc = 0;
+  int i;
+
+  rc += TEST( dbBE_Object_pool_create( 0, TEST_POOL_CAPACITY ), NULL );
+  rc += TEST( dbBE_Object_pool_create( TEST_POOL_OBJ_SIZE, 0 ), NULL );
+  rc += TEST( dbBE_Object_pool_destroy( NULL ), -EINVAL );
+  rc += TEST( dbBE_Object_pool_get( NULL ), NULL );
+  rc += TEST( dbBE_Object_pool_allocated( NULL ), 0 );
+
+  // put without a pool falls back to free()
+  dbBE_Object_pool_put( NULL, malloc( TEST_POOL_OBJ_SIZE ) );
+  dbBE_Object_pool_put( NULL, NULL );
+
+  dbBE_Object_pool_t *pool = dbBE_Object_pool_create( TEST_POOL_OBJ_SIZE, TEST_POOL_CAPACITY );
+  rc += TEST_NOT( pool, NULL );
+  TEST_BREAK( rc, "Failed to create object pool" );
+
+  // an empty pool allocates from the heap
+  void *objs[ TEST_POOL_CAPACITY + 2 ];
+  for( i = 0; i < TEST_POOL_CAPACITY + 2; ++i )
+  {
+    objs[ i ] = dbBE_Object_pool_get( pool );
+    rc += TEST_NOT( objs[ i ], NULL );
+  }
+  rc += TEST( dbBE_Object_pool_allocated( pool ), TEST_POOL_CAPACITY + 2 );
+  TEST_LOG( rc, "Pool allocation" );
+
+  // only up to capacity objects are cached, the rest is freed
+  for( i = 0; i < TEST_POOL_CAPACITY + 2; ++i )
+    dbBE_Object_pool_put( pool, objs[ i ] );
+  rc += TEST( pool->_count, TEST_POOL_CAPACITY );
+
+  // cached objects are reused (last in, first out) without new heap allocations
+  for( i = TEST_POOL_CAPACITY - 1; i >= 0; --i )
+    rc += TEST( dbBE_Object_pool_get( pool ), objs[ i ] );
+  rc += TEST( pool->_count, 0 );
+  rc += TEST( dbBE_Object_pool_allocated( pool ), TEST_POOL_CAPACITY + 2 );
+  TEST_LOG( rc, "Pool reuse" );
+
+  // pooled objects are interchangeable with plain heap objects
+  free( objs[ 0 ] );
+  objs[ 0 ] = malloc( TEST_POOL_OBJ_SIZE );
+  for( i = 0; i < TEST_POOL_CAPACITY; ++i )
+    dbBE_Object_pool_put( pool, objs[ i ] );
+  rc += TEST( pool->_count, TEST_POOL_CAPACITY );
+
+  // concurrent use from multiple threads
+  pthread_t workers[ 4 ];
+  for( i = 0; i < 4; ++i )
+    rc += TEST( pthread_create( &workers[ i ], NULL, pool_worker, pool ), 0 );
+  TEST_BREAK( rc, "Failed to create worker threads" );
+  for( i = 0; i < 4; ++i )
+  {
+    void *errors = NULL;
+    rc += TEST( pthread_join( workers[ i ], &errors ), 0 );
+    rc += TEST( (int64_t)errors, 0 );
+  }
+  rc += TEST( pool->_count <= TEST_POOL_CAPACITY, 1 );
+  // 4 threads hold at most one object each; everything else is recycled
+  rc += TEST( dbBE_Object_pool_allocated( pool ) <= TEST_POOL_CAPACITY + 2 + 4, 1 );
+  TEST_LOG( rc, "Concurrent pool access" );
+
+  rc += TEST( dbBE_Object_pool_destroy( pool ), 0 );
+
+  printf( "Test exiting with rc=%d\n", rc );
+  return rc;
+}
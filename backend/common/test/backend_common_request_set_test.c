@@ -66,6 +66,57 @@ int RemoveTest( dbBE_Request_set_t *set, dbBE_Request_t **req )
   return rc;
 }
 
+/*
+ * fill the set to capacity with adjacent requests (clustered hashes) and delete
+ * them in a scattered order, every remaining entry has to stay reachable
+ */
+int HashTest()
+{
+  int rc = 0;
+  int i, n;
+  const int size = 64;
+
+  dbBE_Request_set_t *set = dbBE_Request_set_create( size );
+  rc += TEST_NOT( set, NULL );
+  TEST_BREAK( rc, "Failed to create set" );
+
+  dbBE_Request_t *reqs = (dbBE_Request_t*)calloc( size + 1, sizeof( dbBE_Request_t ) );
+  for( i = 0; i < size; ++i )
+    rc += TEST( dbBE_Request_set_insert( set, &reqs[ i ] ), 0 );
+  rc += TEST( dbBE_Request_set_insert( set, &reqs[ size ] ), ENOSPC );
+  rc += TEST( dbBE_Request_set_get_len( set ), (size_t)size );
+  rc += TEST( dbBE_Request_set_find( set, &reqs[ size ] ), 0 );
+
+  int deleted[ 64 ];
+  memset( deleted, 0, sizeof( deleted ) );
+  for( n = 0; n < size; ++n )
+  {
+    int d = ( n * 37 ) % size;
+    rc += TEST( dbBE_Request_set_delete( set, &reqs[ d ] ), 1 );
+    rc += TEST( dbBE_Request_set_delete( set, &reqs[ d ] ), 0 );
+    deleted[ d ] = 1;
+    int found = 0;
+    for( i = 0; i < size; ++i )
+      found += ( dbBE_Request_set_find( set, &reqs[ i ] ) == !deleted[ i ] );
+    rc += TEST( found, size );
+  }
+  rc += TEST_NOT( dbBE_Request_set_empty( set ), 0 );
+
+  // duplicates are separate entries
+  rc += TEST( dbBE_Request_set_insert( set, &reqs[ 0 ] ), 0 );
+  rc += TEST( dbBE_Request_set_insert( set, &reqs[ 0 ] ), 0 );
+  rc += TEST( dbBE_Request_set_delete( set, &reqs[ 0 ] ), 1 );
+  rc += TEST( dbBE_Request_set_find( set, &reqs[ 0 ] ), 1 );
+  rc += TEST( dbBE_Request_set_clear( set ), 0 );
+  rc += TEST( dbBE_Request_set_find( set, &reqs[ 0 ] ), 0 );
+  rc += TEST( dbBE_Request_set_get_len( set ), 0 );
+
+  rc += TEST( dbBE_Request_set_destroy( set ), 0 );
+  free( reqs );
+  TEST_LOG( rc, "Set Hash Test." );
+  return rc;
+}
+
 int main( int argc, char *argv[] )
 {
   int rc = 0;
@@ -119,6 +170,7 @@ int main( int argc, char *argv[] )
   rc += TEST( dbBE_Request_set_get_len( set ), 0 );
 
   rc += RemoveTest( set, req );
+  rc += HashTest();
 
   // add a few items before destruction, to employ the wiping code path
   for( i=0; i<3; ++i )
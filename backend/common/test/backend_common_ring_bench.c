@@ -0,0 +1,220 @@
+/*
+ * Copyright © 2018-2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * microbenchmark: hand-off throughput under contention
+ * usage: backend_common_ring_bench [items_per_producer]
+ *
+ * Compares a mutex-protected completion queue (the intrusive list as used
+ * for the progress hand-off before) with the lock-free rings for different
+ * numbers of producer and consumer threads.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../backend/common/completion_queue.h"
+#include "../backend/common/ring.h"
+
+#define BENCH_DEFAULT_ITEMS ( 1000000 )
+#define BENCH_RING_SIZE ( 1024 )
+#define BENCH_MAX_THREADS ( 16 )
+
+typedef enum
+{
+  BENCH_LOCKED_LIST,
+  BENCH_RING_MPMC,
+  BENCH_RING_MPSC
+} bench_impl_t;
+
+static const char *gImplName[] = { "locked-list", "ring-mpmc", "ring-mpsc" };
+
+typedef struct
+{
+  bench_impl_t _impl;
+  pthread_mutex_t _lock;
+  dbBE_Completion_queue_t *_list;
+  dbBE_Ring_t *_ring;
+  dbBE_Completion_t *_items;
+  long _per_producer;
+  int _producers;
+  long _consumed;
+} bench_t;
+
+typedef struct
+{
+  bench_t *_bench;
+  int _id;
+} bench_thread_t;
+
+static
+double now_sec()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static
+int bench_push( bench_t *b, dbBE_Completion_t *item )
+{
+  int rc;
+  switch( b->_impl )
+  {
+    case BENCH_LOCKED_LIST:
+      pthread_mutex_lock( &b->_lock );
+      rc = dbBE_Completion_queue_push( b->_list, item );
+      pthread_mutex_unlock( &b->_lock );
+      return rc;
+    default:
+      return dbBE_Ring_push( b->_ring, item );
+  }
+}
+
+static
+dbBE_Completion_t* bench_pop( bench_t *b )
+{
+  dbBE_Completion_t *item;
+  switch( b->_impl )
+  {
+    case BENCH_LOCKED_LIST:
+      // unlocked length check like the previous progress fetch
+      if( dbBE_Completion_queue_len( b->_list ) == 0 )
+        return NULL;
+      pthread_mutex_lock( &b->_lock );
+      item = dbBE_Completion_queue_pop( b->_list );
+      pthread_mutex_unlock( &b->_lock );
+      return item;
+    case BENCH_RING_MPSC:
+      return (dbBE_Completion_t*)dbBE_Ring_pop_single( b->_ring );
+    default:
+      return (dbBE_Completion_t*)dbBE_Ring_pop( b->_ring );
+  }
+}
+
+static
+void* producer( void *arg )
+{
+  bench_thread_t *t = (bench_thread_t*)arg;
+  bench_t *b = t->_bench;
+  dbBE_Completion_t *items = &b->_items[ t->_id * b->_per_producer ];
+  long n;
+  for( n = 0; n < b->_per_producer; ++n )
+    while( bench_push( b, &items[ n ] ) != 0 )
+      sched_yield();
+  return NULL;
+}
+
+static
+void* consumer( void *arg )
+{
+  bench_thread_t *t = (bench_thread_t*)arg;
+  bench_t *b = t->_bench;
+  long total = b->_per_producer * b->_producers;
+  while( __atomic_load_n( &b->_consumed, __ATOMIC_RELAXED ) < total )
+  {
+    if( bench_pop( b ) != NULL )
+      __atomic_fetch_add( &b->_consumed, 1, __ATOMIC_RELAXED );
+    else
+      sched_yield();
+  }
+  return NULL;
+}
+
+static
+int bench_run( bench_impl_t impl, int producers, int consumers, long per_producer )
+{
+  bench_t b;
+  memset( &b, 0, sizeof( b ) );
+  b._impl = impl;
+  b._per_producer = per_producer;
+  b._producers = producers;
+  pthread_mutex_init( &b._lock, NULL );
+  b._list = dbBE_Completion_queue_create( BENCH_RING_SIZE );
+  b._ring = dbBE_Ring_create( BENCH_RING_SIZE );
+  b._items = (dbBE_Completion_t*)calloc( producers * per_producer, sizeof( dbBE_Completion_t ) );
+  if(( b._list == NULL ) || ( b._ring == NULL ) || ( b._items == NULL ))
+  {
+    fprintf( stderr, "Failed to allocate\n" );
+    return 1;
+  }
+
+  pthread_t threads[ 2 * BENCH_MAX_THREADS ];
+  bench_thread_t targs[ 2 * BENCH_MAX_THREADS ];
+  int n;
+  double start = now_sec();
+  for( n = 0; n < consumers; ++n )
+  {
+    targs[ n ]._bench = &b;
+    targs[ n ]._id = n;
+    pthread_create( &threads[ n ], NULL, consumer, &targs[ n ] );
+  }
+  for( n = 0; n < producers; ++n )
+  {
+    targs[ consumers + n ]._bench = &b;
+    targs[ consumers + n ]._id = n;
+    pthread_create( &threads[ consumers + n ], NULL, producer, &targs[ consumers + n ] );
+  }
+  for( n = 0; n < producers + consumers; ++n )
+    pthread_join( threads[ n ], NULL );
+  double elapsed = now_sec() - start;
+
+  printf( "%-12s P=%2d C=%2d %8.2f Mops/s %8.1f ns/item\n",
+          gImplName[ impl ], producers, consumers,
+          (double)b._consumed / elapsed / 1e6,
+          elapsed * 1e9 / (double)b._consumed );
+
+  free( b._items );
+  dbBE_Ring_destroy( b._ring );
+  dbBE_Completion_queue_destroy( b._list );
+  pthread_mutex_destroy( &b._lock );
+  return 0;
+}
+
+int main( int argc, char **argv )
+{
+  long items = BENCH_DEFAULT_ITEMS;
+  if( argc > 1 )
+    items = strtol( argv[ 1 ], NULL, 10 );
+  if( items <= 0 )
+    items = BENCH_DEFAULT_ITEMS;
+
+  int rc = 0;
+  rc += bench_run( BENCH_LOCKED_LIST, 1, 1, items );
+  rc += bench_run( BENCH_RING_MPSC, 1, 1, items );
+
+  static const int producers[] = { 2, 4, 8 };
+  unsigned p;
+  for( p = 0; p < sizeof( producers ) / sizeof( producers[0] ); ++p )
+  {
+    // many user threads posting to the progress thread
+    rc += bench_run( BENCH_LOCKED_LIST, producers[ p ], 1, items / producers[ p ] );
+    rc += bench_run( BENCH_RING_MPSC, producers[ p ], 1, items / producers[ p ] );
+    // progress thread completing to many user threads
+    rc += bench_run( BENCH_LOCKED_LIST, 1, producers[ p ], items );
+    rc += bench_run( BENCH_RING_MPMC, 1, producers[ p ], items );
+    // both sides contended
+    rc += bench_run( BENCH_LOCKED_LIST, producers[ p ], producers[ p ], items / producers[ p ] );
+    rc += bench_run( BENCH_RING_MPMC, producers[ p ], producers[ p ], items / producers[ p ] );
+  }
+  return rc;
+}
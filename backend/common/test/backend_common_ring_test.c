@@ -0,0 +1,204 @@
+/*
+ * Copyright © 2018-2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifdef __APPLE__
+#include <stdlib.h>
+#else
+#include <malloc.h>
+#endif
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <libdatabroker.h>
+#include "../backend/common/ring.h"
+#include "test_utils.h"
+
+#define TEST_RING_SIZE ( 6 )
+#define TEST_RING_CAPACITY ( 8 )
+#define TEST_RING_THREADS ( 4 )
+#define TEST_RING_ITEMS ( 100000 )
+
+/*
+ * items are encoded as (thread << 32) + sequence + 1 to be able to check
+ * that every producer's items arrive complete and in order
+ */
+typedef struct
+{
+  dbBE_Ring_t *_ring;
+  int _id;
+  int64_t _last[ TEST_RING_THREADS ];
+  int64_t _received;
+  int64_t _errors;
+} ring_thread_arg_t;
+
+static ring_thread_arg_t gArgs[ TEST_RING_THREADS ];
+static int gConsumersDone;
+
+void* ring_producer( void *arg )
+{
+  ring_thread_arg_t *a = (ring_thread_arg_t*)arg;
+  int64_t n;
+  for( n = 0; n < TEST_RING_ITEMS; ++n )
+  {
+    uintptr_t item = ((uintptr_t)a->_id << 32) + n + 1;
+    while( dbBE_Ring_push( a->_ring, (void*)item ) != 0 )
+      sched_yield();
+  }
+  return NULL;
+}
+
+/*
+ * consume until the expected number of items arrived (single consumer)
+ * or until all items are gone (multiple consumers)
+ */
+void* ring_consumer( void *arg )
+{
+  ring_thread_arg_t *a = (ring_thread_arg_t*)arg;
+  int64_t total = a->_received;
+  a->_received = 0;
+  while( a->_received < total )
+  {
+    uintptr_t item;
+    if( total == TEST_RING_ITEMS * TEST_RING_THREADS )
+      item = (uintptr_t)dbBE_Ring_pop_single( a->_ring );
+    else
+      item = (uintptr_t)dbBE_Ring_pop( a->_ring );
+
+    if( item == 0 )
+    {
+      if( __atomic_load_n( &gConsumersDone, __ATOMIC_ACQUIRE ) )
+        break;
+      sched_yield(); // let the producers run if there are fewer cores than threads
+      continue;
+    }
+    int id = (int)( item >> 32 );
+    int64_t seq = (int64_t)( item & 0xffffffff );
+    if(( id >= TEST_RING_THREADS ) || ( seq <= a->_last[ id ] ))
+      ++a->_errors;
+    else
+      a->_last[ id ] = seq;
+    ++a->_received;
+  }
+  return NULL;
+}
+
+int main( int argc, char *argv[] )
+{
+  int rc = 0;
+  int i;
+  uintptr_t n;
+
+  rc += TEST( dbBE_Ring_create( 0 ), NULL );
+  rc += TEST( dbBE_Ring_destroy( NULL ), EINVAL );
+  rc += TEST( dbBE_Ring_push( NULL, (void*)1 ), EINVAL );
+  rc += TEST( dbBE_Ring_pop( NULL ), NULL );
+  rc += TEST( dbBE_Ring_pop_single( NULL ), NULL );
+  rc += TEST( dbBE_Ring_len( NULL ), 0 );
+
+  dbBE_Ring_t *ring = dbBE_Ring_create( TEST_RING_SIZE );
+  rc += TEST_NOT( ring, NULL );
+  TEST_BREAK( rc, "Failed to create ring" );
+
+  // capacity rounded up to the next power of 2
+  rc += TEST( ring->_mask, TEST_RING_CAPACITY - 1 );
+  rc += TEST( dbBE_Ring_push( ring, NULL ), EINVAL );
+  rc += TEST( dbBE_Ring_pop( ring ), NULL );
+  rc += TEST( dbBE_Ring_pop_single( ring ), NULL );
+
+  // fill, overflow, drain in order; repeat to wrap around a few times
+  int round;
+  for( round = 0; round < 3; ++round )
+  {
+    for( n = 1; n <= TEST_RING_CAPACITY; ++n )
+      rc += TEST( dbBE_Ring_push( ring, (void*)n ), 0 );
+    rc += TEST( dbBE_Ring_len( ring ), TEST_RING_CAPACITY );
+    rc += TEST( dbBE_Ring_push( ring, (void*)n ), ENOSPC );
+    for( n = 1; n <= TEST_RING_CAPACITY; ++n )
+    {
+      if( n & 1 )
+        rc += TEST( dbBE_Ring_pop( ring ), (void*)n );
+      else
+        rc += TEST( dbBE_Ring_pop_single( ring ), (void*)n );
+    }
+    rc += TEST( dbBE_Ring_len( ring ), 0 );
+    rc += TEST( dbBE_Ring_pop( ring ), NULL );
+
+    // partial fill to shift the position
+    rc += TEST( dbBE_Ring_push( ring, (void*)1 ), 0 );
+    rc += TEST( dbBE_Ring_pop( ring ), (void*)1 );
+  }
+
+  pthread_t prod[ TEST_RING_THREADS ];
+  pthread_t cons[ TEST_RING_THREADS ];
+  ring_thread_arg_t carg[ TEST_RING_THREADS ];
+
+  // MPSC: all producers, one consumer with pop_single; per-producer order is kept
+  memset( carg, 0, sizeof( carg ) );
+  carg[ 0 ]._ring = ring;
+  carg[ 0 ]._received = TEST_RING_ITEMS * TEST_RING_THREADS;
+  rc += TEST( pthread_create( &cons[ 0 ], NULL, ring_consumer, &carg[ 0 ] ), 0 );
+  for( i = 0; i < TEST_RING_THREADS; ++i )
+  {
+    memset( &gArgs[ i ], 0, sizeof( ring_thread_arg_t ) );
+    gArgs[ i ]._ring = ring;
+    gArgs[ i ]._id = i;
+    rc += TEST( pthread_create( &prod[ i ], NULL, ring_producer, &gArgs[ i ] ), 0 );
+  }
+  TEST_BREAK( rc, "Failed to create threads" );
+  for( i = 0; i < TEST_RING_THREADS; ++i )
+    rc += TEST( pthread_join( prod[ i ], NULL ), 0 );
+  rc += TEST( pthread_join( cons[ 0 ], NULL ), 0 );
+  rc += TEST( carg[ 0 ]._received, TEST_RING_ITEMS * TEST_RING_THREADS );
+  rc += TEST( carg[ 0 ]._errors, 0 );
+
+  // MPMC: all producers, all consumers; nothing lost or duplicated
+  // each consumer sees every producer's items in increasing order
+  memset( carg, 0, sizeof( carg ) );
+  gConsumersDone = 0;
+  for( i = 0; i < TEST_RING_THREADS; ++i )
+  {
+    carg[ i ]._ring = ring;
+    carg[ i ]._received = TEST_RING_ITEMS * TEST_RING_THREADS + 1; // stop via gConsumersDone
+    rc += TEST( pthread_create( &cons[ i ], NULL, ring_consumer, &carg[ i ] ), 0 );
+  }
+  for( i = 0; i < TEST_RING_THREADS; ++i )
+    rc += TEST( pthread_create( &prod[ i ], NULL, ring_producer, &gArgs[ i ] ), 0 );
+  TEST_BREAK( rc, "Failed to create threads" );
+  for( i = 0; i < TEST_RING_THREADS; ++i )
+    rc += TEST( pthread_join( prod[ i ], NULL ), 0 );
+  while( dbBE_Ring_len( ring ) > 0 )
+    sched_yield();
+  __atomic_store_n( &gConsumersDone, 1, __ATOMIC_RELEASE );
+  int64_t received = 0;
+  int64_t errors = 0;
+  for( i = 0; i < TEST_RING_THREADS; ++i )
+  {
+    rc += TEST( pthread_join( cons[ i ], NULL ), 0 );
+    received += carg[ i ]._received;
+    errors += carg[ i ]._errors;
+  }
+  rc += TEST( received, TEST_RING_ITEMS * TEST_RING_THREADS );
+  rc += TEST( errors, 0 );
+  rc += TEST( dbBE_Ring_pop( ring ), NULL );
+
+  rc += TEST( dbBE_Ring_destroy( ring ), 0 );
+
+  printf( "Test exiting with rc=%d\n", rc );
+  return rc;
+}
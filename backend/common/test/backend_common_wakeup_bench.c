@@ -0,0 +1,207 @@
+/*
+ * Copyright © 2018-2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * microbenchmark: blocking wait for an event from another thread
+ * usage: backend_common_wakeup_bench [iterations]
+ *
+ * Compares the two ways a thread in dbrWait_block() can wait for a reply
+ * that arrives after a given delay:
+ *  - backoff: timed condvar waits with intervals doubling from 8us to 1ms;
+ *    nobody signals the condvar (a socket event doesn't), so the reply is
+ *    only noticed when an interval expires
+ *  - fd: poll() on a wake-up fd that becomes readable with the reply
+ *    (as the back-end event fd does)
+ * Reports the average latency from the event to the waiter noticing it,
+ * the waiter's CPU time and the number of wakeups per wait.
+ */
+
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../backend/common/wakeup.h"
+
+#define BENCH_DEFAULT_ITERATIONS ( 200 )
+#define BENCH_BACKOFF_USEC_MIN ( 8 )
+#define BENCH_BACKOFF_USEC_MAX ( 1024 )
+
+typedef enum
+{
+  BENCH_WAIT_BACKOFF,
+  BENCH_WAIT_FD
+} bench_wait_t;
+
+static const char *gWaitName[] = { "backoff", "fd" };
+
+typedef struct
+{
+  bench_wait_t _mode;
+  long _delay_usec;
+  int _iterations;
+  dbBE_Wakeup_t _wakeup;
+  pthread_mutex_t _lock;
+  pthread_cond_t _cond;
+  int _armed;       ///< waiter is ready for the next event
+  int _event;       ///< event happened
+  int64_t _event_nsec;
+} bench_t;
+
+static
+int64_t now_nsec( clockid_t clock )
+{
+  struct timespec ts;
+  clock_gettime( clock, &ts );
+  return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static
+void* bench_producer( void *arg )
+{
+  bench_t *b = (bench_t*)arg;
+  int i;
+  for( i = 0; i < b->_iterations; ++i )
+  {
+    while( ! __atomic_load_n( &b->_armed, __ATOMIC_ACQUIRE ) )
+    {
+      struct timespec y = { 0, 1000 };
+      nanosleep( &y, NULL );
+    }
+    __atomic_store_n( &b->_armed, 0, __ATOMIC_RELAXED );
+
+    struct timespec delay = { b->_delay_usec / 1000000, ( b->_delay_usec % 1000000 ) * 1000 };
+    nanosleep( &delay, NULL );
+
+    b->_event_nsec = now_nsec( CLOCK_MONOTONIC );
+    __atomic_store_n( &b->_event, 1, __ATOMIC_RELEASE );
+    if( b->_mode == BENCH_WAIT_FD )
+      dbBE_Wakeup_signal( &b->_wakeup );
+  }
+  return NULL;
+}
+
+static
+void bench_wait_backoff( bench_t *b, long *wakeups )
+{
+  int64_t usec = BENCH_BACKOFF_USEC_MIN;
+  pthread_mutex_lock( &b->_lock );
+  while( ! __atomic_load_n( &b->_event, __ATOMIC_ACQUIRE ) )
+  {
+    struct timespec until;
+    clock_gettime( CLOCK_MONOTONIC, &until );
+    int64_t nsec = until.tv_nsec + usec * 1000;
+    until.tv_sec += nsec / 1000000000;
+    until.tv_nsec = nsec % 1000000000;
+    pthread_cond_timedwait( &b->_cond, &b->_lock, &until );
+    ++(*wakeups);
+    usec = ( usec * 2 > BENCH_BACKOFF_USEC_MAX ) ? BENCH_BACKOFF_USEC_MAX : usec * 2;
+  }
+  pthread_mutex_unlock( &b->_lock );
+}
+
+static
+void bench_wait_fd( bench_t *b, long *wakeups )
+{
+  struct pollfd pfd;
+  pfd.fd = dbBE_Wakeup_fd( &b->_wakeup );
+  pfd.events = POLLIN;
+  while( ! __atomic_load_n( &b->_event, __ATOMIC_ACQUIRE ) )
+  {
+    pfd.revents = 0;
+    poll( &pfd, 1, 1000 );
+    ++(*wakeups);
+  }
+  dbBE_Wakeup_drain( &b->_wakeup );
+}
+
+static
+int bench_run( bench_wait_t mode, long delay_usec, int iterations )
+{
+  bench_t b;
+  memset( &b, 0, sizeof( b ) );
+  b._mode = mode;
+  b._delay_usec = delay_usec;
+  b._iterations = iterations;
+  if( dbBE_Wakeup_init( &b._wakeup ) != 0 )
+    return 1;
+  pthread_mutex_init( &b._lock, NULL );
+  pthread_condattr_t cattr;
+  pthread_condattr_init( &cattr );
+  pthread_condattr_setclock( &cattr, CLOCK_MONOTONIC );
+  pthread_cond_init( &b._cond, &cattr );
+  pthread_condattr_destroy( &cattr );
+
+  pthread_t producer;
+  if( pthread_create( &producer, NULL, bench_producer, &b ) != 0 )
+    return 1;
+
+  int64_t latency = 0;
+  long wakeups = 0;
+  int64_t cpu = now_nsec( CLOCK_THREAD_CPUTIME_ID );
+  int i;
+  for( i = 0; i < iterations; ++i )
+  {
+    __atomic_store_n( &b._event, 0, __ATOMIC_RELAXED );
+    __atomic_store_n( &b._armed, 1, __ATOMIC_RELEASE );
+    if( mode == BENCH_WAIT_FD )
+      bench_wait_fd( &b, &wakeups );
+    else
+      bench_wait_backoff( &b, &wakeups );
+    latency += now_nsec( CLOCK_MONOTONIC ) - b._event_nsec;
+  }
+  cpu = now_nsec( CLOCK_THREAD_CPUTIME_ID ) - cpu;
+  pthread_join( producer, NULL );
+
+  printf( "%-8s %8ld %14.1f %14.1f %10.1f\n",
+          gWaitName[ mode ], delay_usec,
+          (double)latency / iterations / 1000.0,
+          (double)cpu / iterations / 1000.0,
+          (double)wakeups / iterations );
+
+  pthread_cond_destroy( &b._cond );
+  pthread_mutex_destroy( &b._lock );
+  dbBE_Wakeup_exit( &b._wakeup );
+  return 0;
+}
+
+int main( int argc, char **argv )
+{
+  int iterations = BENCH_DEFAULT_ITERATIONS;
+  if( argc > 1 )
+    iterations = atoi( argv[ 1 ] );
+  if( iterations <= 0 )
+  {
+    fprintf( stderr, "usage: %s [iterations]\n", argv[ 0 ] );
+    return 1;
+  }
+
+  static const long delays[] = { 20, 200, 2000, 20000 };
+  int rc = 0;
+  int d;
+  printf( "%-8s %8s %14s %14s %10s\n", "wait", "delay_us", "latency_us", "cpu_us/wait", "wakeups" );
+  for( d = 0; d < (int)( sizeof( delays ) / sizeof( delays[ 0 ] )); ++d )
+  {
+    int n = ( delays[ d ] >= 20000 ) ? iterations / 10 + 1 : iterations;
+    rc += bench_run( BENCH_WAIT_BACKOFF, delays[ d ], n );
+    rc += bench_run( BENCH_WAIT_FD, delays[ d ], n );
+  }
+  return rc;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright © 2018-2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include <poll.h>
+#include <pthread.h>
+
+#include <libdatabroker.h>
+#include "../backend/common/wakeup.h"
+#include "test_utils.h"
+
+static
+int readable( dbBE_Wakeup_t *w, int timeout_ms )
+{
+  struct pollfd pfd;
+  pfd.fd = dbBE_Wakeup_fd( w );
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+  return poll( &pfd, 1, timeout_ms );
+}
+
+void* signal_thread( void *arg )
+{
+  dbBE_Wakeup_signal( (dbBE_Wakeup_t*)arg );
+  return NULL;
+}
+
+int main( int argc, char *argv[] )
+{
+  int rc = 0;
+  int n;
+
+  rc += TEST( dbBE_Wakeup_init( NULL ), -EINVAL );
+  dbBE_Wakeup_exit( NULL );
+
+  dbBE_Wakeup_t w;
+  rc += TEST( dbBE_Wakeup_init( &w ), 0 );
+  TEST_BREAK( rc, "Failed to create wake-up fd" );
+  rc += TEST_NOT( dbBE_Wakeup_fd( &w ) < 0, 1 );
+
+  // nothing signalled
+  rc += TEST( readable( &w, 0 ), 0 );
+
+  // signals accumulate into a single readable state until drained
+  for( n = 0; n < 100; ++n )
+    dbBE_Wakeup_signal( &w );
+  rc += TEST( readable( &w, 0 ), 1 );
+  dbBE_Wakeup_drain( &w );
+  rc += TEST( readable( &w, 0 ), 0 );
+
+  // draining an empty fd doesn't block
+  dbBE_Wakeup_drain( &w );
+  rc += TEST( readable( &w, 0 ), 0 );
+
+  // a blocked poll is ended by another thread
+  pthread_t thread;
+  rc += TEST( pthread_create( &thread, NULL, signal_thread, &w ), 0 );
+  rc += TEST( readable( &w, 10000 ), 1 );
+  rc += TEST( pthread_join( thread, NULL ), 0 );
+  dbBE_Wakeup_drain( &w );
+
+  dbBE_Wakeup_exit( &w );
+  rc += TEST( dbBE_Wakeup_fd( &w ), -1 );
+  dbBE_Wakeup_exit( &w ); // no double close
+
+  printf( "Test exiting with rc=%d\n", rc );
+  return rc;
+}
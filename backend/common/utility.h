@@ -20,6 +20,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <inttypes.h>
 
 #include "logutil.h"
 
@@ -43,6 +44,23 @@ char* dbBE_Extract_env( const char *env_var, const char *env_default )
   return env;
 }
 
+/*
+ * 64bit FNV-1a hash of the first maxlen characters of a string
+ * used to index name tables on the client and the back-end side
+ */
+static inline
+uint64_t dbBE_String_hash( const char *str, const size_t maxlen )
+{
+  uint64_t hash = 0xcbf29ce484222325ull;
+  size_t n;
+  for( n = 0; ( n < maxlen ) && ( str[ n ] != '\0' ); ++n )
+  {
+    hash ^= (uint8_t)str[ n ];
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
 
 
 
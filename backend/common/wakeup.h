@@ -0,0 +1,104 @@
+/*
+ * Copyright © 2018-2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef BACKEND_COMMON_WAKEUP_H_
+#define BACKEND_COMMON_WAKEUP_H_
+
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#ifndef __APPLE__
+#include <sys/eventfd.h>
+#endif
+
+/*
+ * Non-blocking wake-up fd that lets one thread end the poll()/epoll_wait() of another.
+ * Uses an eventfd where available and a pipe otherwise.
+ * Any thread may signal; only the thread that blocks on it should drain it.
+ */
+
+typedef struct
+{
+  int _fd[ 2 ];  ///< read and write end (the same eventfd on Linux)
+} dbBE_Wakeup_t;
+
+
+static inline
+int dbBE_Wakeup_init( dbBE_Wakeup_t *w )
+{
+  if( w == NULL )
+    return -EINVAL;
+#ifdef __APPLE__
+  if( pipe( w->_fd ) != 0 )
+  {
+    w->_fd[ 0 ] = w->_fd[ 1 ] = -1;
+    return -errno;
+  }
+  int n;
+  for( n = 0; n < 2; ++n )
+  {
+    fcntl( w->_fd[ n ], F_SETFL, fcntl( w->_fd[ n ], F_GETFL ) | O_NONBLOCK );
+    fcntl( w->_fd[ n ], F_SETFD, FD_CLOEXEC );
+  }
+#else
+  w->_fd[ 0 ] = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+  w->_fd[ 1 ] = w->_fd[ 0 ];
+  if( w->_fd[ 0 ] < 0 )
+    return -errno;
+#endif
+  return 0;
+}
+
+static inline
+void dbBE_Wakeup_exit( dbBE_Wakeup_t *w )
+{
+  if(( w == NULL ) || ( w->_fd[ 0 ] < 0 ))
+    return;
+  if( w->_fd[ 1 ] != w->_fd[ 0 ] )
+    close( w->_fd[ 1 ] );
+  close( w->_fd[ 0 ] );
+  w->_fd[ 0 ] = w->_fd[ 1 ] = -1;
+}
+
+/*
+ * the fd to poll for readability
+ */
+#define dbBE_Wakeup_fd( w ) ( (w)->_fd[ 0 ] )
+
+/*
+ * make the fd readable; a full pipe/counter is readable already
+ */
+static inline
+void dbBE_Wakeup_signal( dbBE_Wakeup_t *w )
+{
+  uint64_t one = 1;
+  ssize_t rc = write( w->_fd[ 1 ], &one, sizeof( one ) );
+  (void)rc;
+}
+
+/*
+ * reset the fd to not readable
+ */
+static inline
+void dbBE_Wakeup_drain( dbBE_Wakeup_t *w )
+{
+  uint64_t buf[ 8 ];
+  while( read( w->_fd[ 0 ], buf, sizeof( buf ) ) > 0 ) {}
+}
+
+#endif /* BACKEND_COMMON_WAKEUP_H_ */
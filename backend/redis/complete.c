@@ -134,6 +134,7 @@ dbBE_Completion_t* dbBE_Redis_complete_command( dbBE_Redis_request_t *request,
       }
       break;
     case DBBE_OPCODE_REMOVE:
+    case DBBE_OPCODE_TESTKEY:
       break;
     case DBBE_OPCODE_DIRECTORY:
       switch( rc )
@@ -225,17 +226,17 @@ dbBE_Completion_t* dbBE_Redis_complete_command( dbBE_Redis_request_t *request,
       break;
   }
 
-  return dbBE_Completion_create( request->_user, status, localrc );
+  return dbBE_Redis_completion_allocate( request->_pools, request->_user, status, localrc );
 }
 
 dbBE_Completion_t* dbBE_Redis_complete_error( dbBE_Redis_request_t *request,
                                               DBR_Errorcode_t error,
                                               int64_t retval )
 {
-  return dbBE_Completion_create( request->_user, error, retval );
+  return dbBE_Redis_completion_allocate( request->_pools, request->_user, error, retval );
 }
 
 dbBE_Completion_t* dbBE_Redis_complete_cancel( dbBE_Redis_request_t *request )
 {
-  return dbBE_Completion_create( request->_user, DBR_ERR_CANCELLED, 0 );
+  return dbBE_Redis_completion_allocate( request->_pools, request->_user, DBR_ERR_CANCELLED, 0 );
 }
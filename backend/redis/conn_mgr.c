@@ -74,6 +74,15 @@ dbBE_Redis_connection_mgr_t* dbBE_Redis_connection_mgr_init( const dbBE_Redis_co
     return NULL;
   }
   memcpy( conf, config, sizeof( dbBE_Redis_conn_mgr_config_t ) );
+  if( conf->_pool_size < 1 )
+    conf->_pool_size = 1;
+  if( conf->_pool_size > DBBE_REDIS_CONNECTION_POOL_MAX )
+  {
+    LOG( DBG_ERR, stderr, "connection_mgr_init: limiting connections per server to %d\n", DBBE_REDIS_CONNECTION_POOL_MAX );
+    conf->_pool_size = DBBE_REDIS_CONNECTION_POOL_MAX;
+  }
+  if( conf->_scrap_max == 0 )
+    conf->_scrap_max = DBBE_REDIS_SCRAP_SPACE_LEN;
   conn_mgr->_config = conf;
 
   return conn_mgr;
@@ -102,6 +111,12 @@ void dbBE_Redis_connection_mgr_exit( dbBE_Redis_connection_mgr_t *conn_mgr )
     dbBE_Redis_event_mgr_rm( conn_mgr->_ev_mgr, c );
     dbBE_Redis_connection_destroy( c );
   }
+  for( n = 0; n < DBBE_REDIS_MAX_DEDICATED_CONNECTIONS; ++n )
+    if( conn_mgr->_dedicated[ n ] != NULL )
+      dbBE_Redis_connection_mgr_drop_dedicated( conn_mgr, conn_mgr->_dedicated[ n ] );
+  for( n = 0; n < DBBE_REDIS_MAX_POOLED_CONNECTIONS; ++n )
+    if( conn_mgr->_pooled[ n ] != NULL )
+      dbBE_Redis_connection_mgr_drop_pooled( conn_mgr, conn_mgr->_pooled[ n ] );
 
   dbBE_Redis_event_mgr_exit( conn_mgr->_ev_mgr );
 
@@ -195,6 +210,7 @@ dbBE_Redis_connection_t* dbBE_Redis_connection_mgr_newlink( dbBE_Redis_connectio
     rc = -ENOMEM;
     goto exit_connect;
   }
+  dbBE_Redis_connection_set_buffer_limits( new_conn, conn_mgr->_config->_scrap_max, conn_mgr->_config->_hugepages );
 
   dbBE_Network_address_t *srv_addr = dbBE_Redis_connection_link( new_conn, url, authfile );
   if( srv_addr == NULL )
@@ -222,6 +238,169 @@ exit_connect:
 }
 
 
+/*
+ * create an additional connection to the same Redis instance as conn
+ * and register it with the event mgr under the given index
+ */
+static
+dbBE_Redis_connection_t* dbBE_Redis_connection_mgr_link_extra( dbBE_Redis_connection_mgr_t *conn_mgr,
+                                                               dbBE_Redis_connection_t *conn,
+                                                               const int index )
+{
+  char *authfile = dbBE_Extract_env( DBR_SERVER_AUTHFILE_ENV, DBR_SERVER_DEFAULT_AUTHFILE );
+  dbBE_Redis_connection_t *new_conn = dbBE_Redis_connection_create( conn_mgr->_config->_rbuf_len );
+  if(( new_conn == NULL ) || ( dbBE_Redis_connection_link( new_conn, dbBE_Redis_connection_get_url( conn ), authfile ) == NULL ))
+  {
+    LOG( DBG_ERR, stderr, "connection_mgr_link_extra: failed to connect to %s\n", dbBE_Redis_connection_get_url( conn ) );
+    dbBE_Redis_connection_destroy( new_conn );
+    free( authfile );
+    errno = ENOTCONN;
+    return NULL;
+  }
+  free( authfile );
+  dbBE_Redis_connection_set_buffer_limits( new_conn, conn_mgr->_config->_scrap_max, conn_mgr->_config->_hugepages );
+
+  new_conn->_index = index;
+  int rc = dbBE_Redis_event_mgr_add( conn_mgr->_ev_mgr, new_conn );
+  if( rc != 0 )
+  {
+    LOG( DBG_ERR, stderr, "connection_mgr_link_extra: failed to add conn=%p to event_mgr. rc=%d\n", new_conn, rc );
+    dbBE_Redis_connection_unlink( new_conn );
+    dbBE_Redis_connection_destroy( new_conn );
+    errno = -rc;
+    return NULL;
+  }
+  return new_conn;
+}
+
+dbBE_Redis_connection_t* dbBE_Redis_connection_mgr_get_dedicated( dbBE_Redis_connection_mgr_t *conn_mgr,
+                                                                  dbBE_Redis_connection_t *conn )
+{
+  if(( conn_mgr == NULL ) || ( conn == NULL ) || ( conn->_address == NULL ))
+  {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  // reuse an idle connection to the same instance
+  unsigned n;
+  unsigned free_slot = DBBE_REDIS_MAX_DEDICATED_CONNECTIONS;
+  for( n = 0; n < DBBE_REDIS_MAX_DEDICATED_CONNECTIONS; ++n )
+  {
+    dbBE_Redis_connection_t *d = conn_mgr->_dedicated[ n ];
+    if( d == NULL )
+    {
+      if( free_slot == DBBE_REDIS_MAX_DEDICATED_CONNECTIONS )
+        free_slot = n;
+      continue;
+    }
+    if(( dbBE_Redis_s2r_queue_len( d->_posted_q ) == 0 ) &&
+        ( dbBE_Redis_connection_RTR( d ) ) &&
+        ( dbBE_Network_address_compare( d->_address, conn->_address ) == 0 ))
+      return d;
+  }
+
+  if( free_slot == DBBE_REDIS_MAX_DEDICATED_CONNECTIONS )
+  {
+    LOG( DBG_VERBOSE, stderr, "connection_mgr_get_dedicated: all %d dedicated connections in use\n", conn_mgr->_dedicated_count );
+    errno = EBUSY;
+    return NULL;
+  }
+
+  dbBE_Redis_connection_t *new_conn = dbBE_Redis_connection_mgr_link_extra( conn_mgr, conn, DBBE_REDIS_MAX_CONNECTIONS + free_slot );
+  if( new_conn == NULL )
+    return NULL;
+  conn_mgr->_dedicated[ free_slot ] = new_conn;
+  ++conn_mgr->_dedicated_count;
+  return new_conn;
+}
+
+int dbBE_Redis_connection_mgr_drop_dedicated( dbBE_Redis_connection_mgr_t *conn_mgr,
+                                              dbBE_Redis_connection_t *conn )
+{
+  if(( conn_mgr == NULL ) || ( ! dbBE_Redis_connection_mgr_is_dedicated( conn ) ))
+    return -EINVAL;
+
+  int rc = dbBE_Redis_connection_mgr_rm( conn_mgr, conn );
+  if( rc != 0 )
+    return rc;
+
+  dbBE_Redis_connection_destroy( conn );
+  return 0;
+}
+
+dbBE_Redis_connection_t* dbBE_Redis_connection_mgr_get_pooled( dbBE_Redis_connection_mgr_t *conn_mgr,
+                                                               dbBE_Redis_connection_t *conn,
+                                                               const uint16_t slot )
+{
+  if(( conn_mgr == NULL ) || ( conn == NULL ))
+  {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  // only regular connections have a pool
+  int pool_size = conn_mgr->_config->_pool_size;
+  if(( pool_size <= 1 ) || ( (unsigned)conn->_index >= DBBE_REDIS_MAX_CONNECTIONS ) || ( conn->_address == NULL ))
+    return conn;
+
+  unsigned member = slot % pool_size;
+  if( member == 0 )
+    return conn;
+
+  int16_t *entry = &conn_mgr->_pool[ conn->_index ][ member - 1 ];
+  if( *entry > 0 )
+  {
+    unsigned p = *entry - 1;
+    dbBE_Redis_connection_t *pc = conn_mgr->_pooled[ p ];
+    if(( pc != NULL ) && ( conn_mgr->_pool_owner[ p ] == conn->_index ))
+    {
+      if( dbBE_Network_address_compare( pc->_address, conn->_address ) == 0 )
+        return dbBE_Redis_connection_RTS( pc ) ? pc : conn;
+
+      // the regular connection was recovered to a different instance; replace the stale member once it's idle
+      if(( dbBE_Redis_s2r_queue_len( pc->_posted_q ) != 0 ) || ( dbBE_Redis_connection_bulk_request( pc ) != NULL ))
+        return conn;
+      dbBE_Redis_connection_mgr_drop_pooled( conn_mgr, pc );
+    }
+    *entry = 0;
+  }
+
+  unsigned free_slot;
+  for( free_slot = 0;
+      ( free_slot < DBBE_REDIS_MAX_POOLED_CONNECTIONS ) && ( conn_mgr->_pooled[ free_slot ] != NULL );
+      ++free_slot ) {}
+  if( free_slot == DBBE_REDIS_MAX_POOLED_CONNECTIONS )
+  {
+    LOG( DBG_VERBOSE, stderr, "connection_mgr_get_pooled: all %d pooled connections in use\n", conn_mgr->_pooled_count );
+    return conn;
+  }
+
+  dbBE_Redis_connection_t *new_conn = dbBE_Redis_connection_mgr_link_extra( conn_mgr, conn, DBBE_REDIS_POOLED_INDEX_BASE + free_slot );
+  if( new_conn == NULL )
+    return conn;
+
+  conn_mgr->_pooled[ free_slot ] = new_conn;
+  conn_mgr->_pool_owner[ free_slot ] = conn->_index;
+  *entry = free_slot + 1;
+  ++conn_mgr->_pooled_count;
+  return new_conn;
+}
+
+int dbBE_Redis_connection_mgr_drop_pooled( dbBE_Redis_connection_mgr_t *conn_mgr,
+                                           dbBE_Redis_connection_t *conn )
+{
+  if(( conn_mgr == NULL ) || ( ! dbBE_Redis_connection_mgr_is_pooled( conn ) ))
+    return -EINVAL;
+
+  int rc = dbBE_Redis_connection_mgr_rm( conn_mgr, conn );
+  if( rc != 0 )
+    return rc;
+
+  dbBE_Redis_connection_destroy( conn );
+  return 0;
+}
+
 /*
  * Move a connection from regular to broken list
  */
@@ -234,6 +413,12 @@ int dbBE_Redis_connection_mgr_conn_fail( dbBE_Redis_connection_mgr_t *conn_mgr,
     return -EINVAL;
   }
 
+  // dedicated and pooled connections are not recovered; requests are re-sent on a new one
+  if( dbBE_Redis_connection_mgr_is_dedicated( conn ) )
+    return dbBE_Redis_connection_mgr_drop_dedicated( conn_mgr, conn );
+  if( dbBE_Redis_connection_mgr_is_pooled( conn ) )
+    return dbBE_Redis_connection_mgr_drop_pooled( conn_mgr, conn );
+
   if( conn_mgr->_connection_count <= 0 )
   {
     LOG( DBG_ERR, stderr, "connection_mgr_conn_fail: no active connections, can't fail more\n" );
@@ -778,6 +963,35 @@ int dbBE_Redis_connection_mgr_rm( dbBE_Redis_connection_mgr_t *conn_mgr,
     return -EINVAL;
   }
 
+  if( dbBE_Redis_connection_mgr_is_dedicated( conn ) )
+  {
+    int rc = dbBE_Redis_event_mgr_rm( conn_mgr->_ev_mgr, conn );
+    if( rc != 0 )
+    {
+      LOG( DBG_ERR, stderr, "connection_mgr_rm: failed to remove connection from event mgr.\n" );
+      return rc;
+    }
+    conn_mgr->_dedicated[ conn->_index - DBBE_REDIS_MAX_CONNECTIONS ] = NULL;
+    --conn_mgr->_dedicated_count;
+    conn->_index = DBBE_REDIS_LOCATOR_INDEX_INVAL;
+    return 0;
+  }
+
+  // the pool entry of the owner stays behind and gets detected as stale on the next lookup
+  if( dbBE_Redis_connection_mgr_is_pooled( conn ) )
+  {
+    int rc = dbBE_Redis_event_mgr_rm( conn_mgr->_ev_mgr, conn );
+    if( rc != 0 )
+    {
+      LOG( DBG_ERR, stderr, "connection_mgr_rm: failed to remove connection from event mgr.\n" );
+      return rc;
+    }
+    conn_mgr->_pooled[ conn->_index - DBBE_REDIS_POOLED_INDEX_BASE ] = NULL;
+    --conn_mgr->_pooled_count;
+    conn->_index = DBBE_REDIS_LOCATOR_INDEX_INVAL;
+    return 0;
+  }
+
   if( conn_mgr->_connection_count <= 0 )
   {
     LOG( DBG_ERR, stderr, "connection_mgr_rm: no connections tracked. Can't delete.\n" );
@@ -847,6 +1061,30 @@ dbBE_Redis_connection_t* dbBE_Redis_connection_mgr_get_active( dbBE_Redis_connec
     return NULL;
 }
 
+int dbBE_Redis_connection_mgr_requeue_active( dbBE_Redis_connection_mgr_t *conn_mgr,
+                                              dbBE_Redis_connection_t *conn )
+{
+  if(( conn_mgr == NULL ) || ( conn == NULL ))
+    return -EINVAL;
+  return dbBE_Redis_connection_queue_push( dbBE_Redis_connection_mgr_getqueue( conn_mgr->_ev_mgr ), conn );
+}
+
+dbBE_Redis_connection_t* dbBE_Redis_connection_mgr_get_writable( dbBE_Redis_connection_mgr_t *conn_mgr )
+{
+  if( conn_mgr != NULL )
+    return dbBE_Redis_event_mgr_next_writable( conn_mgr->_ev_mgr );
+  else
+    return NULL;
+}
+
+int dbBE_Redis_connection_mgr_want_write( dbBE_Redis_connection_mgr_t *conn_mgr,
+                                          dbBE_Redis_connection_t *conn )
+{
+  if( conn_mgr == NULL )
+    return -EINVAL;
+  return dbBE_Redis_event_mgr_want_write( conn_mgr->_ev_mgr, conn );
+}
+
 dbBE_Redis_request_t* dbBE_Redis_connection_mgr_request_each( dbBE_Redis_connection_mgr_t *conn_mgr,
                                                               dbBE_Redis_request_t *template_request )
 {
@@ -868,7 +1106,7 @@ dbBE_Redis_request_t* dbBE_Redis_connection_mgr_request_each( dbBE_Redis_connect
           ( dbBE_Network_address_compare_ip( &conn_mgr->_connections[ i ]->_address->_address, &conn_mgr->_local->_address ) != 0))
           continue;
 
-      dbBE_Redis_request_t *req = dbBE_Redis_request_allocate( template_request->_user );
+      dbBE_Redis_request_t *req = dbBE_Redis_request_allocate( template_request->_pools, template_request->_user );
       if( req == NULL )
         continue;
       req->_location._type = DBBE_REDIS_REQUEST_LOCATION_TYPE_SLOT;
@@ -928,7 +1166,9 @@ dbBE_Redis_result_t* dbBE_Redis_connection_mgr_retrieve_info( dbBE_Redis_connect
     if( result == NULL )
       goto error;
 
-    rc = dbBE_Redis_parse_sr_buffer( iobuf, result );
+    dbBE_Redis_parse_state_t parse_state;
+    dbBE_Redis_parse_state_init( &parse_state, result, DBBE_REDIS_PARSE_PARTIAL_NONE );
+    rc = dbBE_Redis_parse_sr_buffer_resume( &parse_state, iobuf );
 
     while( rc == -EAGAIN )
     {
@@ -938,14 +1178,16 @@ dbBE_Redis_result_t* dbBE_Redis_connection_mgr_retrieve_info( dbBE_Redis_connect
       {
         rc = -EAGAIN;
       }
-      dbBE_Redis_result_cleanup( result, 0 );
-      rc = dbBE_Redis_parse_sr_buffer( iobuf, result );
+      rc = dbBE_Redis_parse_sr_buffer_resume( &parse_state, iobuf );
     }
   }
   if( rc != 0 )
   {
     if( result != NULL )
+    {
+      dbBE_Redis_result_cleanup( result, 0 );
       free( result );
+    }
     result = NULL;
   }
   return result;
@@ -40,6 +40,9 @@ typedef struct
 {
   size_t _rbuf_len; ///< length of receive buffer for new connections
   size_t _sbuf_len; ///< length of send buffer for new connections
+  int _pool_size; ///< number of pipelined connections per Redis instance (including the regular one)
+  size_t _scrap_max; ///< max scrap space per connection (0: DBBE_REDIS_SCRAP_SPACE_LEN)
+  int _hugepages; ///< hint hugepages for large per-connection buffers
 } dbBE_Redis_conn_mgr_config_t;
 
 typedef struct
@@ -47,11 +50,17 @@ typedef struct
   // connection list
   dbBE_Redis_connection_t *_connections[ DBBE_REDIS_MAX_CONNECTIONS ];
   dbBE_Redis_connection_t *_broken[ DBBE_REDIS_MAX_CONNECTIONS ];
+  dbBE_Redis_connection_t *_dedicated[ DBBE_REDIS_MAX_DEDICATED_CONNECTIONS ]; // connections for server-side blocking requests
+  dbBE_Redis_connection_t *_pooled[ DBBE_REDIS_MAX_POOLED_CONNECTIONS ]; // additional pipelined connections of regular connections
+  int16_t _pool_owner[ DBBE_REDIS_MAX_POOLED_CONNECTIONS ]; // index of the regular connection a pooled connection belongs to
+  int16_t _pool[ DBBE_REDIS_MAX_CONNECTIONS ][ DBBE_REDIS_CONNECTION_POOL_MAX - 1 ]; // pooled entry + 1 of each pool member (0 = none)
   dbBE_Network_address_t *_local; // used to determine local vs. remote connections
   const dbBE_Redis_conn_mgr_config_t *_config;
   //  pthread_mutex_lock_t _lock;
 
   int _connection_count;
+  int _dedicated_count;
+  int _pooled_count;
 
   // active connections?
   // disabled/old/disconnected connections?
@@ -115,7 +124,30 @@ int dbBE_Redis_connection_mgr_get_connections( dbBE_Redis_connection_mgr_t *conn
 }
 
 /*
- * return the connection entry at a given index
+ * first index of the pooled connections (they follow the dedicated connections)
+ */
+#define DBBE_REDIS_POOLED_INDEX_BASE ( DBBE_REDIS_MAX_CONNECTIONS + DBBE_REDIS_MAX_DEDICATED_CONNECTIONS )
+
+/*
+ * true if the connection is a dedicated connection (index beyond the regular connections)
+ */
+#define dbBE_Redis_connection_mgr_is_dedicated( conn ) \
+  ( ( (conn) != NULL ) && \
+    ( (unsigned)(conn)->_index >= DBBE_REDIS_MAX_CONNECTIONS ) && \
+    ( (unsigned)(conn)->_index < DBBE_REDIS_POOLED_INDEX_BASE ) )
+
+/*
+ * true if the index refers to a pooled connection
+ */
+#define dbBE_Redis_connection_mgr_index_is_pooled( index ) \
+  ( ( (unsigned)(index) >= DBBE_REDIS_POOLED_INDEX_BASE ) && \
+    ( (unsigned)(index) < DBBE_REDIS_MAX_TRACKED_CONNECTIONS ) )
+
+#define dbBE_Redis_connection_mgr_is_pooled( conn ) \
+  ( ( (conn) != NULL ) && dbBE_Redis_connection_mgr_index_is_pooled( (conn)->_index ) )
+
+/*
+ * return the connection entry at a given index (including dedicated and pooled connections)
  */
 static inline
 dbBE_Redis_connection_t* dbBE_Redis_connection_mgr_get_connection_at( dbBE_Redis_connection_mgr_t *conn_mgr,
@@ -123,10 +155,62 @@ dbBE_Redis_connection_t* dbBE_Redis_connection_mgr_get_connection_at( dbBE_Redis
 {
   if(( conn_mgr != NULL ) && ( (unsigned)index == (unsigned)index % DBBE_REDIS_MAX_CONNECTIONS ))
     return conn_mgr->_connections[ index ];
+  if(( conn_mgr != NULL ) && ( (unsigned)index < DBBE_REDIS_POOLED_INDEX_BASE ))
+    return conn_mgr->_dedicated[ index - DBBE_REDIS_MAX_CONNECTIONS ];
+  if(( conn_mgr != NULL ) && ( (unsigned)index < DBBE_REDIS_MAX_TRACKED_CONNECTIONS ))
+    return conn_mgr->_pooled[ index - DBBE_REDIS_POOLED_INDEX_BASE ];
   errno = ENOENT;
   return NULL;
 }
 
+/*
+ * return the regular connection that owns the pooled connection index
+ * (also valid after the pooled connection was dropped until the entry gets reused)
+ * regular connection indices are returned unchanged
+ */
+static inline
+int dbBE_Redis_connection_mgr_get_pool_owner( dbBE_Redis_connection_mgr_t *conn_mgr,
+                                              int index )
+{
+  if(( conn_mgr != NULL ) && dbBE_Redis_connection_mgr_index_is_pooled( index ))
+    return conn_mgr->_pool_owner[ index - DBBE_REDIS_POOLED_INDEX_BASE ];
+  return index;
+}
+
+/*
+ * return an idle dedicated connection to the same Redis instance as conn
+ * a new connection is created if there's no idle one
+ * a dedicated connection is idle while its posted queue is empty
+ * returns NULL if the limit of dedicated connections is reached or the connect failed
+ */
+dbBE_Redis_connection_t* dbBE_Redis_connection_mgr_get_dedicated( dbBE_Redis_connection_mgr_t *conn_mgr,
+                                                                  dbBE_Redis_connection_t *conn );
+
+/*
+ * disconnect and destroy a dedicated connection
+ * any posted requests have to be taken care of by the caller
+ */
+int dbBE_Redis_connection_mgr_drop_dedicated( dbBE_Redis_connection_mgr_t *conn_mgr,
+                                              dbBE_Redis_connection_t *conn );
+
+/*
+ * return the connection of the pool of a regular connection conn that serves the hash slot
+ * the slots of an instance are spread across the pool by slot number, so all requests
+ * for a key use the same connection and stay ordered by its posted queue
+ * pooled connections are created on first use; returns conn itself if pooling is disabled,
+ * the slot maps to conn, or a pooled connection can't be created
+ */
+dbBE_Redis_connection_t* dbBE_Redis_connection_mgr_get_pooled( dbBE_Redis_connection_mgr_t *conn_mgr,
+                                                               dbBE_Redis_connection_t *conn,
+                                                               const uint16_t slot );
+
+/*
+ * disconnect and destroy a pooled connection
+ * any posted requests have to be taken care of by the caller
+ */
+int dbBE_Redis_connection_mgr_drop_pooled( dbBE_Redis_connection_mgr_t *conn_mgr,
+                                           dbBE_Redis_connection_t *conn );
+
 /*
  * return the connection entry to a given destination address
  */
@@ -139,6 +223,24 @@ dbBE_Redis_connection_t* dbBE_Redis_connection_mgr_get_connection_to( dbBE_Redis
  */
 dbBE_Redis_connection_t* dbBE_Redis_connection_mgr_get_active( dbBE_Redis_connection_mgr_t *conn_mgr, const int blocking );
 
+/*
+ * put an active connection back to the end of the queue of active connections
+ * (e.g. because it has more data than was received in one turn)
+ */
+int dbBE_Redis_connection_mgr_requeue_active( dbBE_Redis_connection_mgr_t *conn_mgr,
+                                              dbBE_Redis_connection_t *conn );
+
+/*
+ * return a connection with pending send data whose socket became writable
+ */
+dbBE_Redis_connection_t* dbBE_Redis_connection_mgr_get_writable( dbBE_Redis_connection_mgr_t *conn_mgr );
+
+/*
+ * arm the writable notification for a connection with pending send data
+ */
+int dbBE_Redis_connection_mgr_want_write( dbBE_Redis_connection_mgr_t *conn_mgr,
+                                          dbBE_Redis_connection_t *conn );
+
 
 /*
  * return a list of empty requests, one for each (connected/authorized) connection
@@ -38,6 +38,11 @@
 #include "connection.h"
 #include "common/resolve_addr.h"
 
+// a send to a closed connection must return an error instead of raising SIGPIPE
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL ( 0 )
+#endif
+
 /*
  * create a Redis connection object, initialize with default/uninitialized values
  * does not allocate the sr_buffers
@@ -55,6 +60,7 @@ dbBE_Redis_connection_t *dbBE_Redis_connection_create( const uint64_t sr_buffer_
 
   dbBE_Redis_slot_bitmap_t *slots = NULL;
   dbBE_Redis_s2r_queue_t *queue = NULL;
+  dbBE_Redis_s2r_queue_t *held = NULL;
   dbBE_Transport_dbuffer_t *recvb = NULL;
   dbBE_Transport_sge_buffer_t *cmd = NULL;
 
@@ -91,6 +97,14 @@ dbBE_Redis_connection_t *dbBE_Redis_connection_create( const uint64_t sr_buffer_
   }
   conn->_posted_q = queue;
 
+  held = dbBE_Redis_s2r_queue_create( DBBE_REDIS_WORK_QUEUE_DEPTH );
+  if( held == NULL )
+  {
+    rc = ENOMEM;
+    goto error;
+  }
+  conn->_held_q = held;
+
   slots = dbBE_Redis_slot_bitmap_create();
   if( slots == NULL )
   {
@@ -106,11 +120,16 @@ dbBE_Redis_connection_t *dbBE_Redis_connection_create( const uint64_t sr_buffer_
     goto error;
   }
   conn->_cmd = cmd;
+  conn->_scrap_max = DBBE_REDIS_SCRAP_SPACE_LEN;
   return conn;
 
 error:
   if( recvb != NULL )
     dbBE_Transport_dbuffer_free( recvb );
+  if( queue != NULL )
+    dbBE_Redis_s2r_queue_destroy( queue );
+  if( held != NULL )
+    dbBE_Redis_s2r_queue_destroy( held );
   if( slots != NULL )
     dbBE_Redis_slot_bitmap_destroy( slots );
   if( cmd != NULL )
@@ -333,9 +352,10 @@ int dbBE_Redis_connection_reconnect( dbBE_Redis_connection_t *conn )
 }
 
 static
-ssize_t dbBE_Redis_connection_recv_base( dbBE_Redis_connection_t *conn, dbBE_Redis_sr_buffer_t *buf )
+ssize_t dbBE_Redis_connection_recv_base( dbBE_Redis_connection_t *conn, dbBE_Redis_sr_buffer_t *buf, const int flags )
 {
   ssize_t rc = 0;
+  ssize_t rsize = 0;
   int stored_errno=0;
   do
   {
@@ -347,11 +367,11 @@ ssize_t dbBE_Redis_connection_recv_base( dbBE_Redis_connection_t *conn, dbBE_Red
     errno = 0;
 
     // receive 7/8th at max
-    ssize_t rsize = dbBE_Transport_sr_buffer_remaining( buf ) - (dbBE_Transport_sr_buffer_remaining( buf ) >> 4);
+    rsize = dbBE_Transport_sr_buffer_remaining( buf ) - (dbBE_Transport_sr_buffer_remaining( buf ) >> 4);
     rc = recv( conn->_socket,
                dbBE_Transport_sr_buffer_get_available_position( buf ),
                rsize,
-               0 );
+               flags );
     stored_errno=errno;
 
     LOG( DBG_TRACE, stderr, "recv( %d, %p, %ld, 0) = %ld\n", conn->_socket, dbBE_Transport_sr_buffer_get_available_position( buf ), rsize, rc );
@@ -373,9 +393,9 @@ ssize_t dbBE_Redis_connection_recv_base( dbBE_Redis_connection_t *conn, dbBE_Red
 
   if( rc >= 0 )
   {
-    // disarm connection status if the received data was less than the max capacity
-    // we've received all currently available data
-    if( (size_t)rc <= dbBE_Transport_sr_buffer_get_size( buf ) )
+    // disarm connection status if the received data was less than requested
+    // we've received all currently available data; otherwise more might be waiting
+    if( rc < rsize )
     {
       conn->_status = DBBE_CONNECTION_STATUS_AUTHORIZED;
     }
@@ -389,7 +409,7 @@ ssize_t dbBE_Redis_connection_recv_base( dbBE_Redis_connection_t *conn, dbBE_Red
 ssize_t dbBE_Redis_connection_recv_direct( dbBE_Redis_connection_t *conn,
                                            dbBE_Redis_sr_buffer_t *buf )
 {
-  return dbBE_Redis_connection_recv_base( conn, buf );
+  return dbBE_Redis_connection_recv_base( conn, buf, 0 );
 }
 
 /*
@@ -412,8 +432,14 @@ ssize_t dbBE_Redis_connection_recv( dbBE_Redis_connection_t *conn,
     return 0;
   }
 
+  // don't wait: the connection might only be suspected to have more data after a full buffer
   dbBE_Transport_sr_buffer_reset( buf );
-  ssize_t rc = dbBE_Redis_connection_recv_base( conn, buf );
+  ssize_t rc = dbBE_Redis_connection_recv_base( conn, buf, MSG_DONTWAIT );
+  if(( rc == -EAGAIN ) || ( rc == -EWOULDBLOCK ))
+  {
+    conn->_status = DBBE_CONNECTION_STATUS_AUTHORIZED;
+    return 0;
+  }
 
   LOG( DBG_TRACE, stdout, "RECV: conn=%d:%s", conn->_socket, dbBE_Transport_sr_buffer_get_start( buf ) );
 
@@ -437,7 +463,7 @@ ssize_t dbBE_Redis_connection_recv_more( dbBE_Redis_connection_t *conn,
   if( ! dbBE_Redis_connection_RTR( conn ) )
     return -ENOTCONN;
 
-  ssize_t rc = dbBE_Redis_connection_recv_base( conn, buf );
+  ssize_t rc = dbBE_Redis_connection_recv_base( conn, buf, 0 );
 
   LOG( DBG_VERBOSE, stdout, "recv_more: conn=%d; new=%zd; avail/rem=%zd/%zd\n",
        conn->_socket, rc, dbBE_Transport_sr_buffer_available( buf ), dbBE_Transport_sr_buffer_remaining( buf ) );
@@ -463,7 +489,130 @@ ssize_t dbBE_Redis_connection_recv_sge( dbBE_Redis_connection_t *conn,
   msg.msg_iov = sb->_cmd;
   msg.msg_iovlen = sb->_index;
 
-  return recvmsg( conn->_socket, &msg, 0 );
+  // never wait for the rest of a value: the receiver continues once the socket is readable again
+  ssize_t rc = recvmsg( conn->_socket, &msg, MSG_DONTWAIT );
+  if( rc < 0 )
+  {
+    rc = -errno;
+    if(( rc == -EAGAIN ) || ( rc == -EWOULDBLOCK ))
+    {
+      conn->_status = DBBE_CONNECTION_STATUS_AUTHORIZED;
+      return -EAGAIN;
+    }
+    return rc;
+  }
+  if(( rc == 0 ) && ( dbBE_SGE_get_len( sb->_cmd, sb->_index ) > 0 ))
+    return -ECONNRESET; // peer closed the connection
+  return rc;
+}
+
+int dbBE_Redis_connection_bulk_park( dbBE_Redis_connection_t *conn,
+                                     dbBE_Redis_request_t *request,
+                                     dbBE_sge_t *sge,
+                                     const int sge_count,
+                                     const int64_t total,
+                                     const int64_t done )
+{
+  if(( conn == NULL ) || ( request == NULL ) || ( sge == NULL ) || ( sge_count <= 0 ) || ( sge_count > DBBE_SGE_MAX ))
+    return -EINVAL;
+  if( conn->_bulk_request != NULL )
+    return -EBUSY;
+
+  if( conn->_bulk_sge == NULL )
+  {
+    conn->_bulk_sge = (dbBE_sge_t*)malloc( DBBE_SGE_MAX * sizeof( dbBE_sge_t ) );
+    if( conn->_bulk_sge == NULL )
+      return -ENOMEM;
+  }
+
+  memcpy( conn->_bulk_sge, sge, sge_count * sizeof( dbBE_sge_t ) );
+  conn->_bulk_sge_cnt = sge_count;
+  conn->_bulk_responses = 0;
+  conn->_bulk_total = total;
+  conn->_bulk_done = done;
+  conn->_bulk_request = request;
+  LOG( DBG_TRACE, stderr, "conn=%d: value incomplete %"PRId64"/%"PRId64"; continuing when readable\n", conn->_index, done, total );
+  return 0;
+}
+
+int64_t dbBE_Redis_connection_bulk_resume( dbBE_Redis_connection_t *conn )
+{
+  if(( conn == NULL ) || ( conn->_bulk_request == NULL ))
+    return -EINVAL;
+
+  // the scatter picks up after what arrived already
+  dbBE_sge_t done;
+  done.iov_base = NULL;
+  done.iov_len = conn->_bulk_done;
+  int64_t rc = conn->_sr_dev->scatter( (dbBE_Data_transport_endpoint_t*)conn,
+                                       dbBE_Redis_connection_recv_sge_w,
+                                       &done,
+                                       conn->_bulk_total,
+                                       conn->_bulk_sge_cnt,
+                                       conn->_bulk_sge );
+  if( rc >= 0 )
+  {
+    conn->_bulk_done += rc;
+    if( conn->_bulk_done < conn->_bulk_total )
+    {
+      // keep what's left of the destination space for the next round
+      dbBE_Transport_sge_buffer_t *left = &conn->_sr_dev->_rSGE;
+      memcpy( conn->_bulk_sge, left->_cmd, left->_index * sizeof( dbBE_sge_t ) );
+      conn->_bulk_sge_cnt = left->_index;
+      dbBE_Transport_sge_buffer_reset( left );
+      return -EINPROGRESS;
+    }
+    rc = conn->_bulk_done;
+  }
+  dbBE_Transport_sge_buffer_reset( &conn->_sr_dev->_rSGE );
+  conn->_bulk_request = NULL;
+  return rc;
+}
+
+dbBE_Redis_request_t* dbBE_Redis_connection_bulk_abort( dbBE_Redis_connection_t *conn )
+{
+  if( conn == NULL )
+    return NULL;
+  dbBE_Redis_request_t *request = conn->_bulk_request;
+  conn->_bulk_request = NULL;
+  return request;
+}
+
+int dbBE_Redis_connection_response_pending( dbBE_Redis_connection_t *conn )
+{
+  if( conn == NULL )
+    return 0;
+  if( conn->_status == DBBE_CONNECTION_STATUS_PENDING_DATA )
+    return 1;
+  if(( conn->_recvbuf != NULL ) &&
+      ( ! dbBE_Transport_sr_buffer_empty( dbBE_Transport_dbuffer_get_active( conn->_recvbuf ) ) ))
+    return 1;
+  char c;
+  return ( recv( conn->_socket, &c, 1, MSG_PEEK | MSG_DONTWAIT ) > 0 );
+}
+
+char* dbBE_Redis_connection_get_scrap( dbBE_Redis_connection_t *conn,
+                                       const size_t size )
+{
+  if(( conn == NULL ) || ( size > conn->_scrap_max ))
+    return NULL;
+
+  if( size > conn->_scrap_len )
+  {
+    size_t space = ( conn->_scrap_len > 0 ) ? conn->_scrap_len : DBBE_REDIS_SCRAP_SPACE_MIN;
+    while( space < size )
+      space <<= 1;
+    if( space > conn->_scrap_max )
+      space = conn->_scrap_max;
+
+    // old content is irrelevant, no need to realloc
+    free( conn->_scrap );
+    conn->_scrap = (char*)malloc( space );
+    conn->_scrap_len = ( conn->_scrap != NULL ) ? space : 0;
+    if(( conn->_scrap != NULL ) && conn->_hugepages )
+      dbBE_Transport_memory_advise_hugepages( conn->_scrap, space );
+  }
+  return conn->_scrap;
 }
 
 int dbBE_Redis_connection_send( dbBE_Redis_connection_t *conn,
@@ -485,16 +634,28 @@ int dbBE_Redis_connection_send( dbBE_Redis_connection_t *conn,
     LOG( DBG_ALL, stderr, "SEND: conn=%d:%s", conn->_socket, dbBE_Transport_sr_buffer_get_start( buf ) );
 
 #endif
-  ssize_t rc = send( conn->_socket,
-                     dbBE_Transport_sr_buffer_get_start( buf ),
-                     dbBE_Transport_sr_buffer_available( buf ),
-                     MSG_WAITALL );
-  if( rc == (ssize_t)dbBE_Transport_sr_buffer_available( buf ))
-    dbBE_Transport_sr_buffer_reset( buf );
-  else
-    return -EBADMSG;
-  return rc;
+  // synchronous requests must not overtake pipelined commands that are still pending
+  if( dbBE_Redis_connection_send_pending( conn ) != 0 )
+    return -EBUSY;
 
+  size_t total = dbBE_Transport_sr_buffer_available( buf );
+  size_t sent = 0;
+  while( sent < total )
+  {
+    ssize_t rc = send( conn->_socket,
+                       dbBE_Transport_sr_buffer_get_start( buf ) + sent,
+                       total - sent,
+                       0 );
+    if( rc < 0 )
+    {
+      if( errno == EINTR )
+        continue;
+      return -errno;
+    }
+    sent += rc;
+  }
+  dbBE_Transport_sr_buffer_reset( buf );
+  return sent;
 }
 
 #ifdef DEBUG_REDIS_PROTOCOL
@@ -522,10 +683,195 @@ ssize_t dbBE_Redis_connection_flatten_cmd( dbBE_sge_t *cmd, int cmdlen, dbBE_Red
 #endif // DEBUG_REDIS_PROTOCOL
 
 
+/*
+ * point the copied pending segments back into the (moved or compacted) copy space
+ */
+static
+void dbBE_Redis_connection_pending_rebase( dbBE_Redis_connection_t *conn )
+{
+  int n;
+  for( n = conn->_pending_first; n < conn->_pending_cnt; ++n )
+    if( conn->_pending_copy[ n ] != DBBE_REDIS_PENDING_REF )
+      conn->_pending[ n ].iov_base = conn->_pending_data + conn->_pending_copy[ n ];
+}
+
+/*
+ * make room for count more pending segments and len more bytes of copied data
+ * the sent segments and copies are dropped first
+ */
+static
+int dbBE_Redis_connection_pending_reserve( dbBE_Redis_connection_t *conn, const int count, const size_t len )
+{
+  int remain = conn->_pending_cnt - conn->_pending_first;
+  if( conn->_pending_first > 0 )
+  {
+    memmove( conn->_pending, &conn->_pending[ conn->_pending_first ], remain * sizeof( dbBE_sge_t ) );
+    memmove( conn->_pending_copy, &conn->_pending_copy[ conn->_pending_first ], remain * sizeof( size_t ) );
+    conn->_pending_cnt = remain;
+    conn->_pending_first = 0;
+  }
+
+  if( remain + count > conn->_pending_max )
+  {
+    int max = ( conn->_pending_max > 0 ) ? conn->_pending_max : DBBE_REDIS_PENDING_SGE_MIN;
+    while( max < remain + count )
+      max <<= 1;
+    dbBE_sge_t *pending = (dbBE_sge_t*)realloc( conn->_pending, max * sizeof( dbBE_sge_t ) );
+    if( pending == NULL )
+      return -ENOMEM;
+    conn->_pending = pending;
+    size_t *copy = (size_t*)realloc( conn->_pending_copy, max * sizeof( size_t ) );
+    if( copy == NULL )
+      return -ENOMEM;
+    conn->_pending_copy = copy;
+    conn->_pending_max = max;
+  }
+
+  if( len == 0 )
+    return 0;
+
+  // copies are made in order: everything before the first unsent copy is gone
+  int n;
+  for( n = 0; ( n < remain ) && ( conn->_pending_copy[ n ] == DBBE_REDIS_PENDING_REF ); ++n ) {}
+  size_t sent = ( n < remain ) ? conn->_pending_copy[ n ] : conn->_pending_data_len;
+  if( sent > 0 )
+  {
+    memmove( conn->_pending_data, conn->_pending_data + sent, conn->_pending_data_len - sent );
+    conn->_pending_data_len -= sent;
+    for( ; n < remain; ++n )
+      if( conn->_pending_copy[ n ] != DBBE_REDIS_PENDING_REF )
+        conn->_pending_copy[ n ] -= sent;
+  }
+
+  if( conn->_pending_data_len + len > conn->_pending_space )
+  {
+    size_t space = ( conn->_pending_space > 0 ) ? conn->_pending_space : DBBE_REDIS_PENDING_SPACE_MIN;
+    while( space < conn->_pending_data_len + len )
+      space <<= 1;
+    char *data = (char*)realloc( conn->_pending_data, space );
+    if( data == NULL )
+    {
+      dbBE_Redis_connection_pending_rebase( conn );
+      return -ENOMEM;
+    }
+    conn->_pending_data = data;
+    conn->_pending_space = space;
+    if( conn->_hugepages )
+      dbBE_Transport_memory_advise_hugepages( conn->_pending_data, space );
+  }
+  dbBE_Redis_connection_pending_rebase( conn );
+  return 0;
+}
+
+/*
+ * the segment points into the buffer that gets reused after the send
+ */
+static inline
+int dbBE_Redis_connection_is_transient( dbBE_Redis_sr_buffer_t *transient, dbBE_sge_t *sge )
+{
+  if( transient == NULL )
+    return 1;
+  char *start = dbBE_Transport_sr_buffer_get_start( transient );
+  char *base = (char*)sge->iov_base;
+  return (( base >= start ) && ( base < start + dbBE_Transport_sr_buffer_get_size( transient ) ));
+}
+
+/*
+ * append an SGE list to the pending segments of the connection
+ * only segments in the transient buffer are copied, all others are referenced
+ */
+static
+int dbBE_Redis_connection_park( dbBE_Redis_connection_t *conn,
+                                dbBE_sge_t *cmd,
+                                const int count,
+                                dbBE_Redis_sr_buffer_t *transient )
+{
+  size_t copy_len = 0;
+  int n;
+  for( n = 0; n < count; ++n )
+    if( dbBE_Redis_connection_is_transient( transient, &cmd[ n ] ) )
+      copy_len += cmd[ n ].iov_len;
+
+  int rc = dbBE_Redis_connection_pending_reserve( conn, count, copy_len );
+  if( rc != 0 )
+    return rc;
+
+  for( n = 0; n < count; ++n )
+  {
+    dbBE_sge_t *sge = &conn->_pending[ conn->_pending_cnt ];
+    *sge = cmd[ n ];
+    conn->_pending_copy[ conn->_pending_cnt ] = DBBE_REDIS_PENDING_REF;
+    if( dbBE_Redis_connection_is_transient( transient, &cmd[ n ] ) )
+    {
+      sge->iov_base = conn->_pending_data + conn->_pending_data_len;
+      memcpy( sge->iov_base, cmd[ n ].iov_base, cmd[ n ].iov_len );
+      conn->_pending_copy[ conn->_pending_cnt ] = conn->_pending_data_len;
+      conn->_pending_data_len += cmd[ n ].iov_len;
+    }
+    conn->_pending_len += cmd[ n ].iov_len;
+    ++conn->_pending_cnt;
+  }
+  return 0;
+}
+
+ssize_t dbBE_Redis_connection_flush( dbBE_Redis_connection_t *conn )
+{
+  if( conn == NULL )
+    return -EINVAL;
+
+  while( conn->_pending_first < conn->_pending_cnt )
+  {
+    struct msghdr msg;
+    memset( &msg, 0, sizeof( struct msghdr ) );
+    msg.msg_iov = &conn->_pending[ conn->_pending_first ];
+    msg.msg_iovlen = conn->_pending_cnt - conn->_pending_first;
+    if( msg.msg_iovlen > DBBE_SGE_MAX )
+      msg.msg_iovlen = DBBE_SGE_MAX;
+
+    ssize_t rc = sendmsg( conn->_socket, &msg, MSG_DONTWAIT | MSG_NOSIGNAL );
+    if( rc < 0 )
+    {
+      if( errno == EINTR )
+        continue;
+      if(( errno == EAGAIN ) || ( errno == EWOULDBLOCK ))
+        break;
+      return -errno;
+    }
+    conn->_pending_len -= rc;
+
+    // skip the completely sent segments and advance into a partially sent one
+    while(( conn->_pending_first < conn->_pending_cnt ) && ( (size_t)rc >= conn->_pending[ conn->_pending_first ].iov_len ))
+    {
+      rc -= conn->_pending[ conn->_pending_first ].iov_len;
+      ++conn->_pending_first;
+    }
+    if( rc > 0 )
+    {
+      dbBE_sge_t *sge = &conn->_pending[ conn->_pending_first ];
+      sge->iov_base = (char*)sge->iov_base + rc;
+      sge->iov_len -= rc;
+      if( conn->_pending_copy[ conn->_pending_first ] != DBBE_REDIS_PENDING_REF )
+        conn->_pending_copy[ conn->_pending_first ] += rc;
+    }
+  }
+
+  if( conn->_pending_first == conn->_pending_cnt )
+  {
+    conn->_pending_first = 0;
+    conn->_pending_cnt = 0;
+    conn->_pending_data_len = 0;
+  }
+  LOG( DBG_TRACE, stderr, "flush: conn=%d; pending=%zd\n", conn->_index, dbBE_Redis_connection_send_pending( conn ) );
+  return dbBE_Redis_connection_send_pending( conn );
+}
+
 /*
  * flush the send buffer by sending it to the connected Redis instance
+ * the socket is never waited for; if it's congested, the remaining segments
+ * are parked: copied if they point into the (reused) transient buffer, referenced otherwise
  */
-ssize_t dbBE_Redis_connection_send_cmd( dbBE_Redis_connection_t *conn )
+ssize_t dbBE_Redis_connection_send_cmd( dbBE_Redis_connection_t *conn,
+                                        dbBE_Redis_sr_buffer_t *transient )
 {
   if(( conn == NULL ) || ( conn->_cmd->_index > DBBE_SGE_MAX ))
     return -EINVAL;
@@ -536,57 +882,73 @@ ssize_t dbBE_Redis_connection_send_cmd( dbBE_Redis_connection_t *conn )
 
   dbBE_Transport_sge_buffer_t *sge_buf = conn->_cmd;
   dbBE_sge_t *cmd = sge_buf->_cmd;
+  int cmdlen = sge_buf->_index;
 
-  struct msghdr msg;
-  memset( &msg, 0, sizeof( struct msghdr ) );
-  msg.msg_iov = cmd;
-  msg.msg_iovlen = sge_buf->_index;
-
-  ssize_t total = dbBE_SGE_get_len( cmd, sge_buf->_index );
+  ssize_t total = dbBE_SGE_get_len( cmd, cmdlen );
   ssize_t ssize = 0;
   ssize_t rc = 0;
-
-  do
-  {
-    rc = sendmsg( conn->_socket, &msg, 0 );
-
-    if( rc < 0 ) break;
-    if(( rc > 0 ) && ( rc + ssize < total ))
-    {
-      ssize_t offset = rc;
-      while(( sge_buf->_index > 0 ) && ( offset > 0 ))
-      {
-        if( (size_t)offset < cmd[0].iov_len )
-        {
-          LOG( DBG_TRACE, stderr, "SGE[0] reduce by %ld from %ld to %ld\n", offset, cmd[0].iov_len, cmd[0].iov_len - offset );
-          cmd[0].iov_base = (char*)cmd[0].iov_base + offset;
-          cmd[0].iov_len -= offset;
-          offset = 0;
-        }
-        else
-        {
-          LOG( DBG_TRACE, stderr, "SGE shift remaining data reduced by %ld from %ld to %ld; remaining entries: %d\n",
-               cmd[0].iov_len, offset, offset - cmd[0].iov_len, sge_buf->_index-1 );
-          offset -= cmd[0].iov_len;
-          memmove( cmd, &cmd[1], sizeof( cmd[0] ) * sge_buf->_index );
-          --sge_buf->_index;
-        }
-      }
-    }
-    ssize += rc;
-  } while (( rc >= 0 ) && ( ssize < total ));
+  int first = 0;
 
 #ifdef DEBUG_REDIS_PROTOCOL
   dbBE_Redis_sr_buffer_t *tmpbuffer = dbBE_Transport_sr_buffer_allocate( DBBE_REDIS_SR_BUFFER_LEN );
   ssize_t len = dbBE_Redis_connection_flatten_cmd( cmd, cmdlen, tmpbuffer );
   LOG( DBG_ALL, stdout, "SEND:%"PRId64"%s\n", len, dbBE_Transport_sr_buffer_get_start( tmpbuffer ) );
-  if( len != (ssize_t)dbBE_Transport_sr_buffer_available( tmpbuffer ) )
-    LOG( DBG_ERR, stderr, "SEND: Length error. accumulated %"PRId64" expected %"PRId64"\n", len, dbBE_Transport_sr_buffer_available( tmpbuffer ) );
-  if( len != datalen )
-    LOG( DBG_ERR, stderr, "SEND: Length error. accumulated %"PRId64" SGElen %"PRId64"\n", len, datalen );
+  if( len != total )
+    LOG( DBG_ERR, stderr, "SEND: Length error. accumulated %"PRId64" SGElen %"PRId64"\n", len, total );
   dbBE_Transport_sr_buffer_free( tmpbuffer );
 #endif
 
+  // earlier data is still pending: the new command has to queue up behind it
+  if( dbBE_Redis_connection_send_pending( conn ) != 0 )
+  {
+    rc = dbBE_Redis_connection_flush( conn );
+    if( rc < 0 )
+      goto send_done;
+    if( rc > 0 )
+      ssize = -1; // skip the direct send
+  }
+
+  while(( ssize >= 0 ) && ( ssize < total ))
+  {
+    struct msghdr msg;
+    memset( &msg, 0, sizeof( struct msghdr ) );
+    msg.msg_iov = &cmd[ first ];
+    msg.msg_iovlen = cmdlen - first;
+
+    rc = sendmsg( conn->_socket, &msg, MSG_DONTWAIT | MSG_NOSIGNAL );
+    if( rc < 0 )
+    {
+      if( errno == EINTR )
+        continue;
+      if(( errno == EAGAIN ) || ( errno == EWOULDBLOCK ))
+        break;
+      rc = -errno;
+      goto send_done;
+    }
+    ssize += rc;
+
+    // skip the completely sent entries and advance into a partially sent one
+    while(( first < cmdlen ) && ( (size_t)rc >= cmd[ first ].iov_len ))
+    {
+      rc -= cmd[ first ].iov_len;
+      ++first;
+    }
+    if( rc > 0 )
+    {
+      LOG( DBG_TRACE, stderr, "SGE[%d] reduce by %ld from %ld to %ld\n", first, rc, cmd[ first ].iov_len, cmd[ first ].iov_len - rc );
+      cmd[ first ].iov_base = (char*)cmd[ first ].iov_base + rc;
+      cmd[ first ].iov_len -= rc;
+    }
+  }
+
+  rc = total;
+  if(( first < cmdlen ) && ( dbBE_Redis_connection_park( conn, &cmd[ first ], cmdlen - first, transient ) != 0 ))
+  {
+    LOG( DBG_ERR, stderr, "send_cmd: failed to allocate pending data of conn=%d\n", conn->_index );
+    rc = -ENOMEM;
+  }
+
+send_done:
   dbBE_Transport_sge_buffer_reset( conn->_cmd );
 
   return rc;
@@ -604,6 +966,12 @@ int dbBE_Redis_connection_unlink( dbBE_Redis_connection_t *conn )
   close( conn->_socket );
   conn->_socket = -1;
   conn->_status = DBBE_CONNECTION_STATUS_DISCONNECTED;
+
+  // pending data belongs to requests that get retried after the failure
+  conn->_pending_first = 0;
+  conn->_pending_cnt = 0;
+  conn->_pending_len = 0;
+  conn->_pending_data_len = 0;
 //  don't touch the address, it can be reused during reconnect
 //  dbBE_Redis_address_destroy( conn->_address );
 //  conn->_address = NULL;
@@ -752,9 +1120,20 @@ void dbBE_Redis_connection_destroy( dbBE_Redis_connection_t *conn )
 
   dbBE_Redis_slot_bitmap_destroy( conn->_slots );
   dbBE_Redis_s2r_queue_destroy( conn->_posted_q );
+  dbBE_Redis_s2r_queue_destroy( conn->_held_q );
   dbBE_Transport_dbuffer_free( conn->_recvbuf );
   dbBE_Network_address_destroy( conn->_address );
   dbBE_Transport_sge_buffer_destroy( conn->_cmd );
+  if( conn->_pending != NULL )
+    free( conn->_pending );
+  if( conn->_pending_copy != NULL )
+    free( conn->_pending_copy );
+  if( conn->_pending_data != NULL )
+    free( conn->_pending_data );
+  if( conn->_scrap != NULL )
+    free( conn->_scrap );
+  if( conn->_bulk_sge != NULL )
+    free( conn->_bulk_sge );
 
   // wipe memory
   memset( conn, 0, sizeof( dbBE_Redis_connection_t ) );
@@ -61,6 +61,26 @@ typedef struct dbBE_Redis_connection
   volatile dbBE_Connection_status_t _status;
   struct timeval _last_alive;
   dbBE_Transport_sge_buffer_t *_cmd;
+  dbBE_Redis_s2r_queue_t *_held_q; // requests held back while too much data is pending
+  dbBE_sge_t *_pending; // unsent command segments left by partial non-blocking sends
+  size_t *_pending_copy; // offset of each segment's copy in _pending_data or DBBE_REDIS_PENDING_REF
+  int _pending_first; // first segment of _pending not completely sent
+  int _pending_cnt; // number of segments in _pending
+  int _pending_max; // allocated entries of _pending and _pending_copy
+  size_t _pending_len; // unsent bytes of all segments
+  char *_pending_data; // copies of pending segments that pointed into a reused buffer
+  size_t _pending_data_len; // used bytes of _pending_data
+  size_t _pending_space; // allocated size of _pending_data
+  char *_scrap; // space to receive and drop data that doesn't fit into the user buffers
+  size_t _scrap_len; // allocated size of _scrap
+  size_t _scrap_max; // limit for growing _scrap
+  int _hugepages; // hint hugepages for large _scrap and _pending allocations
+  dbBE_Redis_request_t *_bulk_request; // request whose value is still arriving in its destination (NULL if none)
+  dbBE_sge_t *_bulk_sge; // destination space of the value that's still missing data
+  int _bulk_sge_cnt; // used entries of _bulk_sge (allocated with DBBE_SGE_MAX entries)
+  int _bulk_responses; // responses of the request that follow the value
+  int64_t _bulk_total; // size of the value including the protocol terminator
+  int64_t _bulk_done; // bytes of the value that arrived so far
   char _url[ DBR_SERVER_URL_MAX_LENGTH ];
 } dbBE_Redis_connection_t;
 
@@ -110,6 +130,16 @@ dbBE_Redis_connection_t *dbBE_Redis_connection_create( const uint64_t sr_buffer_
   ( ( (conn) != NULL ) && ( ((conn)->_status == DBBE_CONNECTION_STATUS_CONNECTED ) || dbBE_Redis_connection_RTR_nocheck( conn ) ) )
 
 
+/*
+ * number of bytes of previously posted commands that still wait to be sent
+ */
+#define dbBE_Redis_connection_send_pending( conn ) ( (conn)->_pending_len )
+
+/*
+ * too much data is pending on the connection: hold back further requests
+ */
+#define dbBE_Redis_connection_congested( conn ) ( (conn)->_pending_len >= DBBE_REDIS_PENDING_LIMIT )
+
 /*
  * return the send-transport device assigned to this connection
  */
@@ -175,9 +205,67 @@ ssize_t dbBE_Redis_connection_recv_direct( dbBE_Redis_connection_t *conn,
                                            dbBE_Redis_sr_buffer_t *buf );
 
 
+/*
+ * receive straight into an SGE list (e.g. the user buffers of a large value)
+ * takes only what is already available, returns -EAGAIN if there's nothing to receive
+ * (the last SGE is expected to be the recv buffer for the data following the value)
+ */
 ssize_t dbBE_Redis_connection_recv_sge( dbBE_Redis_connection_t *conn,
                                         dbBE_Transport_sge_buffer_t *sb );
 
+/*
+ * park a value that didn't arrive completely: the connection keeps the request and
+ * the destination space that's still missing data until dbBE_Redis_connection_bulk_resume()
+ * completed the value; total includes the protocol terminator, done is the part that arrived already
+ */
+int dbBE_Redis_connection_bulk_park( dbBE_Redis_connection_t *conn,
+                                     dbBE_Redis_request_t *request,
+                                     dbBE_sge_t *sge,
+                                     const int sge_count,
+                                     const int64_t total,
+                                     const int64_t done );
+
+/*
+ * continue the receive of a parked value with whatever data is available
+ * returns the number of bytes that arrived for the value (including the terminator and any following data),
+ * -EINPROGRESS if the value is still incomplete, or a negative error
+ * the request is released from the connection unless -EINPROGRESS is returned
+ */
+int64_t dbBE_Redis_connection_bulk_resume( dbBE_Redis_connection_t *conn );
+
+/*
+ * release the parked request (if any) of a connection that failed
+ */
+dbBE_Redis_request_t* dbBE_Redis_connection_bulk_abort( dbBE_Redis_connection_t *conn );
+
+/*
+ * return the request of a value that's still arriving on the connection (NULL if there's none)
+ */
+#define dbBE_Redis_connection_bulk_request( conn ) ( ( (conn) != NULL ) ? (conn)->_bulk_request : NULL )
+
+/*
+ * return the scrap space of the connection with at least size bytes
+ * the space is grown on demand and kept until the connection is destroyed
+ * returns NULL if size exceeds the scrap limit of the connection or allocation fails
+ */
+char* dbBE_Redis_connection_get_scrap( dbBE_Redis_connection_t *conn,
+                                       const size_t size );
+
+/*
+ * set the limit for the scrap space (0: DBBE_REDIS_SCRAP_SPACE_LEN)
+ * and whether large allocations should be backed by hugepages
+ */
+static inline
+void dbBE_Redis_connection_set_buffer_limits( dbBE_Redis_connection_t *conn,
+                                              const size_t scrap_max,
+                                              const int hugepages )
+{
+  if( conn == NULL )
+    return;
+  conn->_scrap_max = ( scrap_max > 0 ) ? scrap_max : DBBE_REDIS_SCRAP_SPACE_LEN;
+  conn->_hugepages = hugepages;
+}
+
 // transport-compatible wrapper for recv_sge:
 static inline
 ssize_t dbBE_Redis_connection_recv_sge_w( dbBE_Data_transport_endpoint_t *conn,
@@ -186,6 +274,13 @@ ssize_t dbBE_Redis_connection_recv_sge_w( dbBE_Data_transport_endpoint_t *conn,
   return dbBE_Redis_connection_recv_sge( (dbBE_Redis_connection_t*)(conn), sb );
 }
 
+/*
+ * check whether response data of the connection is waiting to be processed:
+ * the connection is marked active, its recv buffer holds unprocessed data,
+ * or the socket has data available (checked without consuming it)
+ */
+int dbBE_Redis_connection_response_pending( dbBE_Redis_connection_t *conn );
+
 /*
  * flush the send buffer by sending it to the connected Redis instance
  */
@@ -193,9 +288,21 @@ int dbBE_Redis_connection_send( dbBE_Redis_connection_t *conn,
                                 dbBE_Redis_sr_buffer_t *buf );
 
 /*
- * send the cmd vector to the connected Redis instance
+ * send the cmd vector to the connected Redis instance without blocking
+ * data that the socket doesn't accept right away stays pending on the connection;
+ * it's sent ahead of any later command. Pending segments that point into
+ * the transient buffer (e.g. the reused sender buffer) are copied, all others
+ * (user data) are referenced. A NULL transient buffer copies all segments.
+ * returns the number of bytes sent or queued, or a negative error code
+ */
+ssize_t dbBE_Redis_connection_send_cmd( dbBE_Redis_connection_t *conn,
+                                        dbBE_Redis_sr_buffer_t *transient );
+
+/*
+ * continue sending the pending data of the connection without blocking
+ * returns the number of bytes that remain pending or a negative error code
  */
-ssize_t dbBE_Redis_connection_send_cmd( dbBE_Redis_connection_t *conn );
+ssize_t dbBE_Redis_connection_flush( dbBE_Redis_connection_t *conn );
 
 /*
  * disconnect from a Redis instance
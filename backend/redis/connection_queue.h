@@ -36,13 +36,15 @@ typedef struct dbBE_Redis_connection_queue
 {
   volatile uint64_t _head;
   volatile uint64_t _tail;
-  volatile dbBE_Redis_connection_t *_connections[ DBBE_REDIS_MAX_CONNECTIONS ];
+  volatile dbBE_Redis_connection_t *_connections[ DBBE_REDIS_MAX_TRACKED_CONNECTIONS ];
   pthread_mutex_t _mutex;
 } dbBE_Redis_connection_queue_t;
 
 
 #define dbBE_Redis_connection_queue_head( queue ) ( (queue)->_head )
 #define dbBE_Redis_connection_queue_tail( queue ) ( (queue)->_tail )
+#define dbBE_Redis_connection_queue_empty( queue ) \
+  ( dbBE_Redis_connection_queue_head( queue ) == dbBE_Redis_connection_queue_tail( queue ) )
 
 static inline
 dbBE_Redis_connection_queue_t* dbBE_Redis_connection_queue_create()
@@ -92,8 +94,8 @@ deleted_slot_retry:
     return NULL;
   }
 
-  dbBE_Redis_connection_t *conn = (dbBE_Redis_connection_t*)queue->_connections[ tail % DBBE_REDIS_MAX_CONNECTIONS ];
-  queue->_connections[ tail % DBBE_REDIS_MAX_CONNECTIONS ] = NULL;
+  dbBE_Redis_connection_t *conn = (dbBE_Redis_connection_t*)queue->_connections[ tail % DBBE_REDIS_MAX_TRACKED_CONNECTIONS ];
+  queue->_connections[ tail % DBBE_REDIS_MAX_TRACKED_CONNECTIONS ] = NULL;
 
   ++dbBE_Redis_connection_queue_tail( queue );
 
@@ -124,13 +126,22 @@ int dbBE_Redis_connection_queue_push( dbBE_Redis_connection_queue_t *queue,
   uint64_t head = dbBE_Redis_connection_queue_head( queue );
   uint64_t tail = dbBE_Redis_connection_queue_tail( queue );
 
-  if(( head - tail >= DBBE_REDIS_MAX_CONNECTIONS ) || ( queue->_connections[ head ] != NULL ))
+  // a connection that's already waiting in the queue keeps its place
+  uint64_t n;
+  for( n = tail; n < head; ++n )
+    if( queue->_connections[ n % DBBE_REDIS_MAX_TRACKED_CONNECTIONS ] == conn )
+    {
+      pthread_mutex_unlock( &queue->_mutex );
+      return 0;
+    }
+
+  if(( head - tail >= DBBE_REDIS_MAX_TRACKED_CONNECTIONS ) || ( queue->_connections[ head % DBBE_REDIS_MAX_TRACKED_CONNECTIONS ] != NULL ))
   {
     pthread_mutex_unlock( &queue->_mutex );
     return -ENOMEM;
   }
 
-  queue->_connections[ head ] = conn;
+  queue->_connections[ head % DBBE_REDIS_MAX_TRACKED_CONNECTIONS ] = conn;
   ++dbBE_Redis_connection_queue_head( queue );
 
   pthread_mutex_unlock( &queue->_mutex );
@@ -158,8 +169,8 @@ int dbBE_Redis_connection_queue_remove_connection( dbBE_Redis_connection_queue_t
   }
 
   for( n=tail; n<head; ++n )
-    if( queue->_connections[ n % DBBE_REDIS_MAX_CONNECTIONS ] == conn )
-      queue->_connections[ n % DBBE_REDIS_MAX_CONNECTIONS ] = NULL;
+    if( queue->_connections[ n % DBBE_REDIS_MAX_TRACKED_CONNECTIONS ] == conn )
+      queue->_connections[ n % DBBE_REDIS_MAX_TRACKED_CONNECTIONS ] = NULL;
 
   pthread_mutex_unlock( &queue->_mutex );
 
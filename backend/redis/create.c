@@ -162,6 +162,7 @@ int dbBE_Redis_create_key( dbBE_Redis_request_t *request, char *keybuf, uint16_t
     case DBBE_OPCODE_GET:
     case DBBE_OPCODE_READ:
     case DBBE_OPCODE_REMOVE:
+    case DBBE_OPCODE_TESTKEY:
     {
       len = snprintf( keybuf, size, "%s%s%s",
                           dbBE_Redis_namespace_get_name( ns ),
@@ -259,26 +260,22 @@ int dbBE_Redis_create_scan_key( dbBE_Redis_request_t *request,
                                 dbBE_sge_t *keysge )
 {
   char *key = dbBE_Transport_sr_buffer_get_available_position( buf );
-  char *namespace = dbBE_Redis_namespace_get_name( (dbBE_Redis_namespace_t*)(request->_user->_ns_hdl) );
+  dbBE_Redis_namespace_t *ns = (dbBE_Redis_namespace_t*)(request->_user->_ns_hdl);
 
   char *match_all = "*";
   char *match = user_match;
   if(( user_match == NULL ) || ( user_match[0] == '\0'))
     match = match_all;
-  size_t keylen = strnlen( namespace,
-                        DBBE_REDIS_MAX_KEY_LEN ) + DBBE_REDIS_NAMESPACE_SEPARATOR_LEN + strnlen( match, DBBE_REDIS_MAX_KEY_LEN );
-  if( keylen > dbBE_Transport_sr_buffer_remaining( buf ) )
-    return -ENOMEM;
 
-  int len = snprintf( key,
-                      DBBE_REDIS_MAX_KEY_LEN,
-                      "$%ld\r\n%s%s%s\r\n",
-                      keylen,
-                      namespace,
-                      DBBE_REDIS_NAMESPACE_SEPARATOR,
-                      match );
+  size_t space = dbBE_Transport_sr_buffer_remaining( buf );
+  int len = dbBE_Redis_command_insert_key( key,
+                                           space >= DBBE_REDIS_MAX_KEY_LEN ? DBBE_REDIS_MAX_KEY_LEN : space,
+                                           dbBE_Redis_namespace_get_name( ns ),
+                                           dbBE_Redis_namespace_get_len( ns ),
+                                           match,
+                                           strnlen( match, DBBE_REDIS_MAX_KEY_LEN ) );
   if( len < 0 )
-    return -EPROTO;
+    return -ENOMEM;
   dbBE_Transport_sr_buffer_add_data( buf, len, 1 );
 
   keysge->iov_base = key;
@@ -286,6 +283,51 @@ int dbBE_Redis_create_scan_key( dbBE_Redis_request_t *request,
   return 0;
 }
 
+int dbBE_Redis_create_coalesce( dbBE_Data_transport_t *transport,
+                                dbBE_Redis_sr_buffer_t *buf,
+                                dbBE_sge_t *cmd,
+                                const int first,
+                                const int count )
+{
+  if(( transport == NULL ) || ( buf == NULL ) || ( cmd == NULL ) || ( first < 0 ) || ( count < 0 ))
+    return -EINVAL;
+
+  int out = first;
+  int in;
+  for( in = first; in < first + count; ++in )
+  {
+    dbBE_sge_t entry = cmd[ in ];
+    dbBE_sge_t *last = ( out > 0 ) ? &cmd[ out - 1 ] : NULL;
+    char *tail = dbBE_Transport_sr_buffer_get_available_position( buf );
+
+    if( entry.iov_len == 0 )
+      continue;
+
+    // already contiguous
+    if(( last != NULL ) && ( (char*)last->iov_base + last->iov_len == (char*)entry.iov_base ))
+    {
+      last->iov_len += entry.iov_len;
+      continue;
+    }
+
+    if(( entry.iov_len <= DBBE_REDIS_COALESCE_SGE_MAX ) &&
+        ( transport->gather( (dbBE_Data_transport_endpoint_t*)tail,
+                             dbBE_Transport_sr_buffer_remaining( buf ),
+                             1, &entry ) == (int64_t)entry.iov_len ))
+    {
+      dbBE_Transport_sr_buffer_add_data( buf, entry.iov_len, 1 );
+      if(( last != NULL ) && ( (char*)last->iov_base + last->iov_len == tail ))
+      {
+        last->iov_len += entry.iov_len;
+        continue;
+      }
+      entry.iov_base = tail;
+    }
+    cmd[ out++ ] = entry;
+  }
+  return out - first;
+}
+
 int dbBE_Redis_create_command_sge( dbBE_Redis_request_t *request,
                                    dbBE_Redis_sr_buffer_t *buf,
                                    dbBE_sge_t *cmd )
@@ -296,22 +338,30 @@ int dbBE_Redis_create_command_sge( dbBE_Redis_request_t *request,
 
   switch( request->_user->_opcode )
   {
-    case DBBE_OPCODE_PUT: // RPUSH ns_name%sep;t_name value
-      if( stage->_stage != 0 )
+    case DBBE_OPCODE_PUT: // RPUSH/LPUSH ns_name%sep;t_name value
+      if(( stage->_stage != DBBE_REDIS_PUT_STAGE_TAIL ) && ( stage->_stage != DBBE_REDIS_PUT_STAGE_HEAD ))
         return -EPROTO;
       rc = dbBE_Redis_command_rpush_create( request, buf, cmd );
       break;
 
-    case DBBE_OPCODE_GET: // LPOP ns_name%sep;t_name
-      if( stage->_stage != 0 )
+    case DBBE_OPCODE_GET: // LPOP/BLPOP ns_name%sep;t_name
+      if(( stage->_stage != DBBE_REDIS_RETRIEVE_STAGE_POLL ) && ( stage->_stage != DBBE_REDIS_RETRIEVE_STAGE_BLOCK ))
         return -EPROTO;
       rc = dbBE_Redis_command_lpop_create( request, buf, cmd );
       break;
 
     case DBBE_OPCODE_READ:
-      if( stage->_stage != 0 )
-        return -EPROTO;
-      rc = dbBE_Redis_command_lindex_create( request, buf, cmd );
+      switch( stage->_stage )
+      {
+        case DBBE_REDIS_RETRIEVE_STAGE_POLL:
+          rc = dbBE_Redis_command_lindex_create( request, buf, cmd );
+          break;
+        case DBBE_REDIS_RETRIEVE_STAGE_BLOCK: // BLMOVE only needs the key (like LPOP)
+          rc = dbBE_Redis_command_lpop_create( request, buf, cmd );
+          break;
+        default:
+          return -EPROTO;
+      }
       break;
 
     case DBBE_OPCODE_DIRECTORY:
@@ -449,6 +499,15 @@ int dbBE_Redis_create_command_sge( dbBE_Redis_request_t *request,
       break;
     }
 
+    case DBBE_OPCODE_TESTKEY: // EXISTS ns_name%sep;t_name
+    {
+      if( stage->_stage != 0 )
+        return -EINVAL;
+
+      rc = dbBE_Redis_command_exists_create( request, buf, cmd );
+      break;
+    }
+
     case DBBE_OPCODE_MOVE:
     {
       switch( stage->_stage )
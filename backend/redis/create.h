@@ -19,6 +19,7 @@
 #define BACKEND_REDIS_CREATE_H_
 
 #include "transports/sr_buffer.h"
+#include "../common/data_transport.h"
 #include "request.h"
 
 /*
@@ -31,4 +32,16 @@ int dbBE_Redis_create_command_sge( dbBE_Redis_request_t *request,
 
 int dbBE_Redis_create_key( dbBE_Redis_request_t *request, char *keybuf, uint16_t size );
 
+/*
+ * coalesce the count new entries at cmd[first] with each other and with cmd[first-1]
+ * entries of up to DBBE_REDIS_COALESCE_SGE_MAX bytes are gathered into the buffer
+ * unless they already continue the previous entry; larger ones stay in place
+ * returns the remaining number of new entries (the data is unchanged)
+ */
+int dbBE_Redis_create_coalesce( dbBE_Data_transport_t *transport,
+                                dbBE_Redis_sr_buffer_t *buf,
+                                dbBE_sge_t *cmd,
+                                const int first,
+                                const int count );
+
 #endif /* BACKEND_REDIS_CREATE_H_ */
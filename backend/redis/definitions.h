@@ -25,9 +25,54 @@
 
 /*
  * default send-recv buffer size for interaction with Redis
+ * (also the default cap for the growable sender buffer)
  */
 #define DBBE_REDIS_SR_BUFFER_LEN ( 128 * 1048576 )
 
+/*
+ * the sender buffer starts at the min size and doubles whenever a sender pass runs
+ * out of space (up to DBR_BUFFER_LIMIT); a command is only created with at least
+ * the headroom left, otherwise the pending commands are sent first to free the buffer
+ */
+#define DBBE_REDIS_SENDER_BUFFER_MIN ( 1048576 )
+#define DBBE_REDIS_SENDER_HEADROOM ( 4 * DBBE_REDIS_MAX_KEY_LEN + 1024 )
+
+/*
+ * initial size of a connection's space for congested send data
+ */
+#define DBBE_REDIS_PENDING_SPACE_MIN ( 65536 )
+#define DBBE_REDIS_PENDING_SGE_MIN ( 64 )
+
+/*
+ * amount of pending send data at which a connection stops taking new requests
+ */
+#define DBBE_REDIS_PENDING_LIMIT ( 64 * 1048576 )
+
+/*
+ * pending segment that references the caller's data instead of a copy
+ */
+#define DBBE_REDIS_PENDING_REF ( (size_t)-1 )
+
+/*
+ * per-connection space to drop value data that doesn't fit the user buffer
+ * allocated on demand starting with the min size; the max limits the droppable amount
+ */
+#define DBBE_REDIS_SCRAP_SPACE_MIN ( 1048576ull )
+#define DBBE_REDIS_SCRAP_SPACE_LEN ( 512ull * 1024ull * 1024ull )
+
+/*
+ * command SGEs up to this size are copied into the sender buffer to merge
+ * with neighbouring entries; larger ones are sent from their location (zero-copy)
+ */
+#define DBBE_REDIS_COALESCE_SGE_MAX ( 1024 )
+
+/*
+ * chunk size of the arena for parsed response arrays
+ * and the amount of chunks kept for the next receiver pass
+ */
+#define DBBE_REDIS_RESULT_ARENA_CHUNK ( 65536 )
+#define DBBE_REDIS_RESULT_ARENA_KEEP ( 1048576 )
+
 /*
  * default size of the work queue for unprocessed user requests
  */
@@ -44,11 +89,93 @@
 #define DBR_SERVER_DEFAULT_AUTHFILE ".redis.auth"
 
 #define DBR_SERVER_URL_MAX_LENGTH ( 1024 )
+
+/*
+ * number of pipelined connections to each Redis instance (1 = no pooling)
+ */
+#define DBR_SERVER_CONNECTIONS_ENV "DBR_SERVER_CONNECTIONS"
+#define DBR_SERVER_DEFAULT_CONNECTIONS "1"
+
+/*
+ * max number of connection receives in one receiver pass; ready connections are
+ * served round-robin, so each gets a turn before any connection gets a second one
+ */
+#define DBR_RECEIVE_BUDGET_ENV "DBR_RECEIVE_BUDGET"
+#define DBR_RECEIVE_BUDGET_DEFAULT "128"
+
+/*
+ * 1: GET/READ of a missing tuple wait on the server (BLPOP/BLMOVE on a dedicated connection)
+ * 0: the client keeps polling the server until the tuple exists
+ */
+#define DBR_BLOCKING_POP_ENV "DBR_BLOCKING_POP"
+#define DBR_BLOCKING_POP_DEFAULT "1"
+
+/*
+ * max size in MiB of each growable buffer (sender buffer and per-connection scrap space)
+ * 0 keeps the built-in limits (DBBE_REDIS_SR_BUFFER_LEN, DBBE_REDIS_SCRAP_SPACE_LEN)
+ */
+#define DBR_BUFFER_LIMIT_ENV "DBR_BUFFER_LIMIT"
+#define DBR_BUFFER_LIMIT_DEFAULT "0"
+
+/*
+ * hint the OS to use transparent hugepages for large buffers if set to a non-zero value
+ */
+#define DBR_HUGEPAGES_ENV "DBR_HUGEPAGES"
+#define DBR_HUGEPAGES_DEFAULT "0"
+
+/*
+ * enable the backend progress thread if set to a non-zero value
+ */
+#define DBR_PROGRESS_THREAD_DEFAULT "0"
+
+/*
+ * number of idle loops the progress thread spins before it blocks on the connections
+ * and its wake-up fd, the max blocking time while idle and the shorter one while
+ * requests are waiting for a retry in the work queue
+ */
+#define DBBE_REDIS_PROGRESS_SPIN_LOOPS ( 1024 )
+#define DBBE_REDIS_PROGRESS_IDLE_MSEC ( 1000 )
+#define DBBE_REDIS_PROGRESS_RETRY_MSEC ( 1 )
+
+/*
+ * max number of unused internal requests and completions that are kept for reuse
+ */
+#define DBBE_REDIS_POOL_CAPACITY ( DBBE_REDIS_WORK_QUEUE_DEPTH )
+
 /*
  * max number of Redis connections that can be handled simultaneously by the library
  */
 #define DBBE_REDIS_MAX_CONNECTIONS ( (unsigned)256 )
 
+/*
+ * max number of additional connections that are dedicated to requests
+ * blocking on the server side (waiting GET/READ)
+ * their indices follow the regular connections
+ */
+#define DBBE_REDIS_MAX_DEDICATED_CONNECTIONS ( (unsigned)64 )
+
+/*
+ * max number of connections to a single Redis instance (the regular connection plus its pool members)
+ */
+#define DBBE_REDIS_CONNECTION_POOL_MAX ( 8 )
+
+/*
+ * max number of additional pooled connections that share the slots of a Redis instance
+ * with its regular connection; their indices follow the dedicated connections
+ */
+#define DBBE_REDIS_MAX_POOLED_CONNECTIONS ( (unsigned)256 )
+
+/*
+ * total number of connections tracked by the event mgr
+ */
+#define DBBE_REDIS_MAX_TRACKED_CONNECTIONS ( DBBE_REDIS_MAX_CONNECTIONS + DBBE_REDIS_MAX_DEDICATED_CONNECTIONS + DBBE_REDIS_MAX_POOLED_CONNECTIONS )
+
+/*
+ * server-side timeout in seconds (single digit string) of blocking retrieval commands
+ * a blocked request returns to the sender after this time to re-check cancellation and location
+ */
+#define DBBE_REDIS_BLOCKING_TIMEOUT "2"
+
 /*
  * max number of Redis hash slots
  * note: this is the number of slots i.e. the first invalid index!
@@ -90,6 +217,7 @@ struct dbBE_Redis_result;
 
 typedef struct {
   int _len;
+  int _arena; // entries are owned by an arena and not freed with the result
   struct dbBE_Redis_result *_data; // pointing to results;
 } dbBE_Redis_array_t;
 
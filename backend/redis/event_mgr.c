@@ -29,6 +29,15 @@
 #include <event2/event.h>
 
 void dbBE_Redis_event_mgr_callback( evutil_socket_t socket, short ev_type, void *arg );
+void dbBE_Redis_event_mgr_write_callback( evutil_socket_t socket, short ev_type, void *arg );
+
+/*
+ * wake-up and wait timer events only end the event loop, the caller handles the cause
+ */
+static
+void dbBE_Redis_event_mgr_wait_callback( evutil_socket_t socket, short ev_type, void *arg )
+{
+}
 
 /*
  * create and initialize the event mgr
@@ -52,10 +61,20 @@ dbBE_Redis_event_mgr_t* dbBE_Redis_event_mgr_init( unsigned default_timeout )
     return NULL;
   }
 
+  evmgr->_writable_queue = dbBE_Redis_connection_queue_create();
+  if( evmgr->_writable_queue == NULL )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_init: Failed to allocate writable connection queue\n" );
+    dbBE_Redis_connection_queue_destroy( evmgr->_active_queue );
+    free( evmgr );
+    return NULL;
+  }
+
   evmgr->_evbase = event_base_new();
   if( evmgr->_evbase == NULL )
   {
     LOG( DBG_ERR, stderr, "event_mgr_init: Failed to initialize event manager\n" );
+    dbBE_Redis_connection_queue_destroy( evmgr->_writable_queue );
     dbBE_Redis_connection_queue_destroy( evmgr->_active_queue );
     free( evmgr );
     return NULL;
@@ -78,12 +97,18 @@ int dbBE_Redis_event_mgr_exit( dbBE_Redis_event_mgr_t *ev_mgr )
     return -EINVAL;
   }
 
+  if( ev_mgr->_wakeup != NULL )
+    event_free( ev_mgr->_wakeup );
+  if( ev_mgr->_wait_timer != NULL )
+    event_free( ev_mgr->_wait_timer );
+
   if( ev_mgr->_evbase != NULL )
   {
     event_base_free( ev_mgr->_evbase );
   }
 
   dbBE_Redis_connection_queue_destroy( ev_mgr->_active_queue );
+  dbBE_Redis_connection_queue_destroy( ev_mgr->_writable_queue );
 
   memset( ev_mgr, 0, sizeof( dbBE_Redis_event_mgr_t ) );
   free( ev_mgr );
@@ -109,15 +134,15 @@ int dbBE_Redis_event_mgr_add( dbBE_Redis_event_mgr_t *ev_mgr,
     return -EBADF;
   }
 
-  if( (unsigned int)conn->_index % DBBE_REDIS_MAX_CONNECTIONS != (unsigned int)conn->_index )
+  if( (unsigned int)conn->_index % DBBE_REDIS_MAX_TRACKED_CONNECTIONS != (unsigned int)conn->_index )
   {
-    LOG( DBG_ERR, stderr, "event_mgr_add: connection index=%d out of range=%d\n", conn->_index, DBBE_REDIS_MAX_CONNECTIONS );
+    LOG( DBG_ERR, stderr, "event_mgr_add: connection index=%d out of range=%d\n", conn->_index, DBBE_REDIS_MAX_TRACKED_CONNECTIONS );
     return -ERANGE;
   }
 
   // check if this socket has an existing event registered already
   unsigned n;
-  for( n = 0; n < DBBE_REDIS_MAX_CONNECTIONS; ++n )
+  for( n = 0; n < DBBE_REDIS_MAX_TRACKED_CONNECTIONS; ++n )
   {
     struct event *ev = ev_mgr->_events[ n ];
     if( ev != NULL )
@@ -176,9 +201,9 @@ int dbBE_Redis_event_mgr_rearm( dbBE_Redis_event_mgr_t *ev_mgr,
     return -EINVAL;
   }
 
-  if( (unsigned int)conn->_index % DBBE_REDIS_MAX_CONNECTIONS != (unsigned)conn->_index )
+  if( (unsigned int)conn->_index % DBBE_REDIS_MAX_TRACKED_CONNECTIONS != (unsigned)conn->_index )
   {
-    LOG( DBG_ERR, stderr, "event_mgr_rearm: connection index=%d out of range=%d\n", conn->_index, DBBE_REDIS_MAX_CONNECTIONS );
+    LOG( DBG_ERR, stderr, "event_mgr_rearm: connection index=%d out of range=%d\n", conn->_index, DBBE_REDIS_MAX_TRACKED_CONNECTIONS );
     return -ERANGE;
   }
 
@@ -209,9 +234,9 @@ int dbBE_Redis_event_mgr_rm( dbBE_Redis_event_mgr_t *ev_mgr,
     return -EINVAL;
   }
 
-  if( (unsigned int)conn->_index % DBBE_REDIS_MAX_CONNECTIONS != (unsigned)conn->_index )
+  if( (unsigned int)conn->_index % DBBE_REDIS_MAX_TRACKED_CONNECTIONS != (unsigned)conn->_index )
   {
-    LOG( DBG_ERR, stderr, "event_mgr_rm: connection index=%d out of range=%d\n", conn->_index, DBBE_REDIS_MAX_CONNECTIONS );
+    LOG( DBG_ERR, stderr, "event_mgr_rm: connection index=%d out of range=%d\n", conn->_index, DBBE_REDIS_MAX_TRACKED_CONNECTIONS );
     return -ERANGE;
   }
 
@@ -239,6 +264,18 @@ int dbBE_Redis_event_mgr_rm( dbBE_Redis_event_mgr_t *ev_mgr,
 
   event_free( ev );
 
+  ev = ev_mgr->_write_events[ conn->_index ];
+  if( ev != NULL )
+  {
+    if( event_pending( ev, EV_WRITE, NULL ) )
+      --ev_mgr->_write_armed;
+    event_del( ev );
+    free( event_get_callback_arg( ev ) );
+    event_free( ev );
+    ev_mgr->_write_events[ conn->_index ] = NULL;
+  }
+  dbBE_Redis_connection_queue_remove_connection( ev_mgr->_writable_queue, conn );
+
   // remove entry from connection queue
   rc = dbBE_Redis_connection_queue_remove_connection( ev_mgr->_active_queue, conn );
 
@@ -310,3 +347,150 @@ dbBE_Redis_connection_t* dbBE_Redis_event_mgr_next( dbBE_Redis_event_mgr_t *ev_m
 
   return next;
 }
+
+
+int dbBE_Redis_event_mgr_want_write( dbBE_Redis_event_mgr_t *ev_mgr,
+                                     const dbBE_Redis_connection_t *conn )
+{
+  if(( ev_mgr == NULL ) || ( conn == NULL ))
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_want_write: Invalid argument: ev_mgr=%p, conn=%p\n", ev_mgr, conn );
+    return -EINVAL;
+  }
+
+  if( (unsigned int)conn->_index % DBBE_REDIS_MAX_TRACKED_CONNECTIONS != (unsigned)conn->_index )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_want_write: connection index=%d out of range=%d\n", conn->_index, DBBE_REDIS_MAX_TRACKED_CONNECTIONS );
+    return -ERANGE;
+  }
+
+  struct event *ev = ev_mgr->_write_events[ conn->_index ];
+  if( ev == NULL )
+  {
+    dbBE_Redis_event_info_t *info = (dbBE_Redis_event_info_t*)malloc( sizeof( dbBE_Redis_event_info_t ) );
+    if( info == NULL )
+    {
+      LOG( DBG_ERR, stderr, "event_mgr_want_write: failed to allocate event info\n" );
+      return -ENOMEM;
+    }
+    info->_conn = (dbBE_Redis_connection_t*)conn;
+    info->_ev_mgr = ev_mgr;
+    ev = event_new( ev_mgr->_evbase, conn->_socket, EV_WRITE, dbBE_Redis_event_mgr_write_callback, (void*)info );
+    if( ev == NULL )
+    {
+      LOG( DBG_ERR, stderr, "event_mgr_want_write: failed to allocate event.\n");
+      free( info );
+      return -ENOMEM;
+    }
+    ev_mgr->_write_events[ conn->_index ] = ev;
+  }
+
+  if( event_pending( ev, EV_WRITE, NULL ) )
+    return 0;
+
+  if( event_add( ev, NULL ) != 0 )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_want_write: failed to add event.\n" );
+    return -EFAULT;
+  }
+  ++ev_mgr->_write_armed;
+  return 0;
+}
+
+
+void dbBE_Redis_event_mgr_write_callback( evutil_socket_t socket, short ev_type, void *arg )
+{
+  dbBE_Redis_event_info_t *info = (dbBE_Redis_event_info_t*)arg;
+  if(( info == NULL ) || ( info->_conn == NULL ) || ( info->_ev_mgr == NULL ))
+  {
+    LOG( DBG_ERR, stderr, "Triggered write callback with invalid argument.\n" );
+    return;
+  }
+
+  LOG( DBG_TRACE, stderr, "Triggered write callback for socket=%d, index=%d\n", socket, info->_conn->_index );
+  --info->_ev_mgr->_write_armed;
+  dbBE_Redis_connection_queue_push( info->_ev_mgr->_writable_queue, info->_conn );
+}
+
+
+dbBE_Redis_connection_t* dbBE_Redis_event_mgr_next_writable( dbBE_Redis_event_mgr_t *ev_mgr )
+{
+  if( ev_mgr == NULL )
+    return NULL;
+
+  dbBE_Redis_connection_t *next = dbBE_Redis_connection_queue_pop( ev_mgr->_writable_queue );
+  if(( next == NULL ) && ( ev_mgr->_write_armed > 0 ))
+  {
+    event_base_loop( ev_mgr->_evbase, EVLOOP_ONCE | EVLOOP_NONBLOCK );
+    next = dbBE_Redis_connection_queue_pop( ev_mgr->_writable_queue );
+  }
+  return next;
+}
+
+
+int dbBE_Redis_event_mgr_set_wakeup( dbBE_Redis_event_mgr_t *ev_mgr,
+                                     const int fd )
+{
+  if( ev_mgr == NULL )
+    return -EINVAL;
+
+  if( ev_mgr->_wakeup != NULL )
+  {
+    event_free( ev_mgr->_wakeup );
+    ev_mgr->_wakeup = NULL;
+  }
+  if( fd < 0 )
+    return 0;
+
+  ev_mgr->_wakeup = event_new( ev_mgr->_evbase, fd, EV_READ | EV_PERSIST, dbBE_Redis_event_mgr_wait_callback, NULL );
+  if( ev_mgr->_wakeup == NULL )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_set_wakeup: failed to allocate event.\n" );
+    return -ENOMEM;
+  }
+  if( event_add( ev_mgr->_wakeup, NULL ) != 0 )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_set_wakeup: failed to add event.\n" );
+    event_free( ev_mgr->_wakeup );
+    ev_mgr->_wakeup = NULL;
+    return -EFAULT;
+  }
+  return 0;
+}
+
+
+int dbBE_Redis_event_mgr_wait( dbBE_Redis_event_mgr_t *ev_mgr,
+                               const int timeout_ms )
+{
+  if( ev_mgr == NULL )
+    return -EINVAL;
+
+  if( ! dbBE_Redis_connection_queue_empty( ev_mgr->_active_queue ) ||
+      ! dbBE_Redis_connection_queue_empty( ev_mgr->_writable_queue ))
+    return 0;
+
+  if( ev_mgr->_wait_timer == NULL )
+  {
+    ev_mgr->_wait_timer = evtimer_new( ev_mgr->_evbase, dbBE_Redis_event_mgr_wait_callback, NULL );
+    if( ev_mgr->_wait_timer == NULL )
+      return -ENOMEM;
+  }
+
+  struct timeval tv;
+  tv.tv_sec = timeout_ms / 1000;
+  tv.tv_usec = ( timeout_ms % 1000 ) * 1000;
+  evtimer_add( ev_mgr->_wait_timer, &tv );
+  event_base_loop( ev_mgr->_evbase, EVLOOP_ONCE );
+  evtimer_del( ev_mgr->_wait_timer );
+  return 0;
+}
+
+
+int dbBE_Redis_event_mgr_get_fd( dbBE_Redis_event_mgr_t *ev_mgr )
+{
+  if( ev_mgr == NULL )
+    return -EINVAL;
+
+  // libevent doesn't expose a pollable fd of the event base
+  return -ENOTSUP;
+}
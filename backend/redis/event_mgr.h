@@ -19,18 +19,57 @@
 #define BACKEND_REDIS_EVENT_MGR_H_
 
 #include <sys/types.h>
+#ifdef DBBE_REDIS_EVENT_MGR_EPOLL
+#include <sys/epoll.h>
+#else
 #include <event2/event.h>
+#endif
 
 #include "definitions.h"
 #include "connection.h"
 #include "connection_queue.h"
 
+/*
+ * Two implementations share this interface:
+ *  - event_mgr.c: libevent based (default)
+ *  - event_mgr_epoll.c: direct edge-triggered epoll (Linux, built with DBBE_REDIS_EVENT_MGR_EPOLL)
+ * Both deliver readable connections through the active queue and writable ones through the writable queue.
+ */
+
+#ifdef DBBE_REDIS_EVENT_MGR_EPOLL
+
+/*
+ * max number of readiness events retrieved with one epoll_wait()
+ */
+#define DBBE_REDIS_EPOLL_BATCH ( 64 )
+
+typedef struct dbBE_Redis_event_mgr
+{
+  struct timeval _timeout;
+  int _epfd;
+  dbBE_Redis_connection_t *_conns[ DBBE_REDIS_MAX_TRACKED_CONNECTIONS ]; // registered connections by index
+  uint32_t _armed[ DBBE_REDIS_MAX_TRACKED_CONNECTIONS ]; // registered epoll event mask of each connection
+  struct epoll_event _ready[ DBBE_REDIS_EPOLL_BATCH ];
+  dbBE_Redis_connection_queue_t *_active_queue;
+  dbBE_Redis_connection_queue_t *_writable_queue;
+  int _write_armed; // number of connections waiting for the socket to become writable
+  time_t _next_timeout; // idle connections get queued when no event arrived until then
+  int _wakeup_fd; // watched by dbBE_Redis_event_mgr_wait() in addition to the connections (-1: none)
+} dbBE_Redis_event_mgr_t;
+
+#else
+
 typedef struct dbBE_Redis_event_mgr
 {
   struct timeval _timeout;
   struct event_base *_evbase;
-  struct event *_events[ DBBE_REDIS_MAX_CONNECTIONS ];
+  struct event *_events[ DBBE_REDIS_MAX_TRACKED_CONNECTIONS ];
+  struct event *_write_events[ DBBE_REDIS_MAX_TRACKED_CONNECTIONS ]; // one-shot events of connections with pending send data
   dbBE_Redis_connection_queue_t *_active_queue;
+  dbBE_Redis_connection_queue_t *_writable_queue;
+  int _write_armed; // number of write events waiting for the socket to become writable
+  struct event *_wakeup; // read event of the wake-up fd of dbBE_Redis_event_mgr_wait()
+  struct event *_wait_timer; // ends a dbBE_Redis_event_mgr_wait() without events
 } dbBE_Redis_event_mgr_t;
 
 
@@ -43,6 +82,9 @@ typedef struct dbBE_Redis_event_info
 
 
 #define dbBE_Redis_event_mgr_getbase( mgr ) ((mgr)->_evbase)
+
+#endif /* DBBE_REDIS_EVENT_MGR_EPOLL */
+
 #define dbBE_Redis_connection_mgr_getqueue( mgr ) ((mgr)->_active_queue)
 
 /*
@@ -82,5 +124,40 @@ int dbBE_Redis_event_mgr_rm( dbBE_Redis_event_mgr_t *ev_mgr,
  */
 dbBE_Redis_connection_t* dbBE_Redis_event_mgr_next( dbBE_Redis_event_mgr_t *ev_mgr );
 
+/*
+ * request a notification once the socket of the connection accepts more data
+ * the connection is then returned by dbBE_Redis_event_mgr_next_writable()
+ */
+int dbBE_Redis_event_mgr_want_write( dbBE_Redis_event_mgr_t *ev_mgr,
+                                     const dbBE_Redis_connection_t *conn );
+
+/*
+ * retrieve the next connection that became writable after dbBE_Redis_event_mgr_want_write()
+ * only polls for events while write notifications are outstanding
+ */
+dbBE_Redis_connection_t* dbBE_Redis_event_mgr_next_writable( dbBE_Redis_event_mgr_t *ev_mgr );
+
+/*
+ * watch fd (e.g. an eventfd) during dbBE_Redis_event_mgr_wait() to allow other threads to end the wait
+ * the fd is never read by the event mgr; fd < 0 removes a previously set fd
+ */
+int dbBE_Redis_event_mgr_set_wakeup( dbBE_Redis_event_mgr_t *ev_mgr,
+                                     const int fd );
+
+/*
+ * return an fd that becomes readable once dbBE_Redis_event_mgr_next()/next_writable() may find connections
+ * the fd may be polled by another thread while the owner keeps using the event mgr
+ * returns -EAGAIN if connections are queued already and -ENOTSUP if there's no such fd
+ */
+int dbBE_Redis_event_mgr_get_fd( dbBE_Redis_event_mgr_t *ev_mgr );
+
+/*
+ * block until a registered connection or the wake-up fd has events or timeout_ms expired
+ * ready connections are queued for dbBE_Redis_event_mgr_next()/next_writable()
+ * returns immediately if connections are queued already
+ */
+int dbBE_Redis_event_mgr_wait( dbBE_Redis_event_mgr_t *ev_mgr,
+                               const int timeout_ms );
+
 
 #endif /* BACKEND_REDIS_EVENT_MGR_H_ */
@@ -0,0 +1,427 @@
+/*
+ * Copyright © 2018-2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * event manager built directly on edge-triggered epoll
+ *
+ * Readiness is only polled when the active (or writable) queue is empty.
+ * Connections stay in the queues until they are consumed, so the queues cache
+ * the readiness set across calls and no callback layer is involved.
+ * Timeouts are emulated with a single deadline: if a poll finds nothing after
+ * the deadline passed, all registered connections are queued like the
+ * timeout events of the libevent version.
+ */
+
+#include "logutil.h"
+#include "event_mgr.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#ifndef __APPLE__
+#include <malloc.h>  // malloc
+#endif
+#include <time.h>
+#include <sys/epoll.h>
+
+#define DBBE_REDIS_EPOLL_READ ( EPOLLIN | EPOLLRDHUP | EPOLLET )
+
+/*
+ * epoll data of the wake-up fd (beyond the connection indices)
+ */
+#define DBBE_REDIS_EPOLL_WAKEUP ( DBBE_REDIS_MAX_TRACKED_CONNECTIONS )
+
+static inline
+time_t dbBE_Redis_event_mgr_now()
+{
+  struct timespec ts;
+#ifdef CLOCK_MONOTONIC_COARSE
+  clock_gettime( CLOCK_MONOTONIC_COARSE, &ts );
+#else
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+#endif
+  return ts.tv_sec;
+}
+
+/*
+ * create and initialize the event mgr
+ */
+dbBE_Redis_event_mgr_t* dbBE_Redis_event_mgr_init( unsigned default_timeout )
+{
+  dbBE_Redis_event_mgr_t *evmgr = (dbBE_Redis_event_mgr_t*)malloc( sizeof( dbBE_Redis_event_mgr_t ) );
+  if( evmgr == NULL )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_init: Failed to allocate event manager\n" );
+    return NULL;
+  }
+
+  memset( evmgr, 0, sizeof( dbBE_Redis_event_mgr_t ) );
+
+  evmgr->_active_queue = dbBE_Redis_connection_queue_create();
+  evmgr->_writable_queue = dbBE_Redis_connection_queue_create();
+  if(( evmgr->_active_queue == NULL ) || ( evmgr->_writable_queue == NULL ))
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_init: Failed to allocate connection queues\n" );
+    dbBE_Redis_connection_queue_destroy( evmgr->_active_queue );
+    dbBE_Redis_connection_queue_destroy( evmgr->_writable_queue );
+    free( evmgr );
+    return NULL;
+  }
+
+  evmgr->_epfd = epoll_create1( EPOLL_CLOEXEC );
+  if( evmgr->_epfd < 0 )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_init: Failed to initialize epoll: %s\n", strerror( errno ) );
+    dbBE_Redis_connection_queue_destroy( evmgr->_active_queue );
+    dbBE_Redis_connection_queue_destroy( evmgr->_writable_queue );
+    free( evmgr );
+    return NULL;
+  }
+
+  evmgr->_timeout.tv_sec = default_timeout;
+  evmgr->_next_timeout = dbBE_Redis_event_mgr_now() + default_timeout;
+  evmgr->_wakeup_fd = -1;
+
+  return evmgr;
+}
+
+
+/*
+ * exit and destroy the event mgr
+ */
+int dbBE_Redis_event_mgr_exit( dbBE_Redis_event_mgr_t *ev_mgr )
+{
+  if( ev_mgr == NULL )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_exit: Invalid argument ev_mgr=%p\n", ev_mgr );
+    return -EINVAL;
+  }
+
+  close( ev_mgr->_epfd );
+  dbBE_Redis_connection_queue_destroy( ev_mgr->_active_queue );
+  dbBE_Redis_connection_queue_destroy( ev_mgr->_writable_queue );
+
+  memset( ev_mgr, 0, sizeof( dbBE_Redis_event_mgr_t ) );
+  free( ev_mgr );
+
+  return 0;
+}
+
+
+int dbBE_Redis_event_mgr_add( dbBE_Redis_event_mgr_t *ev_mgr,
+                              const dbBE_Redis_connection_t *conn )
+{
+  if(( ev_mgr == NULL ) || ( conn == NULL ))
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_add: Invalid argument: ev_mgr=%p, conn=%p\n", ev_mgr, conn );
+    return -EINVAL;
+  }
+
+  if( conn->_socket <= 0 )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_add: conn=%p has incomplete state to add\n", conn );
+    return -EBADF;
+  }
+
+  if( (unsigned int)conn->_index % DBBE_REDIS_MAX_TRACKED_CONNECTIONS != (unsigned int)conn->_index )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_add: connection index=%d out of range=%d\n", conn->_index, DBBE_REDIS_MAX_TRACKED_CONNECTIONS );
+    return -ERANGE;
+  }
+
+  if( ev_mgr->_conns[ conn->_index ] != NULL )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_add: connection index=%d already registered\n", conn->_index );
+    return -EEXIST;
+  }
+
+  struct epoll_event ev;
+  memset( &ev, 0, sizeof( ev ) );
+  ev.events = DBBE_REDIS_EPOLL_READ;
+  ev.data.u32 = conn->_index;
+  if( epoll_ctl( ev_mgr->_epfd, EPOLL_CTL_ADD, conn->_socket, &ev ) != 0 )
+  {
+    int rc = errno;
+    LOG( DBG_ERR, stderr, "event_mgr_add: failed to add socket=%d: %s\n", conn->_socket, strerror( rc ) );
+    return ( rc == EEXIST ) ? -EEXIST : -EFAULT;
+  }
+
+  ev_mgr->_conns[ conn->_index ] = (dbBE_Redis_connection_t*)conn;
+  ev_mgr->_armed[ conn->_index ] = ev.events;
+  return 0;
+}
+
+int dbBE_Redis_event_mgr_rearm( dbBE_Redis_event_mgr_t *ev_mgr,
+                                const dbBE_Redis_connection_t *conn )
+{
+  if(( ev_mgr == NULL ) || ( conn == NULL ) )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_rearm: Invalid argument: ev_mgr=%p, conn=%p\n", ev_mgr, conn );
+    return -EINVAL;
+  }
+
+  if( (unsigned int)conn->_index % DBBE_REDIS_MAX_TRACKED_CONNECTIONS != (unsigned)conn->_index )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_rearm: connection index=%d out of range=%d\n", conn->_index, DBBE_REDIS_MAX_TRACKED_CONNECTIONS );
+    return -ERANGE;
+  }
+
+  if( ev_mgr->_conns[ conn->_index ] == NULL )
+  {
+    LOG( DBG_INFO, stderr, "event_mgr_rearm: need to create new event for connection index=%d\n", conn->_index );
+    return -ENOENT;
+  }
+
+  // modifying the registration re-evaluates the readiness of the socket
+  struct epoll_event ev;
+  memset( &ev, 0, sizeof( ev ) );
+  ev.events = ev_mgr->_armed[ conn->_index ];
+  ev.data.u32 = conn->_index;
+  if( epoll_ctl( ev_mgr->_epfd, EPOLL_CTL_MOD, conn->_socket, &ev ) != 0 )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_rearm: failed to rearm event.\n" );
+    return -EFAULT;
+  }
+  return 0;
+}
+
+
+int dbBE_Redis_event_mgr_rm( dbBE_Redis_event_mgr_t *ev_mgr,
+                             const dbBE_Redis_connection_t *conn )
+{
+  if(( ev_mgr == NULL ) || ( conn == NULL ) )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_rm: Invalid argument: ev_mgr=%p, conn=%p\n", ev_mgr, conn );
+    return -EINVAL;
+  }
+
+  if( (unsigned int)conn->_index % DBBE_REDIS_MAX_TRACKED_CONNECTIONS != (unsigned)conn->_index )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_rm: connection index=%d out of range=%d\n", conn->_index, DBBE_REDIS_MAX_TRACKED_CONNECTIONS );
+    return -ERANGE;
+  }
+
+  if( ev_mgr->_conns[ conn->_index ] != conn )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_rm: no event for connection index=%d\n", conn->_index );
+    return -ENOENT;
+  }
+
+  // a closed socket is already gone from the epoll set
+  if(( epoll_ctl( ev_mgr->_epfd, EPOLL_CTL_DEL, conn->_socket, NULL ) != 0 ) && ( errno != EBADF ) && ( errno != ENOENT ))
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_rm: failed to remove connection from event mgr\n" );
+    return -EFAULT;
+  }
+
+  if(( ev_mgr->_armed[ conn->_index ] & EPOLLOUT ) != 0 )
+    --ev_mgr->_write_armed;
+  ev_mgr->_conns[ conn->_index ] = NULL;
+  ev_mgr->_armed[ conn->_index ] = 0;
+
+  dbBE_Redis_connection_queue_remove_connection( ev_mgr->_writable_queue, conn );
+  return dbBE_Redis_connection_queue_remove_connection( ev_mgr->_active_queue, conn );
+}
+
+
+/*
+ * retrieve the ready sockets (waiting up to timeout_ms) and distribute the connections to the queues
+ */
+static
+void dbBE_Redis_event_mgr_poll( dbBE_Redis_event_mgr_t *ev_mgr, const int timeout_ms )
+{
+  int n;
+  int count = epoll_wait( ev_mgr->_epfd, ev_mgr->_ready, DBBE_REDIS_EPOLL_BATCH, timeout_ms );
+  if(( count < 0 ) && ( errno != EINTR ))
+    LOG( DBG_ERR, stderr, "event_mgr_poll: epoll_wait failed: %s\n", strerror( errno ) );
+
+  time_t now;
+  if( count > 0 )
+    ev_mgr->_next_timeout = 0; // re-armed with the next empty poll
+  else if(( now = dbBE_Redis_event_mgr_now() ) >= ev_mgr->_next_timeout )
+  {
+    // first empty poll after activity starts the idle period
+    if( ev_mgr->_next_timeout != 0 )
+    {
+      LOG( DBG_VERBOSE, stderr, "event_mgr_poll: timeout detected.\n" );
+      for( n = 0; n < (int)DBBE_REDIS_MAX_TRACKED_CONNECTIONS; ++n )
+        if( ev_mgr->_conns[ n ] != NULL )
+          dbBE_Redis_connection_queue_push( ev_mgr->_active_queue, ev_mgr->_conns[ n ] );
+    }
+    ev_mgr->_next_timeout = now + ev_mgr->_timeout.tv_sec;
+  }
+
+  for( n = 0; n < count; ++n )
+  {
+    uint32_t index = ev_mgr->_ready[ n ].data.u32;
+    uint32_t events = ev_mgr->_ready[ n ].events;
+    if( index == DBBE_REDIS_EPOLL_WAKEUP )
+      continue;
+    dbBE_Redis_connection_t *conn = ev_mgr->_conns[ index ];
+    if( conn == NULL )
+      continue;
+
+    LOG( DBG_TRACE, stderr, "event_mgr_poll: connection index=%d, events=%x\n", index, events );
+
+    // errors and hang-ups are detected by the following recv()
+    if(( events & ( EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLHUP )) != 0 )
+    {
+      dbBE_Redis_connection_set_active( conn );
+      dbBE_Redis_connection_queue_push( ev_mgr->_active_queue, conn );
+    }
+
+    // write notifications are one-shot
+    if((( events & EPOLLOUT ) != 0 ) && (( ev_mgr->_armed[ index ] & EPOLLOUT ) != 0 ))
+    {
+      struct epoll_event ev;
+      memset( &ev, 0, sizeof( ev ) );
+      ev.events = DBBE_REDIS_EPOLL_READ;
+      ev.data.u32 = index;
+      epoll_ctl( ev_mgr->_epfd, EPOLL_CTL_MOD, conn->_socket, &ev );
+      ev_mgr->_armed[ index ] = ev.events;
+      --ev_mgr->_write_armed;
+      dbBE_Redis_connection_queue_push( ev_mgr->_writable_queue, conn );
+    }
+  }
+}
+
+
+dbBE_Redis_connection_t* dbBE_Redis_event_mgr_next( dbBE_Redis_event_mgr_t *ev_mgr )
+{
+  if( ev_mgr == NULL )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_next: Invalid argument: ev_mgr=%p\n", ev_mgr );
+    return NULL;
+  }
+
+  dbBE_Redis_connection_t *next = dbBE_Redis_connection_queue_pop( ev_mgr->_active_queue );
+  if( next != NULL )
+    return next;
+
+  dbBE_Redis_event_mgr_poll( ev_mgr, 0 );
+  return dbBE_Redis_connection_queue_pop( ev_mgr->_active_queue );
+}
+
+
+int dbBE_Redis_event_mgr_want_write( dbBE_Redis_event_mgr_t *ev_mgr,
+                                     const dbBE_Redis_connection_t *conn )
+{
+  if(( ev_mgr == NULL ) || ( conn == NULL ))
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_want_write: Invalid argument: ev_mgr=%p, conn=%p\n", ev_mgr, conn );
+    return -EINVAL;
+  }
+
+  if( (unsigned int)conn->_index % DBBE_REDIS_MAX_TRACKED_CONNECTIONS != (unsigned)conn->_index )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_want_write: connection index=%d out of range=%d\n", conn->_index, DBBE_REDIS_MAX_TRACKED_CONNECTIONS );
+    return -ERANGE;
+  }
+
+  if( ev_mgr->_conns[ conn->_index ] != conn )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_want_write: connection index=%d not registered\n", conn->_index );
+    return -ENOENT;
+  }
+
+  if(( ev_mgr->_armed[ conn->_index ] & EPOLLOUT ) != 0 )
+    return 0;
+
+  struct epoll_event ev;
+  memset( &ev, 0, sizeof( ev ) );
+  ev.events = ev_mgr->_armed[ conn->_index ] | EPOLLOUT;
+  ev.data.u32 = conn->_index;
+  if( epoll_ctl( ev_mgr->_epfd, EPOLL_CTL_MOD, conn->_socket, &ev ) != 0 )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_want_write: failed to add event.\n" );
+    return -EFAULT;
+  }
+  ev_mgr->_armed[ conn->_index ] = ev.events;
+  ++ev_mgr->_write_armed;
+  return 0;
+}
+
+
+dbBE_Redis_connection_t* dbBE_Redis_event_mgr_next_writable( dbBE_Redis_event_mgr_t *ev_mgr )
+{
+  if( ev_mgr == NULL )
+    return NULL;
+
+  dbBE_Redis_connection_t *next = dbBE_Redis_connection_queue_pop( ev_mgr->_writable_queue );
+  if(( next == NULL ) && ( ev_mgr->_write_armed > 0 ))
+  {
+    dbBE_Redis_event_mgr_poll( ev_mgr, 0 );
+    next = dbBE_Redis_connection_queue_pop( ev_mgr->_writable_queue );
+  }
+  return next;
+}
+
+
+int dbBE_Redis_event_mgr_set_wakeup( dbBE_Redis_event_mgr_t *ev_mgr,
+                                     const int fd )
+{
+  if( ev_mgr == NULL )
+    return -EINVAL;
+
+  if( ev_mgr->_wakeup_fd >= 0 )
+  {
+    epoll_ctl( ev_mgr->_epfd, EPOLL_CTL_DEL, ev_mgr->_wakeup_fd, NULL );
+    ev_mgr->_wakeup_fd = -1;
+  }
+  if( fd < 0 )
+    return 0;
+
+  struct epoll_event ev;
+  memset( &ev, 0, sizeof( ev ) );
+  ev.events = EPOLLIN | EPOLLET;
+  ev.data.u32 = DBBE_REDIS_EPOLL_WAKEUP;
+  if( epoll_ctl( ev_mgr->_epfd, EPOLL_CTL_ADD, fd, &ev ) != 0 )
+  {
+    LOG( DBG_ERR, stderr, "event_mgr_set_wakeup: failed to add fd=%d: %s\n", fd, strerror( errno ) );
+    return -EFAULT;
+  }
+  ev_mgr->_wakeup_fd = fd;
+  return 0;
+}
+
+
+int dbBE_Redis_event_mgr_wait( dbBE_Redis_event_mgr_t *ev_mgr,
+                               const int timeout_ms )
+{
+  if( ev_mgr == NULL )
+    return -EINVAL;
+
+  if( dbBE_Redis_connection_queue_empty( ev_mgr->_active_queue ) &&
+      dbBE_Redis_connection_queue_empty( ev_mgr->_writable_queue ))
+    dbBE_Redis_event_mgr_poll( ev_mgr, timeout_ms );
+  return 0;
+}
+
+
+int dbBE_Redis_event_mgr_get_fd( dbBE_Redis_event_mgr_t *ev_mgr )
+{
+  if( ev_mgr == NULL )
+    return -EINVAL;
+
+  // the epoll fd itself is readable while the ready list isn't empty
+  if( ! dbBE_Redis_connection_queue_empty( ev_mgr->_active_queue ) ||
+      ! dbBE_Redis_connection_queue_empty( ev_mgr->_writable_queue ))
+    return -EAGAIN;
+  return ev_mgr->_epfd;
+}
@@ -162,7 +162,9 @@ int dbBE_Redis_locator_reassociate_conn_index( dbBE_Redis_locator_t *locator,
 
 dbBE_Redis_hash_slot_t dbBE_Redis_locator_hash( const char *key, const uint16_t size )
 {
-  return (dbBE_Redis_hash_slot_t)crcremainder( key, size ) & DBBE_REDIS_HASH_SLOT_MASK;
+  uint16_t len = size;
+  const char *tag = crc16_hashtag( key, &len );
+  return (dbBE_Redis_hash_slot_t)crcremainder( tag, len ) & DBBE_REDIS_HASH_SLOT_MASK;
 }
 
 
@@ -19,6 +19,7 @@
 #include "memutil.h"
 #include "namespace.h"
 #include "namespacelist.h"
+#include "common/utility.h"
 
 
 
@@ -162,171 +163,167 @@ int dbBE_Redis_namespace_detach( dbBE_Redis_namespace_t *ns )
 
 
 /***************************************************************************
- * NAMESPACE LIST FUNCTIONS
+ * NAMESPACE TABLE FUNCTIONS
  */
 
-// use last bit of ptr address to signal matching namespace was found
-#define DBBE_REDIS_NS_PTR_MATCH( p ) ((dbBE_Redis_namespace_list_t*)((uintptr_t)(p) | 0x1ull))
-#define DBBE_REDIS_NS_MATCHED( p )   (((uintptr_t)(p) & 0x1ull) != 0)
-#define DBBE_REDIS_NS_PTR_FIX( p )   ((dbBE_Redis_namespace_list_t*)((uintptr_t)(p) & (~0x1ull)))
+dbBE_Redis_namespace_table_t* dbBE_Redis_namespace_table_create()
+{
+  dbBE_Redis_namespace_table_t *t = (dbBE_Redis_namespace_table_t*)calloc( 1, sizeof( dbBE_Redis_namespace_table_t ) );
+  if( t == NULL )
+  {
+    errno = ENOMEM;
+    return NULL;
+  }
+  t->_buckets = (dbBE_Redis_namespace_list_t**)calloc( DBBE_REDIS_NAMESPACE_TABLE_SIZE, sizeof( dbBE_Redis_namespace_list_t* ) );
+  if( t->_buckets == NULL )
+  {
+    free( t );
+    errno = ENOMEM;
+    return NULL;
+  }
+  t->_size = DBBE_REDIS_NAMESPACE_TABLE_SIZE;
+  t->_count = 0;
+  return t;
+}
+
+static inline
+dbBE_Redis_namespace_list_t** dbBE_Redis_namespace_table_bucket( dbBE_Redis_namespace_table_t *t,
+                                                                 const uint64_t hash )
+{
+  return &t->_buckets[ hash & ( t->_size - 1 ) ];
+}
 
-// search for namespace entry
-// if found: return entry but with lowest bit set to 1 (i.e. cannot be dereferenced directly!!!)
-// if not found: return list entry BEFORE insertion needs to happen
+// returns the link that points to the entry of 'name' or the (NULL) link at the end of its bucket
 static
-dbBE_Redis_namespace_list_t* dbBE_Redis_namespace_list_find( dbBE_Redis_namespace_list_t *s,
-                                                             const char *name )
+dbBE_Redis_namespace_list_t** dbBE_Redis_namespace_table_find( dbBE_Redis_namespace_table_t *t,
+                                                               const char *name,
+                                                               const uint64_t hash )
 {
-  dbBE_Redis_namespace_list_t *r = s;
-  int dir = 0;
-  int lcomp = 0;
-  dir = strncmp( name, r->_ns->_name, 1 );
-  do
+  dbBE_Redis_namespace_list_t **link = dbBE_Redis_namespace_table_bucket( t, hash );
+  while( *link != NULL )
   {
-    int comp = strncmp( name, r->_ns->_name, DBR_MAX_KEY_LEN );
-    if( comp == 0 )
-      return DBBE_REDIS_NS_PTR_MATCH( r );
+    if(( (*link)->_hash == hash ) && ( strncmp( name, (*link)->_ns->_name, DBR_MAX_KEY_LEN ) == 0 ))
+      break;
+    link = &(*link)->_n;
+  }
+  return link;
+}
 
-    if( comp < 0 )
-    {
-      if( dir > 0 )
-      {
-        r = r->_p; // one step back; we just detected that we went one step too far
-        break;
-      }
-      lcomp = strncmp( r->_ns->_name, r->_p->_ns->_name, DBR_MAX_KEY_LEN );
-      if( lcomp < 0 )
-      {
-        r = r->_p;
-        break;
-      }
-      dir = -1;
-      r = r->_p;
-    }
-    if( comp > 0 )
+// double the number of buckets; the table stays intact if that fails
+static
+int dbBE_Redis_namespace_table_grow( dbBE_Redis_namespace_table_t *t )
+{
+  size_t new_size = t->_size << 1;
+  dbBE_Redis_namespace_list_t **buckets = (dbBE_Redis_namespace_list_t**)calloc( new_size, sizeof( dbBE_Redis_namespace_list_t* ) );
+  if( buckets == NULL )
+    return -ENOMEM;
+
+  size_t b;
+  for( b = 0; b < t->_size; ++b )
+  {
+    dbBE_Redis_namespace_list_t *e = t->_buckets[ b ];
+    while( e != NULL )
     {
-      if( dir < 0 )
-        break;
-      lcomp = strncmp( r->_ns->_name, r->_n->_ns->_name, DBR_MAX_KEY_LEN );
-      if( lcomp > 0 )
-        break;
-      dir = 1;
-      r = r->_n;
+      dbBE_Redis_namespace_list_t *next = e->_n;
+      dbBE_Redis_namespace_list_t **bucket = &buckets[ e->_hash & ( new_size - 1 ) ];
+      e->_n = *bucket;
+      *bucket = e;
+      e = next;
     }
-  } while( r != s );
-  return r;
+  }
+  free( t->_buckets );
+  t->_buckets = buckets;
+  t->_size = new_size;
+  return 0;
 }
 
-dbBE_Redis_namespace_list_t* dbBE_Redis_namespace_list_get( dbBE_Redis_namespace_list_t *s,
-                                                            const char *name )
+dbBE_Redis_namespace_t* dbBE_Redis_namespace_table_get( dbBE_Redis_namespace_table_t *t,
+                                                        const char *name )
 {
-  if( (s==NULL) || ( name == NULL ))
+  if( (t==NULL) || ( name == NULL ))
   {
     errno = EINVAL;
     return NULL;
   }
-  dbBE_Redis_namespace_list_t *p = dbBE_Redis_namespace_list_find( s, name );
-  if( DBBE_REDIS_NS_MATCHED( p ) )
-  {
-    p = DBBE_REDIS_NS_PTR_FIX( p );
-    return p;
-  }
+  dbBE_Redis_namespace_list_t *e = *dbBE_Redis_namespace_table_find( t, name, dbBE_String_hash( name, DBR_MAX_KEY_LEN ) );
+  if( e != NULL )
+    return e->_ns;
+
   errno = ENOENT;
   return NULL;
 }
 
-dbBE_Redis_namespace_list_t* dbBE_Redis_namespace_list_insert( dbBE_Redis_namespace_list_t *s,
-                                                               dbBE_Redis_namespace_t * const ns )
+int dbBE_Redis_namespace_table_insert( dbBE_Redis_namespace_table_t *t,
+                                       dbBE_Redis_namespace_t * const ns )
 {
-  if( ns == NULL )
-  {
-    errno = EINVAL;
-    return NULL;
-  }
-  dbBE_Redis_namespace_list_t *r = s;
-  if( s == NULL )
-  {
-    r = (dbBE_Redis_namespace_list_t*)calloc( 1, sizeof( dbBE_Redis_namespace_list_t ) );
-    if( r == NULL )
-    {
-      errno = ENOMEM;
-      return NULL;
-    }
-  }
-
-  if(( r->_ns == NULL ) && ( r->_n == NULL ) && ( r->_p == NULL ))
-  {
-    r->_n = r;
-    r->_p = r;
-    r->_ns = ns;
-    return r;
-  }
+  if(( t == NULL ) || ( ns == NULL ))
+    return -EINVAL;
 
-  dbBE_Redis_namespace_list_t *t = dbBE_Redis_namespace_list_find( r, ns->_name );
-  if( DBBE_REDIS_NS_MATCHED( t ) ) // if exact entry is found, the lowest bit is 1
+  uint64_t hash = dbBE_String_hash( ns->_name, DBR_MAX_KEY_LEN );
+  if( *dbBE_Redis_namespace_table_find( t, ns->_name, hash ) != NULL )
   {
     // don't call attach, because insert of existing NS might be an error case
-    errno = EEXIST;
-    return NULL;
+    return -EEXIST;
   }
 
-  r = (dbBE_Redis_namespace_list_t*)calloc( 1, sizeof( dbBE_Redis_namespace_list_t ) );
-  r->_n = t->_n;
-  r->_p = t;
-  t->_n = r;
-  r->_n->_p = r;
-  r->_ns = ns;
-  t = r;
-  return t;
+  dbBE_Redis_namespace_list_t *e = (dbBE_Redis_namespace_list_t*)calloc( 1, sizeof( dbBE_Redis_namespace_list_t ) );
+  if( e == NULL )
+    return -ENOMEM;
+
+  if( t->_count >= t->_size )
+    dbBE_Redis_namespace_table_grow( t ); // longer chains if that fails, but still functional
+
+  dbBE_Redis_namespace_list_t **bucket = dbBE_Redis_namespace_table_bucket( t, hash );
+  e->_hash = hash;
+  e->_ns = ns;
+  e->_n = *bucket;
+  *bucket = e;
+  ++t->_count;
+  return 0;
 }
 
-dbBE_Redis_namespace_list_t* dbBE_Redis_namespace_list_remove( dbBE_Redis_namespace_list_t *s,
-                                                               const dbBE_Redis_namespace_t *ns )
+int dbBE_Redis_namespace_table_remove( dbBE_Redis_namespace_table_t *t,
+                                       const dbBE_Redis_namespace_t *ns )
 {
-  if(( s == NULL ) || ( ns == NULL ))
-  {
-    errno = EINVAL;
-    return NULL;
-  }
+  if(( t == NULL ) || ( ns == NULL ))
+    return -EINVAL;
 
-  dbBE_Redis_namespace_list_t *t = s;
-  dbBE_Redis_namespace_list_t *r = dbBE_Redis_namespace_list_find( s, ns->_name );
-  if( DBBE_REDIS_NS_MATCHED( r ) )
-  {
-    r = DBBE_REDIS_NS_PTR_FIX( r );
-    if( dbBE_Redis_namespace_detach( r->_ns ) > 0 )
-    {
-      errno = EBUSY;
-      return r;
-    }
-    t = r->_n;
-    if( t == r ) // last element in the ring?
-      t = NULL;
-    r->_p->_n = r->_n;
-    r->_n->_p = r->_p;
-    if( memzero( r, 0, sizeof( r ) ) == NULL )
-      free( r );
-    else
-      free( r );
-  }
-  return t;
+  dbBE_Redis_namespace_list_t **link = dbBE_Redis_namespace_table_find( t, ns->_name, dbBE_String_hash( ns->_name, DBR_MAX_KEY_LEN ) );
+  dbBE_Redis_namespace_list_t *e = *link;
+  if( e == NULL )
+    return -ENOENT;
+
+  int refcnt = dbBE_Redis_namespace_detach( e->_ns );
+  if( refcnt != 0 ) // still referenced or error
+    return refcnt;
+
+  *link = e->_n;
+  --t->_count;
+  memzero( e, 0, sizeof( dbBE_Redis_namespace_list_t ) );
+  free( e );
+  return 0;
 }
 
-int dbBE_Redis_namespace_list_clean( dbBE_Redis_namespace_list_t *s )
+int dbBE_Redis_namespace_table_destroy( dbBE_Redis_namespace_table_t *t )
 {
-  if( (s != NULL ) && ( s->_p != NULL )) // cut the ring
-    s->_p->_n = NULL;
-  while( s != NULL)
+  if( t == NULL )
+    return 0;
+
+  size_t b;
+  for( b = 0; b < t->_size; ++b )
   {
-    dbBE_Redis_namespace_list_t *t = s->_n;
-    s->_n = NULL;
-    s->_p = NULL;
-    while( dbBE_Redis_namespace_destroy( s->_ns ) == -EBUSY )
-      dbBE_Redis_namespace_detach( s->_ns );
-    s->_ns = NULL;
-    free( s );
-    s = t;
+    dbBE_Redis_namespace_list_t *e = t->_buckets[ b ];
+    while( e != NULL )
+    {
+      dbBE_Redis_namespace_list_t *next = e->_n;
+      while( dbBE_Redis_namespace_destroy( e->_ns ) == -EBUSY )
+        dbBE_Redis_namespace_detach( e->_ns );
+      free( e );
+      e = next;
+    }
   }
+  free( t->_buckets );
+  free( t );
   return 0;
 }
 
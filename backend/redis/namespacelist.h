@@ -20,29 +20,46 @@
 
 #include "namespace.h"
 
+#define DBBE_REDIS_NAMESPACE_TABLE_SIZE ( 64 )  // initial number of buckets (power of 2)
+
+/*
+ * Namespaces known to the back-end, hashed by name.
+ * Buckets are single-linked lists, the table doubles the number of buckets
+ * once it holds more namespaces than buckets.
+ */
 typedef struct dbBE_Redis_namespace_list
 {
   struct dbBE_Redis_namespace_list *_n;
-  struct dbBE_Redis_namespace_list *_p;
+  uint64_t _hash;
   dbBE_Redis_namespace_t *_ns;
 } dbBE_Redis_namespace_list_t;
 
+typedef struct dbBE_Redis_namespace_table
+{
+  dbBE_Redis_namespace_list_t **_buckets;
+  size_t _size;    // number of buckets
+  size_t _count;   // number of namespaces
+} dbBE_Redis_namespace_table_t;
+
+
+// create an empty namespace table
+dbBE_Redis_namespace_table_t* dbBE_Redis_namespace_table_create();
 
-// retrieve namespace list ptr if namespace 'name' exists; otherwise NULL is returned
-dbBE_Redis_namespace_list_t* dbBE_Redis_namespace_list_get( dbBE_Redis_namespace_list_t *s,
-                                                            const char *name );
+// retrieve namespace if namespace 'name' exists; otherwise NULL is returned
+dbBE_Redis_namespace_t* dbBE_Redis_namespace_table_get( dbBE_Redis_namespace_table_t *t,
+                                                        const char *name );
 
-// insert namespace into sorted list; only insert if not exists
+// insert namespace; only insert if not exists (returns -EEXIST otherwise)
 // attach/refcount needs to be done separately if needed
-dbBE_Redis_namespace_list_t* dbBE_Redis_namespace_list_insert( dbBE_Redis_namespace_list_t *s,
-                                                               dbBE_Redis_namespace_t * const ns );
+int dbBE_Redis_namespace_table_insert( dbBE_Redis_namespace_table_t *t,
+                                       dbBE_Redis_namespace_t * const ns );
 
-// remove namespace from list in case the reference count hits 0 (in that case it's detached/cleaned up too)
-// otherwise only detach, i.e. refcnt decrease
-dbBE_Redis_namespace_list_t* dbBE_Redis_namespace_list_remove( dbBE_Redis_namespace_list_t *s,
-                                                               const dbBE_Redis_namespace_t *ns );
+// detach the namespace and remove it from the table in case the reference count hits 0 (in that case it's cleaned up too)
+// returns the remaining reference count or a negative error
+int dbBE_Redis_namespace_table_remove( dbBE_Redis_namespace_table_t *t,
+                                       const dbBE_Redis_namespace_t *ns );
 
-// wipe the namespace list, regardless of content status
-int dbBE_Redis_namespace_list_clean( dbBE_Redis_namespace_list_t *s );
+// wipe the namespace table, regardless of content status
+int dbBE_Redis_namespace_table_destroy( dbBE_Redis_namespace_table_t *t );
 
 #endif /* BACKEND_REDIS_NAMESPACELIST_H_ */
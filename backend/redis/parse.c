@@ -35,6 +35,7 @@
 #include "result.h"
 #include "parse.h"
 #include "connection.h"
+#include "resp_scan.h"
 
 
 // length of the ASK response including the trailing space
@@ -53,9 +54,6 @@ int return_error_clean_result( int rc, dbBE_Redis_result_t *result )
   return rc;
 }
 
-char* gScrapSpace = NULL;
-#define DBBE_REDIS_SCRAP_SPACE_LEN ( 512ull * 1024ull * 1024ull )
-
 int64_t dbBE_Redis_nul_terminate_string( char *p, size_t *parsed, const int64_t limit )
 {
   size_t res_len = 0;
@@ -64,8 +62,8 @@ int64_t dbBE_Redis_nul_terminate_string( char *p, size_t *parsed, const int64_t
     errno = EINVAL;
     return 0;
   }
-  char *end = strstr( p, "\r\n" );
-  if(( end == NULL ) || ( end - p > limit ))
+  char *end = dbBE_Redis_scan_terminator( p, limit );
+  if( end == NULL )
   {
     *parsed = 0;
     return -EAGAIN;
@@ -110,6 +108,16 @@ int64_t dbBE_Redis_extract_integer( char *p, size_t *parsed, const int64_t limit
     ++pp;
     --remaining;
   }
+
+  // fast path for terminated numbers of up to 8 digits
+  int digits = dbBE_Redis_scan_uint( p, remaining, &ret );
+  if( digits > 0 )
+  {
+    *parsed = pp + digits + 2;
+    return sign * ret;
+  }
+
+
   while((*p != '\r') && (*p != '\0' ) && ( remaining > 0 ))
   {
     ret *= 10;
@@ -148,29 +156,6 @@ exit_with_nan:
   return DBBE_REDIS_NAN;
 }
 
-// function to find the terminator, strstr will not work because of zeroes in the data
-char* dbBE_Redis_find_terminator( char *haystack, const int64_t limit )
-{
-  char *p = haystack;
-  int64_t pos = 0;
-  while( pos < limit )
-  {
-    while( ( pos < limit - 1 ) && ( *p != '\r'))
-    {
-      ++pos;
-      ++p;
-    }
-    if( ( *p == '\r') && ( p[1] == '\n'))
-    {
-      LOG( DBG_VERBOSE, stdout, "Found Terminator @%"PRId64"\n", pos );
-      return p;
-    }
-    ++pos;
-    ++p;
-  }
-  return NULL;
-}
-
 int64_t dbBE_Redis_extract_bulk_string( char **p, size_t *parsed, const int64_t limit, size_t *actual_size )
 {
   if(( p == NULL ) || ( *p == NULL ) || ( parsed == NULL ) || ( limit <= 0 ))
@@ -239,7 +224,7 @@ int64_t dbBE_Redis_extract_bulk_string( char **p, size_t *parsed, const int64_t
     LOG( DBG_ERR, stderr, "Bulk String Terminator not in expected place: exp=%"PRId64"; lim=%"PRId64"; prcssd=%zd; %x %x|%x %x %x\n",
          exp_len, limit, processed, string[exp_len-2], string[exp_len-1], string[exp_len], string[exp_len+1], string[exp_len+2] );
     // if the terminator is not in the expected place, try to parse for the terminator and adjust or fail if terminator is not found
-    char *terminator = dbBE_Redis_find_terminator( string, limit - processed );
+    char *terminator = dbBE_Redis_scan_terminator( string, limit - processed );
     if( terminator == NULL )
     {
       int64_t ret = limit-processed;
@@ -264,24 +249,23 @@ int64_t dbBE_Redis_extract_bulk_string( char **p, size_t *parsed, const int64_t
 }
 
 
-// try not to do anything here, really only do parsing and return of pointer into the rbuffer without copies
-// if copies are needed, let the caller do that, it should know better...
-// the only change happens on the buffer in-place by nul-terminating the strings
-int dbBE_Redis_parse_sr_buffer_check( dbBE_Redis_sr_buffer_t *sr_buf,
-                                      dbBE_Redis_result_t *result,
-                                      const int toplevel )
+/*
+ * parse a single element at the current processed position of the buffer
+ * arrays are only opened: the header is parsed and the entries are allocated
+ * (from the arena if there is one)
+ * returns:
+ *   0 if the element is complete
+ *   1 if an array with entries was opened (entries to be parsed by the caller)
+ *   -EAGAIN if the element is incomplete (the processed position is unchanged)
+ *   other negative errors for parsing errors
+ */
+static
+int dbBE_Redis_parse_element( dbBE_Redis_sr_buffer_t *sr_buf,
+                              dbBE_Redis_result_t *result,
+                              const int allow_partial,
+                              dbBE_Arena_t *arena )
 {
   int rc = 0;
-  if(( sr_buf == NULL ) || ( result == NULL ))
-  {
-    if( result != NULL )
-    {
-      result->_data._integer = -EINVAL;
-      result->_type = dbBE_REDIS_TYPE_INVALID;
-    }
-    return -EINVAL;
-  }
-
   if( dbBE_Transport_sr_buffer_empty( sr_buf ) )
   {
     result->_data._integer = -ENODATA;
@@ -289,8 +273,6 @@ int dbBE_Redis_parse_sr_buffer_check( dbBE_Redis_sr_buffer_t *sr_buf,
     return -ENODATA;
   }
 
-  int64_t available = dbBE_Transport_sr_buffer_unprocessed( sr_buf );
-
   char type;
 
   // the current type of response from Redis
@@ -303,7 +285,14 @@ int dbBE_Redis_parse_sr_buffer_check( dbBE_Redis_sr_buffer_t *sr_buf,
   size_t parsed = 0;
   int64_t len = 0;
 
-  available = dbBE_Transport_sr_buffer_unprocessed( sr_buf );
+  int64_t available = dbBE_Transport_sr_buffer_unprocessed( sr_buf );
+
+  // only the type was received so far
+  if( available == 0 )
+  {
+    dbBE_Transport_sr_buffer_rewind_processed_to( sr_buf, start_parse );
+    return -EAGAIN;
+  }
 
   switch( type )
   {
@@ -408,7 +397,7 @@ int dbBE_Redis_parse_sr_buffer_check( dbBE_Redis_sr_buffer_t *sr_buf,
             break;
           case -EOVERFLOW:
             // prevent partial strings in arrays
-            if( toplevel == 0 )
+            if( ! allow_partial )
             {
               rc = -EAGAIN;
               break;
@@ -430,12 +419,10 @@ int dbBE_Redis_parse_sr_buffer_check( dbBE_Redis_sr_buffer_t *sr_buf,
       break;
     }
 
-    case '*': // parse an array by just skipping the array size and repeat the first
+    case '*': // parse the array header and allocate the entries
     {
-      int n;
       int64_t tmp_len = dbBE_Redis_extract_integer( p, &parsed, available );
-      result->_data._array._len = (int)tmp_len;
-      if(( result->_data._array._len == -EAGAIN ) && ( parsed == 0 ))
+      if(( tmp_len == -EAGAIN ) && ( parsed == 0 ))
       {
         rc = -EAGAIN;
         break;
@@ -447,24 +434,34 @@ int dbBE_Redis_parse_sr_buffer_check( dbBE_Redis_sr_buffer_t *sr_buf,
         result->_data._integer = -EPROTO;
         break;
       }
-      result->_data._array._data = (dbBE_Redis_result_t*)malloc( sizeof (dbBE_Redis_result_t ) * result->_data._array._len );
-      memset( result->_data._array._data, 0, sizeof (dbBE_Redis_result_t ) * result->_data._array._len );
-
-      dbBE_Transport_sr_buffer_advance( sr_buf, parsed );
 
-      rc = 0;
-      for( n = 0; (n < result->_data._array._len) && ( rc == 0 ); ++n )
-        rc = dbBE_Redis_parse_sr_buffer_check( sr_buf, &result->_data._array._data[ n ], 0 );
-      if(( rc == -EAGAIN ) || ( rc == -ENODATA ))
+      // null array (e.g. timeout of a blocking command) is treated like a nil bulk string
+      if( tmp_len < 0 )
       {
-        result->_type = dbBE_REDIS_TYPE_ARRAY;
-        dbBE_Redis_result_cleanup( result, 0 );
-        parsed = 0;
-        rc = -EAGAIN;
+        result->_type = dbBE_REDIS_TYPE_CHAR;
+        result->_data._string._data = NULL;
+        result->_data._string._size = 0;
         break;
       }
+
       result->_type = dbBE_REDIS_TYPE_ARRAY;
-      parsed = 0;
+      result->_data._array._len = (int)tmp_len;
+      result->_data._array._data = NULL;
+      result->_data._array._arena = ( arena != NULL );
+      if( tmp_len == 0 )
+        break;
+
+      if( arena != NULL )
+        result->_data._array._data = (dbBE_Redis_result_t*)dbBE_Arena_calloc( arena, tmp_len, sizeof (dbBE_Redis_result_t ) );
+      else
+        result->_data._array._data = (dbBE_Redis_result_t*)calloc( tmp_len, sizeof (dbBE_Redis_result_t ) );
+      if( result->_data._array._data == NULL )
+      {
+        result->_data._array._len = 0;
+        rc = -ENOMEM;
+        break;
+      }
+      rc = 1;
       break;
     }
     default:
@@ -477,12 +474,124 @@ int dbBE_Redis_parse_sr_buffer_check( dbBE_Redis_sr_buffer_t *sr_buf,
   if( rc == -EAGAIN )
     dbBE_Transport_sr_buffer_rewind_processed_to( sr_buf, start_parse );
   else
-  {
     dbBE_Transport_sr_buffer_advance( sr_buf, parsed );
-    // terminate any strings in the result structure, ONLY if this is the top-level call
-    if( toplevel != 0 )
-      rc = dbBE_Redis_result_terminate_strings( result );
+  return rc;
+}
+
+void dbBE_Redis_parse_state_init( dbBE_Redis_parse_state_t *state,
+                                  dbBE_Redis_result_t *result,
+                                  const dbBE_Redis_parse_partial_t partial )
+{
+  if( state == NULL )
+    return;
+  state->_root = result;
+  state->_partial = partial;
+  state->_depth = 0;
+  state->_started = 0;
+  state->_arena = NULL;
+}
 
+// try not to do anything here, really only do parsing and return of pointer into the rbuffer without copies
+// if copies are needed, let the caller do that, it should know better...
+// the only change happens on the buffer in-place by nul-terminating the strings
+int dbBE_Redis_parse_sr_buffer_resume( dbBE_Redis_parse_state_t *state,
+                                       dbBE_Redis_sr_buffer_t *sr_buf )
+{
+  if(( state == NULL ) || ( sr_buf == NULL ) || ( state->_root == NULL ))
+  {
+    if(( state != NULL ) && ( state->_root != NULL ))
+    {
+      state->_root->_data._integer = -EINVAL;
+      state->_root->_type = dbBE_REDIS_TYPE_INVALID;
+    }
+    return -EINVAL;
+  }
+
+  int rc = 0;
+  while( 1 )
+  {
+    // find the next slot to fill: the root or the next entry of the innermost open array
+    dbBE_Redis_result_t *slot = state->_root;
+    int allow_partial = ( state->_partial != DBBE_REDIS_PARSE_PARTIAL_NONE );
+    if( state->_depth > 0 )
+    {
+      dbBE_Redis_result_t *array = state->_stack[ state->_depth - 1 ];
+      int index = state->_index[ state->_depth - 1 ];
+      slot = &array->_data._array._data[ index ];
+      allow_partial = ( state->_partial == DBBE_REDIS_PARSE_PARTIAL_TAIL ) &&
+          ( state->_depth == 1 ) && ( index == array->_data._array._len - 1 );
+    }
+
+    rc = dbBE_Redis_parse_element( sr_buf, slot, allow_partial, state->_arena );
+    if(( rc == -ENODATA ) && ( state->_started ))
+      rc = -EAGAIN;
+    if( rc == -EAGAIN )
+      return rc; // keep position and stack, continue with this slot after receiving more data
+    if( rc < 0 )
+      break;
+    state->_started = 1;
+
+    if( rc == 1 )
+    {
+      if( state->_depth >= DBBE_REDIS_PARSE_DEPTH_MAX )
+      {
+        LOG( DBG_ERR, stderr, "Redis response parser: arrays nested deeper than %d\n", DBBE_REDIS_PARSE_DEPTH_MAX );
+        rc = -EPROTO;
+        break;
+      }
+      state->_stack[ state->_depth ] = slot;
+      state->_index[ state->_depth ] = 0;
+      ++state->_depth;
+      continue;
+    }
+
+    // slot complete: close all arrays that are complete with it
+    while( state->_depth > 0 )
+    {
+      dbBE_Redis_result_t *array = state->_stack[ state->_depth - 1 ];
+      if( ++state->_index[ state->_depth - 1 ] < array->_data._array._len )
+        break;
+      --state->_depth;
+    }
+    if( state->_depth == 0 )
+      break;
+  }
+
+  state->_depth = 0;
+  state->_started = 0;
+  if( rc < 0 )
+    return rc; // the caller cleans up the (partially filled) result
+
+  // terminate any strings in the result structure now that it's complete
+  return dbBE_Redis_result_terminate_strings( state->_root );
+}
+
+/*
+ * parse a complete response in one go (restores the buffer position if incomplete)
+ */
+static
+int dbBE_Redis_parse_sr_buffer_complete( dbBE_Redis_sr_buffer_t *sr_buf,
+                                         dbBE_Redis_result_t *result,
+                                         const dbBE_Redis_parse_partial_t partial )
+{
+  if(( sr_buf == NULL ) || ( result == NULL ))
+  {
+    if( result != NULL )
+    {
+      result->_data._integer = -EINVAL;
+      result->_type = dbBE_REDIS_TYPE_INVALID;
+    }
+    return -EINVAL;
+  }
+
+  dbBE_Redis_parse_state_t state;
+  dbBE_Redis_parse_state_init( &state, result, partial );
+  char *start_parse = dbBE_Transport_sr_buffer_get_processed_position( sr_buf );
+  int rc = dbBE_Redis_parse_sr_buffer_resume( &state, sr_buf );
+  if( rc == -EAGAIN )
+  {
+    dbBE_Redis_result_cleanup( result, 0 );
+    dbBE_Transport_sr_buffer_rewind_processed_to( sr_buf, start_parse );
   }
   return rc;
 }
@@ -494,7 +603,13 @@ int dbBE_Redis_parse_sr_buffer_check( dbBE_Redis_sr_buffer_t *sr_buf,
 int dbBE_Redis_parse_sr_buffer( dbBE_Redis_sr_buffer_t *sr_buf,
                                 dbBE_Redis_result_t *result )
 {
-  return dbBE_Redis_parse_sr_buffer_check( sr_buf, result, 1 );
+  return dbBE_Redis_parse_sr_buffer_complete( sr_buf, result, DBBE_REDIS_PARSE_PARTIAL_STRING );
+}
+
+int dbBE_Redis_parse_sr_buffer_partial_tail( dbBE_Redis_sr_buffer_t *sr_buf,
+                                             dbBE_Redis_result_t *result )
+{
+  return dbBE_Redis_parse_sr_buffer_complete( sr_buf, result, DBBE_REDIS_PARSE_PARTIAL_TAIL );
 }
 
 
@@ -510,7 +625,7 @@ int dbBE_Redis_process_put( dbBE_Redis_request_t *request,
   switch( rc )
   {
     case 0:
-      if( result->_data._integer < 1 )  // rpush returns new length of list
+      if( result->_data._integer < 1 )  // rpush/lpush return the new length of the list
         rc = -ENOMEM;
       break;
     default:
@@ -639,6 +754,87 @@ dbBE_Transport_sge_buffer_t* dbBE_Redis_parse_copy_assemble_sge( dbBE_Request_t
   return sge_buf;
 }
 
+/*
+ * BLPOP returns [ key, value ]: turn the result into just the value (as returned by LPOP)
+ */
+static
+void dbBE_Redis_process_unwrap_pop( dbBE_Redis_result_t *result )
+{
+  if(( result->_type != dbBE_REDIS_TYPE_ARRAY ) || ( result->_data._array._len != 2 ))
+    return;
+
+  dbBE_Redis_result_t value = result->_data._array._data[ 1 ];
+  dbBE_Redis_result_cleanup( &result->_data._array._data[ 0 ], 0 );
+  if( ! result->_data._array._arena )
+    free( result->_data._array._data );
+  *result = value;
+}
+
+/*
+ * account for the terminator and any following responses that arrived with the rest of a partial string
+ * received covers the whole value (including the already parsed part) and anything beyond
+ * returns the number of bytes of the value
+ */
+static
+int64_t dbBE_Redis_process_partial_received( dbBE_Redis_connection_t *connection,
+                                             int64_t received,
+                                             const int64_t data_len )
+{
+  dbBE_Redis_sr_buffer_t *sr_buf = dbBE_Transport_dbuffer_get_active( connection->_recvbuf );
+  received -= 2; // remove the terminator from the amount of transferred data
+  dbBE_Transport_sr_buffer_add_data( sr_buf, 2, 0 ); // we've received data ...
+  dbBE_Transport_sr_buffer_advance( sr_buf, 2 ); // that's already processed
+
+  // there's another response in the recv buffer after the termination
+  if( received > data_len )
+  {
+    int64_t remain = received - data_len;
+    received = data_len;
+    dbBE_Transport_sr_buffer_add_data( sr_buf, remain, 0 );
+  }
+  return received;
+}
+
+/*
+ * turn the amount of transferred value data into the result of a get
+ */
+static
+int dbBE_Redis_process_get_transferred( dbBE_Redis_request_t *request,
+                                        dbBE_Redis_result_t *result,
+                                        const int64_t transferred,
+                                        const int64_t data_len )
+{
+  int rc = 0;
+  if( (transferred >= 0 ) && (
+         ( transferred == data_len ) || (
+             ( (request->_user->_flags & DBBE_OPCODE_FLAGS_PARTIAL) != 0 ) && ( transferred < data_len )
+         )
+      )
+    )
+  {
+    dbBE_Redis_result_cleanup( result, 0 );  // clean up and set transferred size
+    result->_type = dbBE_REDIS_TYPE_INT;
+    result->_data._integer = data_len;
+  }
+  else
+  {
+    dbBE_Redis_result_cleanup( result, 0 );  // clean up and set int error code
+    result->_type = dbBE_REDIS_TYPE_INT;
+
+    if( transferred < 0 )
+    {
+      rc = transferred;
+      result->_data._integer = 0;
+    }
+    else
+    {
+      rc = -ENOSPC;
+      result->_data._integer = data_len;
+    }
+  }
+  return rc;
+}
+
 int dbBE_Redis_process_get( dbBE_Redis_request_t *request,
                             dbBE_Redis_result_t *result,
                             dbBE_Data_transport_t *transport,
@@ -646,6 +842,10 @@ int dbBE_Redis_process_get( dbBE_Redis_request_t *request,
 {
   int rc = 0;
 
+  if(( request != NULL ) && ( result != NULL ) &&
+      ( request->_user->_opcode == DBBE_OPCODE_GET ) && dbBE_Redis_request_is_blocking( request ))
+    dbBE_Redis_process_unwrap_pop( result );
+
   rc = dbBE_Redis_process_general( request, result );
 
   if( rc == 0 )
@@ -674,14 +874,16 @@ int dbBE_Redis_process_get( dbBE_Redis_request_t *request,
         LOG( DBG_TRACE, stderr, "PARTIAL STRING: %"PRId64"/%"PRId64"\n", result->_data._pstring._size, result->_data._pstring._total_size );
 
         // prepare sge for another receive call
-        if( gScrapSpace == NULL )
-          gScrapSpace = (char*)malloc( DBBE_REDIS_SCRAP_SPACE_LEN );
-
+        // data beyond the user buffer (+terminator) is dropped into the scrap space of the connection
         dbBE_sge_t overflow;
-        overflow.iov_base = gScrapSpace;
-        overflow.iov_len = DBBE_REDIS_SCRAP_SPACE_LEN;
+        overflow.iov_len = 0;
+        int64_t excess = result->_data._pstring._total_size - (int64_t)dbBE_SGE_get_len( request->_user->_sge, request->_user->_sge_count ) + 2;
+        if( excess > (int64_t)dbBE_Transport_sr_buffer_get_size( dbBE_Transport_dbuffer_get_active( connection->_recvbuf ) ) )
+          overflow.iov_len = excess;
+        overflow.iov_base = dbBE_Redis_connection_get_scrap( connection, overflow.iov_len );
+        if( overflow.iov_base == NULL )
+          overflow.iov_len = 0;
         dbBE_Transport_sge_buffer_t *sge_buf = dbBE_Redis_parse_copy_assemble_sge( request->_user, result, &transport->_rSGE, connection->_recvbuf, overflow );
-        dbBE_Redis_sr_buffer_t *sr_buf = dbBE_Transport_dbuffer_get_active( connection->_recvbuf );
 
         if( sge_buf != NULL )
         {
@@ -695,6 +897,21 @@ int dbBE_Redis_process_get( dbBE_Redis_request_t *request,
                                             result->_data._pstring._total_size + 2, // terminator
                                             sge_buf->_index,
                                             sge_buf->_cmd );
+
+          // the rest of the value isn't there yet: the connection continues with it once it's readable again
+          if(( transferred >= 0 ) && ( transferred + (int64_t)pstring.iov_len < data_len + 2 ))
+          {
+            int prc = dbBE_Redis_connection_bulk_park( connection,
+                                                       request,
+                                                       transport->_rSGE._cmd,
+                                                       transport->_rSGE._index,
+                                                       data_len + 2,
+                                                       transferred + pstring.iov_len );
+            dbBE_Transport_sge_buffer_reset( &transport->_rSGE );
+            if( prc == 0 )
+              return return_error_clean_result( -EINPROGRESS, result );
+            transferred = prc;
+          }
         }
         else
         {
@@ -703,19 +920,9 @@ int dbBE_Redis_process_get( dbBE_Redis_request_t *request,
         }
         // adjust for the redis protocol terminator
         if( transferred > 0 )
-        {
-          transferred -= 2; // remove the terminator from the amount of transferred data
-          dbBE_Transport_sr_buffer_add_data( sr_buf, 2, 0 ); // we've received data ...
-          dbBE_Transport_sr_buffer_advance( sr_buf, 2 ); // that's already processed
-          transferred += result->_data._pstring._size; // add what's been already received
-        }
-        // there's another response in the recv buffer after the termination
-        if( transferred > data_len )
-        {
-          int64_t remain = transferred - data_len;
-          transferred = data_len;
-          dbBE_Transport_sr_buffer_add_data( sr_buf, remain, 0 );
-        }
+          transferred = dbBE_Redis_process_partial_received( connection,
+                                                             transferred + result->_data._pstring._size, // add what's been already received
+                                                             data_len );
       }
       else
       {
@@ -737,33 +944,7 @@ int dbBE_Redis_process_get( dbBE_Redis_request_t *request,
 
       if( transferred == -EAGAIN )
         return -EAGAIN;
-      if( (transferred >= 0 ) && (
-             ( transferred == data_len ) || (
-                 ( (request->_user->_flags & DBBE_OPCODE_FLAGS_PARTIAL) != 0 ) && ( transferred < data_len )
-             )
-          )
-        )
-      {
-        dbBE_Redis_result_cleanup( result, 0 );  // clean up and set transferred size
-        result->_type = dbBE_REDIS_TYPE_INT;
-        result->_data._integer = data_len;
-      }
-      else
-      {
-        dbBE_Redis_result_cleanup( result, 0 );  // clean up and set int error code
-        result->_type = dbBE_REDIS_TYPE_INT;
-
-        if( transferred < 0 )
-        {
-          rc = transferred;
-          result->_data._integer = 0;
-        }
-        else
-        {
-          rc = -ENOSPC;
-          result->_data._integer = data_len;
-        }
-      }
+      rc = dbBE_Redis_process_get_transferred( request, result, transferred, data_len );
     }
   }
 
@@ -803,6 +984,58 @@ int dbBE_Redis_process_remove( dbBE_Redis_request_t *request,
   return rc;
 }
 
+int dbBE_Redis_process_testkey( dbBE_Redis_request_t *request,
+                                dbBE_Redis_result_t *result )
+{
+  int rc = 0;
+  rc = dbBE_Redis_process_general( request, result );
+  if( rc == 0 )
+  {
+    switch( result->_data._integer )
+    {
+      case 0:
+        rc = -ENOENT;
+        break;
+
+      case 1:
+        rc = 0;
+        break;
+
+      default:
+        LOG( DBG_ERR, stderr, "TESTKEY: Protocol error for %s\n", request->_user->_key );
+        rc = -EPROTO;
+        break;
+    }
+  }
+
+  // all result info is in rc, no need to keep result
+  dbBE_Redis_result_cleanup( result, 0 );
+  result->_type = dbBE_REDIS_TYPE_INT;
+  result->_data._integer = 0;
+
+  return rc;
+}
+
+/*
+ * check that the dumped value of a move arrived completely
+ * received counts the bytes of the dump including the terminator (or is a negative error)
+ */
+static
+int dbBE_Redis_process_move_dumped( dbBE_Redis_request_t *request,
+                                    dbBE_Redis_result_t *result,
+                                    const int64_t received,
+                                    const int64_t total )
+{
+  if(( received < 0 ) || ( received < total ))
+  {
+    free( request->_status.move.dumped_value );
+    request->_status.move.dumped_value = NULL;
+    return return_error_clean_result( ( received < 0 ) ? -EPROTO : -ENODATA, result );
+  }
+  request->_status.move.len = total;
+  return 0;
+}
+
 int dbBE_Redis_process_move( dbBE_Redis_request_t *request,
                              dbBE_Redis_result_t *result,
                              dbBE_Redis_connection_t *conn )
@@ -841,20 +1074,29 @@ int dbBE_Redis_process_move( dbBE_Redis_request_t *request,
                                                    1,
                                                    &sge );
 
-          if( transferred < 0 )
+          // the rest of the dump isn't there yet: the connection continues with it once it's readable again
+          if(( transferred >= 0 ) && ( transferred < (ssize_t)sge.iov_len ))
           {
-            free( request->_status.move.dumped_value );
-            rc = return_error_clean_result( -EPROTO, result );
-            break;
+            dbBE_Transport_sge_buffer_t *left = &conn->_sr_dev->_rSGE;
+            int prc = dbBE_Redis_connection_bulk_park( conn,
+                                                       request,
+                                                       left->_cmd,
+                                                       left->_index,
+                                                       result->_data._pstring._total_size + 2,
+                                                       transferred + pstring.iov_len );
+            dbBE_Transport_sge_buffer_reset( left );
+            if( prc == 0 )
+            {
+              rc = return_error_clean_result( -EINPROGRESS, result );
+              break;
+            }
+            transferred = prc;
           }
-          transferred += pstring.iov_len;
-          if( transferred < result->_data._pstring._total_size )
-          {
-            free( request->_status.move.dumped_value );
-            rc = return_error_clean_result( -ENODATA, result );
+          if( transferred >= 0 )
+            transferred += pstring.iov_len;
+          rc = dbBE_Redis_process_move_dumped( request, result, transferred, result->_data._pstring._total_size );
+          if( rc != 0 )
             break;
-          }
-          request->_status.move.len = result->_data._pstring._total_size;
         }
         else
         {
@@ -920,6 +1162,31 @@ int dbBE_Redis_process_move( dbBE_Redis_request_t *request,
   return rc;
 }
 
+
+int dbBE_Redis_process_bulk( dbBE_Redis_request_t *request,
+                             dbBE_Redis_result_t *result,
+                             dbBE_Redis_connection_t *connection )
+{
+  int64_t total = connection->_bulk_total;
+  int64_t received = dbBE_Redis_connection_bulk_resume( connection );
+  if( received == -EINPROGRESS )
+    return -EINPROGRESS;
+
+  switch( request->_user->_opcode )
+  {
+    case DBBE_OPCODE_GET:
+    case DBBE_OPCODE_READ:
+      if( received > 0 )
+        received = dbBE_Redis_process_partial_received( connection, received, total - 2 );
+      return dbBE_Redis_process_get_transferred( request, result, received, total - 2 );
+    case DBBE_OPCODE_MOVE:
+      return dbBE_Redis_process_move_dumped( request, result, received, total - 2 );
+    default:
+      return return_error_clean_result( -ENOTSUP, result );
+  }
+}
+
+
 int dbBE_Redis_process_directory( dbBE_Redis_request_t **in_out_request,
                                   dbBE_Redis_result_t *result,
                                   dbBE_Data_transport_t *transport,
@@ -1084,7 +1351,7 @@ int dbBE_Redis_process_directory( dbBE_Redis_request_t **in_out_request,
   return rc;
 }
 
-int dbBE_Redis_process_nshandling( dbBE_Redis_namespace_list_t **s,
+int dbBE_Redis_process_nshandling( dbBE_Redis_namespace_table_t *s,
                                    dbBE_Redis_request_t *request,
                                    dbBE_Redis_result_t *result,
                                    int rc )
@@ -1099,17 +1366,19 @@ int dbBE_Redis_process_nshandling( dbBE_Redis_namespace_list_t **s,
     {
       ns = dbBE_Redis_namespace_create( request->_user->_key );
       if( ns == NULL )
+      {
         rc = return_error_clean_result( -errno, result );
+        break;
+      }
 
-      dbBE_Redis_namespace_list_t *tmp = dbBE_Redis_namespace_list_insert( *s, ns );
-      if( tmp == NULL )
+      int insrc = dbBE_Redis_namespace_table_insert( s, ns );
+      if( insrc != 0 )
       {
-        rc = return_error_clean_result( -errno, result );
+        rc = return_error_clean_result( insrc, result );
         dbBE_Redis_namespace_destroy( ns ); // clean up
       }
       else
       {
-        *s = tmp;
         dbBE_Redis_result_cleanup( result, 0 );
         result->_type = dbBE_REDIS_TYPE_INT;
         result->_data._integer = (int64_t)ns;
@@ -1118,29 +1387,25 @@ int dbBE_Redis_process_nshandling( dbBE_Redis_namespace_list_t **s,
     }
     case DBBE_OPCODE_NSATTACH:
     {
-      dbBE_Redis_namespace_list_t *tmp = dbBE_Redis_namespace_list_get( *s, request->_user->_key );
-      if( tmp == NULL )
+      ns = dbBE_Redis_namespace_table_get( s, request->_user->_key );
+      if( ns == NULL )
       {
         ns = dbBE_Redis_namespace_create( request->_user->_key );
-        tmp = dbBE_Redis_namespace_list_insert( *s, ns );
-        if( tmp == NULL )
+        if( ns == NULL )
+        {
+          rc = return_error_clean_result( -errno, result );
+          break;
+        }
+        int insrc = dbBE_Redis_namespace_table_insert( s, ns );
+        if( insrc != 0 )
         {
-          int tmperr = -errno;
           dbBE_Redis_namespace_destroy( ns );
-          rc = return_error_clean_result( tmperr, result );
+          rc = return_error_clean_result( insrc, result );
           break;
         }
-        *s = tmp;
       }
       else // in case it was already there:
       {
-        ns = tmp->_ns;
-        if( ns == NULL )
-        {
-          LOG( DBG_ERR, stderr, "Fatal: found namespace with NULL entry when looking for %s.\n", request->_user->_key );
-          rc = return_error_clean_result( -EINVAL, result );
-          break;
-        }
         uint32_t refcnt = dbBE_Redis_namespace_get_refcnt( ns );
         if( dbBE_Redis_namespace_attach( ns ) != (int)refcnt + 1 )
         {
@@ -1149,7 +1414,6 @@ int dbBE_Redis_process_nshandling( dbBE_Redis_namespace_list_t **s,
           break;
         }
         rc = 0;
-        *s = tmp;
       }
       dbBE_Redis_result_cleanup( result, 0 );
       result->_type = dbBE_REDIS_TYPE_INT;
@@ -1540,7 +1804,7 @@ int dbBE_Redis_process_nsdetach( dbBE_Redis_request_t **in_out_request,
           continue;
 
         // place that user request into the deletion
-        dbBE_Redis_request_t *delkey = dbBE_Redis_request_allocate( request->_user );
+        dbBE_Redis_request_t *delkey = dbBE_Redis_request_allocate( request->_pools, request->_user );
         if( ! delkey )
           continue;
         delkey->_location._type = request->_location._type;
@@ -19,6 +19,7 @@
 #define BACKEND_REDIS_PARSE_H_
 
 #include "common/data_transport.h"
+#include "common/arena.h"
 #include "transports/sr_buffer.h"
 #include "definitions.h"
 #include "s2r_queue.h"
@@ -62,13 +63,71 @@ int64_t dbBE_Redis_extract_integer( char *p, size_t *parsed, const int64_t limit
  */
 int64_t dbBE_Redis_extract_bulk_string( char **p, size_t *parsed, const int64_t limit, size_t *actual_size );
 
+/*
+ * which elements of a response may be returned as partial strings
+ */
+typedef enum
+{
+  DBBE_REDIS_PARSE_PARTIAL_NONE = 0, ///< only complete responses (e.g. memcopy transport)
+  DBBE_REDIS_PARSE_PARTIAL_STRING = 1, ///< a top-level bulk string may be partial
+  DBBE_REDIS_PARSE_PARTIAL_TAIL = 2 ///< also the last element of a top-level array (blocking pops)
+} dbBE_Redis_parse_partial_t;
+
+#define DBBE_REDIS_PARSE_DEPTH_MAX ( 8 )
+
+/*
+ * state of an incremental parse of a single response
+ * keeps the position in nested arrays across incomplete receives
+ * so that each element is parsed only once
+ */
+typedef struct
+{
+  dbBE_Redis_result_t *_root;
+  dbBE_Redis_result_t *_stack[ DBBE_REDIS_PARSE_DEPTH_MAX ]; ///< open arrays
+  int _index[ DBBE_REDIS_PARSE_DEPTH_MAX ]; ///< next entry to parse in each open array
+  int _depth;
+  int _started; ///< set once the first element of the response got parsed
+  dbBE_Redis_parse_partial_t _partial;
+  dbBE_Arena_t *_arena; ///< optional arena for array entries (NULL: heap)
+} dbBE_Redis_parse_state_t;
+
+/*
+ * prepare the parser state to parse the next response into result
+ * array entries are heap allocated unless an arena is set afterwards
+ */
+void dbBE_Redis_parse_state_init( dbBE_Redis_parse_state_t *state,
+                                  dbBE_Redis_result_t *result,
+                                  const dbBE_Redis_parse_partial_t partial );
+
+/*
+ * continue parsing the response from the current processed position of the buffer
+ * returns:
+ *   0 when the response is complete (the state is ready for the next response)
+ *   -EAGAIN if more data is needed; the completed elements stay in the result and
+ *           the buffer is positioned at the incomplete element. Call again with the
+ *           same state after more data was appended to the buffer.
+ *   -ENODATA if the buffer has no data for a new response
+ *   other negative errors for protocol errors
+ */
+int dbBE_Redis_parse_sr_buffer_resume( dbBE_Redis_parse_state_t *state,
+                                       dbBE_Redis_sr_buffer_t *sr_buf );
+
 /*
  * parse the input buffer
  * return the Redis result including its type and its size
+ * an incomplete response returns -EAGAIN with the buffer position unchanged
  */
 int dbBE_Redis_parse_sr_buffer( dbBE_Redis_sr_buffer_t *sr_buf,
                                 dbBE_Redis_result_t *result );
 
+/*
+ * parse the input buffer like dbBE_Redis_parse_sr_buffer()
+ * but allow the last element of a top-level array to be a partial string
+ * (used for blocking pops that return [ key, value ])
+ */
+int dbBE_Redis_parse_sr_buffer_partial_tail( dbBE_Redis_sr_buffer_t *sr_buf,
+                                             dbBE_Redis_result_t *result );
+
 /*
  * process the response based on the request
  */
@@ -101,12 +160,26 @@ int dbBE_Redis_process_move( dbBE_Redis_request_t *request,
                              dbBE_Redis_result_t *result,
                              dbBE_Redis_connection_t *conn );
 
+/*
+ * continue a get or move whose value is still arriving on the connection
+ * returns -EINPROGRESS while the value is incomplete, the result of the request otherwise
+ */
+int dbBE_Redis_process_bulk( dbBE_Redis_request_t *request,
+                             dbBE_Redis_result_t *result,
+                             dbBE_Redis_connection_t *connection );
+
 /*
  * process the response data of a remove request
  */
 int dbBE_Redis_process_remove( dbBE_Redis_request_t *request,
                                dbBE_Redis_result_t *result );
 
+/*
+ * process the response data of a key existence check
+ */
+int dbBE_Redis_process_testkey( dbBE_Redis_request_t *request,
+                                dbBE_Redis_result_t *result );
+
 /*
  * process the response data of a directory request
  */
@@ -120,7 +193,7 @@ int dbBE_Redis_process_directory( dbBE_Redis_request_t **in_out_request,
 /*
  * post-process namespace create/attach to handle locally tracked namespace handles/structures
  */
-int dbBE_Redis_process_nshandling( dbBE_Redis_namespace_list_t **s,
+int dbBE_Redis_process_nshandling( dbBE_Redis_namespace_table_t *s,
                                    dbBE_Redis_request_t *request,
                                    dbBE_Redis_result_t *result,
                                    int rc );
@@ -0,0 +1,320 @@
+/*
+ * Copyright © 2018-2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "logutil.h"
+#include "redis.h"
+#include "progress.h"
+
+#ifdef __APPLE__
+#include <stdlib.h>
+#else
+#include <malloc.h>  // malloc
+#endif
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+
+dbBE_Redis_progress_t* dbBE_Redis_progress_create( const size_t depth )
+{
+  if( depth == 0 )
+  {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  dbBE_Redis_progress_t *progress = (dbBE_Redis_progress_t*)calloc( 1, sizeof( dbBE_Redis_progress_t ) );
+  if( progress == NULL )
+  {
+    errno = ENOMEM;
+    return NULL;
+  }
+
+  progress->_posted = dbBE_Ring_create( depth );
+  progress->_ready = dbBE_Ring_create( depth );
+  progress->_overflow_q = dbBE_Completion_queue_create( depth );
+  if(( progress->_posted == NULL ) || ( progress->_ready == NULL ) || ( progress->_overflow_q == NULL ))
+  {
+    dbBE_Ring_destroy( progress->_posted );
+    dbBE_Ring_destroy( progress->_ready );
+    dbBE_Completion_queue_destroy( progress->_overflow_q );
+    free( progress );
+    errno = ENOMEM;
+    return NULL;
+  }
+
+  int rc = dbBE_Wakeup_init( &progress->_wakeup );
+  if( rc == 0 )
+  {
+    rc = dbBE_Wakeup_init( &progress->_ready_wakeup );
+    if( rc != 0 )
+      dbBE_Wakeup_exit( &progress->_wakeup );
+  }
+  if( rc != 0 )
+  {
+    LOG( DBG_ERR, stderr, "Failed to create progress wake-up fd. rc=%d\n", rc );
+    dbBE_Ring_destroy( progress->_posted );
+    dbBE_Ring_destroy( progress->_ready );
+    dbBE_Completion_queue_destroy( progress->_overflow_q );
+    free( progress );
+    errno = -rc;
+    return NULL;
+  }
+
+  pthread_mutex_init( &progress->_lock, NULL );
+  progress->_depth = depth;
+  progress->_running = 0;
+  return progress;
+}
+
+int dbBE_Redis_progress_destroy( dbBE_Redis_progress_t *progress )
+{
+  if( progress == NULL )
+    return -EINVAL;
+
+  dbBE_Redis_progress_stop( progress );
+
+  dbBE_Wakeup_exit( &progress->_wakeup );
+  dbBE_Wakeup_exit( &progress->_ready_wakeup );
+  pthread_mutex_destroy( &progress->_lock );
+  dbBE_Ring_destroy( progress->_posted );
+  dbBE_Ring_destroy( progress->_ready );
+  dbBE_Completion_queue_destroy( progress->_overflow_q );
+  memset( progress, 0, sizeof( dbBE_Redis_progress_t ) );
+  free( progress );
+  return 0;
+}
+
+int dbBE_Redis_progress_post( dbBE_Redis_progress_t *progress,
+                              dbBE_Request_t *request )
+{
+  if(( progress == NULL ) || ( request == NULL ))
+    return -EINVAL;
+
+  // the ring may be larger than the requested depth (power of 2)
+  if( dbBE_Ring_len( progress->_posted ) >= progress->_depth )
+    return -EAGAIN;
+  if( dbBE_Ring_push( progress->_posted, request ) != 0 )
+    return -EAGAIN;
+
+  // only signal the thread if it is about to block or blocking
+  // pairs with the fence in dbBE_Redis_progress_idle(): either we see _sleeping or it sees the request
+  __atomic_thread_fence( __ATOMIC_SEQ_CST );
+  if( __atomic_load_n( &progress->_sleeping, __ATOMIC_RELAXED ) )
+    dbBE_Redis_progress_notify( progress );
+  return 0;
+}
+
+void dbBE_Redis_progress_notify( dbBE_Redis_progress_t *progress )
+{
+  if( progress == NULL )
+    return;
+
+  dbBE_Wakeup_signal( &progress->_wakeup );
+}
+
+int dbBE_Redis_progress_arm( dbBE_Redis_progress_t *progress )
+{
+  if( progress == NULL )
+    return -EINVAL;
+
+  __atomic_store_n( &progress->_ready_armed, 1, __ATOMIC_RELAXED );
+  __atomic_thread_fence( __ATOMIC_SEQ_CST );
+  dbBE_Wakeup_drain( &progress->_ready_wakeup );
+  if(( dbBE_Ring_len( progress->_ready ) > 0 ) || ( __atomic_load_n( &progress->_overflow_len, __ATOMIC_ACQUIRE ) > 0 ))
+    return -EAGAIN;
+  return dbBE_Wakeup_fd( &progress->_ready_wakeup );
+}
+
+dbBE_Completion_t* dbBE_Redis_progress_fetch( dbBE_Redis_progress_t *progress )
+{
+  if( progress == NULL )
+    return NULL;
+
+  dbBE_Completion_t *compl = (dbBE_Completion_t*)dbBE_Ring_pop( progress->_ready );
+  if( compl != NULL )
+    return compl;
+
+  if( __atomic_load_n( &progress->_overflow_len, __ATOMIC_ACQUIRE ) == 0 )
+    return NULL;
+
+  // the overflow queue only holds completions that are newer than anything in the ring
+  // and the ring doesn't grow while the overflow is in use; the ring may have been
+  // refilled right before the overflow started, so check it again under the lock
+  pthread_mutex_lock( &progress->_lock );
+  compl = (dbBE_Completion_t*)dbBE_Ring_pop( progress->_ready );
+  if( compl == NULL )
+  {
+    compl = dbBE_Completion_queue_pop( progress->_overflow_q );
+    __atomic_store_n( &progress->_overflow_len, dbBE_Completion_queue_len( progress->_overflow_q ), __ATOMIC_RELEASE );
+  }
+  pthread_mutex_unlock( &progress->_lock );
+  return compl;
+}
+
+int dbBE_Redis_progress_take_posted( dbBE_Redis_progress_t *progress,
+                                     dbBE_Request_queue_t *work_q )
+{
+  if(( progress == NULL ) || ( work_q == NULL ))
+    return -EINVAL;
+
+  int count = 0;
+  dbBE_Request_t *request;
+  while(( request = (dbBE_Request_t*)dbBE_Ring_pop_single( progress->_posted )) != NULL )
+  {
+    dbBE_Request_queue_push( work_q, request );
+    ++count;
+  }
+  return count;
+}
+
+int dbBE_Redis_progress_deliver( dbBE_Redis_progress_t *progress,
+                                 dbBE_Completion_queue_t *compl_q )
+{
+  if(( progress == NULL ) || ( compl_q == NULL ))
+    return -EINVAL;
+
+  int count = 0;
+  dbBE_Completion_t *compl;
+
+  // the ring can only be used while nothing is waiting in the overflow queue to keep the order
+  if( __atomic_load_n( &progress->_overflow_len, __ATOMIC_ACQUIRE ) == 0 )
+  {
+    while(( compl = compl_q->_head ) != NULL )
+    {
+      if( dbBE_Ring_push( progress->_ready, compl ) != 0 )
+        break;
+      dbBE_Completion_queue_pop( compl_q );
+      ++count;
+    }
+  }
+
+  if( dbBE_Completion_queue_len( compl_q ) > 0 )
+  {
+    pthread_mutex_lock( &progress->_lock );
+    while(( compl = dbBE_Completion_queue_pop( compl_q )) != NULL )
+    {
+      dbBE_Completion_queue_push( progress->_overflow_q, compl );
+      ++count;
+    }
+    __atomic_store_n( &progress->_overflow_len, dbBE_Completion_queue_len( progress->_overflow_q ), __ATOMIC_RELEASE );
+    pthread_mutex_unlock( &progress->_lock );
+  }
+
+  // wake up a user thread blocked in poll() on the ready fd, at most once per dbBE_Redis_progress_arm()
+  // pairs with the fence in dbBE_Redis_progress_arm(): either it sees the completions or we see _ready_armed
+  if( count > 0 )
+  {
+    __atomic_thread_fence( __ATOMIC_SEQ_CST );
+    if( __atomic_load_n( &progress->_ready_armed, __ATOMIC_RELAXED ) &&
+        __atomic_exchange_n( &progress->_ready_armed, 0, __ATOMIC_ACQ_REL ))
+      dbBE_Wakeup_signal( &progress->_ready_wakeup );
+  }
+  return count;
+}
+
+/*
+ * block until a connection has events, new requests are posted, the thread
+ * is stopped or the idle timeout expires
+ */
+static
+void dbBE_Redis_progress_idle( dbBE_Redis_progress_t *progress,
+                               dbBE_Redis_context_t *backend )
+{
+  // requests that couldn't be sent yet are retried without waiting for socket events
+  int timeout_ms = ( dbBE_Request_queue_len( backend->_work_q ) > 0 ) ?
+      DBBE_REDIS_PROGRESS_RETRY_MSEC : DBBE_REDIS_PROGRESS_IDLE_MSEC;
+
+  __atomic_store_n( &progress->_sleeping, 1, __ATOMIC_RELAXED );
+  __atomic_thread_fence( __ATOMIC_SEQ_CST );
+  if(( __atomic_load_n( &progress->_running, __ATOMIC_ACQUIRE ) ) && ( dbBE_Ring_len( progress->_posted ) == 0 ))
+    dbBE_Redis_event_mgr_wait( backend->_conn_mgr->_ev_mgr, timeout_ms );
+  __atomic_store_n( &progress->_sleeping, 0, __ATOMIC_RELAXED );
+  dbBE_Wakeup_drain( &progress->_wakeup );
+}
+
+/*
+ * progress thread main loop:
+ * picks up posted requests, drives sender/receiver and hands completions back
+ * spins for a while when idle before it blocks on the connections
+ */
+static
+void* dbBE_Redis_progress_loop( void *args )
+{
+  dbBE_Redis_context_t *backend = (dbBE_Redis_context_t*)args;
+  dbBE_Redis_progress_t *progress = backend->_progress;
+
+  unsigned idle_loops = 0;
+  while( __atomic_load_n( &progress->_running, __ATOMIC_ACQUIRE ) )
+  {
+    int posted = dbBE_Redis_progress_take_posted( progress, backend->_work_q );
+    dbBE_Redis_sender_trigger( backend );
+    int completed = dbBE_Redis_progress_deliver( progress, backend->_compl_q );
+
+    if(( posted > 0 ) || ( completed > 0 ))
+      idle_loops = 0;
+    else if( ++idle_loops > DBBE_REDIS_PROGRESS_SPIN_LOOPS )
+      dbBE_Redis_progress_idle( progress, backend );
+  }
+  return NULL;
+}
+
+int dbBE_Redis_progress_start( dbBE_Redis_progress_t *progress,
+                               struct dbBE_Redis_context *backend )
+{
+  if(( progress == NULL ) || ( backend == NULL ) || ( backend->_progress != progress ))
+    return -EINVAL;
+
+  if( __atomic_exchange_n( &progress->_running, 1, __ATOMIC_ACQ_REL ) != 0 )
+    return -EALREADY;
+
+  int rc = dbBE_Redis_event_mgr_set_wakeup( backend->_conn_mgr->_ev_mgr, dbBE_Wakeup_fd( &progress->_wakeup ) );
+  if( rc != 0 )
+  {
+    __atomic_store_n( &progress->_running, 0, __ATOMIC_RELEASE );
+    return rc;
+  }
+  progress->_backend = backend;
+
+  rc = pthread_create( &progress->_thread, NULL, dbBE_Redis_progress_loop, (void*)backend );
+  if( rc != 0 )
+  {
+    LOG( DBG_ERR, stderr, "Failed to create progress thread. rc=%d\n", rc );
+    dbBE_Redis_event_mgr_set_wakeup( backend->_conn_mgr->_ev_mgr, -1 );
+    progress->_backend = NULL;
+    __atomic_store_n( &progress->_running, 0, __ATOMIC_RELEASE );
+    return -rc;
+  }
+  return 0;
+}
+
+int dbBE_Redis_progress_stop( dbBE_Redis_progress_t *progress )
+{
+  if( progress == NULL )
+    return -EINVAL;
+
+  if( __atomic_exchange_n( &progress->_running, 0, __ATOMIC_ACQ_REL ) == 0 )
+    return 0;
+  dbBE_Redis_progress_notify( progress );
+
+  int rc = -pthread_join( progress->_thread, NULL );
+  dbBE_Redis_event_mgr_set_wakeup( progress->_backend->_conn_mgr->_ev_mgr, -1 );
+  progress->_backend = NULL;
+  return rc;
+}
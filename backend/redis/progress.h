@@ -0,0 +1,123 @@
+/*
+ * Copyright © 2018-2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef BACKEND_REDIS_PROGRESS_H_
+#define BACKEND_REDIS_PROGRESS_H_
+
+#include <pthread.h>
+
+#include "../common/dbbe_api.h"
+#include "../common/request_queue.h"
+#include "../common/completion_queue.h"
+#include "../common/ring.h"
+#include "../common/wakeup.h"
+
+/*
+ * The progress engine is an optional thread that owns the sender, receiver
+ * and event loop of the backend. User threads only interact with it through
+ * two lock-free hand-off rings:
+ *   - posted requests that have not been picked up by the sender yet
+ *     (pushed by any user thread, popped by the progress thread only)
+ *   - completions that are ready to be returned by test_any
+ *     (pushed by the progress thread only, popped by any user thread)
+ * If user threads don't keep up with fetching, completions that don't fit
+ * the ready ring go to a locked overflow queue instead of stalling the thread.
+ * Everything else in the backend context stays single-threaded.
+ * While idle, the thread blocks in the event mgr on the connection sockets
+ * and a wake-up fd (eventfd) that is signalled for new posts and cancellations.
+ */
+
+struct dbBE_Redis_context;
+
+typedef struct dbBE_Redis_progress
+{
+  pthread_t _thread;
+  pthread_mutex_t _lock;                ///< protects the overflow queue
+  dbBE_Wakeup_t _wakeup;                ///< ends the blocking wait of the thread (new posts, cancellations, stop)
+  dbBE_Wakeup_t _ready_wakeup;          ///< signalled for a user thread that blocks until completions are ready
+  int _ready_armed;                     ///< 1 while a user thread wants _ready_wakeup to be signalled
+  struct dbBE_Redis_context *_backend;  ///< backend driven by the running thread
+  dbBE_Ring_t *_posted;                 ///< requests posted by user threads
+  dbBE_Ring_t *_ready;                  ///< completions ready for user threads
+  dbBE_Completion_queue_t *_overflow_q; ///< completions that didn't fit into _ready (in order after it)
+  size_t _overflow_len;                 ///< length of _overflow_q readable without the lock
+  size_t _depth;                        ///< max number of posted but not yet picked up requests
+  int _sleeping;                        ///< 1 while the progress thread blocks (posts have to signal the wake-up fd)
+  int _running;                         ///< 1 while the progress thread is active (atomic)
+} dbBE_Redis_progress_t;
+
+
+/*
+ * create the hand-off rings (without starting the thread)
+ */
+dbBE_Redis_progress_t* dbBE_Redis_progress_create( const size_t depth );
+
+/*
+ * stop the thread if running and destroy the hand-off rings
+ */
+int dbBE_Redis_progress_destroy( dbBE_Redis_progress_t *progress );
+
+/*
+ * start the progress thread driving the backend
+ */
+int dbBE_Redis_progress_start( dbBE_Redis_progress_t *progress,
+                               struct dbBE_Redis_context *backend );
+
+/*
+ * signal the progress thread to exit and join it
+ */
+int dbBE_Redis_progress_stop( dbBE_Redis_progress_t *progress );
+
+/*
+ * hand a new user request to the progress thread
+ * returns -EAGAIN if the hand-off ring is full
+ */
+int dbBE_Redis_progress_post( dbBE_Redis_progress_t *progress,
+                              dbBE_Request_t *request );
+
+/*
+ * wake up the progress thread if it's blocked (e.g. after a cancellation)
+ */
+void dbBE_Redis_progress_notify( dbBE_Redis_progress_t *progress );
+
+/*
+ * prepare a user thread to block until completions are ready
+ * returns the fd to poll or -EAGAIN if completions are ready already
+ */
+int dbBE_Redis_progress_arm( dbBE_Redis_progress_t *progress );
+
+/*
+ * fetch the next completion that's ready for the user (or NULL)
+ */
+dbBE_Completion_t* dbBE_Redis_progress_fetch( dbBE_Redis_progress_t *progress );
+
+/*
+ * progress-thread side: move all posted requests into the work queue
+ * returns the number of transferred requests
+ */
+int dbBE_Redis_progress_take_posted( dbBE_Redis_progress_t *progress,
+                                     dbBE_Request_queue_t *work_q );
+
+/*
+ * progress-thread side: move all completions into the ready ring
+ * (or into the overflow queue once the ring is full)
+ * returns the number of transferred completions
+ */
+int dbBE_Redis_progress_deliver( dbBE_Redis_progress_t *progress,
+                                 dbBE_Completion_queue_t *compl_q );
+
+#endif /* BACKEND_REDIS_PROGRESS_H_ */
@@ -22,7 +22,9 @@
 #include <malloc.h>
 #endif
 #include <string.h>
+#include <errno.h>
 
+#include "logutil.h"
 #include "protocol.h"
 
 dbBE_Redis_command_stage_spec_t *gRedis_command_spec = NULL;
@@ -59,7 +61,7 @@ dbBE_Redis_command_stage_spec_t* dbBE_Redis_command_stages_spec_init()
    * - RPUSH ns_name::t_name value
    */
   op = DBBE_OPCODE_PUT;
-  stage = 0;
+  stage = DBBE_REDIS_PUT_STAGE_TAIL;
   index = op * DBBE_REDIS_COMMAND_STAGE_MAX + stage;
   s = &specs[ index ];
   s->_array_len = 2;
@@ -70,6 +72,21 @@ dbBE_Redis_command_stage_spec_t* dbBE_Redis_command_stages_spec_init()
   strcpy( s->_command, "*3\r\n$5\r\nRPUSH\r\n%0%1" );
   s->_stage = stage;
 
+  /*
+   * - LPUSH ns_name::t_name value
+   * -   (put back in front, see DBBE_OPCODE_FLAGS_HEAD)
+   */
+  stage = DBBE_REDIS_PUT_STAGE_HEAD;
+  index = op * DBBE_REDIS_COMMAND_STAGE_MAX + stage;
+  s = &specs[ index ];
+  s->_array_len = 2;
+  s->_resp_cnt = 1;
+  s->_final = 1;
+  s->_result = 1;
+  s->_expect = dbBE_REDIS_TYPE_INT; // will return integer of inserted keys
+  strcpy( s->_command, "*3\r\n$5\r\nLPUSH\r\n%0%1" );
+  s->_stage = stage;
+
   /*
    * Get
    * - LPOP ns_name::t_name
@@ -77,7 +94,7 @@ dbBE_Redis_command_stage_spec_t* dbBE_Redis_command_stages_spec_init()
    *
    */
   op = DBBE_OPCODE_GET;
-  stage = 0;
+  stage = DBBE_REDIS_RETRIEVE_STAGE_POLL;
   index = op * DBBE_REDIS_COMMAND_STAGE_MAX + stage;
   s = &specs[ index ];
   s->_array_len = 1;
@@ -88,12 +105,27 @@ dbBE_Redis_command_stage_spec_t* dbBE_Redis_command_stages_spec_init()
   strcpy( s->_command, "*2\r\n$4\r\nLPOP\r\n%0" );
   s->_stage = stage;
 
+  /*
+   * - BLPOP ns_name::t_name <timeout>
+   * -   (only sent on a dedicated connection after LPOP found nothing)
+   */
+  stage = DBBE_REDIS_RETRIEVE_STAGE_BLOCK;
+  index = op * DBBE_REDIS_COMMAND_STAGE_MAX + stage;
+  s = &specs[ index ];
+  s->_array_len = 1;
+  s->_resp_cnt = 1;
+  s->_final = 1;
+  s->_result = 1;
+  s->_expect = dbBE_REDIS_TYPE_CHAR; // returns [ key, value ] which is unwrapped to the value before processing
+  strcpy( s->_command, "*3\r\n$5\r\nBLPOP\r\n%0$1\r\n" DBBE_REDIS_BLOCKING_TIMEOUT "\r\n" );
+  s->_stage = stage;
+
   /*
    * read
    * - LINDEX ns_name::t_name <index>
    */
   op = DBBE_OPCODE_READ;
-  stage = 0;
+  stage = DBBE_REDIS_RETRIEVE_STAGE_POLL;
   index = op * DBBE_REDIS_COMMAND_STAGE_MAX + stage;
   s = &specs[ index ];
   s->_array_len = 2;
@@ -104,6 +136,22 @@ dbBE_Redis_command_stage_spec_t* dbBE_Redis_command_stages_spec_init()
   strcpy( s->_command, "*3\r\n$6\r\nLINDEX\r\n%0%1" );
   s->_stage = stage;
 
+  /*
+   * - BLMOVE ns_name::t_name ns_name::t_name LEFT LEFT <timeout>
+   * -   (moving the head onto itself leaves the list unchanged and returns the head;
+   * -    only used for index 0 on a dedicated connection after LINDEX found nothing)
+   */
+  stage = DBBE_REDIS_RETRIEVE_STAGE_BLOCK;
+  index = op * DBBE_REDIS_COMMAND_STAGE_MAX + stage;
+  s = &specs[ index ];
+  s->_array_len = 1;
+  s->_resp_cnt = 1;
+  s->_final = 1;
+  s->_result = 1;
+  s->_expect = dbBE_REDIS_TYPE_CHAR; // will return char buffer
+  strcpy( s->_command, "*6\r\n$6\r\nBLMOVE\r\n%0%0$4\r\nLEFT\r\n$4\r\nLEFT\r\n$1\r\n" DBBE_REDIS_BLOCKING_TIMEOUT "\r\n" );
+  s->_stage = stage;
+
   /*
    * * Directory
    * - HGETALL <namespace>
@@ -316,6 +364,22 @@ dbBE_Redis_command_stage_spec_t* dbBE_Redis_command_stages_spec_init()
   strcpy( s->_command, "*2\r\n$3\r\nDEL\r\n%0" );
   s->_stage = stage;
 
+  /*
+   * TestKey command
+   * - EXISTS ns_name::key
+   */
+  op = DBBE_OPCODE_TESTKEY;
+  stage = 0;
+  index = op * DBBE_REDIS_COMMAND_STAGE_MAX + stage;
+  s = &specs[ index ];
+  s->_array_len = 1;
+  s->_resp_cnt = 1;
+  s->_final = 1;
+  s->_result = 1;
+  s->_expect = dbBE_REDIS_TYPE_INT; // will return number of existing keys: 0 or 1
+  strcpy( s->_command, "*2\r\n$6\r\nEXISTS\r\n%0" );
+  s->_stage = stage;
+
   /*
    * Move command
    * - dump <ns>::<tuplename>              (whole value, old place)
@@ -377,11 +441,73 @@ dbBE_Redis_command_stage_spec_t* dbBE_Redis_command_stages_spec_init()
   strcpy( s->_command, "*6\r\n$4\r\nSCAN\r\n%0$5\r\nMATCH\r\n%1$5\r\nCOUNT\r\n$2\r\n10\r\n" );
   s->_stage = stage;
 
+  // compile the command strings so that request creation doesn't need to parse them
+  for( index = 0; index < total_stages; ++index )
+  {
+    if( specs[ index ]._command[0] == '\0' )
+      continue;
+    if( dbBE_Redis_command_stage_compile( &specs[ index ] ) < 0 )
+    {
+      LOG( DBG_ERR, stderr, "Invalid Redis command spec for opcode %d stage %d\n",
+           index / DBBE_REDIS_COMMAND_STAGE_MAX, index % DBBE_REDIS_COMMAND_STAGE_MAX );
+      free( specs );
+      --gRedis_command_spec_refcnt;
+      return NULL;
+    }
+  }
+
   gRedis_command_spec = specs;
 
   return specs;
 }
 
+int dbBE_Redis_command_stage_compile( dbBE_Redis_command_stage_spec_t *stage )
+{
+  if( stage == NULL )
+    return -EINVAL;
+
+  size_t cmdlen = strnlen( stage->_command, DBBE_REDIS_COMMAND_LENGTH_MAX );
+  if( cmdlen >= DBBE_REDIS_COMMAND_LENGTH_MAX )
+    return -EBADMSG;
+
+  int cnt = 0;
+  size_t start = 0;
+  size_t pos;
+  for( pos = 0; pos <= cmdlen; ++pos )
+  {
+    if(( pos < cmdlen ) && ( stage->_command[ pos ] != '%' ))
+      continue;
+
+    // close the fixed string before the placeholder or the end of the command
+    if( pos > start )
+    {
+      if( cnt >= DBBE_REDIS_COMMAND_SEGMENTS_MAX )
+        return -EBADMSG;
+      stage->_segments[ cnt ]._arg = DBBE_REDIS_COMMAND_SEGMENT_FIXED;
+      stage->_segments[ cnt ]._offset = start;
+      stage->_segments[ cnt ]._len = pos - start;
+      ++cnt;
+    }
+    if( pos == cmdlen )
+      break;
+
+    int idx = (int)stage->_command[ pos + 1 ] - '0';
+    if(( idx < 0 ) || ( idx >= stage->_array_len ) || ( cnt >= DBBE_REDIS_COMMAND_SEGMENTS_MAX ))
+      return -EBADMSG;
+    stage->_segments[ cnt ]._arg = idx;
+    stage->_segments[ cnt ]._offset = pos;
+    stage->_segments[ cnt ]._len = 0;
+    ++cnt;
+
+    ++pos; // skip the index digit
+    start = pos + 1;
+  }
+
+  stage->_command_len = cmdlen;
+  stage->_segment_cnt = cnt;
+  return cnt;
+}
+
 void dbBE_Redis_command_stages_spec_destroy( dbBE_Redis_command_stage_spec_t *specs )
 {
   --gRedis_command_spec_refcnt;
@@ -39,6 +39,26 @@
 #define DBBE_REDIS_COMMAND_ARGS_MAX ( 6 )
 
 
+/*
+ * enumeration of the put variants
+ * only one of them is used per request, selected by DBBE_OPCODE_FLAGS_HEAD
+ */
+typedef enum
+{
+  DBBE_REDIS_PUT_STAGE_TAIL = 0,
+  DBBE_REDIS_PUT_STAGE_HEAD = 1
+} dbBE_Redis_put_stages_t;
+
+/*
+ * enumeration of the get/read stages
+ * a missing tuple switches from polling to a server-side blocking command
+ */
+typedef enum
+{
+  DBBE_REDIS_RETRIEVE_STAGE_POLL = 0,
+  DBBE_REDIS_RETRIEVE_STAGE_BLOCK = 1
+} dbBE_Redis_retrieve_stages_t;
+
 /*
  * enumeration of the directory scan stages
  */
@@ -79,6 +99,27 @@ typedef enum
   DBBE_REDIS_MOVE_STAGE_DEL = 2
 } dbBE_Redis_move_stages_t;
 
+/*
+ * max number of segments (fixed strings and argument slots) of a compiled command
+ */
+#define DBBE_REDIS_COMMAND_SEGMENTS_MAX ( 16 )
+
+/*
+ * marks a segment of a compiled command as fixed string
+ */
+#define DBBE_REDIS_COMMAND_SEGMENT_FIXED ( -1 )
+
+/*
+ * a segment of a compiled command:
+ * either a fixed part of the command string or the slot of an argument
+ */
+typedef struct
+{
+  int16_t _arg; // index of the argument or DBBE_REDIS_COMMAND_SEGMENT_FIXED
+  uint16_t _offset; // start of the fixed string in _command
+  uint16_t _len; // length of the fixed string
+} dbBE_Redis_command_segment_t;
+
 /*
  * holds the generic spec of a command stage
  * - stage number
@@ -94,6 +135,9 @@ typedef struct dbBE_Redis_command_stage_spec
   uint8_t _result; // is it the result-stage of this command?
   dbBE_REDIS_DATA_TYPE _expect; // what result type to expect for this stage
   char _command[ DBBE_REDIS_COMMAND_LENGTH_MAX ]; // Redis command string
+  uint16_t _command_len; // length of the command string
+  uint8_t _segment_cnt; // number of segments of the compiled command
+  dbBE_Redis_command_segment_t _segments[ DBBE_REDIS_COMMAND_SEGMENTS_MAX ]; // compiled command
 } dbBE_Redis_command_stage_spec_t;
 
 extern dbBE_Redis_command_stage_spec_t *gRedis_command_spec;
@@ -104,6 +148,13 @@ extern dbBE_Redis_command_stage_spec_t *gRedis_command_spec;
  */
 dbBE_Redis_command_stage_spec_t* dbBE_Redis_command_stages_spec_init();
 
+/*
+ * compile the command string of a stage into a sequence of fixed strings and argument slots
+ * (%N in the command string refers to argument N)
+ * returns the number of segments or -EBADMSG if the command string is invalid
+ */
+int dbBE_Redis_command_stage_compile( dbBE_Redis_command_stage_spec_t *stage );
+
 /*
  * destroy the stage specs (if refcount is 0)
  */
@@ -66,7 +66,12 @@ void* dbBE_Redis_receiver( void *args )
   //  - on the receive buffers/Redis sockets
   //  - on a notification/wake-up pipe for cancellations/urgent matters
 
-  int receive_limit = 128 * 1024 * 1024;
+  // responses don't outlive the receiver pass (data that's kept is copied during processing)
+  // so the array entries of the previous pass can all go at once
+  dbBE_Arena_reset( input->_backend->_result_arena );
+
+  // one buffer per turn and ready connection, bounded by the budget
+  int receive_budget = input->_backend->_receive_budget;
   dbBE_Redis_connection_t *conn = NULL;
 
 receive_more_responses:
@@ -76,8 +81,25 @@ receive_more_responses:
     goto skip_receiving;
 
   dbBE_Redis_sr_buffer_t *sr_buf = dbBE_Transport_dbuffer_get_active( conn->_recvbuf );
+  dbBE_Redis_request_t *request = NULL;
+  dbBE_Redis_result_t result;
+  memset( &result, 0, sizeof( dbBE_Redis_result_t ) );
+
+  // assume this is a new request
+  int responses_remain = 0;
+
+  // a value that's still arriving goes straight to its destination, the recv buffer takes what follows it
+  if( dbBE_Redis_connection_bulk_request( conn ) != NULL )
+  {
+    request = dbBE_Redis_connection_bulk_request( conn );
+    responses_remain = conn->_bulk_responses;
+    rc = dbBE_Redis_process_bulk( request, &result, conn );
+    if( rc == -EINPROGRESS )
+      goto next_connection;
+    sr_buf = dbBE_Transport_dbuffer_get_active( conn->_recvbuf );
+    goto process_result;
+  }
 
-  receive_limit = dbBE_Transport_sr_buffer_get_size( sr_buf );
   rc = dbBE_Redis_connection_recv( conn, sr_buf );
   if( rc <= 0 )
   {
@@ -94,37 +116,33 @@ receive_more_responses:
       default:
         LOG( DBG_ERR, stderr, "Recv from conn %d returned %d\n", conn->_index, rc );
 
-        // drain the posted queue of this connection and place the requests for retry
-        dbBE_Redis_request_t *request;
+        // drain the posted and held queues of this connection and place the requests for retry
         while( ( request = dbBE_Redis_s2r_queue_pop( conn->_posted_q ) ) != NULL )
         {
           dbBE_Redis_s2r_queue_push( input->_backend->_retry_q, request );
         }
+        while( ( request = dbBE_Redis_s2r_queue_pop( conn->_held_q ) ) != NULL )
+        {
+          dbBE_Redis_s2r_queue_push( input->_backend->_retry_q, request );
+        }
         // remove the connection from the locator index
         dbBE_Redis_locator_reassociate_conn_index( input->_backend->_locator,
                                                    conn->_index,
                                                    DBBE_REDIS_LOCATOR_INDEX_INVAL );
 
-        // remove the connection from the connection mgr
+        // remove the connection from the connection mgr (dedicated and pooled ones are destroyed)
         dbBE_Redis_connection_mgr_conn_fail( input->_backend->_conn_mgr, conn );
+        conn = NULL;
 
         // todo: cancel all remaining requests for cleanup
 
         // intentionally no break
       case 0:
-        goto skip_receiving;
+        goto next_connection;
         break;
     }
   }
 
-  dbBE_Redis_request_t *request = NULL;
-  dbBE_Redis_result_t result;
-  memset( &result, 0, sizeof( dbBE_Redis_result_t ) );
-
-  // assume this is a new request
-  int responses_remain = 0;
-  receive_limit -= rc;
-
 process_next_item:
 
   // when we received something:
@@ -137,7 +155,7 @@ process_next_item:
     LOG( DBG_ERR, stderr, "Serious backend protocol error. Expected posted request, but nothing found\n" );
     // todo: instead of skipping, generate an asynchronous error (i.e. one that doesn't belong to a request)
     // alternative: cancell all requests
-    goto skip_receiving;
+    goto next_connection;
   }
 
   LOG( DBG_TRACE, stderr, "Processing request op=%d on conn %d\n", request->_user->_opcode, conn->_index );
@@ -150,24 +168,22 @@ process_next_item:
   // parse buffer for next complete response including nested arrays
   dbBE_Redis_result_cleanup( &result, 0 );
 
-
-
-
-
-
-
-
+  // memcpy transport is not ready for partial string result handling
+  // blocking pops return the value as the last element of an array which can be a partial string too
+  dbBE_Redis_parse_partial_t partial = DBBE_REDIS_PARSE_PARTIAL_STRING;
+  if( input->_backend->_transport == &dbBE_Memcopy_transport )
+    partial = DBBE_REDIS_PARSE_PARTIAL_NONE;
+  else if( dbBE_Redis_request_is_blocking( request ) )
+    partial = DBBE_REDIS_PARSE_PARTIAL_TAIL;
+
+  // the parser state keeps the already parsed part of an incomplete response
+  // so only newly received data is parsed after recv_more()
+  dbBE_Redis_parse_state_t parse_state;
+  dbBE_Redis_parse_state_init( &parse_state, &result, partial );
+  parse_state._arena = input->_backend->_result_arena;
 
   sr_buf = dbBE_Transport_dbuffer_get_active( conn->_recvbuf );
-  rc = dbBE_Redis_parse_sr_buffer( sr_buf, &result );
-
-  // memcpy transport is not ready for partial string result handling
-  if(( result._type == dbBE_REDIS_TYPE_STRING_PART ) && ( input->_backend->_transport == &dbBE_Memcopy_transport ))
-  {
-    // restore parsing position for the next loop
-    dbBE_Transport_sr_buffer_rewind_processed_to( sr_buf, dbBE_Transport_sr_buffer_get_start( sr_buf ) );
-    rc = -EAGAIN;
-  }
+  rc = dbBE_Redis_parse_sr_buffer_resume( &parse_state, sr_buf );
 
   while( rc == -EAGAIN )
   {
@@ -177,15 +193,7 @@ process_next_item:
     {
       rc = -EAGAIN;
     }
-    rc = dbBE_Redis_parse_sr_buffer( sr_buf, &result );
-
-    // memcpy transport is not ready for partial string result handling
-    if(( result._type == dbBE_REDIS_TYPE_STRING_PART ) && ( input->_backend->_transport == &dbBE_Memcopy_transport ))
-    {
-      // restore parsing position for the next loop
-      dbBE_Transport_sr_buffer_rewind_processed_to( sr_buf, dbBE_Transport_sr_buffer_get_start( sr_buf ) );
-      rc = -EAGAIN;
-    }
+    rc = dbBE_Redis_parse_sr_buffer_resume( &parse_state, sr_buf );
   }
 
   // decide:
@@ -248,7 +256,8 @@ process_next_item:
             // remove the connection from the connection mgr
             // todo: drain the response pipe to avoid stuck requests
             dbBE_Redis_connection_mgr_rm( input->_backend->_conn_mgr, conn );
-            goto skip_receiving;
+            conn = NULL;
+            goto next_connection;
           }
           case 1:
           {
@@ -269,7 +278,7 @@ process_next_item:
               {
                 fprintf( stderr, "RedisBE: Failed to create error completion.\n");
                 dbBE_Redis_result_cleanup( &result, 0 );
-                goto skip_receiving;
+                goto next_connection;
               }
             }
             // update the connection slot in new destination
@@ -309,8 +318,19 @@ process_next_item:
             rc = dbBE_Redis_process_put( request, &result );
             break;
 
-          case DBBE_OPCODE_GET:
           case DBBE_OPCODE_READ:
+            // servers without BLMOVE reject the blocking read: fall back to polling for good
+            if( dbBE_Redis_request_is_blocking( request ) && ( result._type == dbBE_REDIS_TYPE_ERROR ))
+            {
+              LOG( DBG_INFO, stderr, "Server-side blocking read unavailable: %s. Falling back to polling.\n",
+                   result._data._string._data );
+              input->_backend->_blocking_read = 0;
+              dbBE_Redis_request_set_polling( request );
+              rc = -EAGAIN;
+              break;
+            }
+            // intentionally no break
+          case DBBE_OPCODE_GET:
             rc = dbBE_Redis_process_get( request, &result, input->_backend->_transport, conn );
             break;
 
@@ -318,6 +338,10 @@ process_next_item:
             rc = dbBE_Redis_process_remove( request, &result );
             break;
 
+          case DBBE_OPCODE_TESTKEY:
+            rc = dbBE_Redis_process_testkey( request, &result );
+            break;
+
           case DBBE_OPCODE_MOVE:
             rc = dbBE_Redis_process_move( request, &result, conn );
             break;
@@ -330,7 +354,7 @@ process_next_item:
             break;
           case DBBE_OPCODE_NSCREATE:
             rc = dbBE_Redis_process_nscreate( request, &result );
-            rc = dbBE_Redis_process_nshandling( &input->_backend->_namespaces, request, &result, rc );
+            rc = dbBE_Redis_process_nshandling( input->_backend->_namespaces, request, &result, rc );
             break;
 
           case DBBE_OPCODE_NSQUERY:
@@ -339,7 +363,7 @@ process_next_item:
 
           case DBBE_OPCODE_NSATTACH:
             rc = dbBE_Redis_process_nsattach( request, &result );
-            rc = dbBE_Redis_process_nshandling( &input->_backend->_namespaces, request, &result, rc );
+            rc = dbBE_Redis_process_nshandling( input->_backend->_namespaces, request, &result, rc );
             break;
 
           case DBBE_OPCODE_NSDETACH:
@@ -349,8 +373,7 @@ process_next_item:
                                               responses_remain );
             if(( rc == 0 ) && ( request != NULL ) && ( request->_step->_final != 0 ))
             {
-              dbBE_Redis_namespace_list_t *tmp = dbBE_Redis_namespace_list_remove( input->_backend->_namespaces, request->_user->_ns_hdl );
-              input->_backend->_namespaces = tmp;
+              dbBE_Redis_namespace_table_remove( input->_backend->_namespaces, request->_user->_ns_hdl );
             }
             break;
 
@@ -373,6 +396,14 @@ process_next_item:
 
         }
 
+        // the value is still arriving: the connection keeps the request until it's complete
+        if( rc == -EINPROGRESS )
+        {
+          conn->_bulk_responses = responses_remain;
+          goto next_connection;
+        }
+
+process_result:
         // there are cases where requests get modified and re-queued or completed in a request-specific way
         if( request == NULL )
           break;
@@ -399,7 +430,7 @@ process_next_item:
               LOG( DBG_ERR, stderr, "RedisBE: Failed to create completion.\n");
               dbBE_Redis_result_cleanup( &result, 0 );
               dbBE_Redis_request_destroy( request );
-              goto skip_receiving;
+              goto next_connection;
             }
           }
 
@@ -411,9 +442,12 @@ process_next_item:
           }
           else // final stage
           {
+            // a cancel that arrives while the last response is in flight is too late;
+            // drop it so it can't hit a later request that reuses the same memory
+            dbBE_Request_set_delete( input->_backend->_cancellations, request->_user );
             if( dbBE_Completion_queue_push( input->_backend->_compl_q, request->_completion ) != 0 )
             {
-              free( request->_completion );
+              dbBE_Redis_completion_release( &input->_backend->_pools, request->_completion );
               dbBE_Redis_request_destroy( request );
               LOG( DBG_ERR, stderr, "RedisBE: Failed to queue completion in final request stage.\n" );
               // todo: save the status to mark the request for cleanup during the next stages
@@ -427,6 +461,8 @@ process_next_item:
           if( rc == -EAGAIN ) // EAGAIN is special for requests with polling or flags
           {
             dbBE_Redis_result_cleanup( &result, 0 );
+            // instead of polling again, wait for the data on the server side (if possible)
+            dbBE_Redis_request_set_blocking( request, input->_backend->_blocking_read );
             dbBE_Redis_s2r_queue_push( input->_backend->_retry_q, request );
             LOG( DBG_TRACE, stderr, "EAGAIN in parsing op=%d conn %d; remaining data=%ld\n", request->_user->_opcode,
                  conn->_index, dbBE_Transport_sr_buffer_unprocessed( sr_buf ) );
@@ -438,7 +474,7 @@ process_next_item:
               goto process_next_item;
             }
             else
-              goto skip_receiving;
+              goto next_connection;
           }
 
           // first pull any potentially existing completion from previous result stage(s) and clean it up
@@ -446,23 +482,24 @@ process_next_item:
           if( completion != NULL )
           {
             memset( completion, 0, sizeof( dbBE_Completion_t ) );
-            free( completion );
+            dbBE_Redis_completion_release( &input->_backend->_pools, completion );
           }
 
           completion = dbBE_Redis_complete_command(
               request,
               &result,
               rc );
+          dbBE_Request_set_delete( input->_backend->_cancellations, request->_user );
           dbBE_Redis_request_destroy( request );
           if( completion == NULL )
           {
             fprintf( stderr, "RedisBE: Failed to create error completion.\n");
             dbBE_Redis_result_cleanup( &result, 0 );
-            goto skip_receiving;
+            goto next_connection;
           }
           if( dbBE_Completion_queue_push( input->_backend->_compl_q, completion ) != 0 )
           {
-            free( completion );
+            dbBE_Redis_completion_release( &input->_backend->_pools, completion );
             dbBE_Redis_request_destroy( request );
             fprintf( stderr, "RedisBE: Failed to queue completion.\n" );
             // todo: save the status to mark the request for cleanup during the next stages
@@ -489,7 +526,12 @@ process_next_item:
   }
   dbBE_Redis_result_cleanup( &result, 0 );
 
-  if( receive_limit > 0 )
+next_connection:
+  // a connection that filled the buffer may have more data waiting; it goes to the end of the line
+  if(( conn != NULL ) && ( dbBE_Redis_connection_get_status( conn ) == DBBE_CONNECTION_STATUS_PENDING_DATA ))
+    dbBE_Redis_connection_mgr_requeue_active( input->_backend->_conn_mgr, conn );
+
+  if( --receive_budget > 0 )
     goto receive_more_responses;
 
 skip_receiving:
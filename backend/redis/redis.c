@@ -45,7 +45,9 @@ const dbBE_api_t dbBE =
       .post = Redis_post,
       .cancel = Redis_cancel,
       .test = Redis_test,
-      .test_any = Redis_test_any
+      .test_any = Redis_test_any,
+      .release = Redis_release,
+      .event_fd = Redis_event_fd
     };
 
 /*
@@ -62,6 +64,13 @@ dbBE_Handle_t Redis_initialize(void)
 
   memset( context, 0, sizeof( dbBE_Redis_context_t ) );
 
+  if( dbBE_Redis_request_pools_init( &context->_pools ) != 0 )
+  {
+    LOG( DBG_ERR, stderr, "dbBE_Redis_context_t::initialize: Failed to allocate request pools.\n" );
+    free( context );
+    return NULL;
+  }
+
   // protocol spec allocation
   dbBE_Redis_command_stage_spec_t *spec = dbBE_Redis_command_stages_spec_init();
   if( spec == NULL )
@@ -125,7 +134,21 @@ dbBE_Handle_t Redis_initialize(void)
 
   context->_cancellations = cancel;
 
-  dbBE_Redis_sr_buffer_t *sbuf = dbBE_Transport_sr_buffer_allocate( DBBE_REDIS_SR_BUFFER_LEN );
+  char *limit_env = dbBE_Extract_env( DBR_BUFFER_LIMIT_ENV, DBR_BUFFER_LIMIT_DEFAULT );
+  long long limit_mb = ( limit_env != NULL ) ? strtoll( limit_env, NULL, 10 ) : 0;
+  size_t buffer_limit = ( limit_mb > 0 ) ? (size_t)limit_mb * 1048576 : 0;
+  free( limit_env );
+  context->_sender_buffer_max = ( buffer_limit > 0 ) ? buffer_limit : DBBE_REDIS_SR_BUFFER_LEN;
+
+  char *huge_env = dbBE_Extract_env( DBR_HUGEPAGES_ENV, DBR_HUGEPAGES_DEFAULT );
+  context->_hugepages = ( huge_env != NULL ) ? ( strtol( huge_env, NULL, 10 ) != 0 ) : 0;
+  free( huge_env );
+
+  // starts small, the sender grows it on demand up to _sender_buffer_max
+  size_t sbuf_len = DBBE_REDIS_SENDER_BUFFER_MIN;
+  if( sbuf_len > context->_sender_buffer_max )
+    sbuf_len = context->_sender_buffer_max;
+  dbBE_Redis_sr_buffer_t *sbuf = dbBE_Transport_sr_buffer_allocate( sbuf_len );
   if( sbuf == NULL )
   {
     LOG( DBG_ERR, stderr, "dbBE_Redis_context_t::initialize: Failed to allocate sender buffer.\n" );
@@ -135,7 +158,17 @@ dbBE_Handle_t Redis_initialize(void)
 
   context->_sender_buffer = sbuf;
 
-  int *sender_conns = (int*)calloc( DBBE_REDIS_COALESCED_MAX * DBBE_REDIS_MAX_CONNECTIONS + 1, sizeof( int ));
+  dbBE_Arena_t *arena = dbBE_Arena_create( DBBE_REDIS_RESULT_ARENA_CHUNK, DBBE_REDIS_RESULT_ARENA_KEEP );
+  if( arena == NULL )
+  {
+    LOG( DBG_ERR, stderr, "dbBE_Redis_context_t::initialize: Failed to allocate result arena.\n" );
+    Redis_exit( context );
+    return NULL;
+  }
+
+  context->_result_arena = arena;
+
+  int *sender_conns = (int*)calloc( DBBE_REDIS_COALESCED_MAX * DBBE_REDIS_MAX_TRACKED_CONNECTIONS + 1, sizeof( int ));
   if( sender_conns == NULL )
   {
     LOG( DBG_ERR, stderr, "dbBE_Redis_context_t::initialize: Failed to allocate sender connection array.\n" );
@@ -144,6 +177,16 @@ dbBE_Handle_t Redis_initialize(void)
   }
 
   context->_sender_connections = sender_conns;
+  char *blocking_env = dbBE_Extract_env( DBR_BLOCKING_POP_ENV, DBR_BLOCKING_POP_DEFAULT );
+  // enabled until the server proves otherwise
+  context->_blocking_read = ( blocking_env != NULL ) ? ( strtol( blocking_env, NULL, 10 ) != 0 ) : 1;
+  free( blocking_env );
+
+  char *budget_env = dbBE_Extract_env( DBR_RECEIVE_BUDGET_ENV, DBR_RECEIVE_BUDGET_DEFAULT );
+  context->_receive_budget = ( budget_env != NULL ) ? (int)strtol( budget_env, NULL, 10 ) : 0;
+  if( context->_receive_budget <= 0 )
+    context->_receive_budget = DBBE_REDIS_MAX_TRACKED_CONNECTIONS;
+  free( budget_env );
 
   dbBE_Data_transport_t *transport = &dbBE_Smallcopy_transport;
   context->_transport = transport;
@@ -152,6 +195,12 @@ dbBE_Handle_t Redis_initialize(void)
   dbBE_Redis_conn_mgr_config_t config;
   config._rbuf_len = transport->_recv_buffer_len;
   config._sbuf_len = transport->_send_buffer_len;
+  config._scrap_max = buffer_limit;
+  config._hugepages = context->_hugepages;
+
+  char *pool_env = dbBE_Extract_env( DBR_SERVER_CONNECTIONS_ENV, DBR_SERVER_DEFAULT_CONNECTIONS );
+  config._pool_size = ( pool_env != NULL ) ? (int)strtol( pool_env, NULL, 10 ) : 1;
+  free( pool_env );
 
   // create connection mgr
   dbBE_Redis_connection_mgr_t *conn_mgr = dbBE_Redis_connection_mgr_init( &config );
@@ -164,8 +213,14 @@ dbBE_Handle_t Redis_initialize(void)
 
   context->_conn_mgr = conn_mgr;
 
-  // initialize an empty list of namespaces
-  context->_namespaces = NULL;
+  // initialize an empty table of namespaces
+  context->_namespaces = dbBE_Redis_namespace_table_create();
+  if( context->_namespaces == NULL )
+  {
+    LOG( DBG_ERR, stderr, "dbBE_Redis_context_t::initialize: Failed to initialize namespace table\n" );
+    Redis_exit( context );
+    return NULL;
+  }
 
   dbBE_Redis_iterator_list_t iterators = dbBE_Redis_iterator_list_allocate();
   if( iterators == NULL )
@@ -184,6 +239,22 @@ dbBE_Handle_t Redis_initialize(void)
     return NULL;
   }
 
+  // optional progress thread; started last because it immediately starts driving the connections
+  char *progress_env = dbBE_Extract_env( DBR_PROGRESS_THREAD_ENV, DBR_PROGRESS_THREAD_DEFAULT );
+  if(( progress_env != NULL ) && ( strtol( progress_env, NULL, 10 ) != 0 ))
+  {
+    context->_progress = dbBE_Redis_progress_create( DBBE_REDIS_WORK_QUEUE_DEPTH );
+    if(( context->_progress == NULL ) || ( dbBE_Redis_progress_start( context->_progress, context ) != 0 ))
+    {
+      LOG( DBG_ERR, stderr, "dbBE_Redis_context_t::initialize: Failed to start progress thread.\n" );
+      free( progress_env );
+      Redis_exit( context );
+      return NULL;
+    }
+  }
+  if( progress_env != NULL )
+    free( progress_env );
+
   return (dbBE_Handle_t*)context;
 }
 
@@ -197,6 +268,13 @@ int Redis_exit( dbBE_Handle_t be )
   if( be != NULL )
   {
     dbBE_Redis_context_t *context = (dbBE_Redis_context_t*)be;
+    // the progress thread has to be gone before anything else is torn down
+    if( context->_progress != NULL )
+    {
+      temp = dbBE_Redis_progress_destroy( context->_progress );
+      if(( temp != 0 ) && ( rc == 0 )) rc = temp;
+      context->_progress = NULL;
+    }
     dbBE_Redis_connection_mgr_exit( context->_conn_mgr );
     temp = dbBE_Redis_iterator_list_destroy( context->_iterators );
     if(( temp != 0 ) && ( rc == 0 )) rc = temp;
@@ -206,11 +284,13 @@ int Redis_exit( dbBE_Handle_t be )
     if(( temp != 0 ) && ( rc == 0 )) rc = temp;
     temp = dbBE_Redis_cluster_info_destroy( context->_cluster_info );
     if(( temp != 0 ) && ( rc == 0 )) rc = temp;
-    temp = dbBE_Redis_namespace_list_clean( context->_namespaces );
+    temp = dbBE_Redis_namespace_table_destroy( context->_namespaces );
     if(( temp != 0 ) && ( rc == 0 )) rc = temp;
     if( context->_sender_connections != NULL )
       free( context->_sender_connections );
     dbBE_Transport_sr_buffer_free( context->_sender_buffer );
+    if( context->_result_arena != NULL )
+      dbBE_Arena_destroy( context->_result_arena );
     temp = dbBE_Redis_s2r_queue_destroy( context->_retry_q );
     if(( temp != 0 ) && ( rc == 0 )) rc = temp;
     temp = dbBE_Completion_queue_destroy( context->_compl_q );
@@ -218,13 +298,9 @@ int Redis_exit( dbBE_Handle_t be )
     temp = dbBE_Request_queue_destroy( context->_work_q );
     if(( temp != 0 ) && ( rc == 0 )) rc = temp;
     dbBE_Redis_command_stages_spec_destroy( context->_spec );
+    dbBE_Redis_request_pools_exit( &context->_pools );
     memset( context, 0, sizeof( dbBE_Redis_context_t ) );
     free( context );
-    if( gScrapSpace != NULL )
-    {
-      free( gScrapSpace );
-      gScrapSpace = NULL;
-    }
     context = NULL;
   }
 
@@ -244,6 +320,7 @@ int dbBE_Redis_request_sanity_check( dbBE_Request_t *request )
         rc = dbBE_Redis_namespace_validate( request->_ns_hdl );
       break;
     case DBBE_OPCODE_REMOVE:
+    case DBBE_OPCODE_TESTKEY:
     case DBBE_OPCODE_GET:
     case DBBE_OPCODE_READ:
     case DBBE_OPCODE_PUT:
@@ -305,6 +382,18 @@ dbBE_Request_handle_t Redis_post( dbBE_Handle_t be,
 
   dbBE_Redis_context_t *rbe = ( dbBE_Redis_context_t* )be;
 
+  // with a progress thread, just hand the request over; the thread does the rest
+  if( rbe->_progress != NULL )
+  {
+    int rc = dbBE_Redis_progress_post( rbe->_progress, request );
+    if( rc != 0 )
+    {
+      errno = -rc;
+      return NULL;
+    }
+    return (dbBE_Request_handle_t*)request;
+  }
+
   // check if there's space in the queue
   if( dbBE_Request_queue_len( rbe->_work_q ) >= DBBE_REDIS_WORK_QUEUE_DEPTH )
   {
@@ -345,6 +434,9 @@ int Redis_cancel( dbBE_Handle_t be,
 
   if( dbBE_Request_set_insert( rbe->_cancellations, be_req ) == ENOSPC )
     return EAGAIN;
+  // a blocked progress thread wouldn't see the cancellation before the next socket event
+  if( rbe->_progress != NULL )
+    dbBE_Redis_progress_notify( rbe->_progress );
   return 0;
 }
 
@@ -373,6 +465,14 @@ dbBE_Completion_t* Redis_test_any( dbBE_Handle_t be )
 
   dbBE_Redis_context_t *rbe = ( dbBE_Redis_context_t* )be;
 
+  if( rbe->_progress != NULL )
+  {
+    dbBE_Completion_t *compl = dbBE_Redis_progress_fetch( rbe->_progress );
+    if( compl == NULL )
+      errno = EAGAIN;
+    return compl;
+  }
+
   if( dbBE_Completion_queue_len( rbe->_compl_q ) == 0 )
   {
     // if completion queue is empty, see if we can make some progress on requests to change that.
@@ -390,6 +490,32 @@ dbBE_Completion_t* Redis_test_any( dbBE_Handle_t be )
   return compl;
 }
 
+/*
+ * return a processed completion for reuse
+ */
+void Redis_release( dbBE_Handle_t be, dbBE_Completion_t *compl )
+{
+  dbBE_Redis_context_t *rbe = (dbBE_Redis_context_t*)be;
+  dbBE_Redis_completion_release( ( rbe != NULL ) ? &rbe->_pools : NULL, compl );
+}
+
+int Redis_event_fd( dbBE_Handle_t be )
+{
+  dbBE_Redis_context_t *rbe = (dbBE_Redis_context_t*)be;
+  if( rbe == NULL )
+    return -EINVAL;
+
+  if( rbe->_progress != NULL )
+    return dbBE_Redis_progress_arm( rbe->_progress );
+
+  // without socket events, queued work would only be picked up by the next test_any()
+  if(( dbBE_Completion_queue_len( rbe->_compl_q ) > 0 ) ||
+     ( dbBE_Request_queue_len( rbe->_work_q ) > 0 ) ||
+     ( dbBE_Redis_s2r_queue_len( rbe->_retry_q ) > 0 ))
+    return -EAGAIN;
+  return dbBE_Redis_event_mgr_get_fd( rbe->_conn_mgr->_ev_mgr );
+}
+
 /*
  * create the initial connection to Redis with srbuffers by extracting the url from the ENV variable
  */
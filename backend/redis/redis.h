@@ -23,6 +23,7 @@
 #include "../common/completion_queue.h"
 #include "../common/request_set.h"
 #include "../common/data_transport.h"
+#include "../common/arena.h"
 
 #include "definitions.h"
 #include "protocol.h"
@@ -32,8 +33,9 @@
 #include "cluster_info.h"
 #include "namespacelist.h"
 #include "iterator.h"
+#include "progress.h"
 
-typedef struct
+typedef struct dbBE_Redis_context
 {
   dbBE_Redis_command_stage_spec_t *_spec;
   dbBE_Redis_cluster_info_t *_cluster_info;
@@ -42,14 +44,20 @@ typedef struct
   dbBE_Request_queue_t *_work_q;
   dbBE_Completion_queue_t *_compl_q;
   dbBE_Redis_s2r_queue_t *_retry_q;
+  dbBE_Redis_request_pools_t _pools;  // recycled requests and completions
   dbBE_Request_set_t *_cancellations;
   dbBE_Data_transport_t *_transport;
   dbBE_Redis_sr_buffer_t *_sender_buffer;
-  dbBE_Redis_namespace_list_t *_namespaces;
+  size_t _sender_buffer_max;  // limit for growing the sender buffer
+  int _hugepages;  // hint hugepages for large buffers
+  dbBE_Redis_namespace_table_t *_namespaces;
+  dbBE_Arena_t *_result_arena;  // array entries of parsed responses, reset per receiver pass
   int *_sender_connections;
+  int _blocking_read;  // 0 if blocking reads (BLMOVE) are disabled or unsupported by the server
+  int _receive_budget;  // max number of connection receives per receiver pass
   dbBE_Redis_iterator_list_t _iterators;
   // sender/receiver threads
-
+  dbBE_Redis_progress_t *_progress;  // optional progress thread (NULL: progress is driven by post/test_any)
 } dbBE_Redis_context_t;
 
 
@@ -89,6 +97,17 @@ dbBE_Completion_t* Redis_test( dbBE_Handle_t be,
  */
 dbBE_Completion_t* Redis_test_any( dbBE_Handle_t be );
 
+/*
+ * return a processed completion for reuse
+ */
+void Redis_release( dbBE_Handle_t be, dbBE_Completion_t *compl );
+
+/*
+ * return an fd to block on until test_any may find new completions
+ * (-EAGAIN: call test_any again, -ENOTSUP: no fd available)
+ */
+int Redis_event_fd( dbBE_Handle_t be );
+
 
 /**************************************************************************
  * non-API functions
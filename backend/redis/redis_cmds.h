@@ -56,19 +56,95 @@ int dbBE_Redis_command_microcmd_create( dbBE_Redis_command_stage_spec_t *stage,
   len += Redis_insert_to_sr_buffer( sr_buf, dbBE_REDIS_TYPE_ARRAY, data );
 
   data->_string._data = stage->_command;
-  data->_string._size = strnlen( stage->_command, DBBE_REDIS_COMMAND_LENGTH_MAX );
+  data->_string._size = stage->_command_len;
   len += Redis_insert_to_sr_buffer( sr_buf, dbBE_REDIS_TYPE_CHAR, data );
 
   return len;
 }
 
 
+/*
+ * write the decimal digits of value to buf (needs space for 20 chars)
+ * returns the number of digits
+ */
+static inline
+int dbBE_Redis_command_format_uint( char *buf, uint64_t value )
+{
+  char tmp[ 20 ];
+  int n = 0;
+  do
+  {
+    tmp[ n++ ] = '0' + (char)( value % 10 );
+    value /= 10;
+  } while( value > 0 );
+
+  int len = n;
+  while( n > 0 )
+    *buf++ = tmp[ --n ];
+  return len;
+}
+
+/*
+ * write the bulk string header "$<len>\r\n" to buf
+ * returns the number of bytes written or -E2BIG if it doesn't fit into space
+ */
+static inline
+int dbBE_Redis_command_insert_bulk_head( char *buf, size_t space, size_t len )
+{
+  if( space < 23 ) // '$' + max digits + terminator
+  {
+    char tmp[ 23 ];
+    int hlen = dbBE_Redis_command_insert_bulk_head( tmp, sizeof( tmp ), len );
+    if( (size_t)hlen > space )
+      return -E2BIG;
+    memcpy( buf, tmp, hlen );
+    return hlen;
+  }
+  buf[ 0 ] = '$';
+  int hlen = 1 + dbBE_Redis_command_format_uint( buf + 1, len );
+  buf[ hlen++ ] = '\r';
+  buf[ hlen++ ] = '\n';
+  return hlen;
+}
+
+/*
+ * write a complete bulk string entry of [prefix<separator>]name to buf
+ * prefix can be NULL to create an entry of just the name
+ * returns the number of bytes written or -EMSGSIZE if it doesn't fit into size
+ */
+static inline
+int dbBE_Redis_command_insert_key( char *buf, uint16_t size,
+                                   const char *prefix, size_t prefix_len,
+                                   const char *name, size_t name_len )
+{
+  size_t keylen = name_len;
+  if( prefix != NULL )
+    keylen += prefix_len + DBBE_REDIS_NAMESPACE_SEPARATOR_LEN;
+
+  int len = dbBE_Redis_command_insert_bulk_head( buf, size, keylen );
+  if(( len < 0 ) || ( len + keylen + 2 >= size ))
+    return -EMSGSIZE;
+
+  if( prefix != NULL )
+  {
+    memcpy( buf + len, prefix, prefix_len );
+    len += prefix_len;
+    memcpy( buf + len, DBBE_REDIS_NAMESPACE_SEPARATOR, DBBE_REDIS_NAMESPACE_SEPARATOR_LEN );
+    len += DBBE_REDIS_NAMESPACE_SEPARATOR_LEN;
+  }
+  memcpy( buf + len, name, name_len );
+  len += name_len;
+  buf[ len++ ] = '\r';
+  buf[ len++ ] = '\n';
+  buf[ len ] = '\0';
+  return len;
+}
+
 int dbBE_Redis_create_key_cmd( dbBE_Redis_request_t *request, char *keybuf, uint16_t size )
 {
   if( keybuf == NULL )
     return -EINVAL;
 
-  int len = 0;
   dbBE_Redis_namespace_t *ns = (dbBE_Redis_namespace_t*)request->_user->_ns_hdl;
   switch( request->_user->_opcode )
   {
@@ -76,44 +152,26 @@ int dbBE_Redis_create_key_cmd( dbBE_Redis_request_t *request, char *keybuf, uint
     case DBBE_OPCODE_GET:
     case DBBE_OPCODE_READ:
     case DBBE_OPCODE_REMOVE:
-    {
-      int keylen = strnlen( dbBE_Redis_namespace_get_name( ns ), size ) + DBBE_REDIS_NAMESPACE_SEPARATOR_LEN + strnlen( request->_user->_key, size );
-      len = snprintf( keybuf, size, "$%d\r\n%s%s%s\r\n",
-                      keylen,
-                      dbBE_Redis_namespace_get_name( ns ),
-                      DBBE_REDIS_NAMESPACE_SEPARATOR,
-                      request->_user->_key );
-      if(( len < 0 ) || ( len >= size ))
-        return -EMSGSIZE;
-      break;
-    }
+    case DBBE_OPCODE_TESTKEY:
+      return dbBE_Redis_command_insert_key( keybuf, size,
+                                            dbBE_Redis_namespace_get_name( ns ),
+                                            dbBE_Redis_namespace_get_len( ns ),
+                                            request->_user->_key,
+                                            strnlen( request->_user->_key, size ) );
     case DBBE_OPCODE_NSCREATE:
     case DBBE_OPCODE_NSATTACH:
-    {
-      int keylen = strnlen( request->_user->_key, size );
-      len = snprintf( keybuf, size, "$%d\r\n%s\r\n",
-                      keylen,
-                      request->_user->_key );
-      break;
-    }
+      return dbBE_Redis_command_insert_key( keybuf, size,
+                                            NULL, 0,
+                                            request->_user->_key,
+                                            strnlen( request->_user->_key, size ) );
     case DBBE_OPCODE_DIRECTORY:
     case DBBE_OPCODE_NSQUERY:
     case DBBE_OPCODE_ITERATOR: // iterator should never get here to build a key (SCAN <cursor> MATCH ....) has no 'key'
-    {
-      int keylen = strnlen( dbBE_Redis_namespace_get_name( ns ), size );
-      len = snprintf( keybuf, size, "$%d\r\n%s\r\n",
-                      keylen,
-                      dbBE_Redis_namespace_get_name( ns ) );
-      break;
-    }
     case DBBE_OPCODE_NSDELETE:
-    {
-      int keylen = strnlen( dbBE_Redis_namespace_get_name( ns ), size );
-      len = snprintf( keybuf, size, "$%d\r\n%s\r\n",
-                      keylen,
-                      dbBE_Redis_namespace_get_name( ns ) );
-      break;
-    }
+      return dbBE_Redis_command_insert_key( keybuf, size,
+                                            NULL, 0,
+                                            dbBE_Redis_namespace_get_name( ns ),
+                                            dbBE_Redis_namespace_get_len( ns ) );
 
     case DBBE_OPCODE_NSDETACH:
     {
@@ -121,25 +179,17 @@ int dbBE_Redis_create_key_cmd( dbBE_Redis_request_t *request, char *keybuf, uint
       {
         case DBBE_REDIS_NSDETACH_STAGE_DELCHECK: // HINCRBY ns_name refcnt -1; HMGET ns_name refcnt flags
         case DBBE_REDIS_NSDETACH_STAGE_DELNS: // DEL ns_name
-        {
-          int keylen = strnlen( dbBE_Redis_namespace_get_name( ns ), size );
-          len = snprintf( keybuf, size, "$%d\r\n%s\r\n",
-                          keylen,
-                          dbBE_Redis_namespace_get_name( ns ) );
-          break;
-        }
+          return dbBE_Redis_command_insert_key( keybuf, size,
+                                                NULL, 0,
+                                                dbBE_Redis_namespace_get_name( ns ),
+                                                dbBE_Redis_namespace_get_len( ns ) );
         case DBBE_REDIS_NSDETACH_STAGE_SCAN: // SCAN 0 MATCH ns_name%sep;*
           return -ENOSYS;
         case DBBE_REDIS_NSDETACH_STAGE_DELKEYS: // DEL ns_name%sep;key  (already complete key in nsdetach.scankey)
-        {
-          int keylen = strnlen( request->_status.nsdetach.scankey, size );
-          len = snprintf( keybuf, size, "$%d\r\n%s\r\n",
-                          keylen,
-                          request->_status.nsdetach.scankey );
-          if(( len < 0 ) || ( len >= size ))
-            return -EMSGSIZE;
-          break;
-        }
+          return dbBE_Redis_command_insert_key( keybuf, size,
+                                                NULL, 0,
+                                                request->_status.nsdetach.scankey,
+                                                strnlen( request->_status.nsdetach.scankey, size ) );
         default:
           return -EPROTO;
       }
@@ -147,33 +197,28 @@ int dbBE_Redis_create_key_cmd( dbBE_Redis_request_t *request, char *keybuf, uint
     }
     case DBBE_OPCODE_MOVE:
     {
-      char *ns_name = NULL;
+      dbBE_Redis_namespace_t *key_ns = ns;
       switch( request->_step->_stage )
       {
         case DBBE_REDIS_MOVE_STAGE_RESTORE: // restore stage uses the new namespace for the key
-          ns_name = dbBE_Redis_namespace_get_name( (dbBE_Redis_namespace_t*)request->_user->_sge[0].iov_base );
+          key_ns = (dbBE_Redis_namespace_t*)request->_user->_sge[0].iov_base;
           break;
         default:
-          ns_name = dbBE_Redis_namespace_get_name( ns );
           break;
       }
-      if( ns_name == NULL )
+      if( key_ns == NULL )
         return -EINVAL;
 
-      int keylen = strnlen( ns_name, size ) + DBBE_REDIS_NAMESPACE_SEPARATOR_LEN + strnlen( request->_user->_key, size );
-      len = snprintf( keybuf, size, "$%d\r\n%s%s%s\r\n",
-                      keylen,
-                      ns_name,
-                      DBBE_REDIS_NAMESPACE_SEPARATOR,
-                      request->_user->_key );
-      if(( len < 0 ) || ( len >= size ))
-        return -EMSGSIZE;
-      break;
+      return dbBE_Redis_command_insert_key( keybuf, size,
+                                            dbBE_Redis_namespace_get_name( key_ns ),
+                                            dbBE_Redis_namespace_get_len( key_ns ),
+                                            request->_user->_key,
+                                            strnlen( request->_user->_key, size ) );
     }
     default:
       return -ENOSYS;
   }
-  return len;
+  return -ENOSYS;
 }
 
 
@@ -210,13 +255,16 @@ int dbBE_Redis_command_create_sr_buffer_field( dbBE_Redis_sr_buffer_t *buf,
 {
   // create and insert field entry
   char *fld = dbBE_Transport_sr_buffer_get_available_position( buf );
-  int fldlen = 0;
-  if( field == NULL )
-    fldlen = snprintf( fld, dbBE_Transport_sr_buffer_remaining( buf ), "$0\r\n\r\n" ); // insert empty-string
-  else
-    fldlen = snprintf( fld, dbBE_Transport_sr_buffer_remaining( buf ), "$%ld\r\n%s\r\n", len, field );
-  if( fldlen <= 0 )
+  size_t space = dbBE_Transport_sr_buffer_remaining( buf );
+  if( field == NULL ) // insert empty-string
+    len = 0;
+  int fldlen = dbBE_Redis_command_insert_bulk_head( fld, space, len );
+  if(( fldlen < 0 ) || ( fldlen + len + 2 > space ))
     return -E2BIG;
+  memcpy( fld + fldlen, field, len );
+  fldlen += len;
+  fld[ fldlen++ ] = '\r';
+  fld[ fldlen++ ] = '\n';
   if( dbBE_Transport_sr_buffer_add_data( buf, fldlen, 1 ) != (size_t)fldlen )
     return -E2BIG;
 
@@ -240,151 +288,86 @@ int dbBE_Redis_command_put_parse( dbBE_Redis_command_stage_spec_t spec,
       return ( err ); \
     }
 
-#define DBBE_REDIS_CMD_REWIND_CMD_AND_ERROR( err, cmd_idx ) \
-    { \
-      cmd_idx = 0; \
-      return ( err ); \
-    }
-
+/*
+ * assemble the command of a stage into the sr_buffer (copy of the arguments)
+ * uses the compiled segments of the stage spec
+ */
 static inline
 int dbBE_Redis_command_create_sgeN( dbBE_Redis_command_stage_spec_t *stage,
                                     dbBE_Redis_sr_buffer_t *sr_buf,
                                     dbBE_sge_t *args )
 {
   int rc = 0;
-  int n = 0;
-  char *cmdptr = stage->_command;
+  int n;
   char *initial = dbBE_Transport_sr_buffer_get_processed_position( sr_buf );
-  char *cmdend = stage->_command + strlen( stage->_command );
 
-  while((cmdptr < cmdend ))
+  for( n = 0; n < stage->_segment_cnt; ++n )
   {
-    // get next location of parameter
-    char *loc = index( cmdptr, '%' );
-
-    // no more parameters. break and add the remaining cmd string
-    if( loc == NULL )
-      break;
+    dbBE_Redis_command_segment_t *seg = &stage->_segments[ n ];
+    char *pos = dbBE_Transport_sr_buffer_get_processed_position( sr_buf );
+    size_t space = dbBE_Transport_sr_buffer_remaining( sr_buf );
 
-    // index() did something funky...
-    if(( loc > cmdend ) || ( *loc != '%' ))
-      DBBE_REDIS_CMD_REWIND_BUF_AND_ERROR( -EBADMSG, sr_buf, initial );
+    if( seg->_arg == DBBE_REDIS_COMMAND_SEGMENT_FIXED )
+    {
+      if( seg->_len > space )
+        DBBE_REDIS_CMD_REWIND_BUF_AND_ERROR( -ENOMEM, sr_buf, initial );
+      memcpy( pos, &stage->_command[ seg->_offset ], seg->_len );
+      rc += dbBE_Transport_sr_buffer_add_data( sr_buf, seg->_len, 1 );
+      continue;
+    }
 
-    // what positional arg to insert?
-    int idx = (int)loc[1] - 48;
-    if(( idx < 0 )  ||  ( idx >= stage->_array_len )  || ( args[ idx ].iov_base == NULL ))
+    dbBE_sge_t *arg = &args[ seg->_arg ];
+    if( arg->iov_base == NULL )
       DBBE_REDIS_CMD_REWIND_BUF_AND_ERROR( -EBADMSG, sr_buf, initial );
 
-    // insert cmd string up to position
-    char tmp = *loc;
-    /*
-     *  todo: note this changes the cmd buffer and thus is not thread-safe
-     *        in case there are multiple threads creating commands
-     */
-    *loc = '\0';
-    int len = snprintf( dbBE_Transport_sr_buffer_get_processed_position( sr_buf ),
-                        dbBE_Transport_sr_buffer_remaining( sr_buf ),
-                        "%s", cmdptr );
-    *loc = tmp;
-    if( len < 0 ) // can be 0 if 2 args appear back-to-back
+    // insert args[n] with its length header and terminator
+    int len = dbBE_Redis_command_insert_bulk_head( pos, space, arg->iov_len );
+    if(( len < 0 ) || ( len + arg->iov_len + 2 > space ))
       DBBE_REDIS_CMD_REWIND_BUF_AND_ERROR( -ENOMEM, sr_buf, initial );
-
-    rc += dbBE_Transport_sr_buffer_add_data( sr_buf, len, 1 );
-
-    // insert args[n]
-    len = snprintf( dbBE_Transport_sr_buffer_get_processed_position( sr_buf ),
-                    dbBE_Transport_sr_buffer_remaining( sr_buf ),
-                    "$%ld\r\n", args[ idx ].iov_len );
-    if( len < 4 ) // fixed chars + single digit number + one-length argument
-      DBBE_REDIS_CMD_REWIND_BUF_AND_ERROR( -ENOMEM, sr_buf, initial );
-
-    rc += dbBE_Transport_sr_buffer_add_data( sr_buf, len, 1 );
-
-    size_t maxlen = args[ idx ].iov_len;
-    if( maxlen > dbBE_Transport_sr_buffer_remaining( sr_buf ) - 2 ) // -2 because of cmd terminator
-      maxlen = dbBE_Transport_sr_buffer_remaining( sr_buf ) - 2;
-    memcpy( dbBE_Transport_sr_buffer_get_processed_position( sr_buf ),
-            args[ idx ].iov_base,
-            maxlen );
-
-    rc += dbBE_Transport_sr_buffer_add_data( sr_buf, maxlen, 1 );
-    rc += dbBE_Redis_command_create_terminate( sr_buf );
-
-    cmdptr = loc + 2;
-    ++n;
-  }
-
-  // add any remaining/trailing cmd string data
-  if( cmdptr < cmdend )
-  {
-    int len = snprintf( dbBE_Transport_sr_buffer_get_processed_position( sr_buf ),
-                        dbBE_Transport_sr_buffer_remaining( sr_buf ),
-                        "%s", cmdptr );
-    if( len <= 0 ) // if equal to zero, then cmdptr == cmdend - can't be true here
-      DBBE_REDIS_CMD_REWIND_BUF_AND_ERROR( -ENOMEM, sr_buf, initial );
-
+    memcpy( pos + len, arg->iov_base, arg->iov_len );
+    len += arg->iov_len;
+    pos[ len++ ] = '\r';
+    pos[ len++ ] = '\n';
     rc += dbBE_Transport_sr_buffer_add_data( sr_buf, len, 1 );
   }
 
   return rc;
 }
 
+/*
+ * assemble the command of a stage as a list of sges without copying
+ * the arguments are expected to be complete bulk strings including header and terminator
+ * uses the compiled segments of the stage spec
+ */
 static inline
 int dbBE_Redis_command_create_sgeN_uncheck( dbBE_Redis_command_stage_spec_t *stage,
                                             dbBE_sge_t *args,
                                             dbBE_sge_t *cmd )
 {
-  char *cmdptr = stage->_command;
-  char *cmdend = stage->_command + strlen( stage->_command );
-
   int cmd_idx = 0;
+  int n;
 
-  while((cmdptr < cmdend ))
+  for( n = 0; n < stage->_segment_cnt; ++n )
   {
-    // get next location of parameter
-    char *loc = index( cmdptr, '%' );
-
-    // no more parameters. break and add the remaining cmd string
-    if( loc == NULL )
-      break;
-
-    // index() did something funky...
-    if(( loc > cmdend ) || ( *loc != '%' ))
-      DBBE_REDIS_CMD_REWIND_CMD_AND_ERROR( -EBADMSG, cmd_idx );
-
-    // insert chars from defined cmd string, if any
-    if( loc != cmdptr )
+    dbBE_Redis_command_segment_t *seg = &stage->_segments[ n ];
+    if( seg->_arg == DBBE_REDIS_COMMAND_SEGMENT_FIXED )
     {
-      cmd[ cmd_idx ].iov_base = cmdptr;
-      cmd[ cmd_idx ].iov_len = (size_t)(loc - cmdptr);
-      cmdptr += cmd[ cmd_idx ].iov_len;
+      cmd[ cmd_idx ].iov_base = &stage->_command[ seg->_offset ];
+      cmd[ cmd_idx ].iov_len = seg->_len;
       ++cmd_idx;
+      continue;
     }
 
-    // what positional arg to insert?
-    int idx = (int)loc[1] - 48;
-    if(( idx < 0 )  ||  ( idx >= stage->_array_len ))
-      DBBE_REDIS_CMD_REWIND_CMD_AND_ERROR( -EBADMSG, cmd_idx );
-
-    if( args[ idx ].iov_base == NULL )
+    if( args[ seg->_arg ].iov_base == NULL )
       break;
 
     // insert args[n]
-    if( args[ idx ].iov_len > 0 )
+    if( args[ seg->_arg ].iov_len > 0 )
     {
-      cmd[ cmd_idx ].iov_base = args[ idx ].iov_base;
-      cmd[ cmd_idx ].iov_len = args[ idx ].iov_len;
+      cmd[ cmd_idx ].iov_base = args[ seg->_arg ].iov_base;
+      cmd[ cmd_idx ].iov_len = args[ seg->_arg ].iov_len;
       ++cmd_idx;
     }
-    cmdptr = loc + 2;
-  }
-
-  // add any remaining/trailing cmd string data
-  if( cmdptr < cmdend )
-  {
-    cmd[ cmd_idx ].iov_base = cmdptr;
-    cmd[ cmd_idx ].iov_len = (size_t)( cmdend - cmdptr );
-    ++cmd_idx;
   }
 
   return cmd_idx;
@@ -447,17 +430,13 @@ int dbBE_Redis_command_lindex_create( dbBE_Redis_request_t *req,
 
   // insert the index to fetch (extracted from the flags value)
   int64_t uindex = req->_user->_flags >> 4;
-  int uindex_len = uindex == 0 ? 1 : (int64_t)( log10( uindex )) + 1;
-  char *lindex = dbBE_Transport_sr_buffer_get_available_position( buf );
-  int lindex_len = snprintf( lindex, dbBE_Transport_sr_buffer_remaining( buf ),
-                             "$%d\r\n%ld\r\n", uindex_len, uindex );
-  if(( lindex_len < 0 ) || ( ( dbBE_Transport_sr_buffer_add_data( buf, lindex_len, 1 ) != (size_t)lindex_len ) ))
+  char digits[ 20 ];
+  int uindex_len = dbBE_Redis_command_format_uint( digits, uindex );
+  if( dbBE_Redis_command_create_sr_buffer_field( buf, digits, uindex_len, &sge[1] ) != 0 )
     goto error;
 
   sge[0].iov_base = key;
   sge[0].iov_len = keylen;
-  sge[1].iov_base = lindex;
-  sge[1].iov_len = lindex_len;
   return dbBE_Redis_command_create_sgeN_uncheck( req->_step, sge, cmd );
 
 error:
@@ -597,8 +576,8 @@ int dbBE_Redis_command_restore_create( dbBE_Redis_request_t *req,
   // todo: see note in protocol.c
   // create dump-value prefix
   char *prefix = dbBE_Transport_sr_buffer_get_available_position( buf );
-  int prefix_len = snprintf( prefix, dbBE_Transport_sr_buffer_remaining( buf ),
-                             "$%ld\r\n", req->_status.move.len );
+  int prefix_len = dbBE_Redis_command_insert_bulk_head( prefix, dbBE_Transport_sr_buffer_remaining( buf ),
+                                                        req->_status.move.len );
   if(( prefix_len < 0 ) || ( ( dbBE_Transport_sr_buffer_add_data( buf, prefix_len, 1 ) != (size_t)prefix_len ) ))
     goto error;
 
@@ -811,7 +790,10 @@ int dbBE_Redis_command_hincrby_create( dbBE_Redis_request_t *req,
   sge[0].iov_len = keylen;
 
   char incbuf[ 32 ];
-  int len = snprintf( incbuf, 31, "%d", increment );
+  int len = 0;
+  if( increment < 0 )
+    incbuf[ len++ ] = '-';
+  len += dbBE_Redis_command_format_uint( incbuf + len, increment < 0 ? -(int64_t)increment : increment );
   if( dbBE_Redis_command_create_sr_buffer_field( buf, incbuf, len, &sge[ 1 ] ) != 0 )
     goto error;
 
@@ -845,7 +827,10 @@ int dbBE_Redis_command_delcheck_create( dbBE_Redis_request_t *req,
 
   // create and insert decrement value
   char incbuf[ 32 ];
-  int len = snprintf( incbuf, 31, "%d", increment );
+  int len = 0;
+  if( increment < 0 )
+    incbuf[ len++ ] = '-';
+  len += dbBE_Redis_command_format_uint( incbuf + len, increment < 0 ? -(int64_t)increment : increment );
   if( dbBE_Redis_command_create_sr_buffer_field( buf, incbuf, len, &sge[ 1 ] ) != 0 )
     goto error;
 
@@ -897,7 +882,8 @@ int dbBE_Redis_command_rpush_create( dbBE_Redis_request_t *request,
   int rc = 0;
   dbBE_Redis_command_stage_spec_t *stage = request->_step;
 
-  if( stage->_stage != 0 ) // Put is only a single stage request
+  // Put is a single stage request in one of two variants
+  if(( stage->_stage != DBBE_REDIS_PUT_STAGE_TAIL ) && ( stage->_stage != DBBE_REDIS_PUT_STAGE_HEAD ))
     return -EINVAL;
 
   // create key
@@ -925,10 +911,7 @@ int dbBE_Redis_command_rpush_create( dbBE_Redis_request_t *request,
 
   // insert lenth-prefix to buffer
   char *valpre = dbBE_Transport_sr_buffer_get_available_position( buf );
-  if( dbBE_Transport_sr_buffer_remaining( buf ) <= (log10( vallen + 1 ) + 3 ) )  // pre-check if there's enough space for the prefix
-    return -E2BIG;
-
-  int valprelen = snprintf( valpre, dbBE_Transport_sr_buffer_remaining( buf ), "$%ld\r\n", vallen );
+  int valprelen = dbBE_Redis_command_insert_bulk_head( valpre, dbBE_Transport_sr_buffer_remaining( buf ), vallen );
   if( valprelen < 4 )
   {
     dbBE_Transport_sr_buffer_rewind_available_to( buf, key );
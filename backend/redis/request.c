@@ -27,23 +27,58 @@
 
 #include "request.h"
 
+int dbBE_Redis_request_pools_init( dbBE_Redis_request_pools_t *pools )
+{
+  if( pools == NULL )
+    return -EINVAL;
+
+  pools->_requests = dbBE_Object_pool_create( sizeof( dbBE_Redis_request_t ), DBBE_REDIS_POOL_CAPACITY );
+  pools->_completions = dbBE_Object_pool_create( sizeof( dbBE_Completion_t ), DBBE_REDIS_POOL_CAPACITY );
+  if(( pools->_requests == NULL ) || ( pools->_completions == NULL ))
+  {
+    dbBE_Redis_request_pools_exit( pools );
+    return -ENOMEM;
+  }
+  return 0;
+}
+
+void dbBE_Redis_request_pools_exit( dbBE_Redis_request_pools_t *pools )
+{
+  if( pools == NULL )
+    return;
+  if( pools->_requests != NULL )
+    dbBE_Object_pool_destroy( pools->_requests );
+  if( pools->_completions != NULL )
+    dbBE_Object_pool_destroy( pools->_completions );
+  pools->_requests = NULL;
+  pools->_completions = NULL;
+}
+
 
  /*
  * allocate the memory of a new request an initialize according to the user request
  */
-dbBE_Redis_request_t* dbBE_Redis_request_allocate( dbBE_Request_t *user )
+dbBE_Redis_request_t* dbBE_Redis_request_allocate( dbBE_Redis_request_pools_t *pools,
+                                                  dbBE_Request_t *user )
 {
   if( user == NULL )
     return NULL;
 
-  dbBE_Redis_request_t *request = (dbBE_Redis_request_t*)malloc( sizeof( dbBE_Redis_request_t ) );
+  dbBE_Redis_request_t *request = NULL;
+  if( pools != NULL )
+    request = (dbBE_Redis_request_t*)dbBE_Object_pool_get( pools->_requests );
+  if( request == NULL )
+    request = (dbBE_Redis_request_t*)malloc( sizeof( dbBE_Redis_request_t ) );
   if( request == NULL )
     return NULL;
 
   memset( request, 0, sizeof( dbBE_Redis_request_t ) );
 
+  request->_pools = pools;
   request->_user = user;
   request->_step = &gRedis_command_spec[ user->_opcode * DBBE_REDIS_COMMAND_STAGE_MAX ];
+  if(( user->_opcode == DBBE_OPCODE_PUT ) && ( user->_flags & DBBE_OPCODE_FLAGS_HEAD ))
+    request->_step += DBBE_REDIS_PUT_STAGE_HEAD;
 
   return request;
 }
@@ -54,8 +89,38 @@ void dbBE_Redis_request_destroy( dbBE_Redis_request_t *request )
     return;
 
   // do not destroy any potential completion here because completions live longer than requests
+  dbBE_Redis_request_pools_t *pools = request->_pools;
   memset( request, 0, sizeof( dbBE_Redis_request_t ) );
-  free( request );
+  dbBE_Object_pool_put( ( pools != NULL ) ? pools->_requests : NULL, request );
+}
+
+dbBE_Completion_t* dbBE_Redis_completion_allocate( dbBE_Redis_request_pools_t *pools,
+                                                   dbBE_Request_t *user,
+                                                   DBR_Errorcode_t status,
+                                                   int64_t rc )
+{
+  if( user == NULL )
+    return NULL;
+
+  dbBE_Completion_t *completion = NULL;
+  if( pools != NULL )
+    completion = (dbBE_Completion_t*)dbBE_Object_pool_get( pools->_completions );
+  if( completion == NULL )
+    completion = (dbBE_Completion_t*)malloc( sizeof( dbBE_Completion_t ) );
+  if( completion == NULL )
+    return NULL;
+
+  completion->_next = NULL;
+  completion->_rc = rc;
+  completion->_user = user->_user;
+  completion->_status = status;
+  return completion;
+}
+
+void dbBE_Redis_completion_release( dbBE_Redis_request_pools_t *pools,
+                                    dbBE_Completion_t *completion )
+{
+  dbBE_Object_pool_put( ( pools != NULL ) ? pools->_completions : NULL, completion );
 }
 
 int dbBE_Redis_request_stage_transition( dbBE_Redis_request_t *request )
@@ -85,3 +150,34 @@ int dbBE_Redis_request_stage_transition( dbBE_Redis_request_t *request )
   request->_step = &gRedis_command_spec[ request->_user->_opcode * DBBE_REDIS_COMMAND_STAGE_MAX + stage ];
   return 0;
 }
+
+int dbBE_Redis_request_set_blocking( dbBE_Redis_request_t *request,
+                                     const int allow_read )
+{
+  if(( request == NULL ) || ( request->_step == NULL ))
+    return -EINVAL;
+
+  if( request->_step->_stage != DBBE_REDIS_RETRIEVE_STAGE_POLL )
+    return -EALREADY;
+
+  switch( request->_user->_opcode )
+  {
+    case DBBE_OPCODE_GET:
+      break;
+    case DBBE_OPCODE_READ:
+      // the blocking command can only wait for the head of the list
+      if(( allow_read == 0 ) || (( request->_user->_flags >> 4 ) != 0 ))
+        return -ENOTSUP;
+      break;
+    default:
+      return -ENOTSUP;
+  }
+  request->_step = &gRedis_command_spec[ request->_user->_opcode * DBBE_REDIS_COMMAND_STAGE_MAX + DBBE_REDIS_RETRIEVE_STAGE_BLOCK ];
+  return 0;
+}
+
+void dbBE_Redis_request_set_polling( dbBE_Redis_request_t *request )
+{
+  if( dbBE_Redis_request_is_blocking( request ) )
+    request->_step = &gRedis_command_spec[ request->_user->_opcode * DBBE_REDIS_COMMAND_STAGE_MAX + DBBE_REDIS_RETRIEVE_STAGE_POLL ];
+}
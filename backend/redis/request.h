@@ -24,6 +24,7 @@
 #include "refcounter.h"
 #include "locator.h"
 #include "iterator.h"
+#include "../common/object_pool.h"
 
 typedef struct dbBE_Redis_intern_detach_data
 {
@@ -82,6 +83,15 @@ typedef struct dbBE_Redis_request_location
   dbBE_Redis_request_location_data_t _data;
 } dbBE_Redis_request_location_t;
 
+/*
+ * recycled requests and completions of a backend context
+ */
+typedef struct dbBE_Redis_request_pools
+{
+  dbBE_Object_pool_t *_requests;
+  dbBE_Object_pool_t *_completions;
+} dbBE_Redis_request_pools_t;
+
 typedef struct dbBE_Redis_request
 {
   dbBE_Redis_intern_data_t _status;  // allows to keep some state to keep track of multistage-multinode request processing
@@ -89,24 +99,69 @@ typedef struct dbBE_Redis_request
   dbBE_Redis_command_stage_spec_t *_step;
   dbBE_Completion_t *_completion;  // multi-stage requests with early completions need to hold that here
   dbBE_Redis_request_location_t _location; // where this request should go (in case we know)
+  dbBE_Redis_request_pools_t *_pools;  // pools of the backend context the request returns to (NULL: heap)
   struct dbBE_Redis_request *_next;
 } dbBE_Redis_request_t;
 
 /*
  * allocate the memory of a new request an initialize according to the user request
  */
-dbBE_Redis_request_t* dbBE_Redis_request_allocate( dbBE_Request_t *user );
+dbBE_Redis_request_t* dbBE_Redis_request_allocate( dbBE_Redis_request_pools_t *pools,
+                                                  dbBE_Request_t *user );
 
 /*
  * wipe and delete a request
  */
 void dbBE_Redis_request_destroy( dbBE_Redis_request_t *request );
 
+/*
+ * create/release the request and completion pools of a backend context
+ * without pools, requests and completions fall back to plain malloc/free
+ */
+int dbBE_Redis_request_pools_init( dbBE_Redis_request_pools_t *pools );
+void dbBE_Redis_request_pools_exit( dbBE_Redis_request_pools_t *pools );
+
+/*
+ * allocate and initialize a completion for a user request
+ */
+dbBE_Completion_t* dbBE_Redis_completion_allocate( dbBE_Redis_request_pools_t *pools,
+                                                   dbBE_Request_t *user,
+                                                   DBR_Errorcode_t status,
+                                                   int64_t rc );
+
+/*
+ * return a completion for reuse
+ * completions from this pool are plain heap objects, so free() is fine too
+ */
+void dbBE_Redis_completion_release( dbBE_Redis_request_pools_t *pools,
+                                    dbBE_Completion_t *completion );
+
 
 /*
  * transition a request to the next stage
  */
 int dbBE_Redis_request_stage_transition( dbBE_Redis_request_t *request );
 
+/*
+ * true if the request is a get/read in its server-side blocking stage
+ */
+#define dbBE_Redis_request_is_blocking( req ) \
+  ( ( (req) != NULL ) && ( (req)->_step != NULL ) && \
+    (( (req)->_user->_opcode == DBBE_OPCODE_GET ) || ( (req)->_user->_opcode == DBBE_OPCODE_READ )) && \
+    ( (req)->_step->_stage == DBBE_REDIS_RETRIEVE_STAGE_BLOCK ) )
+
+/*
+ * switch a get/read that found no data from polling to its blocking stage
+ * reads can only block for index 0 and only if allow_read is set
+ * returns -ENOTSUP if the request has to keep polling
+ */
+int dbBE_Redis_request_set_blocking( dbBE_Redis_request_t *request,
+                                     const int allow_read );
+
+/*
+ * switch a blocking get/read back to polling (e.g. no dedicated connection available)
+ */
+void dbBE_Redis_request_set_polling( dbBE_Redis_request_t *request );
+
 
 #endif /* BACKEND_REDIS_REQUEST_H_ */
@@ -0,0 +1,147 @@
+/*
+ * Copyright © 2018-2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include <inttypes.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define DBBE_REDIS_SCAN_X86
+#include <immintrin.h>
+#endif
+
+#include "resp_scan.h"
+
+typedef char* (*dbBE_Redis_scan_fn_t)( const char *p, const int64_t limit );
+
+/*
+ * scalar version: memchr for the '\r' then check the '\n'
+ */
+static
+char* dbBE_Redis_scan_terminator_scalar( const char *p, const int64_t limit )
+{
+  const char *end = p + limit - 1; // last position that can hold a '\r'
+  while( p < end )
+  {
+    p = (const char*)memchr( p, '\r', end - p );
+    if( p == NULL )
+      return NULL;
+    if( p[1] == '\n' )
+      return (char*)p;
+    ++p;
+  }
+  return NULL;
+}
+
+#ifdef DBBE_REDIS_SCAN_X86
+/*
+ * vector versions: compare a block against '\r' and the same block shifted by one against '\n'
+ * the combined mask has a bit set for each complete terminator.
+ * Loads never go beyond the limit, the tail is handled by the scalar version.
+ */
+__attribute__((target("sse2")))
+static
+char* dbBE_Redis_scan_terminator_sse2( const char *p, const int64_t limit )
+{
+  const __m128i cr = _mm_set1_epi8( '\r' );
+  const __m128i lf = _mm_set1_epi8( '\n' );
+  int64_t pos = 0;
+  for( pos = 0; pos + 17 <= limit; pos += 16 )
+  {
+    __m128i a = _mm_loadu_si128( (const __m128i*)( p + pos ) );
+    __m128i b = _mm_loadu_si128( (const __m128i*)( p + pos + 1 ) );
+    unsigned mask = (unsigned)_mm_movemask_epi8( _mm_and_si128( _mm_cmpeq_epi8( a, cr ),
+                                                                _mm_cmpeq_epi8( b, lf ) ) );
+    if( mask != 0 )
+      return (char*)( p + pos + __builtin_ctz( mask ) );
+  }
+  return dbBE_Redis_scan_terminator_scalar( p + pos, limit - pos );
+}
+
+__attribute__((target("avx2")))
+static
+char* dbBE_Redis_scan_terminator_avx2( const char *p, const int64_t limit )
+{
+  const __m256i cr = _mm256_set1_epi8( '\r' );
+  const __m256i lf = _mm256_set1_epi8( '\n' );
+  int64_t pos = 0;
+  for( pos = 0; pos + 33 <= limit; pos += 32 )
+  {
+    __m256i a = _mm256_loadu_si256( (const __m256i*)( p + pos ) );
+    __m256i b = _mm256_loadu_si256( (const __m256i*)( p + pos + 1 ) );
+    unsigned mask = (unsigned)_mm256_movemask_epi8( _mm256_and_si256( _mm256_cmpeq_epi8( a, cr ),
+                                                                      _mm256_cmpeq_epi8( b, lf ) ) );
+    if( mask != 0 )
+      return (char*)( p + pos + __builtin_ctz( mask ) );
+  }
+  return dbBE_Redis_scan_terminator_sse2( p + pos, limit - pos );
+}
+#endif /* DBBE_REDIS_SCAN_X86 */
+
+static
+char* dbBE_Redis_scan_terminator_resolve( const char *p, const int64_t limit );
+
+// selected implementation; resolved with the first call (concurrent resolution stores the same value)
+static dbBE_Redis_scan_fn_t gScan_terminator = dbBE_Redis_scan_terminator_resolve;
+
+static
+char* dbBE_Redis_scan_terminator_resolve( const char *p, const int64_t limit )
+{
+  dbBE_Redis_scan_select( DBBE_REDIS_SCAN_AUTO );
+  return gScan_terminator( p, limit );
+}
+
+dbBE_Redis_scan_level_t dbBE_Redis_scan_select( dbBE_Redis_scan_level_t level )
+{
+  dbBE_Redis_scan_level_t available = DBBE_REDIS_SCAN_SCALAR;
+#ifdef DBBE_REDIS_SCAN_X86
+  __builtin_cpu_init();
+  if( __builtin_cpu_supports( "sse2" ) )
+    available = DBBE_REDIS_SCAN_SSE2;
+  if( __builtin_cpu_supports( "avx2" ) )
+    available = DBBE_REDIS_SCAN_AVX2;
+#endif
+
+  if(( level == DBBE_REDIS_SCAN_AUTO ) || ( level > available ))
+    level = available;
+
+  switch( level )
+  {
+#ifdef DBBE_REDIS_SCAN_X86
+    case DBBE_REDIS_SCAN_AVX2:
+      gScan_terminator = dbBE_Redis_scan_terminator_avx2;
+      break;
+    case DBBE_REDIS_SCAN_SSE2:
+      gScan_terminator = dbBE_Redis_scan_terminator_sse2;
+      break;
+#endif
+    default:
+      level = DBBE_REDIS_SCAN_SCALAR;
+      gScan_terminator = dbBE_Redis_scan_terminator_scalar;
+      break;
+  }
+  return level;
+}
+
+char* dbBE_Redis_scan_terminator( const char *p, const int64_t limit )
+{
+  if(( p == NULL ) || ( limit < 2 ))
+    return NULL;
+  return gScan_terminator( p, limit );
+}
+
+
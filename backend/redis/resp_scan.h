@@ -0,0 +1,93 @@
+/*
+ * Copyright © 2018-2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef BACKEND_REDIS_RESP_SCAN_H_
+#define BACKEND_REDIS_RESP_SCAN_H_
+
+#include <inttypes.h>
+#include <string.h>
+
+/*
+ * Low-level scanning helpers of the RESP parser.
+ *
+ * The terminator search has a scalar implementation and (on x86) SSE2 and
+ * AVX2 implementations. The best one supported by the CPU is selected at
+ * runtime with the first call.
+ */
+
+typedef enum
+{
+  DBBE_REDIS_SCAN_AUTO = -1, ///< select the best available implementation
+  DBBE_REDIS_SCAN_SCALAR = 0,
+  DBBE_REDIS_SCAN_SSE2 = 1,
+  DBBE_REDIS_SCAN_AVX2 = 2
+} dbBE_Redis_scan_level_t;
+
+/*
+ * find the first "\r\n" in the first limit bytes of p (both chars within the limit)
+ * returns a pointer to the '\r' or NULL if there's no complete terminator
+ * p may contain any data including nul-bytes
+ */
+char* dbBE_Redis_scan_terminator( const char *p, const int64_t limit );
+
+/*
+ * select the implementation of the terminator scan
+ * levels that are not supported by the CPU or the build fall back to the next lower one
+ * returns the selected level
+ */
+dbBE_Redis_scan_level_t dbBE_Redis_scan_select( dbBE_Redis_scan_level_t level );
+
+/*
+ * SWAR decoding of a \r\n-terminated unsigned number of up to 8 digits at p
+ * (one 8-byte load, digit validation, and conversion in 3 multiply steps)
+ * returns the number of digits and sets *value
+ * returns 0 if the number is longer, not terminated within limit, or contains non-digits
+ * (the caller is expected to fall back to the byte-wise parsing in that case)
+ */
+static inline
+int dbBE_Redis_scan_uint( const char *p, const int64_t limit, int64_t *value )
+{
+#if defined(__BYTE_ORDER__) && ( __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ )
+  if( limit < 10 ) // 8 digits + terminator have to be readable
+    return 0;
+
+  uint64_t chunk;
+  memcpy( &chunk, p, 8 );
+
+  // per byte: non-zero if the high nibble isn't 3 or the low nibble is > 9
+  uint64_t bad = (( chunk & 0xF0F0F0F0F0F0F0F0ull ) ^ 0x3030303030303030ull ) |
+      ((( chunk & 0x0F0F0F0F0F0F0F0Full ) + 0x0606060606060606ull ) & 0xF0F0F0F0F0F0F0F0ull );
+  bad = ((( bad & 0x7F7F7F7F7F7F7F7Full ) + 0x7F7F7F7F7F7F7F7Full ) | bad ) & 0x8080808080808080ull;
+
+  int digits = ( bad == 0 ) ? 8 : ( __builtin_ctzll( bad ) >> 3 );
+  if(( digits == 0 ) || ( p[ digits ] != '\r' ) || ( p[ digits + 1 ] != '\n' ))
+    return 0;
+
+  // right-align the digits and fill the leading bytes with '0'
+  if( digits < 8 )
+    chunk = ( chunk << ( 8 * ( 8 - digits ) ) ) | ( 0x3030303030303030ull >> ( 8 * digits ) );
+
+  chunk = ( chunk & 0x0F0F0F0F0F0F0F0Full ) * 2561 >> 8;
+  chunk = ( chunk & 0x00FF00FF00FF00FFull ) * 6553601 >> 16;
+  *value = (int64_t)(uint32_t)(( chunk & 0x0000FFFF0000FFFFull ) * 42949672960001ull >> 32 );
+  return digits;
+#else
+  return 0;
+#endif
+}
+
+#endif /* BACKEND_REDIS_RESP_SCAN_H_ */
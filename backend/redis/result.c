@@ -35,12 +35,13 @@ int dbBE_Redis_result_cleanup( dbBE_Redis_result_t *result, int dealloc )
     {
       int n;
       // cleanup and free array - the array creation mechanism allocates new memory
-      // so we have to clean it up here
+      // so we have to clean it up here (unless it's owned by the receiver's arena)
       if( result->_data._array._data != NULL )
       {
         for( n = 0; n < result->_data._array._len; ++n )
           dbBE_Redis_result_cleanup( & result->_data._array._data[ n ], 0 );
-        free( result->_data._array._data );
+        if( ! result->_data._array._arena )
+          free( result->_data._array._data );
       }
       break;
     }
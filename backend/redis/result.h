@@ -37,4 +37,16 @@ int dbBE_Redis_result_cleanup( dbBE_Redis_result_t *result, int dealloc );
 int dbBE_Redis_result_terminate_strings( dbBE_Redis_result_t *result );
 
 
+// true if the result is a partial string or an array that ends with one
+static inline
+int dbBE_Redis_result_is_partial( const dbBE_Redis_result_t *result )
+{
+  if( result->_type == dbBE_REDIS_TYPE_STRING_PART )
+    return 1;
+  return ( result->_type == dbBE_REDIS_TYPE_ARRAY ) &&
+      ( result->_data._array._len > 0 ) &&
+      ( result->_data._array._data[ result->_data._array._len - 1 ]._type == dbBE_REDIS_TYPE_STRING_PART );
+}
+
+
 #endif /* BACKEND_REDIS_RESULT_H_ */
@@ -42,13 +42,13 @@ int dbBE_Redis_create_send_error( dbBE_Completion_queue_t *cq, dbBE_Redis_reques
   dbBE_Completion_t *completion = dbBE_Redis_complete_error( request,
                                                              error,
                                                              0 );
+  dbBE_Redis_request_pools_t *pools = request->_pools;
   dbBE_Redis_request_destroy( request );
   if( completion != NULL )
   {
     if( dbBE_Completion_queue_push( cq, completion ) != 0 )
     {
-      free( completion );
-      dbBE_Redis_request_destroy( request );
+      dbBE_Redis_completion_release( pools, completion );
       fprintf( stderr, "RedisBE: Failed to queue send-error completion.\n" );
     }
   }
@@ -65,6 +65,7 @@ int dbBE_Redis_cmd_stage_needs_rekeying( dbBE_Redis_request_t *request )
   check += (( request->_step->_stage == 0 ) && ( request->_user->_opcode != DBBE_OPCODE_ITERATOR )); // all first-stage requests need to get checked (except iterators)
   check += ( request->_user->_opcode == DBBE_OPCODE_MOVE ); // MOVE cmd needs re-keying for each stage
   check += (( request->_user->_opcode == DBBE_OPCODE_NSDETACH ) && ( request->_step->_stage == DBBE_REDIS_NSDETACH_STAGE_DELNS ) );
+  check += dbBE_Redis_request_is_blocking( request ); // the slot might have moved while the request was waiting
   return check;
 }
 
@@ -162,7 +163,7 @@ dbBE_Redis_request_t* dbBE_Redis_request_preprocess( dbBE_Redis_context_t *backe
         }
         if( dbBE_Completion_queue_push( backend->_compl_q, completion ) != 0 )
         {
-          free( completion );
+          dbBE_Redis_completion_release( &backend->_pools, completion );
           dbBE_Redis_request_destroy( request );
           fprintf( stderr, "RedisBE: Failed to queue completion.\n" );
           return NULL;
@@ -180,6 +181,29 @@ dbBE_Redis_request_t* dbBE_Redis_request_preprocess( dbBE_Redis_context_t *backe
   return request;
 }
 
+/*
+ * complete a cancelled request and destroy it
+ * multi-stage requests may carry the completion of an earlier result stage which is replaced
+ */
+static
+void dbBE_Redis_sender_complete_cancelled( dbBE_Redis_context_t *backend,
+                                           dbBE_Redis_request_t *request )
+{
+  if( request->_completion != NULL )
+  {
+    dbBE_Redis_completion_release( &backend->_pools, request->_completion );
+    request->_completion = NULL;
+  }
+
+  dbBE_Completion_t *completion = dbBE_Redis_complete_cancel( request );
+  if(( completion != NULL ) && ( dbBE_Completion_queue_push( backend->_compl_q, completion ) != 0 ))
+  {
+    dbBE_Redis_completion_release( &backend->_pools, completion );
+    LOG( DBG_ERR, stderr, "Failed to queue cancel completion.\n" );
+  }
+  dbBE_Redis_request_destroy( request );
+}
+
 static
 dbBE_Redis_request_t* dbBE_Redis_sender_acquire_request( dbBE_Redis_context_t *backend )
 {
@@ -199,7 +223,7 @@ dbBE_Redis_request_t* dbBE_Redis_sender_acquire_request( dbBE_Redis_context_t *b
     {
       user_req = dbBE_Request_queue_pop( backend->_work_q );
       if( user_req != NULL )
-        request = dbBE_Redis_request_allocate( user_req );
+        request = dbBE_Redis_request_allocate( &backend->_pools, user_req );
     }
 
     // if there's really nothing to do: skip
@@ -208,21 +232,10 @@ dbBE_Redis_request_t* dbBE_Redis_sender_acquire_request( dbBE_Redis_context_t *b
 
 
     // Check if this request has been cancelled before continuing to process it
+    // (a single atomic load as long as nothing is cancelled)
     if( dbBE_Request_set_delete( backend->_cancellations, request->_user) != 0 )
     {
-      dbBE_Completion_t *completion = dbBE_Redis_complete_cancel( request );
-
-      if( completion != NULL )
-        if( dbBE_Completion_queue_push( backend->_compl_q, completion ) != 0 )
-        {
-          free( completion );
-          dbBE_Redis_request_destroy( request );
-          fprintf( stderr, "RedisBE: Failed to queue completion.\n" );
-          // todo: save the status to mark the request for cleanup during the next stages
-        }
-
-      // clean the RedisBE request struct
-      dbBE_Redis_request_destroy( request );
+      dbBE_Redis_sender_complete_cancelled( backend, request );
       request = NULL;
     }
 
@@ -233,6 +246,106 @@ dbBE_Redis_request_t* dbBE_Redis_sender_acquire_request( dbBE_Redis_context_t *b
   return request;
 }
 
+/*
+ * requests blocked on a dedicated connection are not seen by acquire_request
+ * until the server-side timeout expires. Complete cancelled ones right away
+ * and drop their connection so that a late response has nowhere to go.
+ * If the response has arrived already, the server has popped the value;
+ * the connection is handed to the receiver instead, which completes the
+ * request with the data (or returns it for cancellation on a timeout).
+ */
+static
+void dbBE_Redis_sender_cancel_blocked( dbBE_Redis_context_t *backend )
+{
+  if(( backend->_conn_mgr->_dedicated_count == 0 ) || ( dbBE_Request_set_empty( backend->_cancellations ) ))
+    return;
+
+  unsigned n;
+  for( n = 0; n < DBBE_REDIS_MAX_DEDICATED_CONNECTIONS; ++n )
+  {
+    dbBE_Redis_connection_t *conn = backend->_conn_mgr->_dedicated[ n ];
+    if(( conn == NULL ) || ( dbBE_Redis_s2r_queue_len( conn->_posted_q ) == 0 ))
+      continue;
+
+    dbBE_Redis_request_t *request = conn->_posted_q->_head;
+    if( dbBE_Request_set_find( backend->_cancellations, request->_user ) == 0 )
+      continue;
+
+    if( dbBE_Redis_connection_response_pending( conn ) )
+    {
+      dbBE_Redis_connection_set_active( conn );
+      dbBE_Redis_connection_mgr_requeue_active( backend->_conn_mgr, conn );
+      continue;
+    }
+
+    dbBE_Request_set_delete( backend->_cancellations, request->_user );
+    request = dbBE_Redis_s2r_queue_pop( conn->_posted_q );
+    dbBE_Redis_sender_complete_cancelled( backend, request );
+    dbBE_Redis_connection_mgr_drop_dedicated( backend->_conn_mgr, conn );
+  }
+}
+
+/*
+ * return the held back requests of a connection to the retry queue (in order)
+ */
+static
+void dbBE_Redis_sender_release_held( dbBE_Redis_context_t *backend,
+                                     dbBE_Redis_connection_t *conn )
+{
+  dbBE_Redis_request_t *request;
+  while(( request = dbBE_Redis_s2r_queue_pop( conn->_held_q )) != NULL )
+    dbBE_Redis_s2r_queue_push( backend->_retry_q, request );
+}
+
+/*
+ * a send to the connection failed: same as a failed recv,
+ * its posted and held requests are retried and the connection goes to recovery
+ */
+static
+void dbBE_Redis_sender_conn_fail( dbBE_Redis_context_t *backend,
+                                  dbBE_Redis_connection_t *conn )
+{
+  dbBE_Redis_request_t *request;
+  while(( request = dbBE_Redis_s2r_queue_pop( conn->_posted_q )) != NULL )
+    dbBE_Redis_s2r_queue_push( backend->_retry_q, request );
+  dbBE_Redis_sender_release_held( backend, conn );
+
+  // a value that was still arriving is lost with the connection
+  request = dbBE_Redis_connection_bulk_abort( conn );
+  if( request != NULL )
+    dbBE_Redis_create_send_error( backend->_compl_q, request, DBR_ERR_NOCONNECT );
+
+  dbBE_Redis_locator_reassociate_conn_index( backend->_locator,
+                                             conn->_index,
+                                             DBBE_REDIS_LOCATOR_INDEX_INVAL );
+  dbBE_Redis_connection_mgr_conn_fail( backend->_conn_mgr, conn );
+}
+
+/*
+ * continue sending the pending data of connections whose sockets became writable again
+ * connections that are still congested get re-armed, failed ones go to recovery;
+ * once a connection is below the pending limit, its held back requests are released
+ */
+static
+void dbBE_Redis_sender_flush_pending( dbBE_Redis_context_t *backend )
+{
+  dbBE_Redis_connection_t *conn;
+  while(( conn = dbBE_Redis_connection_mgr_get_writable( backend->_conn_mgr )) != NULL )
+  {
+    ssize_t rc = dbBE_Redis_connection_flush( conn );
+    if( rc < 0 )
+    {
+      LOG( DBG_ERR, stderr, "Failed to flush pending data of conn=%d. rc=%zd\n", conn->_index, rc );
+      dbBE_Redis_sender_conn_fail( backend, conn );
+      continue;
+    }
+    if( rc > 0 )
+      dbBE_Redis_connection_mgr_want_write( backend->_conn_mgr, conn );
+    if( ! dbBE_Redis_connection_congested( conn ) )
+      dbBE_Redis_sender_release_held( backend, conn );
+  }
+}
+
 static
 dbBE_Redis_connection_t* dbBE_Redis_sender_find_connection( dbBE_Redis_context_t *backend,
                                                             dbBE_Redis_request_t *request )
@@ -264,7 +377,16 @@ dbBE_Redis_connection_t* dbBE_Redis_sender_find_connection( dbBE_Redis_context_t
       if( request->_location._data._conn_idx == DBBE_REDIS_LOCATOR_INDEX_INVAL )
         request->_location._type = DBBE_REDIS_REQUEST_LOCATION_TYPE_UNKNOWN;
       else
+      {
         request->_location._type = DBBE_REDIS_REQUEST_LOCATION_TYPE_SLOT;
+
+        // spread the slots of an instance across its connection pool; later stages stay on the same connection
+        dbBE_Redis_connection_t *pooled = dbBE_Redis_connection_mgr_get_pooled( backend->_conn_mgr,
+                                                                                dbBE_Redis_connection_mgr_get_connection_at( backend->_conn_mgr, request->_location._data._conn_idx ),
+                                                                                slot );
+        if( pooled != NULL )
+          request->_location._data._conn_idx = pooled->_index;
+      }
     }
 
     if( request->_location._type == DBBE_REDIS_REQUEST_LOCATION_TYPE_UNKNOWN )
@@ -276,13 +398,82 @@ dbBE_Redis_connection_t* dbBE_Redis_sender_find_connection( dbBE_Redis_context_t
 
   // connection mgr to retrieve the sr_buffer + socket
   if( request->_location._type == DBBE_REDIS_REQUEST_LOCATION_TYPE_SLOT )
+  {
     conn = dbBE_Redis_connection_mgr_get_connection_at( backend->_conn_mgr, request->_location._data._conn_idx );
+
+    // a pooled connection might be gone since the previous stage; continue on the regular connection
+    if(( conn == NULL ) && ( dbBE_Redis_connection_mgr_index_is_pooled( request->_location._data._conn_idx ) ))
+    {
+      request->_location._data._conn_idx = dbBE_Redis_connection_mgr_get_pool_owner( backend->_conn_mgr, request->_location._data._conn_idx );
+      conn = dbBE_Redis_connection_mgr_get_connection_at( backend->_conn_mgr, request->_location._data._conn_idx );
+    }
+  }
   else
     conn = request->_location._data._connection;
 
   return conn;
 }
 
+/*
+ * send the assembled commands of all pending connections
+ * a failed or congested connection must not hold back the others
+ * afterwards, nothing refers to the sender buffer anymore
+ */
+static
+void dbBE_Redis_sender_post_pending( dbBE_Redis_context_t *backend,
+                                     int *pending_conn,
+                                     int *pending_last )
+{
+  while( *pending_last >= 0 )
+  {
+    dbBE_Redis_connection_t *conn = dbBE_Redis_connection_mgr_get_connection_at( backend->_conn_mgr, pending_conn[ *pending_last ] );
+    if( conn == NULL ) // failed already while its commands were assembled
+    {
+      --( *pending_last );
+      continue;
+    }
+    int rc = dbBE_Redis_connection_send_cmd( conn, backend->_sender_buffer );
+    if( rc < 0 )
+    {
+      LOG( DBG_ERR, stderr, "Failed to send command to conn=%d. rc=%d\n", conn->_index, rc );
+      dbBE_Redis_sender_conn_fail( backend, conn );
+    }
+    else if( dbBE_Redis_connection_send_pending( conn ) != 0 )
+      dbBE_Redis_connection_mgr_want_write( backend->_conn_mgr, conn );
+    else if( dbBE_Redis_s2r_queue_len( conn->_held_q ) != 0 )
+      dbBE_Redis_sender_release_held( backend, conn );
+    --( *pending_last );
+  }
+}
+
+/*
+ * make sure the sender buffer has room for another command:
+ * send what's assembled so far and grow the then empty buffer (up to the limit)
+ */
+static
+void dbBE_Redis_sender_make_room( dbBE_Redis_context_t *backend,
+                                  int *pending_conn,
+                                  int *pending_last )
+{
+  dbBE_Redis_sr_buffer_t *sbuf = backend->_sender_buffer;
+  if( dbBE_Transport_sr_buffer_remaining( sbuf ) >= DBBE_REDIS_SENDER_HEADROOM )
+    return;
+
+  dbBE_Redis_sender_post_pending( backend, pending_conn, pending_last );
+  dbBE_Transport_sr_buffer_reset( sbuf );
+
+  size_t size = dbBE_Transport_sr_buffer_get_size( sbuf );
+  if( size >= backend->_sender_buffer_max )
+    return;
+  size = ( size * 2 < backend->_sender_buffer_max ) ? size * 2 : backend->_sender_buffer_max;
+  if( dbBE_Transport_sr_buffer_resize( sbuf, size ) != 0 )
+  {
+    LOG( DBG_ERR, stderr, "Failed to grow sender buffer to %zu bytes. Continuing with the old size.\n", size );
+  }
+  else if( backend->_hugepages )
+    dbBE_Transport_memory_advise_hugepages( dbBE_Transport_sr_buffer_get_start( sbuf ), size );
+}
+
 /*
  * sender function, creates requests to redis
  */
@@ -340,6 +531,9 @@ void* dbBE_Redis_sender( void *args )
     }
   }
 
+  dbBE_Redis_sender_flush_pending( input->_backend );
+  dbBE_Redis_sender_cancel_blocked( input->_backend );
+
   dbBE_Redis_request_t *request = NULL;
   int *pending_conn = input->_backend->_sender_connections;
 
@@ -360,6 +554,16 @@ void* dbBE_Redis_sender( void *args )
       break;
     }
 
+    // blocking commands would stall the pipeline, they get a connection of their own
+    if( dbBE_Redis_request_is_blocking( request ) )
+    {
+      dbBE_Redis_connection_t *dedicated = dbBE_Redis_connection_mgr_get_dedicated( input->_backend->_conn_mgr, conn );
+      if( dedicated != NULL )
+        conn = dedicated;
+      else
+        dbBE_Redis_request_set_polling( request );
+    }
+
     if( ! dbBE_Redis_connection_RTS( conn ) )
     {
       LOG( DBG_ERR, stderr, "Associated connection not ready to send\n" );
@@ -367,11 +571,46 @@ void* dbBE_Redis_sender( void *args )
       break;
     }
 
+    // back-pressure: the connection gets no more requests until its pending data drained below the limit
+    // (later requests for it are held too, to keep the order)
+    if( dbBE_Redis_connection_congested( conn ) || ( dbBE_Redis_s2r_queue_len( conn->_held_q ) != 0 ))
+    {
+      LOG( DBG_TRACE, stderr, "conn=%d congested. holding request\n", conn->_index );
+      dbBE_Redis_s2r_queue_push( conn->_held_q, request );
+      continue;
+    }
+
+    // not enough SGE space left for the uncoalesced command: send what's there first
+    if( dbBE_Transport_sge_buffer_remain( conn->_cmd ) < (unsigned)( request->_step->_segment_cnt + request->_user->_sge_count + 2 ) )
+    {
+      ssize_t src = dbBE_Redis_connection_send_cmd( conn, input->_backend->_sender_buffer );
+      if( src < 0 )
+      {
+        // the posted requests are retried together with this one once the connection is recovered
+        LOG( DBG_ERR, stderr, "Failed to send command to conn=%d. rc=%zd\n", conn->_index, src );
+        dbBE_Redis_sender_conn_fail( input->_backend, conn );
+        dbBE_Redis_s2r_queue_push( input->_backend->_retry_q, request );
+        break;
+      }
+      if( dbBE_Redis_connection_send_pending( conn ) != 0 )
+        dbBE_Redis_connection_mgr_want_write( input->_backend->_conn_mgr, conn );
+      dbBE_Transport_sge_buffer_reset( conn->_cmd );
+    }
+
+    dbBE_Redis_sender_make_room( input->_backend, pending_conn, &pending_last );
+
     // create_command assembles an SGE list
     // entries either come directly from user or from send buffer
+    // small entries are then gathered into the send buffer to merge with their neighbours
     // when complete, connection.send() fires the assembled data
     dbBE_sge_t *cmd = dbBE_Transport_sge_buffer_get_current( conn->_cmd );
     rc = dbBE_Redis_create_command_sge( request, input->_backend->_sender_buffer, cmd );
+    if( rc >= 0 )
+      rc = dbBE_Redis_create_coalesce( input->_backend->_transport,
+                                       input->_backend->_sender_buffer,
+                                       conn->_cmd->_cmd,
+                                       conn->_cmd->_index,
+                                       rc );
     if( rc < 0 )
     {
       LOG( DBG_ERR, stderr, "Failed to create command. rc=%d\n", rc );
@@ -380,8 +619,7 @@ void* dbBE_Redis_sender( void *args )
     }
 
     // update cmd buffer status for this connection
-    if( dbBE_Transport_sge_buffer_add( conn->_cmd, rc ) > ( (DBBE_SGE_MAX << 4) * 3 ))
-      request_limit = 1; // if we exceed 75% of the SGE space, we better stop to avoid blowing the limit with the next request
+    dbBE_Transport_sge_buffer_add( conn->_cmd, rc );
 
     // instead of sending, add connection to a pending connections list
     if(( pending_last < 0 ) || ( conn->_index != pending_conn[ pending_last ] ))
@@ -400,16 +638,7 @@ void* dbBE_Redis_sender( void *args )
 
 skip_sending:
   // before triggering the receiver, do the post on all pending connections
-  while( pending_last >= 0 )
-  {
-    rc = dbBE_Redis_connection_send_cmd( dbBE_Redis_connection_mgr_get_connection_at( input->_backend->_conn_mgr, pending_conn[ pending_last ] ) );
-    if( rc < 0 )
-    {
-      LOG( DBG_ERR, stderr, "Failed to send command. rc=%d\n", rc );
-      break;
-    }
-    --pending_last;
-  }
+  dbBE_Redis_sender_post_pending( input->_backend, input->_backend->_sender_connections, &pending_last );
   dbBE_Transport_sr_buffer_reset( input->_backend->_sender_buffer );
 
   // complete the request with an error
@@ -112,7 +112,7 @@ int test_put( dbBE_Redis_command_stage_spec_t *stage_specs,
 
   usr->_opcode = DBBE_OPCODE_PUT;
 
-  rc += TEST_NOT_RC( dbBE_Redis_request_allocate( usr ), NULL, request );
+  rc += TEST_NOT_RC( dbBE_Redis_request_allocate( NULL, usr ), NULL, request );
 
   // a regular successful put
   rc += TEST( test_completion( request, &result, 0, DBR_SUCCESS, 1 ), 0 );
@@ -175,7 +175,7 @@ int test_get( dbBE_Redis_command_stage_spec_t *stage_specs,
 
   TEST_BREAK( rc, "mem-allocation failed" );
 
-  rc += TEST_NOT_RC( dbBE_Redis_request_allocate( usr ), NULL, request );
+  rc += TEST_NOT_RC( dbBE_Redis_request_allocate( NULL, usr ), NULL, request );
 
   result._type = dbBE_REDIS_TYPE_INT;
   result._data._integer = datalen;
@@ -251,7 +251,7 @@ int test_move( dbBE_Redis_command_stage_spec_t *stage_specs,
 
   TEST_BREAK( rc, "mem-allocation failed" );
 
-  rc += TEST_NOT_RC( dbBE_Redis_request_allocate( usr ), NULL, request );
+  rc += TEST_NOT_RC( dbBE_Redis_request_allocate( NULL, usr ), NULL, request );
 
   result._type = dbBE_REDIS_TYPE_INT;
   result._data._integer = datalen;
@@ -328,7 +328,7 @@ int test_remove( dbBE_Redis_command_stage_spec_t *stage_specs,
 
   usr->_opcode = DBBE_OPCODE_REMOVE;
 
-  rc += TEST_NOT_RC( dbBE_Redis_request_allocate( usr ), NULL, request );
+  rc += TEST_NOT_RC( dbBE_Redis_request_allocate( NULL, usr ), NULL, request );
 
   // a regular successful remove
   rc += TEST( test_completion( request, &result, 0, DBR_SUCCESS, 0 ), 0 );
@@ -387,7 +387,7 @@ int test_directory( dbBE_Redis_command_stage_spec_t *stage_specs,
   usr->_sge[0].iov_base = data;
   usr->_sge[0].iov_len = datalen;
 
-  rc += TEST_NOT_RC( dbBE_Redis_request_allocate( usr ), NULL, request );
+  rc += TEST_NOT_RC( dbBE_Redis_request_allocate( NULL, usr ), NULL, request );
 
   // a regular successful directory
   rc += TEST( test_completion( request, &result, 0, DBR_SUCCESS, datalen ), 0 );
@@ -453,7 +453,7 @@ int test_nscreate( dbBE_Redis_command_stage_spec_t *stage_specs,
   usr->_sge[0].iov_base = NULL;
   usr->_sge[0].iov_len = 0;
 
-  rc += TEST_NOT_RC( dbBE_Redis_request_allocate( usr ), NULL, request );
+  rc += TEST_NOT_RC( dbBE_Redis_request_allocate( NULL, usr ), NULL, request );
 
   // a regular successful nscreate
   rc += TEST( test_completion( request, &result, 0, DBR_SUCCESS, (int64_t)ns ), 0 );
@@ -525,7 +525,7 @@ int test_nsattach( dbBE_Redis_command_stage_spec_t *stage_specs,
   usr->_sge[0].iov_base = NULL;
   usr->_sge[0].iov_len = 0;
 
-  rc += TEST_NOT_RC( dbBE_Redis_request_allocate( usr ), NULL, request );
+  rc += TEST_NOT_RC( dbBE_Redis_request_allocate( NULL, usr ), NULL, request );
 
   // a regular successful nsattach
   rc += TEST( test_completion( request, &result, 0, DBR_SUCCESS, (int64_t)ns ), 0 );
@@ -599,7 +599,7 @@ int test_nsdetach( dbBE_Redis_command_stage_spec_t *stage_specs,
   usr->_sge[0].iov_base = NULL;
   usr->_sge[0].iov_len = 0;
 
-  rc += TEST_NOT_RC( dbBE_Redis_request_allocate( usr ), NULL, request );
+  rc += TEST_NOT_RC( dbBE_Redis_request_allocate( NULL, usr ), NULL, request );
 
   // a regular successful nsdetach
   rc += TEST( test_completion( request, &result, 0, DBR_SUCCESS, 0 ), 0 );
@@ -669,7 +669,7 @@ int test_nsdelete( dbBE_Redis_command_stage_spec_t *stage_specs,
   usr->_sge[0].iov_base = NULL;
   usr->_sge[0].iov_len = 0;
 
-  rc += TEST_NOT_RC( dbBE_Redis_request_allocate( usr ), NULL, request );
+  rc += TEST_NOT_RC( dbBE_Redis_request_allocate( NULL, usr ), NULL, request );
 
   // delete of busy namespace: DBR_ERR_NSBUSY and rc = refcount
   result._data._integer = 5;
@@ -743,7 +743,7 @@ int test_nsquery( dbBE_Redis_command_stage_spec_t *stage_specs,
   usr->_sge[0].iov_base = data;
   usr->_sge[0].iov_len = datalen;
 
-  rc += TEST_NOT_RC( dbBE_Redis_request_allocate( usr ), NULL, request );
+  rc += TEST_NOT_RC( dbBE_Redis_request_allocate( NULL, usr ), NULL, request );
 
   // a regular successful query
   rc += TEST( test_completion( request, &result, 0, DBR_SUCCESS, datalen >> 1 ), 0 );
@@ -807,7 +807,7 @@ int test_iterator( dbBE_Redis_command_stage_spec_t *stage_specs,
   usr->_sge[0].iov_base = data;
   usr->_sge[0].iov_len = datalen;
 
-  rc += TEST_NOT_RC( dbBE_Redis_request_allocate( usr ), NULL, request );
+  rc += TEST_NOT_RC( dbBE_Redis_request_allocate( NULL, usr ), NULL, request );
 
   dbBE_Redis_iterator_list_t itlist = NULL;
   rc += TEST_NOT_RC( dbBE_Redis_iterator_list_allocate(), NULL, itlist );
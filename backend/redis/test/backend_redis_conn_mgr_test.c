@@ -45,7 +45,7 @@ int test_request_each( dbBE_Redis_connection_mgr_t *conn_mgr )
   user._group = DBR_GROUP_EMPTY;
   user._opcode = DBBE_OPCODE_NSDELETE;
 
-  dbBE_Redis_request_t *rbase = dbBE_Redis_request_allocate( &user );
+  dbBE_Redis_request_t *rbase = dbBE_Redis_request_allocate( NULL, &user );
   if( rbase == NULL )
   {
     TEST_LOG( 1, "Request allocation failed" );
@@ -110,6 +110,7 @@ int main( int argc, char ** argv )
 
   dbBE_Redis_conn_mgr_config_t config;
   config._rbuf_len = 16384;
+  config._pool_size = 1;
 
   rc += TEST_NOT_RC( dbBE_Redis_locator_create(), NULL, locator );
   rc += TEST( dbBE_Redis_connection_mgr_init( NULL ), NULL );
@@ -129,6 +130,16 @@ int main( int argc, char ** argv )
 
   rc += TEST_NOT( dbBE_Redis_connection_link( conn, host, auth ), NULL );
   rc += TEST( dbBE_Redis_connection_mgr_add( mgr, conn ), 0 );
+
+  // without pooling, every slot maps to the regular connection
+  rc += TEST( dbBE_Redis_connection_mgr_get_pooled( mgr, NULL, 0 ), NULL );
+  rc += TEST( dbBE_Redis_connection_mgr_get_pooled( mgr, conn, 0 ), conn );
+  rc += TEST( dbBE_Redis_connection_mgr_get_pooled( mgr, conn, 12345 ), conn );
+  rc += TEST( dbBE_Redis_connection_mgr_index_is_pooled( conn->_index ), 0 );
+  rc += TEST( dbBE_Redis_connection_mgr_index_is_pooled( DBBE_REDIS_POOLED_INDEX_BASE ), 1 );
+  rc += TEST( dbBE_Redis_connection_mgr_get_pool_owner( mgr, conn->_index ), conn->_index );
+  rc += TEST( dbBE_Redis_connection_mgr_drop_pooled( mgr, conn ), -EINVAL );
+
   rc += TEST( dbBE_Redis_connection_mgr_retrieve_info( NULL, NULL, NULL, DBBE_INFO_CATEGORY_UNSPECIFIED ), NULL );
   rc += TEST( dbBE_Redis_connection_mgr_retrieve_info( mgr, NULL, NULL, DBBE_INFO_CATEGORY_UNSPECIFIED ), NULL );
   rc += TEST( dbBE_Redis_connection_mgr_retrieve_info( mgr, conn, NULL, DBBE_INFO_CATEGORY_UNSPECIFIED ), NULL );
@@ -19,6 +19,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
 
 #include "../backend/redis/redis.h"
 #include "common/utility.h"
@@ -27,6 +29,313 @@
 
 #define DBBE_TEST_BUFFER_LEN ( 1024 )
 
+/*
+ * send more than the socket buffer can take over a socketpair:
+ * the remainder has to be parked and later commands have to queue up behind it
+ */
+int test_partial_send()
+{
+  int rc = 0;
+  int sv[ 2 ];
+  rc += TEST( socketpair( AF_UNIX, SOCK_STREAM, 0, sv ), 0 );
+  TEST_BREAK( rc, "socketpair failed" );
+
+  int bufsize = 4096;
+  setsockopt( sv[ 0 ], SOL_SOCKET, SO_SNDBUF, &bufsize, sizeof( bufsize ) );
+  setsockopt( sv[ 1 ], SOL_SOCKET, SO_RCVBUF, &bufsize, sizeof( bufsize ) );
+
+  dbBE_Redis_connection_t *conn = dbBE_Redis_connection_create( DBBE_REDIS_SR_BUFFER_LEN );
+  rc += TEST_NOT( conn, NULL );
+  TEST_BREAK( rc, "connection creation failed" );
+  conn->_socket = sv[ 0 ];
+  conn->_status = DBBE_CONNECTION_STATUS_AUTHORIZED;
+
+  const size_t len = 1024 * 1024;
+  char *data = (char*)malloc( 2 * len );
+  char *recvd = (char*)malloc( 2 * len );
+  size_t n;
+  for( n = 0; n < 2 * len; ++n )
+    data[ n ] = (char)( n * 7 );
+
+  // first command: two SGEs, much more than the socket accepts
+  conn->_cmd->_cmd[ 0 ].iov_base = data;
+  conn->_cmd->_cmd[ 0 ].iov_len = 100;
+  conn->_cmd->_cmd[ 1 ].iov_base = data + 100;
+  conn->_cmd->_cmd[ 1 ].iov_len = len - 100;
+  conn->_cmd->_index = 2;
+  rc += TEST( dbBE_Redis_connection_send_cmd( conn, NULL ), (ssize_t)len );
+  rc += TEST( conn->_cmd->_index, 0 );
+  rc += TEST_NOT( dbBE_Redis_connection_send_pending( conn ), 0 );
+
+  // second command is queued behind the pending data
+  conn->_cmd->_cmd[ 0 ].iov_base = data + len;
+  conn->_cmd->_cmd[ 0 ].iov_len = len;
+  conn->_cmd->_index = 1;
+  rc += TEST( dbBE_Redis_connection_send_cmd( conn, NULL ), (ssize_t)len );
+  rc += TEST_NOT( dbBE_Redis_connection_send_pending( conn ), 0 );
+
+  // the data got copied, wipe the source to make sure it's not used any more
+  memset( data, 0, len );
+
+  // drain the other end and flush until everything arrived
+  size_t received = 0;
+  while(( rc == 0 ) && ( received < 2 * len ))
+  {
+    ssize_t r = recv( sv[ 1 ], recvd + received, 2 * len - received, MSG_DONTWAIT );
+    if( r > 0 )
+      received += r;
+    rc += ( dbBE_Redis_connection_flush( conn ) < 0 );
+  }
+  rc += TEST( received, 2 * len );
+  rc += TEST( dbBE_Redis_connection_send_pending( conn ), 0 );
+  for( n = 0; n < 2 * len; ++n )
+    data[ n ] = (char)( n * 7 );
+  rc += TEST( memcmp( data, recvd, 2 * len ), 0 );
+
+  // pending data of a failed connection is dropped with the connection
+  conn->_cmd->_cmd[ 0 ].iov_base = data;
+  conn->_cmd->_cmd[ 0 ].iov_len = len;
+  conn->_cmd->_index = 1;
+  rc += TEST( dbBE_Redis_connection_send_cmd( conn, NULL ), (ssize_t)len );
+  rc += TEST( dbBE_Redis_connection_unlink( conn ), 0 );
+  rc += TEST( dbBE_Redis_connection_send_pending( conn ), 0 );
+
+  close( sv[ 1 ] );
+  free( recvd );
+  free( data );
+  dbBE_Redis_connection_destroy( conn );
+  return rc;
+}
+
+/*
+ * congested sends only copy the data of the transient buffer, user data stays referenced
+ */
+int test_zero_copy_send()
+{
+  int rc = 0;
+  int sv[ 2 ];
+  rc += TEST( socketpair( AF_UNIX, SOCK_STREAM, 0, sv ), 0 );
+  TEST_BREAK( rc, "socketpair failed" );
+
+  int bufsize = 4096;
+  setsockopt( sv[ 0 ], SOL_SOCKET, SO_SNDBUF, &bufsize, sizeof( bufsize ) );
+  setsockopt( sv[ 1 ], SOL_SOCKET, SO_RCVBUF, &bufsize, sizeof( bufsize ) );
+
+  dbBE_Redis_connection_t *conn = dbBE_Redis_connection_create( DBBE_REDIS_SR_BUFFER_LEN );
+  rc += TEST_NOT( conn, NULL );
+  TEST_BREAK( rc, "connection creation failed" );
+  conn->_socket = sv[ 0 ];
+  conn->_status = DBBE_CONNECTION_STATUS_AUTHORIZED;
+
+  dbBE_Redis_sr_buffer_t *sbuf = dbBE_Transport_sr_buffer_allocate( DBBE_REDIS_SR_BUFFER_LEN );
+  rc += TEST_NOT( sbuf, NULL );
+  TEST_BREAK( rc, "buffer allocation failed" );
+
+  const size_t hlen = 64;
+  const size_t len = 1024 * 1024;
+  const size_t total = 2 * ( hlen + len );
+  char *data = (char*)malloc( 2 * len );
+  char *expect = (char*)malloc( total );
+  char *recvd = (char*)malloc( total );
+  char *header = dbBE_Transport_sr_buffer_get_start( sbuf );
+  size_t n;
+  for( n = 0; n < 2 * len; ++n )
+    data[ n ] = (char)( n * 7 );
+  for( n = 0; n < 2 * hlen; ++n )
+    header[ n ] = (char)( n + 1 );
+  memcpy( expect, header, hlen );
+  memcpy( expect + hlen, data, len );
+  memcpy( expect + hlen + len, header + hlen, hlen );
+  memcpy( expect + 2 * hlen + len, data + len, len );
+
+  // two commands of a header in the sender buffer and a large user value
+  int c;
+  for( c = 0; c < 2; ++c )
+  {
+    conn->_cmd->_cmd[ 0 ].iov_base = header + c * hlen;
+    conn->_cmd->_cmd[ 0 ].iov_len = hlen;
+    conn->_cmd->_cmd[ 1 ].iov_base = data + c * len;
+    conn->_cmd->_cmd[ 1 ].iov_len = len;
+    conn->_cmd->_index = 2;
+    rc += TEST( dbBE_Redis_connection_send_cmd( conn, sbuf ), (ssize_t)( hlen + len ) );
+  }
+  rc += TEST_NOT( dbBE_Redis_connection_send_pending( conn ), 0 );
+
+  // the second value is referenced, its header copied
+  rc += TEST( conn->_pending[ conn->_pending_cnt - 1 ].iov_base, data + len );
+  rc += TEST( conn->_pending_copy[ conn->_pending_cnt - 1 ], DBBE_REDIS_PENDING_REF );
+  rc += TEST_NOT( conn->_pending[ conn->_pending_cnt - 2 ].iov_base, header + hlen );
+  rc += TEST( conn->_pending_data_len, hlen );
+
+  // the sender buffer gets reused
+  memset( header, 0, 2 * hlen );
+
+  size_t received = 0;
+  while(( rc == 0 ) && ( received < total ))
+  {
+    ssize_t r = recv( sv[ 1 ], recvd + received, total - received, MSG_DONTWAIT );
+    if( r > 0 )
+      received += r;
+    rc += ( dbBE_Redis_connection_flush( conn ) < 0 );
+  }
+  rc += TEST( received, total );
+  rc += TEST( dbBE_Redis_connection_send_pending( conn ), 0 );
+  rc += TEST( conn->_pending_cnt, 0 );
+  rc += TEST( memcmp( expect, recvd, total ), 0 );
+
+  // a failed send is reported by the flush
+  conn->_cmd->_cmd[ 0 ].iov_base = data;
+  conn->_cmd->_cmd[ 0 ].iov_len = len;
+  conn->_cmd->_index = 1;
+  rc += TEST( dbBE_Redis_connection_send_cmd( conn, sbuf ), (ssize_t)len );
+  rc += TEST_NOT( dbBE_Redis_connection_send_pending( conn ), 0 );
+  close( sv[ 1 ] );
+  ssize_t frc = 0;
+  while(( frc = dbBE_Redis_connection_flush( conn ) ) > 0 ) {}
+  rc += TEST( frc, -EPIPE );
+
+  rc += TEST( dbBE_Redis_connection_unlink( conn ), 0 );
+  rc += TEST( dbBE_Redis_connection_send_pending( conn ), 0 );
+  free( recvd );
+  free( expect );
+  free( data );
+  dbBE_Transport_sr_buffer_free( sbuf );
+  dbBE_Redis_connection_destroy( conn );
+  return rc;
+}
+
+/*
+ * receive a value straight into multiple SGEs with the following data ending up in the last SGE
+ */
+int test_large_recv()
+{
+  int rc = 0;
+  int sv[ 2 ];
+  rc += TEST( socketpair( AF_UNIX, SOCK_STREAM, 0, sv ), 0 );
+  TEST_BREAK( rc, "socketpair failed" );
+
+  dbBE_Redis_connection_t *conn = dbBE_Redis_connection_create( DBBE_REDIS_SR_BUFFER_LEN );
+  rc += TEST_NOT( conn, NULL );
+  TEST_BREAK( rc, "connection creation failed" );
+  conn->_socket = sv[ 0 ];
+  conn->_status = DBBE_CONNECTION_STATUS_AUTHORIZED;
+
+  const size_t len = 100000;
+  const char *trailer = "\r\n+OK\r\n";
+  char *data = (char*)malloc( len );
+  char *recvd = (char*)calloc( 1, len );
+  char tail[ DBBE_TEST_BUFFER_LEN ];
+  size_t n;
+  for( n = 0; n < len; ++n )
+    data[ n ] = (char)( n * 13 );
+
+  rc += TEST( send( sv[ 1 ], data, len, 0 ), (ssize_t)len );
+  rc += TEST( send( sv[ 1 ], trailer, strlen( trailer ), 0 ), (ssize_t)strlen( trailer ) );
+
+  dbBE_Transport_sge_buffer_t sb;
+  sb._cmd[ 0 ].iov_base = recvd;
+  sb._cmd[ 0 ].iov_len = 40000;
+  sb._cmd[ 1 ].iov_base = recvd + 40000;
+  sb._cmd[ 1 ].iov_len = 40000;
+  sb._cmd[ 2 ].iov_base = recvd + 80000;
+  sb._cmd[ 2 ].iov_len = len - 80000;
+  sb._cmd[ 3 ].iov_base = tail;
+  sb._cmd[ 3 ].iov_len = DBBE_TEST_BUFFER_LEN;
+  sb._index = 4;
+  rc += TEST( dbBE_Redis_connection_recv_sge( conn, &sb ), (ssize_t)( len + strlen( trailer ) ) );
+  rc += TEST( memcmp( data, recvd, len ), 0 );
+  rc += TEST( memcmp( tail, trailer, strlen( trailer ) ), 0 );
+
+  // scrap space is allocated on demand and limited
+  rc += TEST( conn->_scrap, NULL );
+  rc += TEST_NOT( dbBE_Redis_connection_get_scrap( conn, 100 ), NULL );
+  rc += TEST( conn->_scrap_len, DBBE_REDIS_SCRAP_SPACE_MIN );
+  rc += TEST_NOT( dbBE_Redis_connection_get_scrap( conn, 3 * DBBE_REDIS_SCRAP_SPACE_MIN ), NULL );
+  rc += TEST( conn->_scrap_len, 4 * DBBE_REDIS_SCRAP_SPACE_MIN );
+  rc += TEST( dbBE_Redis_connection_get_scrap( conn, DBBE_REDIS_SCRAP_SPACE_LEN + 1 ), NULL );
+
+  // runtime limit is clamped into the growth
+  dbBE_Redis_connection_set_buffer_limits( conn, 6 * DBBE_REDIS_SCRAP_SPACE_MIN, 0 );
+  rc += TEST( dbBE_Redis_connection_get_scrap( conn, 6 * DBBE_REDIS_SCRAP_SPACE_MIN + 1 ), NULL );
+  rc += TEST_NOT( dbBE_Redis_connection_get_scrap( conn, 5 * DBBE_REDIS_SCRAP_SPACE_MIN ), NULL );
+  rc += TEST( conn->_scrap_len, 6 * DBBE_REDIS_SCRAP_SPACE_MIN );
+  dbBE_Redis_connection_set_buffer_limits( conn, 0, 0 );
+  rc += TEST( conn->_scrap_max, DBBE_REDIS_SCRAP_SPACE_LEN );
+
+  rc += TEST( dbBE_Redis_connection_unlink( conn ), 0 );
+  close( sv[ 1 ] );
+  free( recvd );
+  free( data );
+  dbBE_Redis_connection_destroy( conn );
+  return rc;
+}
+
+/*
+ * a value that arrives in pieces is parked in the connection and completed when more data is there
+ */
+int test_bulk_recv()
+{
+  int rc = 0;
+  int sv[ 2 ];
+  rc += TEST( socketpair( AF_UNIX, SOCK_STREAM, 0, sv ), 0 );
+  TEST_BREAK( rc, "socketpair failed" );
+
+  dbBE_Redis_connection_t *conn = dbBE_Redis_connection_create( DBBE_REDIS_SR_BUFFER_LEN );
+  rc += TEST_NOT( conn, NULL );
+  TEST_BREAK( rc, "connection creation failed" );
+  conn->_socket = sv[ 0 ];
+  conn->_status = DBBE_CONNECTION_STATUS_AUTHORIZED;
+
+  const size_t len = 100000;
+  const size_t first = 30000;
+  const char *trailer = "\r\n+OK\r\n";
+  char *data = (char*)malloc( len );
+  char *recvd = (char*)calloc( 1, len );
+  char tail[ DBBE_TEST_BUFFER_LEN ];
+  size_t n;
+  for( n = 0; n < len; ++n )
+    data[ n ] = (char)( n * 7 );
+
+  dbBE_Redis_request_t request;
+  dbBE_sge_t sge[ 3 ];
+  sge[ 0 ].iov_base = recvd;
+  sge[ 0 ].iov_len = 50000;
+  sge[ 1 ].iov_base = recvd + 50000;
+  sge[ 1 ].iov_len = len - 50000;
+  sge[ 2 ].iov_base = tail;
+  sge[ 2 ].iov_len = DBBE_TEST_BUFFER_LEN;
+
+  // nothing there yet: the request stays parked without blocking
+  rc += TEST( dbBE_Redis_connection_bulk_park( conn, &request, sge, 3, len + 2, 0 ), 0 );
+  rc += TEST( dbBE_Redis_connection_bulk_park( conn, &request, sge, 3, len + 2, 0 ), -EBUSY );
+  rc += TEST( dbBE_Redis_connection_bulk_request( conn ), &request );
+  rc += TEST( dbBE_Redis_connection_bulk_resume( conn ), -EINPROGRESS );
+
+  rc += TEST( send( sv[ 1 ], data, first, 0 ), (ssize_t)first );
+  rc += TEST( dbBE_Redis_connection_bulk_resume( conn ), -EINPROGRESS );
+  rc += TEST( conn->_bulk_done, (int64_t)first );
+  rc += TEST( dbBE_Redis_connection_bulk_request( conn ), &request );
+
+  rc += TEST( send( sv[ 1 ], data + first, len - first, 0 ), (ssize_t)( len - first ) );
+  rc += TEST( send( sv[ 1 ], trailer, strlen( trailer ), 0 ), (ssize_t)strlen( trailer ) );
+  rc += TEST( dbBE_Redis_connection_bulk_resume( conn ), (int64_t)( len + strlen( trailer ) ) );
+  rc += TEST( dbBE_Redis_connection_bulk_request( conn ), NULL );
+  rc += TEST( memcmp( data, recvd, len ), 0 );
+  rc += TEST( memcmp( tail, trailer, strlen( trailer ) ), 0 );
+
+  // a failed connection hands back the parked request
+  rc += TEST( dbBE_Redis_connection_bulk_park( conn, &request, sge, 3, len + 2, 0 ), 0 );
+  rc += TEST( dbBE_Redis_connection_bulk_abort( conn ), &request );
+  rc += TEST( dbBE_Redis_connection_bulk_request( conn ), NULL );
+
+  rc += TEST( dbBE_Redis_connection_unlink( conn ), 0 );
+  close( sv[ 1 ] );
+  free( recvd );
+  free( data );
+  dbBE_Redis_connection_destroy( conn );
+  return rc;
+}
+
 int main( int argc, char ** argv )
 {
   int rc = 0;
@@ -42,6 +351,11 @@ int main( int argc, char ** argv )
   rc += TEST( dbBE_Redis_connection_get_status( conn ), DBBE_CONNECTION_STATUS_INITIALIZED );
   fprintf(stderr,"0. rc=%d\n", rc);
 
+  rc += test_partial_send();
+  rc += test_zero_copy_send();
+  rc += test_large_recv();
+  rc += test_bulk_recv();
+
 
   char *url = dbBE_Extract_env( DBR_SERVER_HOST_ENV, DBR_SERVER_DEFAULT_HOST );
   rc += TEST_NOT( url, NULL );
@@ -111,9 +425,9 @@ int main( int argc, char ** argv )
 
   dbBE_sge_t sge[4];
   memset( sge, 0, 4 * sizeof( dbBE_sge_t ) );
-  rc += TEST( dbBE_Redis_connection_send_cmd( NULL ), -EINVAL );
+  rc += TEST( dbBE_Redis_connection_send_cmd( NULL, NULL ), -EINVAL );
   conn->_cmd->_index = DBBE_SGE_MAX+1;
-  rc += TEST( dbBE_Redis_connection_send_cmd( conn ), -EINVAL );
+  rc += TEST( dbBE_Redis_connection_send_cmd( conn, NULL ), -EINVAL );
   conn->_cmd->_index = 0;
 
   rc += TEST( dbBE_Redis_connection_unlink( conn ), -EINVAL );
@@ -0,0 +1,120 @@
+/*
+ * Copyright © 2018-2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * microbenchmark: keys/second hashed into Redis cluster slots
+ * usage: backend_redis_crc16_bench [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../crc16.h"
+#include "../locator.h"
+
+#define BENCH_KEY_COUNT ( 1024 )
+#define BENCH_DEFAULT_ITERATIONS ( 2000 )
+
+/*
+ * bit-by-bit CRC16 (the previous implementation without the padding copy) for comparison
+ */
+static
+int crc16_bitwise( const char *message, const uint16_t size )
+{
+  unsigned int remain = 0;
+  int i;
+  for( i = 0; i < size + 2; ++i )
+  {
+    unsigned char byte = ( i < size ) ? message[ i ] : 0;
+    unsigned int mask;
+    for( mask = 0x80; mask > 0; mask >>= 1 )
+    {
+      remain <<= 1;
+      if( byte & mask ) remain += 1;
+      if( remain > 0xffff )
+      {
+        remain &= 0xffff;
+        remain ^= 0x1021;
+      }
+    }
+  }
+  return remain;
+}
+
+static
+double now_sec()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int main( int argc, char **argv )
+{
+  long iterations = BENCH_DEFAULT_ITERATIONS;
+  if( argc > 1 )
+    iterations = strtol( argv[ 1 ], NULL, 10 );
+  if( iterations <= 0 )
+    iterations = BENCH_DEFAULT_ITERATIONS;
+
+  // namespace::key style keys of typical length
+  static char keys[ BENCH_KEY_COUNT ][ 64 ];
+  uint16_t lens[ BENCH_KEY_COUNT ];
+  int n;
+  for( n = 0; n < BENCH_KEY_COUNT; ++n )
+    lens[ n ] = snprintf( keys[ n ], 64, "BenchmarkNS" DBBE_REDIS_NAMESPACE_SEPARATOR "key_%08d", n * 7919 );
+
+  // verify before timing
+  for( n = 0; n < BENCH_KEY_COUNT; ++n )
+    if( crcremainder( keys[ n ], lens[ n ] ) != crc16_bitwise( keys[ n ], lens[ n ] ) )
+    {
+      fprintf( stderr, "CRC mismatch for key %s\n", keys[ n ] );
+      return 1;
+    }
+
+  unsigned sink = 0;
+  long i;
+  double start, bitwise, table, slot;
+
+  start = now_sec();
+  for( i = 0; i < iterations; ++i )
+    for( n = 0; n < BENCH_KEY_COUNT; ++n )
+      sink += crc16_bitwise( keys[ n ], lens[ n ] );
+  bitwise = now_sec() - start;
+
+  start = now_sec();
+  for( i = 0; i < iterations; ++i )
+    for( n = 0; n < BENCH_KEY_COUNT; ++n )
+      sink += crcremainder( keys[ n ], lens[ n ] );
+  table = now_sec() - start;
+
+  start = now_sec();
+  for( i = 0; i < iterations; ++i )
+    for( n = 0; n < BENCH_KEY_COUNT; ++n )
+      sink += dbBE_Redis_locator_hash( keys[ n ], lens[ n ] );
+  slot = now_sec() - start;
+
+  double keys_total = (double)iterations * BENCH_KEY_COUNT;
+  printf( "keys hashed:        %.0f (avg len %d)\n", keys_total, lens[ BENCH_KEY_COUNT / 2 ] );
+  printf( "bitwise crc16:      %12.0f keys/s\n", keys_total / bitwise );
+  printf( "table crc16:        %12.0f keys/s\n", keys_total / table );
+  printf( "locator_hash (tag): %12.0f keys/s\n", keys_total / slot );
+  printf( "(checksum %u)\n", sink );
+  return 0;
+}
@@ -17,6 +17,7 @@
 
 #include "test_utils.h"
 #include "../crc16.h"
+#include "../locator.h"
 
 int main(int argc, char * argv[])
 {
@@ -52,6 +53,33 @@ int main(int argc, char * argv[])
   rc += TEST( crcremainder( msg, 9 ), 0x1e7a );
   TEST_LOG( rc, "Regular CRC failed" );
 
+  // odd and even lengths take different paths through the sliced loop
+  rc += TEST( crcremainder( "1", 1 ), 0x2672 );
+  rc += TEST( crcremainder( "12345678", 8 ), 0x9015 );
+  TEST_LOG( rc, "Odd/even length CRC failed" );
+
+  // hash tags
+  uint16_t len;
+  const char *tagged = "{user1000}.following";
+  len = strlen( tagged );
+  rc += TEST( crc16_hashtag( tagged, &len ), tagged + 1 );
+  rc += TEST( len, 8 );
+  rc += TEST( dbBE_Redis_locator_hash( tagged, strlen( tagged ) ), dbBE_Redis_locator_hash( "user1000", 8 ) );
+  rc += TEST( dbBE_Redis_locator_hash( "foo{user1000}bar{x}", 19 ), dbBE_Redis_locator_hash( "user1000", 8 ) );
+  rc += TEST( dbBE_Redis_locator_hash( "123456789", 9 ), 0x31C3 & 0x3FFF );
+  TEST_LOG( rc, "Hash tag failed" );
+
+  // no valid tag: hash the whole key
+  const char *untagged[] = { "foo{}{bar}", "foo{bar", "foo}bar{", "{", "}{", NULL };
+  int n;
+  for( n = 0; untagged[ n ] != NULL; ++n )
+  {
+    len = strlen( untagged[ n ] );
+    rc += TEST( crc16_hashtag( untagged[ n ], &len ), untagged[ n ] );
+    rc += TEST( len, strlen( untagged[ n ] ) );
+  }
+  TEST_LOG( rc, "Invalid hash tag failed" );
+
 
   if (argc < 2)
     free( msg );
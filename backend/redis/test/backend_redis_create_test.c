@@ -59,6 +59,37 @@ int Flatten_cmd( dbBE_sge_t *cmd, int cmdlen, dbBE_Redis_sr_buffer_t *dest )
 
 extern int dbBE_Redis_create_key_cmd( dbBE_Redis_request_t *request, char *keybuf, uint16_t size );
 
+int stage_compile_test()
+{
+  int rc = 0;
+  dbBE_Redis_command_stage_spec_t stage;
+  memset( &stage, 0, sizeof( stage ) );
+
+  stage._array_len = 2;
+  strcpy( stage._command, "*4\r\n$7\r\nHINCRBY\r\n%0$6\r\nrefcnt\r\n%1" );
+  rc += TEST( dbBE_Redis_command_stage_compile( &stage ), 4 );
+  rc += TEST( stage._command_len, strlen( stage._command ) );
+  rc += TEST( stage._segments[ 0 ]._arg, DBBE_REDIS_COMMAND_SEGMENT_FIXED );
+  rc += TEST( stage._segments[ 0 ]._len, 17 );
+  rc += TEST( stage._segments[ 1 ]._arg, 0 );
+  rc += TEST( stage._segments[ 2 ]._arg, DBBE_REDIS_COMMAND_SEGMENT_FIXED );
+  rc += TEST( strncmp( &stage._command[ stage._segments[ 2 ]._offset ], "$6\r\nrefcnt\r\n", stage._segments[ 2 ]._len ), 0 );
+  rc += TEST( stage._segments[ 3 ]._arg, 1 );
+
+  // back-to-back arguments don't create empty fixed strings
+  strcpy( stage._command, "%0%1" );
+  rc += TEST( dbBE_Redis_command_stage_compile( &stage ), 2 );
+
+  // arguments beyond the array len are invalid
+  strcpy( stage._command, "*2\r\n$3\r\nDEL\r\n%2" );
+  rc += TEST( dbBE_Redis_command_stage_compile( &stage ), -EBADMSG );
+  strcpy( stage._command, "*2\r\n$3\r\nDEL\r\n%" );
+  rc += TEST( dbBE_Redis_command_stage_compile( &stage ), -EBADMSG );
+
+  printf( "stage_compile_test exiting with rc=%d\n", rc );
+  return rc;
+}
+
 int key_creation_test()
 {
   dbBE_Request_t *ureq = (dbBE_Request_t*)calloc( 1, sizeof( dbBE_Request_t ) + 2 * sizeof( dbBE_sge_t ) );
@@ -66,6 +97,10 @@ int key_creation_test()
 
   int rc = 0;
   char *reference = (char*)malloc(DBBE_REDIS_MAX_KEY_LEN);
+  dbBE_Redis_namespace_t *ns = dbBE_Redis_namespace_create( "test" );
+  dbBE_Redis_namespace_t *move_ns = dbBE_Redis_namespace_create( "moved" );
+  if(( ns == NULL ) || ( move_ns == NULL ))
+    return 1;
 
   ureq->_flags = 0;
   ureq->_group = DBR_GROUP_LIST_EMPTY;
@@ -74,10 +109,10 @@ int key_creation_test()
   ureq->_next = NULL;
   ureq->_sge_count = 1;
   ureq->_user = NULL;
-  ureq->_sge[0].iov_base = "moved";
-  ureq->_sge[0].iov_len = 5;
+  ureq->_sge[0].iov_base = move_ns; // target namespace of the move
+  ureq->_sge[0].iov_len = sizeof( dbBE_Redis_namespace_t );
 
-  dbBE_Redis_request_t *req = dbBE_Redis_request_allocate( ureq );
+  dbBE_Redis_request_t *req = dbBE_Redis_request_allocate( NULL, ureq );
   if( req == NULL )
     return 1;
 
@@ -98,7 +133,7 @@ int key_creation_test()
         break;
         break;
       default:
-        ureq->_ns_hdl = "test";
+        ureq->_ns_hdl = ns;
         if( req->_step->_expect == dbBE_REDIS_TYPE_UNSPECIFIED )
           return 10000;
         break;
@@ -139,6 +174,8 @@ int key_creation_test()
   dbBE_Transport_sr_buffer_free( buf );
   free( reference );
   free( ureq );
+  dbBE_Redis_namespace_destroy( ns );
+  dbBE_Redis_namespace_destroy( move_ns );
   return rc;
 }
 
@@ -177,6 +214,7 @@ int main( int argc, char ** argv )
   ureq->_sge[ 1 ].iov_base = strdup(" You're done.");
   ureq->_sge[ 1 ].iov_len = 13;
   ureq->_opcode = DBBE_OPCODE_PUT;
+  ureq->_flags = 0;
   ureq->_key = "bla";
   ureq->_ns_hdl = ns;
 
@@ -185,7 +223,7 @@ int main( int argc, char ** argv )
   rc += TEST( keylen, 11 );
   rc += TEST( vallen, 25 );
 
-  req = dbBE_Redis_request_allocate( ureq );
+  req = dbBE_Redis_request_allocate( NULL, ureq );
   rc += TEST_NOT( req, NULL );
 
   // create a put
@@ -196,6 +234,47 @@ int main( int argc, char ** argv )
                       dbBE_Transport_sr_buffer_get_start( data_buf ) ),
               0 );
   TEST_LOG( rc, dbBE_Transport_sr_buffer_get_start( data_buf ) );
+
+  // small entries coalesce into a single one without changing the data
+  rc += TEST_RC( dbBE_Redis_create_coalesce( &dbBE_Memcopy_transport, sr_buf, cmd, 0, cmdlen ), 1, cmdlen );
+  rc += TEST( Flatten_cmd( cmd, cmdlen, data_buf ), 0 );
+  rc += TEST( strcmp( "*3\r\n$5\r\nRPUSH\r\n$11\r\nTestNS::bla\r\n$25\r\nHello World! You're done.\r\n",
+                      dbBE_Transport_sr_buffer_get_start( data_buf ) ),
+              0 );
+
+  // a second command becomes a single entry too and doesn't touch the first one
+  int cmdlen2 = 0;
+  rc += TEST_RC( dbBE_Redis_create_command_sge( req, sr_buf, &cmd[ 1 ] ), 6, cmdlen2 );
+  rc += TEST( dbBE_Redis_create_coalesce( &dbBE_Memcopy_transport, sr_buf, cmd, 1, cmdlen2 ), 1 );
+  rc += TEST( Flatten_cmd( cmd, 2, data_buf ), 0 );
+  rc += TEST( strcmp( "*3\r\n$5\r\nRPUSH\r\n$11\r\nTestNS::bla\r\n$25\r\nHello World! You're done.\r\n"
+                      "*3\r\n$5\r\nRPUSH\r\n$11\r\nTestNS::bla\r\n$25\r\nHello World! You're done.\r\n",
+                      dbBE_Transport_sr_buffer_get_start( data_buf ) ),
+              0 );
+
+  // entries that don't fit into the buffer stay in place
+  rc += TEST_RC( dbBE_Redis_create_command_sge( req, sr_buf, &cmd[ 1 ] ), 6, cmdlen2 );
+  dbBE_Transport_sr_buffer_add_data( sr_buf, dbBE_Transport_sr_buffer_remaining( sr_buf ), 1 );
+  rc += TEST( dbBE_Redis_create_coalesce( &dbBE_Memcopy_transport, sr_buf, cmd, 1, cmdlen2 ), 5 );
+  rc += TEST( cmd[ 3 ].iov_base, ureq->_sge[ 0 ].iov_base );
+  rc += TEST( dbBE_Redis_create_coalesce( NULL, sr_buf, cmd, 1, cmdlen2 ), -EINVAL );
+  TEST_LOG( rc, "coalesce" );
+  dbBE_Transport_sr_buffer_reset( sr_buf );
+  dbBE_Redis_request_destroy( req );
+
+  // a put to the head of the list
+  ureq->_flags = DBBE_OPCODE_FLAGS_HEAD;
+  req = dbBE_Redis_request_allocate( NULL, ureq );
+  rc += TEST_NOT( req, NULL );
+  rc += TEST_RC( dbBE_Redis_create_command_sge( req, sr_buf, cmd ), 6, cmdlen  );
+  rc += TEST( Flatten_cmd( cmd, cmdlen, data_buf ), 0 );
+  rc += TEST( strcmp( "*3\r\n$5\r\nLPUSH\r\n$11\r\nTestNS::bla\r\n$25\r\nHello World! You're done.\r\n",
+                      dbBE_Transport_sr_buffer_get_start( data_buf ) ),
+              0 );
+  TEST_LOG( rc, dbBE_Transport_sr_buffer_get_start( data_buf ) );
+  dbBE_Transport_sr_buffer_reset( sr_buf );
+  ureq->_flags = 0;
+
   dbBE_Redis_request_destroy( req );
   free( ureq->_sge[ 0 ].iov_base );
   free( ureq->_sge[ 1 ].iov_base );
@@ -204,7 +283,7 @@ int main( int argc, char ** argv )
   ureq->_opcode = DBBE_OPCODE_GET;
   ureq->_sge_count = 1;
 
-  req = dbBE_Redis_request_allocate( ureq );
+  req = dbBE_Redis_request_allocate( NULL, ureq );
   rc += TEST_NOT( req, NULL );
 
   dbBE_Transport_sr_buffer_reset( sr_buf );
@@ -222,7 +301,7 @@ int main( int argc, char ** argv )
   // create a read
   ureq->_opcode = DBBE_OPCODE_READ;
 
-  req = dbBE_Redis_request_allocate( ureq );
+  req = dbBE_Redis_request_allocate( NULL, ureq );
   rc += TEST_NOT( req, NULL );
 
   dbBE_Transport_sr_buffer_reset( sr_buf );
@@ -237,13 +316,63 @@ int main( int argc, char ** argv )
   TEST_LOG( rc, dbBE_Transport_sr_buffer_get_start( data_buf ) );
   dbBE_Redis_request_destroy( req );
 
+  // create a blocking read (only possible for index 0 and if the server supports it)
+  ureq->_flags = 0;
+  req = dbBE_Redis_request_allocate( NULL, ureq );
+  rc += TEST_NOT( req, NULL );
+  rc += TEST( dbBE_Redis_request_set_blocking( req, 0 ), -ENOTSUP );
+  rc += TEST( dbBE_Redis_request_is_blocking( req ), 0 );
+  rc += TEST( dbBE_Redis_request_set_blocking( req, 1 ), 0 );
+  rc += TEST( dbBE_Redis_request_is_blocking( req ), 1 );
+  rc += TEST( dbBE_Redis_request_set_blocking( req, 1 ), -EALREADY );
+
+  dbBE_Transport_sr_buffer_reset( sr_buf );
+  rc += TEST_RC( dbBE_Redis_create_command_sge( req,
+                                                sr_buf,
+                                                cmd ), 4, cmdlen );
+  rc += TEST( Flatten_cmd( cmd, cmdlen, data_buf ), 0 );
+  rc += TEST( strcmp( "*6\r\n$6\r\nBLMOVE\r\n$11\r\nTestNS::bla\r\n$11\r\nTestNS::bla\r\n$4\r\nLEFT\r\n$4\r\nLEFT\r\n$1\r\n" DBBE_REDIS_BLOCKING_TIMEOUT "\r\n",
+                      dbBE_Transport_sr_buffer_get_start( data_buf ) ),
+              0 );
+  TEST_LOG( rc, dbBE_Transport_sr_buffer_get_start( data_buf ) );
+
+  dbBE_Redis_request_set_polling( req );
+  rc += TEST( dbBE_Redis_request_is_blocking( req ), 0 );
+  rc += TEST( req->_step->_stage, DBBE_REDIS_RETRIEVE_STAGE_POLL );
+  dbBE_Redis_request_destroy( req );
+
+  ureq->_flags = ( 3 << 4 );
+  req = dbBE_Redis_request_allocate( NULL, ureq );
+  rc += TEST_NOT( req, NULL );
+  rc += TEST( dbBE_Redis_request_set_blocking( req, 1 ), -ENOTSUP );
+  dbBE_Redis_request_destroy( req );
+  ureq->_flags = 0;
+
+  // create a blocking get
+  ureq->_opcode = DBBE_OPCODE_GET;
+  req = dbBE_Redis_request_allocate( NULL, ureq );
+  rc += TEST_NOT( req, NULL );
+  rc += TEST( dbBE_Redis_request_set_blocking( req, 0 ), 0 );
+
+  dbBE_Transport_sr_buffer_reset( sr_buf );
+  rc += TEST_RC( dbBE_Redis_create_command_sge( req,
+                                                sr_buf,
+                                                cmd ), 3, cmdlen );
+  rc += TEST( Flatten_cmd( cmd, cmdlen, data_buf ), 0 );
+  rc += TEST( strcmp( "*3\r\n$5\r\nBLPOP\r\n$11\r\nTestNS::bla\r\n$1\r\n" DBBE_REDIS_BLOCKING_TIMEOUT "\r\n",
+                      dbBE_Transport_sr_buffer_get_start( data_buf ) ),
+              0 );
+  TEST_LOG( rc, dbBE_Transport_sr_buffer_get_start( data_buf ) );
+  dbBE_Redis_request_destroy( req );
+  ureq->_opcode = DBBE_OPCODE_READ;
+
   // create a directory (meta stage)
   ureq->_opcode = DBBE_OPCODE_DIRECTORY;
   ureq->_sge_count = 1;
   ureq->_match = strdup( "*" );
   ureq->_key = NULL;
 
-  req = dbBE_Redis_request_allocate( ureq );
+  req = dbBE_Redis_request_allocate( NULL, ureq );
   rc += TEST_NOT( req, NULL );
 
   dbBE_Transport_sr_buffer_reset( sr_buf );
@@ -295,7 +424,7 @@ int main( int argc, char ** argv )
   ureq->_sge[0].iov_base = strdup("users, admins");
   ureq->_sge[0].iov_len = strlen( ureq->_sge[0].iov_base );
 
-  req = dbBE_Redis_request_allocate( ureq );
+  req = dbBE_Redis_request_allocate( NULL, ureq );
   rc += TEST_NOT( req, NULL );
 
   dbBE_Transport_sr_buffer_reset( sr_buf );
@@ -351,7 +480,7 @@ int main( int argc, char ** argv )
   ureq->_sge[0].iov_base = meta;
   ureq->_sge[0].iov_len = 10000;
 
-  req = dbBE_Redis_request_allocate( ureq );
+  req = dbBE_Redis_request_allocate( NULL, ureq );
   rc += TEST_NOT( req, NULL );
 
   dbBE_Transport_sr_buffer_reset( sr_buf );
@@ -373,7 +502,7 @@ int main( int argc, char ** argv )
   ureq->_sge[0].iov_base = NULL;
   ureq->_sge[0].iov_len = 0;
 
-  req = dbBE_Redis_request_allocate( ureq );
+  req = dbBE_Redis_request_allocate( NULL, ureq );
   rc += TEST_NOT( req, NULL );
 
   dbBE_Transport_sr_buffer_reset( sr_buf );
@@ -408,7 +537,7 @@ int main( int argc, char ** argv )
   ureq->_sge[0].iov_base = NULL;
   ureq->_sge[0].iov_len = 0;
 
-  req = dbBE_Redis_request_allocate( ureq );
+  req = dbBE_Redis_request_allocate( NULL, ureq );
   rc += TEST_NOT( req, NULL );
 
   dbBE_Transport_sr_buffer_reset( sr_buf );
@@ -475,7 +604,7 @@ int main( int argc, char ** argv )
   ureq->_key = NULL;
   ureq->_ns_hdl = ns;
 
-  req = dbBE_Redis_request_allocate( ureq );
+  req = dbBE_Redis_request_allocate( NULL, ureq );
   rc += TEST_NOT( req, NULL );
 
   rc += TEST( req->_step->_stage, DBBE_REDIS_NSDELETE_STAGE_EXIST );
@@ -509,7 +638,7 @@ int main( int argc, char ** argv )
   ureq->_key = "TestTup";
   ureq->_ns_hdl = ns;
 
-  req = dbBE_Redis_request_allocate( ureq );
+  req = dbBE_Redis_request_allocate( NULL, ureq );
   rc += TEST_NOT( req, NULL );
 
   rc += TEST( req->_step->_stage, 0 );
@@ -521,11 +650,29 @@ int main( int argc, char ** argv )
   TEST_LOG( rc, dbBE_Transport_sr_buffer_get_start( data_buf ) );
   dbBE_Redis_request_destroy( req );
 
+  // create a testkey command
+  ureq->_opcode = DBBE_OPCODE_TESTKEY;
+  ureq->_key = "TestTup";
+  ureq->_ns_hdl = ns;
+
+  req = dbBE_Redis_request_allocate( NULL, ureq );
+  rc += TEST_NOT( req, NULL );
+
+  rc += TEST( req->_step->_stage, 0 );
+  rc += TEST( req->_step->_final, 1 );
+  dbBE_Transport_sr_buffer_reset( sr_buf );
+  rc += TEST_RC( dbBE_Redis_create_command_sge( req, sr_buf, cmd ), 2, cmdlen );
+  rc += TEST( Flatten_cmd( cmd, cmdlen, data_buf ), 0 );
+  rc += TEST( strcmp( "*2\r\n$6\r\nEXISTS\r\n$15\r\nTestNS::TestTup\r\n",
+                      dbBE_Transport_sr_buffer_get_start( data_buf ) ), 0 );
+  TEST_LOG( rc, dbBE_Transport_sr_buffer_get_start( data_buf ) );
+  dbBE_Redis_request_destroy( req );
+
   // create a move command
   ureq->_opcode = DBBE_OPCODE_MOVE;
   ureq->_key = "TestTup";
 
-  req = dbBE_Redis_request_allocate( ureq );
+  req = dbBE_Redis_request_allocate( NULL, ureq );
   rc += TEST_NOT( req, NULL );
 
   rc += TEST( req->_step->_stage, DBBE_REDIS_MOVE_STAGE_DUMP );
@@ -584,7 +731,7 @@ int main( int argc, char ** argv )
   ureq->_sge[0].iov_base = ureq->_key;
   ureq->_sge[0].iov_len = 7;
 
-  req = dbBE_Redis_request_allocate( ureq );
+  req = dbBE_Redis_request_allocate( NULL, ureq );
   rc += TEST_NOT( req, NULL );
 
   rc += TEST( req->_step->_stage, 0 );
@@ -624,6 +771,7 @@ int main( int argc, char ** argv )
 
   free(ureq);
 
+  rc += stage_compile_test();
   rc += key_creation_test();
 
   dbBE_Redis_namespace_destroy( target_ns );
@@ -0,0 +1,148 @@
+/*
+ * Copyright © 2018-2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * microbenchmark: per-operation overhead of the event manager
+ * usage: backend_redis_event_mgr_bench_{libevent|epoll} [iterations [connections]]
+ *
+ * The same source is built against both event manager implementations.
+ * Connections are socketpairs without a server:
+ *  - idle: event_mgr_next() without any pending data
+ *  - ready: one byte written to every connection, then all of them retrieved and drained
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "../event_mgr.h"
+
+#define BENCH_DEFAULT_ITERATIONS ( 2000 )
+#define BENCH_DEFAULT_CONNECTIONS ( 64 )
+
+#ifdef DBBE_REDIS_EVENT_MGR_EPOLL
+#define BENCH_IMPL_NAME "epoll"
+#else
+#define BENCH_IMPL_NAME "libevent"
+#endif
+
+static
+double now_sec()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int main( int argc, char **argv )
+{
+  long iterations = BENCH_DEFAULT_ITERATIONS;
+  int connections = BENCH_DEFAULT_CONNECTIONS;
+  if( argc > 1 )
+    iterations = strtol( argv[ 1 ], NULL, 10 );
+  if( argc > 2 )
+    connections = strtol( argv[ 2 ], NULL, 10 );
+  if( iterations <= 0 )
+    iterations = BENCH_DEFAULT_ITERATIONS;
+  if(( connections <= 0 ) || ( connections > (int)DBBE_REDIS_MAX_CONNECTIONS ))
+    connections = BENCH_DEFAULT_CONNECTIONS;
+
+  dbBE_Redis_event_mgr_t *mgr = dbBE_Redis_event_mgr_init( 100 );
+  dbBE_Redis_connection_t *conns = (dbBE_Redis_connection_t*)calloc( connections, sizeof( dbBE_Redis_connection_t ) );
+  int *peers = (int*)calloc( connections, sizeof( int ) );
+  if(( mgr == NULL ) || ( conns == NULL ) || ( peers == NULL ))
+  {
+    fprintf( stderr, "Failed to allocate\n" );
+    return 1;
+  }
+
+  int n;
+  for( n = 0; n < connections; ++n )
+  {
+    int sv[ 2 ];
+    if( socketpair( AF_UNIX, SOCK_STREAM, 0, sv ) != 0 )
+    {
+      fprintf( stderr, "socketpair failed: %s\n", strerror( errno ) );
+      return 1;
+    }
+    conns[ n ]._socket = sv[ 0 ];
+    conns[ n ]._index = n;
+    conns[ n ]._status = DBBE_CONNECTION_STATUS_AUTHORIZED;
+    peers[ n ] = sv[ 1 ];
+    if( dbBE_Redis_event_mgr_add( mgr, &conns[ n ] ) != 0 )
+    {
+      fprintf( stderr, "Failed to register connection %d\n", n );
+      return 1;
+    }
+  }
+
+  // idle: nothing pending, the loop has to find out that there's nothing to do
+  long i;
+  long unexpected = 0;
+  double start = now_sec();
+  for( i = 0; i < iterations * connections; ++i )
+    if( dbBE_Redis_event_mgr_next( mgr ) != NULL )
+      ++unexpected;
+  double idle = now_sec() - start;
+
+  // ready: every connection has data, retrieve all of them
+  char byte = 'x';
+  double ready = 0.0;
+  long events = 0;
+  for( i = 0; i < iterations; ++i )
+  {
+    for( n = 0; n < connections; ++n )
+      if( write( peers[ n ], &byte, 1 ) != 1 )
+        return 1;
+
+    start = now_sec();
+    int found = 0;
+    long retry = 1000;
+    while(( found < connections ) && ( --retry > 0 ))
+    {
+      dbBE_Redis_connection_t *conn = dbBE_Redis_event_mgr_next( mgr );
+      if( conn == NULL )
+        continue;
+      if( read( conn->_socket, &byte, 1 ) == 1 )
+        ++found;
+      conn->_status = DBBE_CONNECTION_STATUS_AUTHORIZED; // like the receiver after draining
+    }
+    ready += now_sec() - start;
+    events += found;
+  }
+
+  printf( "%-9s conns=%4d idle: %8.1f ns/next()  ready: %8.1f ns/event  (%ld events, %ld unexpected)\n",
+          BENCH_IMPL_NAME, connections,
+          idle * 1e9 / ( iterations * connections ),
+          ready * 1e9 / ( events > 0 ? events : 1 ),
+          events, unexpected );
+
+  for( n = 0; n < connections; ++n )
+  {
+    dbBE_Redis_event_mgr_rm( mgr, &conns[ n ] );
+    close( conns[ n ]._socket );
+    close( peers[ n ] );
+  }
+  dbBE_Redis_event_mgr_exit( mgr );
+  free( conns );
+  free( peers );
+  return ( events == iterations * connections ) ? 0 : 1;
+}
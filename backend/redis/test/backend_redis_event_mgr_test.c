@@ -75,6 +75,34 @@ int main( int argc, char **argv )
   rc += TEST( dbBE_Redis_event_mgr_add( mgr, conn ), -EEXIST );
   conn->_index = 0;
 
+  /////////////////////////////////////////////////////////
+  //  testing the active queue
+  // a queued connection is only queued once and the queue wraps around
+  dbBE_Redis_connection_queue_t *queue = dbBE_Redis_connection_mgr_getqueue( mgr );
+  rc += TEST( dbBE_Redis_connection_queue_push( queue, conn ), 0 );
+  rc += TEST( dbBE_Redis_connection_queue_push( queue, conn ), 0 );
+  rc += TEST( dbBE_Redis_connection_queue_pop( queue ), conn );
+  rc += TEST( dbBE_Redis_connection_queue_pop( queue ), NULL );
+
+  dbBE_Redis_connection_t *conn2 = dbBE_Redis_connection_create( DBBE_REDIS_SR_BUFFER_LEN );
+  rc += TEST_NOT( conn2, NULL );
+  unsigned n;
+  for( n = 0; ( rc == 0 ) && ( n < 2 * DBBE_REDIS_MAX_TRACKED_CONNECTIONS ); ++n )
+  {
+    rc += TEST( dbBE_Redis_connection_queue_push( queue, conn ), 0 );
+    rc += TEST( dbBE_Redis_connection_queue_push( queue, conn2 ), 0 );
+    rc += TEST( dbBE_Redis_connection_queue_push( queue, conn ), 0 );
+    rc += TEST( dbBE_Redis_connection_queue_pop( queue ), conn );
+    rc += TEST( dbBE_Redis_connection_queue_pop( queue ), conn2 );
+  }
+  rc += TEST( dbBE_Redis_connection_queue_pop( queue ), NULL );
+  dbBE_Redis_connection_destroy( conn2 );
+
+  rc += TEST( dbBE_Redis_event_mgr_want_write( NULL, conn ), -EINVAL );
+  rc += TEST( dbBE_Redis_event_mgr_want_write( mgr, NULL ), -EINVAL );
+  rc += TEST( dbBE_Redis_event_mgr_next_writable( mgr ), NULL );
+  TEST_LOG( rc, "queue testing" );
+
   /////////////////////////////////////////////////////////
   //  testing rearm
 
@@ -30,24 +30,6 @@
 #include <unistd.h>
 #include <string.h>
 
-#ifdef DBBE_DBG_TEST
-int Flatten( dbBE_Redis_namespace_list_t *l )
-{
-  if( l == NULL )
-    return 0;
-  dbBE_Redis_namespace_list_t *s = l;
-  do
-  {
-    printf( "%s\t", l->_ns->_name );
-    l = l->_n;
-  } while( l != s );
-  printf( "\n" );
-  return 0;
-}
-#else
-int Flatten( dbBE_Redis_namespace_list_t *l ) {return 0;}
-#endif
-
 int namespacetest()
 {
   int rc = 0;
@@ -107,28 +89,35 @@ int namespacetest()
 
 #define DBBE_TEST_NAMESPACE_COUNT (1000)
 
-int namespacelisttest()
+int namespacetabletest()
 {
   int rc = 0;
 
   dbBE_Redis_namespace_t *ns = NULL;
   dbBE_Redis_namespace_t *many[ DBBE_TEST_NAMESPACE_COUNT ];
-  dbBE_Redis_namespace_list_t *list = NULL;
+  dbBE_Redis_namespace_table_t *table = NULL;
 
-  rc += TEST( dbBE_Redis_namespace_list_clean( NULL ), 0 );
-  rc += TEST( dbBE_Redis_namespace_list_insert( NULL, NULL ), NULL );
+  rc += TEST( dbBE_Redis_namespace_table_destroy( NULL ), 0 );
+  rc += TEST( dbBE_Redis_namespace_table_insert( NULL, NULL ), -EINVAL );
+  rc += TEST( dbBE_Redis_namespace_table_remove( NULL, NULL ), -EINVAL );
+  rc += TEST( dbBE_Redis_namespace_table_get( NULL, NULL ), NULL );
   rc += TEST( errno, EINVAL );
-  rc += TEST( dbBE_Redis_namespace_list_remove( NULL, NULL ), NULL );
-  rc += TEST( dbBE_Redis_namespace_list_get( NULL, NULL ), NULL );
+
+  rc += TEST_NOT_RC( dbBE_Redis_namespace_table_create(), NULL, table );
+  TEST_BREAK( rc, "Failed to create namespace table" );
+  rc += TEST( table->_size, DBBE_REDIS_NAMESPACE_TABLE_SIZE );
+  rc += TEST( dbBE_Redis_namespace_table_get( table, "Test" ), NULL );
+  rc += TEST( errno, ENOENT );
 
   rc += TEST_NOT_RC( dbBE_Redis_namespace_create( "Test" ), NULL, ns );
-  rc += TEST_NOT_RC( dbBE_Redis_namespace_list_insert( list, ns ), NULL, list );
-  rc += TEST( dbBE_Redis_namespace_list_insert( list, ns ), NULL );
+  rc += TEST( dbBE_Redis_namespace_table_insert( table, ns ), 0 );
+  rc += TEST( dbBE_Redis_namespace_table_insert( table, ns ), -EEXIST );
+  rc += TEST( dbBE_Redis_namespace_table_get( table, "Test" ), ns );
+  rc += TEST( dbBE_Redis_namespace_table_get( table, "Tes" ), NULL );
 
   TEST_BREAK( rc, "Found error already. Skipping further tests" );
   int i;
   int doubles = 0;
-  dbBE_Redis_namespace_list_t *tmp = NULL;
   for( i=0; i<DBBE_TEST_NAMESPACE_COUNT; ++i )
   {
     int nlen = (random() % (17-1)) + 1;
@@ -136,63 +125,63 @@ int namespacelisttest()
     rc += TEST_NOT_RC( dbBE_Redis_namespace_create( ns_name ), NULL, many[i] );
     free( ns_name );
     TEST_BREAK( rc, "Unable to create another namespace before insert. Cannot continue." );
-    // not testing because it might be NULL because of duplicates
-    tmp = dbBE_Redis_namespace_list_insert( list, many[i] );
-    if( tmp == NULL ) // in case that entry already existed
+    // not testing because it might fail because of duplicates
+    if( dbBE_Redis_namespace_table_insert( table, many[i] ) == -EEXIST )
     {
       ++doubles;
-      rc += TEST_NOT_RC( dbBE_Redis_namespace_list_get( list, many[i]->_name ), NULL, tmp );
-      rc += TEST_NOT( tmp , NULL );
-      TEST_BREAK( rc, "Inconsistent namespace list entry." );
-      rc += TEST_NOT( dbBE_Redis_namespace_attach( tmp->_ns ), 1 );
+      dbBE_Redis_namespace_t *existing = NULL;
+      rc += TEST_NOT_RC( dbBE_Redis_namespace_table_get( table, many[i]->_name ), NULL, existing );
+      TEST_BREAK( rc, "Inconsistent namespace table entry." );
+      rc += TEST_NOT( dbBE_Redis_namespace_attach( existing ), 1 );
       rc += TEST( dbBE_Redis_namespace_destroy( many[i] ), 0 );
       --i;
       continue;
     }
-    list = tmp;
-    Flatten( list );
-    rc += TEST_NOT_INFO( list->_n, list, many[i]->_name );
+    rc += TEST_INFO( dbBE_Redis_namespace_table_get( table, many[i]->_name ), many[i], many[i]->_name );
   }
+  // the table grew with the number of entries
+  rc += TEST( table->_count, DBBE_TEST_NAMESPACE_COUNT + 1 );
+  rc += TEST( table->_size >= DBBE_TEST_NAMESPACE_COUNT, 1 );
 
   LOG( DBG_ALL, stdout, "Double creation/attach %d\n", doubles );
   TEST_BREAK( rc, "Found error already. Skipping further tests" );
   for( i=0; i<DBBE_TEST_NAMESPACE_COUNT; ++i )
   {
-    if( many[ i ] != NULL )
+    if( many[ i ] == NULL )
+      continue;
+    int refcnt = dbBE_Redis_namespace_table_remove( table, many[ i ] );
+    rc += TEST( refcnt >= 0, 1 );
+    TEST_BREAK( rc, "Failed to remove namespace." );
+    if( refcnt > 0 ) // still attached
     {
-      rc += TEST_INFO( 0, 0, many[ i ]->_name );
-      rc += TEST_NOT_RC( dbBE_Redis_namespace_list_remove( list, many[ i ] ), NULL, tmp );
-      rc += TEST_NOT_INFO( tmp, NULL, "namespace list not empty?" );
-      // tmp needs to be non-null since we have at least Test-namespace in there
-      TEST_BREAK( rc, "unexpected drain of namspace list." );
-      if(( tmp->_ns == many[i] ) && ( dbBE_Redis_namespace_validate( many[ i ] ) == 0 )) // still valid ns
-      {
-        rc += TEST_NOT( many[ i ]->_refcnt, 0 );
-        TEST_BREAK( rc, "Inconsistent reference count" );
-        --doubles;
-        list = tmp;
-        --i;
-        continue;
-      }
-      list = tmp;
-      rc += TEST_NOT( list->_ns->_name[0], 0 );
-      Flatten( list );
-//      rc += TEST( dbBE_Redis_namespace_destroy( many[ i ] ), 0 );
-      many[ i ] = NULL;
+      rc += TEST( many[ i ]->_refcnt, (uint32_t)refcnt );
+      --doubles;
+      --i;
+      continue;
     }
+    many[ i ] = NULL;
   }
   rc += TEST_INFO( doubles, 0, "Multi-attached counter == 0 ?" );
+  rc += TEST( table->_count, 1 );
 
-  // remove the last one should return NULL for the list ptr
+  // needs to keep the entry, because namespace refcnt is > 1
   rc += TEST( dbBE_Redis_namespace_attach( ns ), 2 );
-  // needs to return list ptr, because namespace refcnt is > 1
-  rc += TEST( dbBE_Redis_namespace_list_remove( list, ns ), list );
+  rc += TEST( dbBE_Redis_namespace_table_remove( table, ns ), 1 );
+  rc += TEST( dbBE_Redis_namespace_table_get( table, "Test" ), ns );
 
-  // now it's detached once more and should be cleaned up from the list
-  rc += TEST( dbBE_Redis_namespace_list_remove( list, ns ), NULL );
+  // now it's detached once more and should be cleaned up from the table
+  rc += TEST( dbBE_Redis_namespace_table_remove( table, ns ), 0 );
+  rc += TEST( table->_count, 0 );
+  rc += TEST( dbBE_Redis_namespace_table_get( table, "Test" ), NULL );
 
-  // no destruction should be happening as this already is done by list_remove()
+  // no destruction should be happening as this already is done by table_remove()
   rc += TEST( dbBE_Redis_namespace_destroy( ns ), -EBADF );
+
+  // destroying a table with remaining entries cleans up the namespaces
+  rc += TEST_NOT_RC( dbBE_Redis_namespace_create( "Remaining" ), NULL, ns );
+  rc += TEST( dbBE_Redis_namespace_table_insert( table, ns ), 0 );
+  rc += TEST( dbBE_Redis_namespace_attach( ns ), 2 );
+  rc += TEST( dbBE_Redis_namespace_table_destroy( table ), 0 );
   return rc;
 }
 
@@ -202,7 +191,7 @@ int main( int argc, char ** argv )
 
   rc += namespacetest();
   TEST_BREAK( rc, "Found error already. Skipping further tests" );
-  rc += namespacelisttest();
+  rc += namespacetabletest();
 
   printf( "Test exiting with rc=%d\n", rc );
   return rc;
@@ -0,0 +1,276 @@
+/*
+ * Copyright © 2018-2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * microbenchmark: bytes/second and replies/second of the RESP parser
+ * usage: backend_redis_parse_bench [iterations [recorded_stream_file]]
+ *
+ * Without a file, a set of synthetic streams that resemble pipelined
+ * data broker traffic is used. A recorded stream needs to contain complete
+ * Redis responses only (e.g. the server->client side of a capture).
+ * Each stream is parsed with heap allocated arrays and with the result arena
+ * (reset every BENCH_ARENA_PASS replies like the receiver does per pass).
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../backend/redis/parse.h"
+#include "../backend/redis/result.h"
+#include "../backend/redis/resp_scan.h"
+#include "../backend/transports/sr_buffer.h"
+
+#define BENCH_STREAM_LEN ( 4 * 1024 * 1024 )
+#define BENCH_DEFAULT_ITERATIONS ( 20 )
+#define BENCH_ARENA_PASS ( 128 )
+
+typedef struct
+{
+  const char *_name;
+  char *_data;
+  size_t _len;
+} bench_stream_t;
+
+static
+double now_sec()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/*
+ * fill a stream with repeated responses created by gen() until it's full
+ */
+static
+bench_stream_t bench_stream_create( const char *name, int (*gen)( char *, size_t, int ) )
+{
+  bench_stream_t s = { name, (char*)malloc( BENCH_STREAM_LEN ), 0 };
+  int n = 0;
+  char item[ 4096 ];
+  while( s._data != NULL )
+  {
+    int len = gen( item, sizeof( item ), n++ );
+    if( s._len + len > BENCH_STREAM_LEN )
+      break;
+    memcpy( s._data + s._len, item, len );
+    s._len += len;
+  }
+  return s;
+}
+
+// RPUSH acknowledgements
+static
+int gen_acks( char *buf, size_t size, int n )
+{
+  return snprintf( buf, size, ":%d\r\n", 1 + n % 1000 );
+}
+
+// LPOP of small values
+static
+int gen_values( char *buf, size_t size, int n )
+{
+  int len = snprintf( buf, size, "$64\r\n" );
+  memset( buf + len, 'a' + n % 26, 64 );
+  len += 64;
+  return len + snprintf( buf + len, size - len, "\r\n" );
+}
+
+// longer status/error lines (e.g. error messages, cluster redirects)
+static
+int gen_lines( char *buf, size_t size, int n )
+{
+  return snprintf( buf, size, "-ERR %0*d\r\n", 40 + n % 200, n );
+}
+
+// mix of acks, status, nil, values, errors, and scan arrays
+static
+int gen_mixed( char *buf, size_t size, int n )
+{
+  switch( n % 8 )
+  {
+    case 0: return snprintf( buf, size, "+OK\r\n" );
+    case 1: return snprintf( buf, size, "$-1\r\n" );
+    case 2: return snprintf( buf, size, "-MOVED %d 10.0.0.%d:6379\r\n", n % 16384, n % 8 );
+    case 3: return snprintf( buf, size, "*2\r\n$4\r\n%04d\r\n*3\r\n$10\r\nNS::key_%02d\r\n$10\r\nNS::key_%02d\r\n$10\r\nNS::key_%02d\r\n",
+                             n % 10000, n % 100, ( n + 1 ) % 100, ( n + 2 ) % 100 );
+    case 4: return snprintf( buf, size, "$1024\r\n%01024d\r\n", n );
+    case 5: return snprintf( buf, size, "-ERR unknown command 'BLMOVE', with args beginning with: \r\n" );
+    default:
+      return gen_acks( buf, size, n );
+  }
+}
+
+// SCAN replies of namespace and iterator operations
+static
+int gen_scan( char *buf, size_t size, int n )
+{
+  int len = snprintf( buf, size, "*2\r\n$4\r\n%04d\r\n*10\r\n", n % 10000 );
+  int k;
+  for( k = 0; k < 10; ++k )
+    len += snprintf( buf + len, size - len, "$12\r\nNS::key_%04d\r\n", ( n + k ) % 10000 );
+  return len;
+}
+
+static
+bench_stream_t bench_stream_load( const char *filename )
+{
+  bench_stream_t s = { filename, NULL, 0 };
+  FILE *f = fopen( filename, "rb" );
+  if( f == NULL )
+    return s;
+  fseek( f, 0, SEEK_END );
+  long size = ftell( f );
+  fseek( f, 0, SEEK_SET );
+  if( size > 0 )
+  {
+    s._data = (char*)malloc( size );
+    if(( s._data != NULL ) && ( fread( s._data, 1, size, f ) == (size_t)size ))
+      s._len = size;
+  }
+  fclose( f );
+  return s;
+}
+
+/*
+ * parse the whole stream; returns the number of replies or -1 on error
+ * the parser nul-terminates strings in place, so the stream is restored before the timed part
+ */
+static
+long bench_parse( dbBE_Redis_sr_buffer_t *sr_buf, bench_stream_t *s, dbBE_Arena_t *arena, double *elapsed )
+{
+  long replies = 0;
+  dbBE_Redis_result_t result;
+  dbBE_Redis_parse_state_t state;
+  memset( &result, 0, sizeof( result ) );
+  memcpy( dbBE_Transport_sr_buffer_get_start( sr_buf ), s->_data, s->_len );
+  dbBE_Transport_sr_buffer_rewind_processed_to( sr_buf, dbBE_Transport_sr_buffer_get_start( sr_buf ) );
+
+  double start = now_sec();
+  while( ! dbBE_Transport_sr_buffer_empty( sr_buf ) )
+  {
+    if( arena != NULL )
+    {
+      if( replies % BENCH_ARENA_PASS == 0 )
+        dbBE_Arena_reset( arena );
+      dbBE_Redis_parse_state_init( &state, &result, DBBE_REDIS_PARSE_PARTIAL_STRING );
+      state._arena = arena;
+      if( dbBE_Redis_parse_sr_buffer_resume( &state, sr_buf ) != 0 )
+        return -1;
+    }
+    else if( dbBE_Redis_parse_sr_buffer( sr_buf, &result ) != 0 )
+      return -1;
+    dbBE_Redis_result_cleanup( &result, 0 );
+    ++replies;
+  }
+  *elapsed += now_sec() - start;
+  return replies;
+}
+
+static
+int bench_run( bench_stream_t *s, long iterations )
+{
+  if( s->_len == 0 )
+  {
+    fprintf( stderr, "Empty or unreadable stream %s\n", s->_name );
+    return 1;
+  }
+
+  dbBE_Redis_sr_buffer_t *sr_buf = dbBE_Transport_sr_buffer_allocate( s->_len + 1 );
+  if( sr_buf == NULL )
+    return 1;
+  dbBE_Transport_sr_buffer_add_data( sr_buf, s->_len, 0 );
+  dbBE_Arena_t *arena = dbBE_Arena_create( DBBE_REDIS_RESULT_ARENA_CHUNK, DBBE_REDIS_RESULT_ARENA_KEEP );
+  if( arena == NULL )
+  {
+    dbBE_Transport_sr_buffer_free( sr_buf );
+    return 1;
+  }
+
+  static const char *level_names[] = { "scalar", "sse2", "avx2" };
+  dbBE_Redis_scan_level_t level;
+  for( level = DBBE_REDIS_SCAN_SCALAR; level <= DBBE_REDIS_SCAN_AVX2; ++level )
+  {
+    if( dbBE_Redis_scan_select( level ) != level )
+      continue;
+
+    int use_arena;
+    for( use_arena = 0; use_arena < 2; ++use_arena )
+    {
+      dbBE_Arena_t *a = use_arena ? arena : NULL;
+      double elapsed = 0.0;
+      long replies = bench_parse( sr_buf, s, a, &elapsed ); // warm up
+      if( replies < 0 )
+      {
+        fprintf( stderr, "Stream %s contains incomplete or invalid responses\n", s->_name );
+        dbBE_Arena_destroy( arena );
+        dbBE_Transport_sr_buffer_free( sr_buf );
+        return 1;
+      }
+
+      long i;
+      elapsed = 0.0;
+      for( i = 0; i < iterations; ++i )
+        bench_parse( sr_buf, s, a, &elapsed );
+
+      printf( "%-10s %-7s %-5s %10.1f MB/s %12.0f replies/s\n", s->_name, level_names[ level ],
+              use_arena ? "arena" : "heap",
+              (double)s->_len * iterations / elapsed / 1e6,
+              (double)replies * iterations / elapsed );
+    }
+  }
+  dbBE_Redis_scan_select( DBBE_REDIS_SCAN_AUTO );
+  dbBE_Arena_destroy( arena );
+  dbBE_Transport_sr_buffer_free( sr_buf );
+  return 0;
+}
+
+int main( int argc, char **argv )
+{
+  int rc = 0;
+  long iterations = BENCH_DEFAULT_ITERATIONS;
+  if( argc > 1 )
+    iterations = strtol( argv[ 1 ], NULL, 10 );
+  if( iterations <= 0 )
+    iterations = BENCH_DEFAULT_ITERATIONS;
+
+  if( argc > 2 )
+  {
+    bench_stream_t s = bench_stream_load( argv[ 2 ] );
+    rc += bench_run( &s, iterations );
+    free( s._data );
+    return rc;
+  }
+
+  bench_stream_t streams[ 5 ];
+  streams[ 0 ] = bench_stream_create( "acks", gen_acks );
+  streams[ 1 ] = bench_stream_create( "values", gen_values );
+  streams[ 2 ] = bench_stream_create( "lines", gen_lines );
+  streams[ 3 ] = bench_stream_create( "mixed", gen_mixed );
+  streams[ 4 ] = bench_stream_create( "scan", gen_scan );
+
+  int n;
+  for( n = 0; n < 5; ++n )
+  {
+    rc += bench_run( &streams[ n ], iterations );
+    free( streams[ n ]._data );
+  }
+  return rc;
+}
@@ -27,6 +27,7 @@
 #include <libdatabroker.h>
 #include "../backend/redis/result.h"
 #include "../backend/redis/parse.h"
+#include "../backend/redis/resp_scan.h"
 #include "../backend/redis/result.h"
 #include "../backend/transports/double_buffer.h"
 #include "test_utils.h"
@@ -150,6 +151,76 @@ int TestRedis_extract_int()
   return rc;
 }
 
+int TestRedis_scan()
+{
+  int rc = 0;
+  char buffer[ 256 ];
+  int64_t value = 0;
+
+  // compare all implementations against a plain byte-wise search
+  dbBE_Redis_scan_level_t level;
+  for( level = DBBE_REDIS_SCAN_SCALAR; level <= DBBE_REDIS_SCAN_AVX2; ++level )
+  {
+    int selected = dbBE_Redis_scan_select( level );
+    rc += TEST( selected <= level, 1 );
+    int len, pos, errors = 0;
+    for( len = 0; len < 100; ++len )
+      for( pos = -1; pos < len; ++pos )
+      {
+        memset( buffer, 'x', sizeof( buffer ) );
+        buffer[ len ] = '\r'; buffer[ len + 1 ] = '\n'; // beyond the limit: must not be found
+        if( pos >= 0 )
+        {
+          buffer[ pos ] = '\r';
+          if( pos > 0 ) buffer[ pos - 1 ] = '\r'; // a lone \r right before
+          if( pos + 1 < len ) buffer[ pos + 1 ] = '\n';
+        }
+        buffer[ 0 ] = '\0'; // nul-bytes are regular data
+
+        char *expected = NULL;
+        int n;
+        for( n = 0; ( n + 1 < len ) && ( expected == NULL ); ++n )
+          if(( buffer[ n ] == '\r' ) && ( buffer[ n + 1 ] == '\n' ))
+            expected = &buffer[ n ];
+        if( dbBE_Redis_scan_terminator( buffer, len ) != expected )
+          ++errors;
+      }
+    rc += TEST( errors, 0 );
+    TEST_LOG( rc, "Terminator scan mismatch" );
+  }
+  rc += TEST( dbBE_Redis_scan_terminator( NULL, 10 ), NULL );
+  dbBE_Redis_scan_select( DBBE_REDIS_SCAN_AUTO );
+
+  // SWAR number decoding needs the terminator within the limit and readable 8+2 bytes
+  rc += TEST( dbBE_Redis_scan_uint( "7\r\nxxxxxxxx", 11, &value ), 1 );
+  rc += TEST( value, 7 );
+  rc += TEST( dbBE_Redis_scan_uint( "1234\r\nxxxxxx", 12, &value ), 4 );
+  rc += TEST( value, 1234 );
+  rc += TEST( dbBE_Redis_scan_uint( "12345678\r\nxx", 12, &value ), 8 );
+  rc += TEST( value, 12345678 );
+  rc += TEST( dbBE_Redis_scan_uint( "00000042\r\nxx", 12, &value ), 8 );
+  rc += TEST( value, 42 );
+  rc += TEST( dbBE_Redis_scan_uint( "123456789\r\nx", 12, &value ), 0 ); // too long for the fast path
+  rc += TEST( dbBE_Redis_scan_uint( "12a4\r\nxxxxxx", 12, &value ), 0 );
+  rc += TEST( dbBE_Redis_scan_uint( "12/4\r\nxxxxxx", 12, &value ), 0 );
+  rc += TEST( dbBE_Redis_scan_uint( "12:4\r\nxxxxxx", 12, &value ), 0 );
+  rc += TEST( dbBE_Redis_scan_uint( "1234\rxxxxxxx", 12, &value ), 0 );
+  rc += TEST( dbBE_Redis_scan_uint( "\r\nxxxxxxxxxx", 12, &value ), 0 );
+  rc += TEST( dbBE_Redis_scan_uint( "7\r\n", 3, &value ), 0 );
+
+  // the byte-wise fallback still covers long numbers and buffer ends
+  size_t parsed = 0;
+  rc += TEST( dbBE_Redis_extract_integer( "1234567890123\r\n", &parsed, 15 ), 1234567890123ll );
+  rc += TEST( parsed, 15 );
+  rc += TEST( dbBE_Redis_extract_integer( "-12\r\n", &parsed, 5 ), -12 );
+  rc += TEST( parsed, 5 );
+  rc += TEST( dbBE_Redis_extract_integer( "-12\r\n:1\r\n:2\r\n", &parsed, 17 ), -12 );
+  rc += TEST( parsed, 5 );
+
+  printf( "TestRedis_scan exiting with rc=%d\n", rc );
+  return rc;
+}
+
 int TestRedis_extract_bulk_string()
 {
   int rc = 0;
@@ -620,6 +691,201 @@ int TestRedis_parse_ctx_buffer_errors()
   return rc;
 }
 
+int TestRedis_parse_blocking_pop()
+{
+  int rc = 0;
+  size_t len;
+  int err_code;
+
+  dbBE_Redis_sr_buffer_t *sr_buf;
+  dbBE_Redis_result_t result;
+
+  sr_buf = dbBE_Transport_sr_buffer_allocate( DBBE_TEST_BUFFER_LEN );
+  if( sr_buf == NULL )
+    return 1;
+
+  // a timed out blocking pop returns a null array
+  len = TestReset_sr_buffer( sr_buf, "*-1\r\n" );
+  err_code = dbBE_Redis_parse_sr_buffer_partial_tail( sr_buf, &result );
+  rc += TEST( err_code, 0 );
+  rc += TEST( dbBE_Transport_sr_buffer_processed( sr_buf ), len );
+  rc += TEST( result._type, dbBE_REDIS_TYPE_CHAR );
+  rc += TEST( result._data._string._data, NULL );
+  rc += TEST( result._data._string._size, 0 );
+  rc += TEST( dbBE_Redis_result_is_partial( &result ), 0 );
+  dbBE_Redis_result_cleanup( &result, 0 );
+
+  // a complete [ key, value ] response
+  len = TestReset_sr_buffer( sr_buf, "*2\r\n$3\r\nkey\r\n$5\r\nvalue\r\n" );
+  err_code = dbBE_Redis_parse_sr_buffer_partial_tail( sr_buf, &result );
+  rc += TEST( err_code, 0 );
+  rc += TEST( dbBE_Transport_sr_buffer_processed( sr_buf ), len );
+  rc += TEST( result._type, dbBE_REDIS_TYPE_ARRAY );
+  rc += TEST( result._data._array._len, 2 );
+  rc += TEST( result._data._array._data[ 1 ]._type, dbBE_REDIS_TYPE_CHAR );
+  rc += TEST( strncmp( result._data._array._data[ 1 ]._data._string._data, "value", 5 ), 0 );
+  rc += TEST( dbBE_Redis_result_is_partial( &result ), 0 );
+  dbBE_Redis_result_cleanup( &result, 0 );
+
+  // the value may be incomplete
+  len = TestReset_sr_buffer( sr_buf, "*2\r\n$3\r\nkey\r\n$40\r\nHello W" );
+  err_code = dbBE_Redis_parse_sr_buffer_partial_tail( sr_buf, &result );
+  rc += TEST( err_code, 0 );
+  rc += TEST( result._type, dbBE_REDIS_TYPE_ARRAY );
+  rc += TEST( result._data._array._len, 2 );
+  rc += TEST( result._data._array._data[ 1 ]._type, dbBE_REDIS_TYPE_STRING_PART );
+  rc += TEST( result._data._array._data[ 1 ]._data._pstring._total_size, 40 );
+  rc += TEST( dbBE_Redis_result_is_partial( &result ), 1 );
+  dbBE_Redis_result_cleanup( &result, 0 );
+
+  // but not the key
+  len = TestReset_sr_buffer( sr_buf, "*2\r\n$30\r\nke" );
+  err_code = dbBE_Redis_parse_sr_buffer_partial_tail( sr_buf, &result );
+  rc += TEST( err_code, -EAGAIN );
+  rc += TEST( dbBE_Transport_sr_buffer_processed( sr_buf ), 0 );
+
+  // regular parsing still requires complete arrays
+  len = TestReset_sr_buffer( sr_buf, "*2\r\n$3\r\nkey\r\n$40\r\nHello W" );
+  err_code = dbBE_Redis_parse_sr_buffer( sr_buf, &result );
+  rc += TEST( err_code, -EAGAIN );
+  rc += TEST( dbBE_Transport_sr_buffer_processed( sr_buf ), 0 );
+
+  dbBE_Transport_sr_buffer_free( sr_buf );
+  printf( "TestRedis_parse_blocking_pop exiting with rc=%d\n", rc );
+  return rc;
+}
+
+/*
+ * feed a response in chunks of chunk_size bytes and make sure the parser
+ * never goes back to an already parsed position
+ */
+int TestRedis_parse_resume_chunked( const char *response, const int chunk_size, const dbBE_Redis_parse_partial_t partial )
+{
+  int rc = 0;
+  dbBE_Redis_sr_buffer_t *sr_buf = dbBE_Transport_sr_buffer_allocate( DBBE_TEST_BUFFER_LEN * 8 );
+  if( sr_buf == NULL )
+    return 1;
+  TestReset_sr_buffer( sr_buf, "" );
+
+  dbBE_Redis_result_t result;
+  memset( &result, 0, sizeof( result ) );
+  dbBE_Redis_parse_state_t state;
+  dbBE_Redis_parse_state_init( &state, &result, partial );
+
+  size_t total = strlen( response );
+  size_t fed = 0;
+  size_t last_processed = 0;
+  int err_code = -EAGAIN;
+  while(( err_code == -EAGAIN ) && ( fed < total ))
+  {
+    size_t chunk = total - fed;
+    if( chunk > (size_t)chunk_size )
+      chunk = chunk_size;
+    memcpy( dbBE_Transport_sr_buffer_get_available_position( sr_buf ), response + fed, chunk );
+    dbBE_Transport_sr_buffer_add_data( sr_buf, chunk, 0 );
+    fed += chunk;
+
+    err_code = dbBE_Redis_parse_sr_buffer_resume( &state, sr_buf );
+    rc += TEST_NOT( dbBE_Transport_sr_buffer_processed( sr_buf ) < last_processed, 1 );
+    last_processed = dbBE_Transport_sr_buffer_processed( sr_buf );
+  }
+  rc += TEST( err_code, 0 );
+  rc += TEST( fed, total );
+  rc += TEST( dbBE_Transport_sr_buffer_processed( sr_buf ), total );
+
+  // compare with the result of parsing the complete response at once
+  dbBE_Redis_sr_buffer_t *ref_buf = dbBE_Transport_sr_buffer_allocate( DBBE_TEST_BUFFER_LEN * 8 );
+  dbBE_Redis_result_t reference;
+  TestReset_sr_buffer( ref_buf, response );
+  rc += TEST( dbBE_Redis_parse_sr_buffer( ref_buf, &reference ), 0 );
+  rc += TEST( result._type, reference._type );
+  if(( result._type == dbBE_REDIS_TYPE_ARRAY ) && ( reference._type == dbBE_REDIS_TYPE_ARRAY ))
+  {
+    rc += TEST( result._data._array._len, reference._data._array._len );
+    dbBE_Redis_result_t *last = &result._data._array._data[ result._data._array._len - 1 ];
+    dbBE_Redis_result_t *ref_last = &reference._data._array._data[ reference._data._array._len - 1 ];
+    rc += TEST( last->_type, ref_last->_type );
+    if(( last->_type == dbBE_REDIS_TYPE_CHAR ) && ( ref_last->_type == dbBE_REDIS_TYPE_CHAR ))
+      rc += TEST( strcmp( last->_data._string._data, ref_last->_data._string._data ), 0 );
+  }
+  dbBE_Redis_result_cleanup( &reference, 0 );
+  dbBE_Redis_result_cleanup( &result, 0 );
+  dbBE_Transport_sr_buffer_free( ref_buf );
+  dbBE_Transport_sr_buffer_free( sr_buf );
+  return rc;
+}
+
+int TestRedis_parse_resume()
+{
+  int rc = 0;
+  int chunk;
+
+  // SCAN-like response with nested array
+  const char *scan = "*2\r\n$4\r\n1234\r\n*4\r\n$8\r\nNS::key1\r\n$8\r\nNS::key2\r\n$-1\r\n$14\r\nNS::key_number\r\n";
+  for( chunk = 1; chunk < 20; ++chunk )
+    rc += TestRedis_parse_resume_chunked( scan, chunk, DBBE_REDIS_PARSE_PARTIAL_NONE );
+
+  // large array of integers and status lines
+  char large[ 8192 ];
+  int n;
+  int len = snprintf( large, sizeof( large ), "*300\r\n" );
+  for( n = 0; n < 300; ++n )
+    len += snprintf( large + len, sizeof( large ) - len, ( n & 1 ) ? ":%d\r\n" : "+OK%d\r\n", n );
+  rc += TestRedis_parse_resume_chunked( large, 7, DBBE_REDIS_PARSE_PARTIAL_STRING );
+  rc += TestRedis_parse_resume_chunked( large, 1460, DBBE_REDIS_PARSE_PARTIAL_STRING );
+
+  // the parse state survives incomplete elements at any depth
+  dbBE_Redis_sr_buffer_t *sr_buf = dbBE_Transport_sr_buffer_allocate( DBBE_TEST_BUFFER_LEN );
+  if( sr_buf == NULL )
+    return 1;
+  dbBE_Redis_result_t result;
+  dbBE_Redis_parse_state_t state;
+
+  TestReset_sr_buffer( sr_buf, "*3\r\n:1\r\n*2\r\n+A\r\n$5\r\nhe" );
+  dbBE_Redis_parse_state_init( &state, &result, DBBE_REDIS_PARSE_PARTIAL_TAIL );
+  rc += TEST( dbBE_Redis_parse_sr_buffer_resume( &state, sr_buf ), -EAGAIN );
+  rc += TEST( state._depth, 2 );
+  rc += TEST( state._index[ 0 ], 1 );
+  rc += TEST( state._index[ 1 ], 1 );
+  // positioned at the incomplete bulk string
+  rc += TEST( dbBE_Transport_sr_buffer_processed( sr_buf ), strlen( "*3\r\n:1\r\n*2\r\n+A\r\n" ) );
+  rc += TEST( result._type, dbBE_REDIS_TYPE_ARRAY );
+  rc += TEST( result._data._array._data[ 0 ]._data._integer, 1 );
+
+  // retrying without new data doesn't change anything
+  rc += TEST( dbBE_Redis_parse_sr_buffer_resume( &state, sr_buf ), -EAGAIN );
+  rc += TEST( state._depth, 2 );
+  rc += TEST( dbBE_Transport_sr_buffer_processed( sr_buf ), strlen( "*3\r\n:1\r\n*2\r\n+A\r\n" ) );
+
+  const char *rest = "llo\r\n$2\r\nok\r\n";
+  memcpy( dbBE_Transport_sr_buffer_get_available_position( sr_buf ), rest, strlen( rest ) );
+  dbBE_Transport_sr_buffer_add_data( sr_buf, strlen( rest ), 0 );
+  rc += TEST( dbBE_Redis_parse_sr_buffer_resume( &state, sr_buf ), 0 );
+  rc += TEST( state._depth, 0 );
+  rc += TEST( dbBE_Transport_sr_buffer_empty( sr_buf ), 1 );
+  rc += TEST( result._data._array._len, 3 );
+  rc += TEST( result._data._array._data[ 1 ]._type, dbBE_REDIS_TYPE_ARRAY );
+  rc += TEST( strcmp( result._data._array._data[ 1 ]._data._array._data[ 1 ]._data._string._data, "hello" ), 0 );
+  rc += TEST( strcmp( result._data._array._data[ 2 ]._data._string._data, "ok" ), 0 );
+  dbBE_Redis_result_cleanup( &result, 0 );
+
+  // the next response starts with a fresh state; an empty buffer has no data
+  dbBE_Redis_parse_state_init( &state, &result, DBBE_REDIS_PARSE_PARTIAL_STRING );
+  rc += TEST( dbBE_Redis_parse_sr_buffer_resume( &state, sr_buf ), -ENODATA );
+
+  // too deeply nested arrays are a protocol error
+  TestReset_sr_buffer( sr_buf, "*1\r\n*1\r\n*1\r\n*1\r\n*1\r\n*1\r\n*1\r\n*1\r\n*1\r\n:1\r\n" );
+  dbBE_Redis_parse_state_init( &state, &result, DBBE_REDIS_PARSE_PARTIAL_STRING );
+  rc += TEST( dbBE_Redis_parse_sr_buffer_resume( &state, sr_buf ), -EPROTO );
+  dbBE_Redis_result_cleanup( &result, 0 );
+
+  rc += TEST( dbBE_Redis_parse_sr_buffer_resume( NULL, sr_buf ), -EINVAL );
+
+  dbBE_Transport_sr_buffer_free( sr_buf );
+  printf( "TestRedis_parse_resume exiting with rc=%d\n", rc );
+  return rc;
+}
+
 // define the function here because it's not exposed in header file
 dbBE_Transport_sge_buffer_t* dbBE_Redis_parse_copy_assemble_sge( dbBE_Request_t *r,
                                                              dbBE_Redis_result_t *c,
@@ -846,11 +1112,14 @@ int main( int argc, char ** argv )
     return -1;
   }
 
+  rc += TestRedis_scan();
   rc += TestRedis_get_strlen();
   rc += TestRedis_extract_int();
   rc += TestRedis_extract_bulk_string();
   rc += TestRedis_parse_ctx_buffer();
   rc += TestRedis_parse_ctx_buffer_errors();
+  rc += TestRedis_parse_blocking_pop();
+  rc += TestRedis_parse_resume();
   rc += TestSGEAssemble();
 
   printf( "Test exiting with rc=%d\n", rc );
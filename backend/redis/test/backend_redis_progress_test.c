@@ -0,0 +1,146 @@
+/*
+ * Copyright © 2018-2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifdef __APPLE__
+#include <stdlib.h>
+#else
+#include <malloc.h>
+#endif
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <libdatabroker.h>
+#include "../backend/redis/progress.h"
+#include "test_utils.h"
+
+#define TEST_PROGRESS_DEPTH ( 16 )
+#define TEST_PROGRESS_ITEMS ( 100000 )
+
+/*
+ * consumer thread: fetch completions until all items arrived
+ */
+void* progress_consumer( void *arg )
+{
+  dbBE_Redis_progress_t *progress = (dbBE_Redis_progress_t*)arg;
+  int64_t expected = 0;
+  int64_t errors = 0;
+  while( expected < TEST_PROGRESS_ITEMS )
+  {
+    dbBE_Completion_t *compl = dbBE_Redis_progress_fetch( progress );
+    if( compl == NULL )
+      continue;
+    if( compl->_rc != expected )
+      ++errors;
+    ++expected;
+    free( compl );
+  }
+  return (void*)errors;
+}
+
+int main( int argc, char ** argv )
+{
+  int rc = 0;
+  int i;
+
+  rc += TEST( dbBE_Redis_progress_create( 0 ), NULL );
+  rc += TEST( dbBE_Redis_progress_destroy( NULL ), -EINVAL );
+
+  dbBE_Redis_progress_t *progress = dbBE_Redis_progress_create( TEST_PROGRESS_DEPTH );
+  rc += TEST_NOT( progress, NULL );
+  TEST_BREAK( rc, "Failed to create progress hand-off" );
+
+  // nothing posted, nothing completed
+  rc += TEST( dbBE_Redis_progress_fetch( progress ), NULL );
+
+  dbBE_Request_queue_t *work_q = dbBE_Request_queue_create( TEST_PROGRESS_DEPTH );
+  dbBE_Completion_queue_t *compl_q = dbBE_Completion_queue_create( TEST_PROGRESS_DEPTH );
+  rc += TEST( dbBE_Redis_progress_take_posted( progress, work_q ), 0 );
+  rc += TEST( dbBE_Redis_progress_deliver( progress, compl_q ), 0 );
+
+  // fill the posted queue up to the limit
+  dbBE_Request_t req[ TEST_PROGRESS_DEPTH + 1 ];
+  memset( req, 0, sizeof( req ) );
+  for( i = 0; i < TEST_PROGRESS_DEPTH; ++i )
+    rc += TEST( dbBE_Redis_progress_post( progress, &req[ i ] ), 0 );
+  rc += TEST( dbBE_Redis_progress_post( progress, &req[ i ] ), -EAGAIN );
+  rc += TEST( dbBE_Redis_progress_post( progress, NULL ), -EINVAL );
+
+  // the progress side picks up everything in order
+  rc += TEST( dbBE_Redis_progress_take_posted( progress, work_q ), TEST_PROGRESS_DEPTH );
+  rc += TEST( dbBE_Request_queue_len( work_q ), TEST_PROGRESS_DEPTH );
+  for( i = 0; i < TEST_PROGRESS_DEPTH; ++i )
+    rc += TEST( dbBE_Request_queue_pop( work_q ), &req[ i ] );
+
+  // and there's space again
+  rc += TEST( dbBE_Redis_progress_post( progress, &req[ TEST_PROGRESS_DEPTH ] ), 0 );
+  rc += TEST( dbBE_Redis_progress_take_posted( progress, work_q ), 1 );
+  rc += TEST( dbBE_Request_queue_pop( work_q ), &req[ TEST_PROGRESS_DEPTH ] );
+
+  // completions are handed over in order
+  for( i = 0; i < 3; ++i )
+  {
+    dbBE_Completion_t *compl = (dbBE_Completion_t*)calloc( 1, sizeof( dbBE_Completion_t ) );
+    compl->_rc = i;
+    dbBE_Completion_queue_push( compl_q, compl );
+  }
+  rc += TEST( dbBE_Redis_progress_deliver( progress, compl_q ), 3 );
+  rc += TEST( dbBE_Completion_queue_len( compl_q ), 0 );
+  for( i = 0; i < 3; ++i )
+  {
+    dbBE_Completion_t *compl = dbBE_Redis_progress_fetch( progress );
+    rc += TEST_NOT( compl, NULL );
+    if( compl == NULL )
+      break;
+    rc += TEST( compl->_rc, i );
+    free( compl );
+  }
+  rc += TEST( dbBE_Redis_progress_fetch( progress ), NULL );
+
+  // concurrent delivery and fetching from a different thread
+  pthread_t consumer;
+  rc += TEST( pthread_create( &consumer, NULL, progress_consumer, progress ), 0 );
+  TEST_BREAK( rc, "Failed to create consumer thread" );
+  for( i = 0; i < TEST_PROGRESS_ITEMS; ++i )
+  {
+    dbBE_Completion_t *compl = (dbBE_Completion_t*)calloc( 1, sizeof( dbBE_Completion_t ) );
+    compl->_rc = i;
+    dbBE_Completion_queue_push( compl_q, compl );
+    if(( i & 0x7 ) == 0x7 )
+      dbBE_Redis_progress_deliver( progress, compl_q );
+  }
+  dbBE_Redis_progress_deliver( progress, compl_q );
+  void *errors = NULL;
+  rc += TEST( pthread_join( consumer, &errors ), 0 );
+  rc += TEST( (int64_t)errors, 0 );
+
+  // stopping a progress engine that never started is fine
+  rc += TEST( dbBE_Redis_progress_stop( progress ), 0 );
+  rc += TEST( dbBE_Redis_progress_start( progress, NULL ), -EINVAL );
+
+  // notifications without a blocked thread don't accumulate into errors
+  for( i = 0; i < 4 * TEST_PROGRESS_DEPTH; ++i )
+    dbBE_Redis_progress_notify( progress );
+  dbBE_Redis_progress_notify( NULL );
+
+  rc += TEST( dbBE_Redis_progress_destroy( progress ), 0 );
+  dbBE_Request_queue_destroy( work_q );
+  dbBE_Completion_queue_destroy( compl_q );
+
+  printf( "Test exiting with rc=%d\n", rc );
+  return rc;
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright © 2018-2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * microbenchmark: client-side throughput of small PUTs
+ * usage: backend_redis_put_bench [iterations]
+ *
+ * Batches of RPUSH commands are created like the sender does and sent over a
+ * socketpair that is drained by a second thread (no server involved).
+ * Each value size runs with the SGEs as created and with small entries coalesced.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "../backend/common/dbbe_api.h"
+#include "../backend/redis/connection.h"
+#include "../backend/redis/create.h"
+#include "../backend/redis/namespace.h"
+#include "../backend/redis/protocol.h"
+#include "../backend/redis/request.h"
+#include "../backend/transports/smallcopy.h"
+
+#define BENCH_DEFAULT_ITERATIONS ( 20000 )
+#define BENCH_BATCH ( DBBE_REDIS_COALESCED_MAX )
+
+static
+double now_sec()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static
+void* drain( void *arg )
+{
+  int fd = *(int*)arg;
+  char *buf = (char*)malloc( 1024 * 1024 );
+  while(( buf != NULL ) && ( read( fd, buf, 1024 * 1024 ) > 0 ))
+    ;
+  free( buf );
+  return NULL;
+}
+
+static
+int bench_run( dbBE_Redis_connection_t *conn,
+               dbBE_Redis_sr_buffer_t *sbuf,
+               dbBE_Redis_request_t *req,
+               size_t vallen,
+               long iterations,
+               int coalesce )
+{
+  long entries = 0;
+  long i;
+  int n;
+  double start = now_sec();
+  for( i = 0; i < iterations; ++i )
+  {
+    for( n = 0; n < BENCH_BATCH; ++n )
+    {
+      int rc = dbBE_Redis_create_command_sge( req, sbuf, dbBE_Transport_sge_buffer_get_current( conn->_cmd ) );
+      if(( rc >= 0 ) && coalesce )
+        rc = dbBE_Redis_create_coalesce( &dbBE_Smallcopy_transport, sbuf, conn->_cmd->_cmd, conn->_cmd->_index, rc );
+      if( rc < 0 )
+        return 1;
+      dbBE_Transport_sge_buffer_add( conn->_cmd, rc );
+    }
+    entries += conn->_cmd->_index;
+    if( dbBE_Redis_connection_send_cmd( conn, sbuf ) < 0 )
+      return 1;
+    while( dbBE_Redis_connection_send_pending( conn ) != 0 )
+      if( dbBE_Redis_connection_flush( conn ) < 0 )
+        return 1;
+    dbBE_Transport_sr_buffer_reset( sbuf );
+  }
+  double elapsed = now_sec() - start;
+
+  printf( "value=%5zu %-9s %10.0f PUTs/s %8.1f MB/s (values) %6.1f iovecs/batch\n",
+          vallen, coalesce ? "coalesced" : "plain",
+          (double)iterations * BENCH_BATCH / elapsed,
+          (double)iterations * BENCH_BATCH * vallen / elapsed / 1e6,
+          (double)entries / iterations );
+  return 0;
+}
+
+int main( int argc, char **argv )
+{
+  int rc = 0;
+  long iterations = BENCH_DEFAULT_ITERATIONS;
+  if( argc > 1 )
+    iterations = strtol( argv[ 1 ], NULL, 10 );
+  if( iterations <= 0 )
+    iterations = BENCH_DEFAULT_ITERATIONS;
+
+  int sv[ 2 ];
+  if( socketpair( AF_UNIX, SOCK_STREAM, 0, sv ) != 0 )
+  {
+    fprintf( stderr, "socketpair failed: %s\n", strerror( errno ) );
+    return 1;
+  }
+  pthread_t reader;
+  pthread_create( &reader, NULL, drain, &sv[ 1 ] );
+
+  dbBE_Redis_command_stage_spec_t *specs = dbBE_Redis_command_stages_spec_init();
+  dbBE_Redis_namespace_t *ns = dbBE_Redis_namespace_create( "BenchNS" );
+  dbBE_Redis_connection_t *conn = dbBE_Redis_connection_create( DBBE_REDIS_SR_BUFFER_LEN );
+  dbBE_Redis_sr_buffer_t *sbuf = dbBE_Transport_sr_buffer_allocate( DBBE_REDIS_SR_BUFFER_LEN );
+  dbBE_Request_t *ureq = (dbBE_Request_t*)calloc( 1, sizeof( dbBE_Request_t ) + sizeof( dbBE_sge_t ) );
+  char *value = (char*)malloc( 1024 );
+  if(( specs == NULL ) || ( ns == NULL ) || ( conn == NULL ) || ( sbuf == NULL ) || ( ureq == NULL ) || ( value == NULL ))
+  {
+    fprintf( stderr, "Failed to allocate\n" );
+    return 1;
+  }
+  memset( value, 'v', 1024 );
+  conn->_socket = sv[ 0 ];
+  conn->_status = DBBE_CONNECTION_STATUS_AUTHORIZED;
+
+  ureq->_opcode = DBBE_OPCODE_PUT;
+  ureq->_key = "bench_key_0001";
+  ureq->_ns_hdl = ns;
+  ureq->_sge_count = 1;
+  ureq->_sge[ 0 ].iov_base = value;
+
+  static const size_t sizes[] = { 32, 64, 128, 256, 1024 };
+  unsigned s;
+  for( s = 0; ( rc == 0 ) && ( s < sizeof( sizes ) / sizeof( sizes[0] ) ); ++s )
+  {
+    ureq->_sge[ 0 ].iov_len = sizes[ s ];
+    dbBE_Redis_request_t *req = dbBE_Redis_request_allocate( NULL, ureq );
+    if( req == NULL )
+      return 1;
+    rc += bench_run( conn, sbuf, req, sizes[ s ], iterations, 0 );
+    rc += bench_run( conn, sbuf, req, sizes[ s ], iterations, 1 );
+    dbBE_Redis_request_destroy( req );
+  }
+
+  shutdown( sv[ 0 ], SHUT_WR );
+  pthread_join( reader, NULL );
+  close( sv[ 1 ] );
+  dbBE_Redis_connection_unlink( conn );
+  dbBE_Redis_connection_destroy( conn );
+  dbBE_Transport_sr_buffer_free( sbuf );
+  dbBE_Redis_namespace_destroy( ns );
+  dbBE_Redis_command_stages_spec_destroy( specs );
+  free( ureq );
+  free( value );
+  return rc;
+}
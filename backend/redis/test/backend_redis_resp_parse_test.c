@@ -157,7 +157,7 @@ int TestNSDetach( const char *namespace,
   memset( &result, 0, sizeof( dbBE_Redis_result_t ) );
 
   // make a copy of the request because delete processing messes around with the redis request
-  dbBE_Redis_request_t *req_io = dbBE_Redis_request_allocate( req->_user );
+  dbBE_Redis_request_t *req_io = dbBE_Redis_request_allocate( NULL, req->_user );
 
   // create a dummy connection mgr (for scan)
   dbBE_Redis_connection_mgr_t *cmr;
@@ -488,7 +488,7 @@ int TestDirectory( const char *namespace,
   memset( &result, 0, sizeof( dbBE_Redis_result_t ) );
 
   // make a copy of the request because delete processing messes around with the redis request
-  dbBE_Redis_request_t *req_io = dbBE_Redis_request_allocate( req->_user );
+  dbBE_Redis_request_t *req_io = dbBE_Redis_request_allocate( NULL, req->_user );
 
   // set a transport for the return of the data
   dbBE_Data_transport_t *transport = &dbBE_Memcopy_transport;
@@ -719,7 +719,7 @@ int main( int argc, char ** argv )
   ureq->_sge[0].iov_len = strlen( ureq->_sge[0].iov_base );
   ureq->_group = DBR_GROUP_EMPTY;
 
-  req = dbBE_Redis_request_allocate( ureq );
+  req = dbBE_Redis_request_allocate( NULL, ureq );
   rc += TestNSCreate( "TestNS", sr_buf, req );
   dbBE_Redis_request_destroy( req );
 
@@ -730,7 +730,7 @@ int main( int argc, char ** argv )
   ureq->_sge[0].iov_base = NULL;
   ureq->_sge[0].iov_len = 0;
 
-  req = dbBE_Redis_request_allocate( ureq );
+  req = dbBE_Redis_request_allocate( NULL, ureq );
   rc += TestNSAttach( "TestNS", sr_buf, req );
   dbBE_Redis_request_destroy( req );
 
@@ -740,7 +740,7 @@ int main( int argc, char ** argv )
   ureq->_sge[0].iov_base = NULL;
   ureq->_sge[0].iov_len = 0;
 
-  req = dbBE_Redis_request_allocate( ureq );
+  req = dbBE_Redis_request_allocate( NULL, ureq );
   rc += TestNSDetach( "TestNS", sr_buf, req );
   dbBE_Redis_request_destroy( req );
 
@@ -749,12 +749,13 @@ int main( int argc, char ** argv )
   ureq->_opcode = DBBE_OPCODE_NSDELETE;
   ureq->_key = NULL;
 
-  req = dbBE_Redis_request_allocate( ureq );
+  req = dbBE_Redis_request_allocate( NULL, ureq );
   rc += TestNSDelete( "TestNS", sr_buf, req );
   dbBE_Redis_request_destroy( req );
 
 
   ureq->_opcode = DBBE_OPCODE_PUT;
+  ureq->_flags = 0;
   ureq->_key = strdup("blafasel");
   ureq->_sge_count = 2;
   ureq->_sge[ 0 ].iov_base = buffer;
@@ -765,21 +766,21 @@ int main( int argc, char ** argv )
   snprintf( buffer, 13, "Hello World" );
   snprintf( &buffer[16], 14, " You're done." );
 
-  req = dbBE_Redis_request_allocate( ureq );
+  req = dbBE_Redis_request_allocate( NULL, ureq );
   rc += TestPut( "TestNS", sr_buf, req );
   dbBE_Redis_request_destroy( req );
 
   memset( buffer, 0, 1024 );
 
   ureq->_opcode = DBBE_OPCODE_READ;
-  req = dbBE_Redis_request_allocate( ureq );
+  req = dbBE_Redis_request_allocate( NULL, ureq );
   rc += TestRead( "TestNS", sr_buf, req );
   dbBE_Redis_request_destroy( req );
 
   memset( buffer, 0, 1024 );
 
   ureq->_opcode = DBBE_OPCODE_GET;
-  req = dbBE_Redis_request_allocate( ureq );
+  req = dbBE_Redis_request_allocate( NULL, ureq );
   rc += TestRead( "TestNS", sr_buf, req );
   dbBE_Redis_request_destroy( req );
 
@@ -790,14 +791,14 @@ int main( int argc, char ** argv )
   ureq->_sge[ 0 ].iov_base = buffer;
   ureq->_sge[ 0 ].iov_len = 1024;
 
-  req = dbBE_Redis_request_allocate( ureq );
+  req = dbBE_Redis_request_allocate( NULL, ureq );
   rc += TestDirectory( "TestNS", sr_buf, req );
   dbBE_Redis_request_destroy( req );
 
   memset( buffer, 0, 1024 );
 
   ureq->_opcode = DBBE_OPCODE_REMOVE;
-  req = dbBE_Redis_request_allocate( ureq );
+  req = dbBE_Redis_request_allocate( NULL, ureq );
   rc += TestRemove( "TestNS", sr_buf, req );
   dbBE_Redis_request_destroy( req );
 
@@ -812,7 +813,7 @@ int main( int argc, char ** argv )
   ureq->_sge[ 1 ].iov_base = DBR_GROUP_EMPTY;
   ureq->_sge[ 1 ].iov_len = sizeof( DBR_Group_t );
 
-  req = dbBE_Redis_request_allocate( ureq );
+  req = dbBE_Redis_request_allocate( NULL, ureq );
   rc += TestMove( "TestNS", sr_buf, req );
   dbBE_Redis_request_destroy( req );
 
@@ -259,6 +259,7 @@ int cluster_info_test_create_server( dbBE_Redis_result_t *res, int idx, int scnt
 {
   res->_type = dbBE_REDIS_TYPE_ARRAY;
   res->_data._array._len = 2+scnt;
+  res->_data._array._arena = 0;
   res->_data._array._data = (dbBE_Redis_result_t*)malloc( sizeof (dbBE_Redis_result_t ) * res->_data._array._len );
 
   res->_data._array._data[0]._type = dbBE_REDIS_TYPE_INT;
@@ -271,6 +272,7 @@ int cluster_info_test_create_server( dbBE_Redis_result_t *res, int idx, int scnt
   {
     res->_data._array._data[n]._type = dbBE_REDIS_TYPE_ARRAY;
     res->_data._array._data[n]._data._array._len = 3;
+    res->_data._array._data[n]._data._array._arena = 0;
     res->_data._array._data[n]._data._array._data = (dbBE_Redis_result_t*)malloc( sizeof (dbBE_Redis_result_t ) * res->_data._array._data[n]._data._array._len );
 
     res->_data._array._data[n]._data._array._data[0]._type = dbBE_REDIS_TYPE_CHAR;
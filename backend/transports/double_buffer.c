@@ -41,7 +41,7 @@ dbBE_Transport_dbuffer_t* dbBE_Transport_dbuffer_allocate( const size_t size )
   if( ret == NULL )
     return NULL;
 
-  char *buffer = (char*)malloc( size * 2 );
+  char *buffer = (char*)calloc( 2, size );
   if( buffer == NULL )
   {
     free( ret );
@@ -40,12 +40,29 @@ dbBE_Data_transport_t dbBE_Smallcopy_transport =
       ._send_buffer_len = 16384
     };
 
+/*
+ * copy the SGE data into the memory at dev (the destination has len bytes of space)
+ * returns the number of copied bytes or -ENOMEM if the data doesn't fit
+ */
 int64_t dbBE_Transport_scopy_gather( dbBE_Data_transport_endpoint_t* dev,
                                      size_t len,
                                      int sge_count,
                                      dbBE_sge_t *sge )
 {
-  return -ENOSYS; // not implemented
+  if(( dev == NULL ) || ( sge_count <= 0 ) || ( sge == NULL ))
+    return -EINVAL;
+
+  if( dbBE_SGE_get_len( sge, sge_count ) > len )
+    return -ENOMEM;
+
+  char *pos = (char*)dev;
+  int n;
+  for( n = 0; n < sge_count; ++n )
+  {
+    memcpy( pos, sge[ n ].iov_base, sge[ n ].iov_len );
+    pos += sge[ n ].iov_len;
+  }
+  return (int64_t)( pos - (char*)dev );
 }
 
 int64_t dbBE_Transport_scopy_scatter( dbBE_Data_transport_endpoint_t* dev,
@@ -95,27 +112,30 @@ int64_t dbBE_Transport_scopy_scatter( dbBE_Data_transport_endpoint_t* dev,
       if( partial->iov_len > 0 )
         LOG( DBG_TRACE, stderr, "after  device.recv( %ld/%ld ) = %ld\n", rsize, total, rc );
 
+      if( rc == -EAGAIN )
+      {
+        // the device has nothing more for now: report what arrived, the rest of the SGEs stay in sge_buf
+        LOG( DBG_TRACE, stderr, "device.recv() would block after %ld/%ld\n", rsize, total - partial->iov_len );
+        return rsize;
+      }
       if( rc < 0 ) break;
       if(( rc > 0 ) && ( rc + (size_t)rsize < total - partial->iov_len ))
       {
+        // skip the filled entries and trim the partially filled one; then compact once
         ssize_t offset = rc;
-        while(( sge_buf->_index > 0 ) && ( offset > 0 ))
+        unsigned first = 0;
+        while(( first < sge_buf->_index ) && ( (size_t)offset >= sge_buf->_cmd[ first ].iov_len ))
+          offset -= sge_buf->_cmd[ first++ ].iov_len;
+        if( first < sge_buf->_index )
+        {
+          sge_buf->_cmd[ first ].iov_base = (char*)sge_buf->_cmd[ first ].iov_base + offset;
+          sge_buf->_cmd[ first ].iov_len -= offset;
+        }
+        LOG( DBG_TRACE, stderr, "SGE advanced by %ld: dropped %u of %u entries\n", rc, first, sge_buf->_index );
+        if( first > 0 )
         {
-          if( (size_t)offset < sge_buf->_cmd[0].iov_len )
-          {
-            LOG( DBG_TRACE, stderr, "SGE[0] reduce by %ld from %ld to %ld\n", offset, sge_buf->_cmd[0].iov_len, sge_buf->_cmd[0].iov_len - offset );
-            sge_buf->_cmd[0].iov_base = (char*)sge_buf->_cmd[0].iov_base + offset;
-            sge_buf->_cmd[0].iov_len -= offset;
-            offset = 0;
-          }
-          else
-          {
-            LOG( DBG_TRACE, stderr, "SGE shift remaining data reduced by %ld from %ld to %ld; remaining entries: %d\n",
-                 sge_buf->_cmd[0].iov_len, offset, offset - sge_buf->_cmd[0].iov_len, sge_buf->_index-1 );
-            offset -= sge_buf->_cmd[0].iov_len;
-            memmove( sge_buf->_cmd, &sge_buf->_cmd[1], sizeof( sge_buf->_cmd[0] ) * sge_buf->_index );
-            --sge_buf->_index;
-          }
+          memmove( sge_buf->_cmd, &sge_buf->_cmd[ first ], sizeof( sge_buf->_cmd[0] ) * ( sge_buf->_index - first ) );
+          sge_buf->_index -= first;
         }
       }
       rsize += rc;
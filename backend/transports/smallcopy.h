@@ -23,9 +23,12 @@
 #include "../common/dbbe_api.h"
 #include "../common/data_transport.h"
 
-extern char* gScrapSpace;
 extern dbBE_Data_transport_t dbBE_Smallcopy_transport;
 
+/*
+ * gather copies the SGE data to the memory provided as dev
+ * (no partial copies, all data has to fit into the given space)
+ */
 int64_t dbBE_Transport_scopy_gather( dbBE_Data_transport_endpoint_t* dev,
                                      size_t len,
                                      int sge_count,
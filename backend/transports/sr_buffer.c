@@ -25,6 +25,9 @@
 #endif
 #include <string.h>
 #include <errno.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
 
 dbBE_Redis_sr_buffer_t* dbBE_Transport_sr_buffer_allocate( const size_t size )
@@ -33,7 +36,8 @@ dbBE_Redis_sr_buffer_t* dbBE_Transport_sr_buffer_allocate( const size_t size )
   if( ret == NULL )
     return NULL;
 
-  if( dbBE_Transport_sr_buffer_initialize( ret, size, (char*)malloc( size ) ) != 0 )
+  // calloc leaves large zero-pages untouched until first use
+  if( dbBE_Transport_sr_buffer_initialize( ret, size, (char*)calloc( 1, size ) ) != 0 )
   {
     free( ret );
     return NULL;
@@ -62,8 +66,6 @@ int dbBE_Transport_sr_buffer_initialize( dbBE_Redis_sr_buffer_t *sr_buf,
   if( sr_buf->_start == NULL )
     return -ENOMEM;
 
-  memset( sr_buf->_start, 0, size );
-
   return 0;
 }
 
@@ -83,11 +85,48 @@ void dbBE_Transport_sr_buffer_free( dbBE_Redis_sr_buffer_t *sr_buf )
     return;
 
   if( sr_buf->_start != NULL )
-  {
-    memset( sr_buf->_start, 0, sr_buf->_size );
     free( sr_buf->_start );
-  }
 
   memset( sr_buf, 0, sizeof( dbBE_Redis_sr_buffer_t ) );
   free( sr_buf );
 }
+
+int dbBE_Transport_sr_buffer_resize( dbBE_Redis_sr_buffer_t *sr_buf,
+                                     const size_t size )
+{
+  if(( sr_buf == NULL ) || ( size == 0 ))
+    return -EINVAL;
+  if( sr_buf->_available != 0 )
+    return -EBUSY;
+  if( size == sr_buf->_size )
+    return 0;
+
+  // content is irrelevant, no need to realloc
+  char *buffer = (char*)calloc( 1, size );
+  if( buffer == NULL )
+    return -ENOMEM;
+  free( sr_buf->_start );
+  sr_buf->_start = buffer;
+  sr_buf->_size = size;
+  sr_buf->_processed = 0;
+  return 0;
+}
+
+int dbBE_Transport_memory_advise_hugepages( char *mem, const size_t size )
+{
+  if( mem == NULL )
+    return -EINVAL;
+#ifdef MADV_HUGEPAGE
+  uintptr_t page = (uintptr_t)sysconf( _SC_PAGESIZE );
+  uintptr_t start = ( (uintptr_t)mem + page - 1 ) & ~( page - 1 );
+  uintptr_t end = ( (uintptr_t)mem + size ) & ~( page - 1 );
+  if(( end <= start ) || ( end - start < DBBE_TRANSPORT_HUGEPAGE_MIN ))
+    return 0;  // too small to benefit
+  if( madvise( (void*)start, end - start, MADV_HUGEPAGE ) != 0 )
+    return -errno;
+  return 0;
+#else
+  (void)size;
+  return -ENOTSUP;
+#endif
+}
@@ -45,8 +45,14 @@ typedef struct
 } dbBE_Redis_sr_buffer_t;
 
 
+/*
+ * buffers below this size are not worth a hugepage hint
+ */
+#define DBBE_TRANSPORT_HUGEPAGE_MIN ( 2 * 1048576 )
+
 /*
  * allocate an initialize the send-receive buffer
+ * the memory is zeroed lazily by the OS (pages are only touched on first use)
  */
 dbBE_Redis_sr_buffer_t* dbBE_Transport_sr_buffer_allocate( const size_t size );
 
@@ -56,6 +62,20 @@ dbBE_Redis_sr_buffer_t* dbBE_Transport_sr_buffer_allocate( const size_t size );
 int dbBE_Transport_sr_buffer_initialize( dbBE_Redis_sr_buffer_t *sr_buf,
                                          const size_t size,
                                          char *buffer );
+/*
+ * replace the memory of an empty buffer with a new allocation of the given size
+ * returns -EBUSY if the buffer holds data, -ENOMEM leaves the old memory in place
+ */
+int dbBE_Transport_sr_buffer_resize( dbBE_Redis_sr_buffer_t *sr_buf,
+                                     const size_t size );
+
+/*
+ * ask the OS to back the page-aligned part of the given memory with transparent hugepages
+ * memory smaller than DBBE_TRANSPORT_HUGEPAGE_MIN is left alone
+ * returns 0 on success or if it's ignored, -ENOTSUP if the platform has no support
+ */
+int dbBE_Transport_memory_advise_hugepages( char *mem, const size_t size );
+
 /*
  * reset the stats of the send-receive buffer
  */
@@ -108,6 +108,15 @@ int main( int argc, char ** argv )
   rc += TEST( dbBE_Transport_sr_buffer_processed( buffer ), DBBE_TEST_BUFFER_LEN >> 1 );
   rc += TEST( dbBE_Transport_sr_buffer_get_processed_position( buffer ), dbBE_Transport_sr_buffer_get_start( buffer ) + (DBBE_TEST_BUFFER_LEN >> 1) );
 
+  // resizing is only possible while the buffer is empty
+  rc += TEST( dbBE_Transport_sr_buffer_resize( buffer, DBBE_TEST_BUFFER_LEN << 1 ), -EBUSY );
+  dbBE_Transport_sr_buffer_reset( buffer );
+  rc += TEST( dbBE_Transport_sr_buffer_resize( buffer, 0 ), -EINVAL );
+  rc += TEST( dbBE_Transport_sr_buffer_resize( buffer, DBBE_TEST_BUFFER_LEN << 1 ), 0 );
+  rc += TEST( dbBE_Transport_sr_buffer_get_size( buffer ), DBBE_TEST_BUFFER_LEN << 1 );
+  rc += TEST( dbBE_Transport_sr_buffer_full( buffer, DBBE_TEST_BUFFER_LEN << 1 ), 0 );
+  rc += TEST( dbBE_Transport_sr_buffer_add_data( buffer, DBBE_TEST_BUFFER_LEN << 1, 1 ), DBBE_TEST_BUFFER_LEN << 1 );
+
   dbBE_Transport_sr_buffer_free( buffer );
 
   printf( "Test exiting with rc=%d\n", rc );
@@ -25,7 +25,9 @@ dbrPut (DBR_Handle_t cs_handle,
         DBR_Tuple_name_t tuple_name,
         DBR_Group_t group)
 {
-  dbrDA_Request_chain_t *req = (dbrDA_Request_chain_t*)calloc( 1, sizeof( dbrDA_Request_chain_t ) + sizeof( dbBE_sge_t ) );
+  dbrDA_Request_chain_t *req = libdbrRequest_chain_alloc( cs_handle, 1 );
+  if( req == NULL )
+    return DBR_ERR_NOMEMORY;
   req->_key = tuple_name;
   req->_size = size;
   req->_ret_size = &req->_size;
@@ -37,7 +39,7 @@ dbrPut (DBR_Handle_t cs_handle,
   rc = libdbrPut( cs_handle,
                   req,
                   group );
-  free( req );
+  libdbrRequest_chain_release( cs_handle, req );
   return rc;
 }
 
@@ -49,7 +51,9 @@ dbrPutA (DBR_Handle_t cs_handle,
          DBR_Tuple_name_t tuple_name,
          DBR_Group_t group)
 {
-  dbrDA_Request_chain_t *req = (dbrDA_Request_chain_t*)calloc( 1, sizeof( dbrDA_Request_chain_t) + sizeof( dbBE_sge_t ));
+  dbrDA_Request_chain_t *req = libdbrRequest_chain_alloc( cs_handle, 1 );
+  if( req == NULL )
+    return DB_TAG_ERROR;
   req->_key = tuple_name;
   req->_next = NULL;
   req->_size = size;
@@ -60,6 +64,37 @@ dbrPutA (DBR_Handle_t cs_handle,
 
   return libdbrPutA( cs_handle,
                      req,
-                     group );
+                     group,
+                     NULL,
+                     NULL );
   // no free of req here, since it's needed for dbrTest()
 }
+
+
+DBR_Tag_t
+dbrPutA_cb (DBR_Handle_t cs_handle,
+            void *va_ptr,
+            int64_t size,
+            DBR_Tuple_name_t tuple_name,
+            DBR_Group_t group,
+            DBR_Completion_cb_t callback,
+            void *cb_context )
+{
+  dbrDA_Request_chain_t *req = libdbrRequest_chain_alloc( cs_handle, 1 );
+  if( req == NULL )
+    return DB_TAG_ERROR;
+  req->_key = tuple_name;
+  req->_next = NULL;
+  req->_size = size;
+  req->_ret_size = &req->_size;
+  req->_sge_count = 1;
+  req->_value_sge[0].iov_base = va_ptr;
+  req->_value_sge[0].iov_len = size;
+
+  return libdbrPutA( cs_handle,
+                     req,
+                     group,
+                     callback,
+                     cb_context );
+  // req is released by the library before the callback is invoked
+}
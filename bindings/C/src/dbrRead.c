@@ -27,7 +27,9 @@ dbrRead(DBR_Handle_t cs_handle,
         DBR_Group_t group,
         int flags )
 {
-  dbrDA_Request_chain_t *req = (dbrDA_Request_chain_t*)calloc( 1, sizeof( dbrDA_Request_chain_t ) + sizeof( dbBE_sge_t ) );;
+  dbrDA_Request_chain_t *req = libdbrRequest_chain_alloc( cs_handle, 1 );
+  if( req == NULL )
+    return DBR_ERR_NOMEMORY;
   req->_key = tuple_name;
   req->_ret_size = size;
   req->_size = *size;
@@ -42,7 +44,7 @@ dbrRead(DBR_Handle_t cs_handle,
                    match_template,
                    group,
                    flags );
-  free( req );
+  libdbrRequest_chain_release( cs_handle, req );
   return rc;
 }
 
@@ -56,7 +58,9 @@ dbrReadA(DBR_Handle_t cs_handle,
          DBR_Group_t group,
          int flags )
 {
-  dbrDA_Request_chain_t *req = (dbrDA_Request_chain_t*)calloc( 1, sizeof( dbrDA_Request_chain_t ) + sizeof( dbBE_sge_t ) );;
+  dbrDA_Request_chain_t *req = libdbrRequest_chain_alloc( cs_handle, 1 );
+  if( req == NULL )
+    return DB_TAG_ERROR;
   req->_key = tuple_name;
   req->_ret_size = size;
   req->_size = *size;
@@ -69,6 +73,41 @@ dbrReadA(DBR_Handle_t cs_handle,
                       match_template,
                       group,
                       flags,
-                      size );
+                      size,
+                      NULL,
+                      NULL );
   // no free of req here, since it's needed for dbrTest()
 }
+
+
+DBR_Tag_t
+dbrReadA_cb(DBR_Handle_t cs_handle,
+            void *va_ptr,
+            int64_t *size,
+            DBR_Tuple_name_t tuple_name,
+            DBR_Tuple_template_t match_template,
+            DBR_Group_t group,
+            int flags,
+            DBR_Completion_cb_t callback,
+            void *cb_context )
+{
+  dbrDA_Request_chain_t *req = libdbrRequest_chain_alloc( cs_handle, 1 );
+  if( req == NULL )
+    return DB_TAG_ERROR;
+  req->_key = tuple_name;
+  req->_ret_size = size;
+  req->_size = *size;
+  req->_sge_count = 1;
+  req->_value_sge[0].iov_base = va_ptr;
+  req->_value_sge[0].iov_len = *size;
+
+  return libdbrReadA( cs_handle,
+                      req,
+                      match_template,
+                      group,
+                      flags,
+                      size,
+                      callback,
+                      cb_context );
+  // req is released by the library before the callback is invoked
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright © 2018 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "libdbrAPI.h"
+
+DBR_Errorcode_t
+dbrRemoveOrphans( DBR_Handle_t cs_handle,
+                  DBR_Group_t group,
+                  DBR_Tuple_name_t tuple_name )
+{
+  return (DBR_Errorcode_t)libdbrRemoveOrphans( cs_handle,
+                                               group,
+                                               tuple_name );
+}
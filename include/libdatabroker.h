@@ -28,6 +28,11 @@
 #include "errorcodes.h"
 
 #define DBR_TIMEOUT_ENV "DBR_TIMEOUT"
+#define DBR_WAIT_POLICY_ENV "DBR_WAIT_POLICY"
+#define DBR_WAIT_SPIN_ENV "DBR_WAIT_SPIN_USEC"
+#define DBR_PROGRESS_THREAD_ENV "DBR_PROGRESS_THREAD"
+#define DBR_STRIPE_THRESHOLD_ENV "DBR_STRIPE_THRESHOLD"
+#define DBR_STRIPE_SIZE_ENV "DBR_STRIPE_SIZE"
 /**
  * @defgroup api  User Level API
  *
@@ -131,6 +136,17 @@ typedef int64_t DBR_Tag_t;
 #else
 typedef void* DBR_Tag_t;
 #endif
+
+/**
+ * @typedef DBR_Completion_cb_t
+ * @brief   Completion callback of an asynchronous call.
+ *
+ * Invoked exactly once when the asynchronous call identified by tag completes.
+ * status is the value that dbrTest() would have returned for the call.
+ * The tag is released by the library before the callback is invoked.
+ *
+ */
+typedef void (*DBR_Completion_cb_t)( DBR_Tag_t tag, DBR_Errorcode_t status, void *context );
 /**
  * @typedef DBR_Name_t
  * @brief   Name of a namespace.
@@ -746,6 +762,31 @@ DBR_Errorcode_t dbrRemove( DBR_Handle_t dbr_handle,
                            DBR_Tuple_template_t match_template );
 
 
+/**
+ * @brief Remove the leftover chunks of striped values of a tuple name.
+ *
+ * dbrRemove() only removes the chunks of the striped values it finds at the front of a tuple.
+ * Chunks of striped values further back, or of puts that failed halfway, stay behind.
+ * This maintenance call finds them with directory scans and removes them.
+ * It must not run concurrently with puts of the same tuple name.
+ *
+ * @param [in] dbr_handle	Handle of the namespace.
+ * @param [in] group		Group where the tuple is stored.
+ * @param [in] tuple_name	Name of the tuple.
+ *
+ * @return
+ * 		- DBR_SUCCESS if the operation is successful or striping is not configured;
+ * 		- DBR_ERR_EXISTS if the tuple still holds values;
+ * 		- An error code identifying the issue, otherwise.
+ *
+ * 	@see DBR_Errorcode_t
+ *
+ */
+DBR_Errorcode_t dbrRemoveOrphans( DBR_Handle_t dbr_handle,
+                                  DBR_Group_t group,
+                                  DBR_Tuple_name_t tuple_name );
+
+
 /*
  * data broker request handling functions
  * to test for completion or cancel non-blocking requests
@@ -785,6 +826,145 @@ DBR_Errorcode_t dbrTest( DBR_Tag_t req_tag );
 DBR_Errorcode_t dbrCancel( DBR_Tag_t req_tag );
 
 
+/**
+ * @brief Test the completion of a set of asynchronous calls.
+ *
+ * This function processes all completions that are available at the time of the call
+ * and checks every tag of the list in a single pass. Tags of completed calls are released
+ * and replaced by DB_TAG_ERROR in the list. List entries that are DB_TAG_ERROR are ignored.
+ * This allows to repeatedly call the function with the same list until all calls are complete.
+ *
+ * @param [in,out] tags         Array of tags corresponding to asynchronous calls.
+ * @param [in]     count        Number of entries in tags and results.
+ * @param [out]    results      Per tag result: the completion status of each call that completed
+ *                              during this call or DBR_ERR_INPROGRESS if the call is still pending.
+ *                              Entries of ignored tags are not modified.
+ * @param [out]    completed    Number of calls that completed during this call (can be NULL).
+ *
+ * @return
+ *     - DBR_SUCCESS if at least one call has completed;
+ *     - DBR_ERR_INPROGRESS if none of the calls has completed;
+ *     - DBR_ERR_TAGERROR if there's no tag left in the list;
+ *     - An error code identifying the issue, otherwise.
+ */
+DBR_Errorcode_t dbrTestSome( DBR_Tag_t *tags,
+                             const int count,
+                             DBR_Errorcode_t *results,
+                             int *completed );
+
+/**
+ * @brief Wait for the completion of any call in a set of asynchronous calls.
+ *
+ * Same as dbrTestSome() but blocks until at least one of the calls has completed.
+ * Multiple calls may complete at once and are all reported in results.
+ * The function waits at most DBR_TIMEOUT seconds.
+ *
+ * @param [in,out] tags         Array of tags corresponding to asynchronous calls.
+ * @param [in]     count        Number of entries in tags and results.
+ * @param [out]    results      Per tag result (see dbrTestSome()).
+ * @param [out]    completed    Number of calls that completed (can be NULL).
+ *
+ * @return
+ *     - DBR_SUCCESS if at least one call has completed;
+ *     - DBR_ERR_TIMEOUT if no call completed before the timeout occurred;
+ *     - DBR_ERR_TAGERROR if there's no tag left in the list;
+ *     - An error code identifying the issue, otherwise.
+ */
+DBR_Errorcode_t dbrWaitAny( DBR_Tag_t *tags,
+                            const int count,
+                            DBR_Errorcode_t *results,
+                            int *completed );
+
+/**
+ * @brief Wait for the completion of all calls in a set of asynchronous calls.
+ *
+ * Same as dbrTestSome() but blocks until all of the calls have completed.
+ * The function waits at most DBR_TIMEOUT seconds. In case of a timeout, the
+ * completed calls are released and reported like in dbrTestSome() and the
+ * remaining tags stay valid.
+ *
+ * @param [in,out] tags         Array of tags corresponding to asynchronous calls.
+ * @param [in]     count        Number of entries in tags and results.
+ * @param [out]    results      Per tag result (see dbrTestSome()).
+ *
+ * @return
+ *     - DBR_SUCCESS if all calls have completed (check results for the status of each call);
+ *     - DBR_ERR_TIMEOUT if not all calls completed before the timeout occurred;
+ *     - An error code identifying the issue, otherwise.
+ */
+DBR_Errorcode_t dbrWaitAll( DBR_Tag_t *tags,
+                            const int count,
+                            DBR_Errorcode_t *results );
+
+
+/**
+ * @brief Insert a tuple in a namespace asynchronously with completion callback.
+ *
+ * Same as dbrPutA() but instead of testing the returned tag, the completion
+ * is reported by invoking the callback. The tag must not be used with dbrTest(),
+ * dbrTestSome(), dbrWaitAny() or dbrWaitAll().
+ *
+ * The callback is invoked without any library locks held by whichever thread
+ * drives the completion: any Data Broker call that makes progress (e.g. dbrProgress(),
+ * dbrTest() of other requests or blocking calls). If the back-end runs its own
+ * progress thread (see DBR_PROGRESS_THREAD), a library thread invokes the callbacks
+ * without the need for any further calls.
+ *
+ * @param [in] callback     Function to call on completion.
+ * @param [in] cb_context   User context passed to the callback.
+ *
+ * For the other parameters and return values see dbrPutA().
+ */
+DBR_Tag_t dbrPutA_cb( DBR_Handle_t dbr_handle,
+                      void *va_ptr,
+                      int64_t size,
+                      DBR_Tuple_name_t tuple_name,
+                      DBR_Group_t group,
+                      DBR_Completion_cb_t callback,
+                      void *cb_context );
+
+/**
+ * @brief Get a tuple from a namespace asynchronously with completion callback.
+ *
+ * Same as dbrGetA() but with completion callback (see dbrPutA_cb()).
+ */
+DBR_Tag_t dbrGetA_cb( DBR_Handle_t dbr_handle,
+                      void *va_ptr,
+                      int64_t *size,
+                      DBR_Tuple_name_t tuple_name,
+                      DBR_Tuple_template_t match_template,
+                      DBR_Group_t group,
+                      int flags,
+                      DBR_Completion_cb_t callback,
+                      void *cb_context );
+
+/**
+ * @brief Read a tuple from a namespace asynchronously with completion callback.
+ *
+ * Same as dbrReadA() but with completion callback (see dbrPutA_cb()).
+ */
+DBR_Tag_t dbrReadA_cb( DBR_Handle_t dbr_handle,
+                       void *va_ptr,
+                       int64_t *size,
+                       DBR_Tuple_name_t tuple_name,
+                       DBR_Tuple_template_t match_template,
+                       DBR_Group_t group,
+                       int flags,
+                       DBR_Completion_cb_t callback,
+                       void *cb_context );
+
+/**
+ * @brief Drive the back-end and invoke the callbacks of completed requests.
+ *
+ * @param [out] completed   Number of invoked callbacks (can be NULL).
+ *
+ * @return
+ *     - DBR_SUCCESS if the call was successful;
+ *     - An error code identifying the issue, otherwise.
+ */
+DBR_Errorcode_t dbrProgress( int *completed );
+
+
 
 /**
  * @brief Create or progress an iterator
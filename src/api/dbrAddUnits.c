@@ -79,5 +79,6 @@ libdbrAddUnits( DBR_Handle_t cs_handle,
 
 error:
   dbrRemove_request( cs, pctx );
+  dbrTag_release( cs->_reverse, tag ); // in case the request never made it into the table
   return rc;
 }
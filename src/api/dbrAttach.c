@@ -58,22 +58,16 @@ libdbrAttach (DBR_Name_t db_name)
   if( ctx == NULL )
     return (DBR_Handle_t)NULL;
 
-  BIGLOCK_LOCK( ctx );
+  NSLOCK_LOCK( ctx );
 
   dbrName_space_t *cs = NULL;
 
   // check if this name is already tracked in the in-mem table
-  uint32_t idx = dbrMain_find( ctx, db_name );
-  if( idx != dbrERROR_INDEX )
+  cs = dbrMain_find( ctx, db_name );
+  if( cs != NULL )
   {
-    cs = ctx->_cs_list[ idx ];
-    if( cs == NULL )
-    {
-      errno = ENOENT;
-      BIGLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)NULL );
-    }
     if(( errno = dbrMain_attach( ctx, cs ) ) != 0 )
-      BIGLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)NULL );
+      NSLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)NULL );
   }
   else
   {
@@ -81,13 +75,13 @@ libdbrAttach (DBR_Name_t db_name)
     if( cs == NULL )
     {
       errno = ETOOMANYREFS;
-      BIGLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)NULL );
+      NSLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)NULL );
     }
   }
 
   DBR_Tag_t tag = dbrTag_get( cs->_reverse );
   if( tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)NULL );
+    NSLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)NULL );
 
   DBR_Errorcode_t attach_rc = DBR_SUCCESS;
   dbrRequestContext_t *rctx = dbrCreate_request_ctx( DBBE_OPCODE_NSATTACH,
@@ -130,12 +124,13 @@ libdbrAttach (DBR_Name_t db_name)
 
   cs->_be_ns_hdl = (dbBE_NS_Handle_t)rctx->_cpl._rc;
   dbrRemove_request( cs, rctx );
-  BIGLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)cs );
+  NSLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)cs );
 
 error:
   dbrRemove_request( cs, rctx );
+  dbrTag_release( cs->_reverse, tag ); // in case the request never made it into the table
   if( cs != NULL )
     dbrMain_detach( ctx, cs );
   LOG( DBG_ERR, stderr, "Attach error: %s\n", dbrGet_error( attach_rc ) );
-  BIGLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)NULL );
+  NSLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)NULL );
 }
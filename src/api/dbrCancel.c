@@ -24,42 +24,29 @@
 
 DBR_Errorcode_t libdbrCancel( DBR_Tag_t req_tag )
 {
-#ifdef DBR_INTTAG
   dbrMain_context_t *main_ctx = dbrCheckCreateMainCTX();
   if( main_ctx == NULL )
     return DBR_ERR_INVALID;
 
-  if(( req_tag < 0 ) || ( req_tag >= dbrMAX_TAGS ))
+  if( dbrValidateTag( NULL, req_tag ) != DBR_SUCCESS )
     return DBR_ERR_TAGERROR;
 
-  BIGLOCK_LOCK( main_ctx );
-
-  dbrRequestContext_t *rctx = main_ctx->_cs_wq[ req_tag ];
+  TAGLOCK_LOCK( main_ctx );
+  dbrRequestContext_t *rctx = dbrTag_lookup( main_ctx, req_tag );
+  TAGLOCK_UNLOCK( main_ctx );
   if( rctx == NULL )
-    BIGLOCK_UNLOCKRETURN( main_ctx, DBR_ERR_TAGERROR );
-
-#else
-#error "Currently not supported because of lack of access to main context and locking"
-  if( req_tag == NULL
-      || req_tag == DB_TAG_ERROR )
     return DBR_ERR_TAGERROR;
 
-  dbrRequestContext_t *rctx = *(dbrRequestContext_t**)req_tag;
-  if( rctx == NULL )
-    return DBR_ERR_HANDLE;
-
-#endif
-
   DBR_Errorcode_t rc = dbrValidateTag( rctx, req_tag );
   if( rc != DBR_SUCCESS )
-    BIGLOCK_UNLOCKRETURN( main_ctx, rc );
+    return rc;
 
   dbrName_space_t* cs = rctx->_ctx;
   if( cs->_be_ctx == NULL )
-    BIGLOCK_UNLOCKRETURN( main_ctx, DBR_ERR_NSINVAL );
+    return DBR_ERR_NSINVAL;
 
   // todo: call the back-end cancel op
 
   rc = dbrRemove_request( cs, rctx );
-  BIGLOCK_UNLOCKRETURN( main_ctx, rc );
+  return rc;
 }
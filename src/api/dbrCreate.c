@@ -49,22 +49,15 @@ libdbrCreate (DBR_Name_t db_name,
   if( ctx->_be_ctx == NULL )
     return NULL;
 
-  BIGLOCK_LOCK( ctx );
+  NSLOCK_LOCK( ctx );
   dbrName_space_t *cs = NULL;
 
   // check if this name is already tracked in the in-mem table
-  uint32_t idx = dbrMain_find( ctx, db_name );
-  if( idx != dbrERROR_INDEX )
+  cs = dbrMain_find( ctx, db_name );
+  if( cs != NULL )
   {
     // already existing CS is an error - but check the global state to be sure!!
     local_result = DBR_ERR_EXISTS;
-
-    cs = ctx->_cs_list[ idx ];
-    if( cs == NULL )
-    {
-      errno = ENOENT;
-      BIGLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)NULL );
-    }
   }
   else
   {
@@ -73,7 +66,7 @@ libdbrCreate (DBR_Name_t db_name,
     if( cs == NULL )
     {
       errno = ENOMEM;
-      BIGLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)NULL );
+      NSLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)NULL );
     }
 
     local_result = DBR_SUCCESS;
@@ -81,7 +74,7 @@ libdbrCreate (DBR_Name_t db_name,
 
   DBR_Tag_t tag = dbrTag_get( cs->_reverse );
   if( tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)NULL );
+    NSLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)NULL );
 
   rctx = dbrCreate_request_ctx( DBBE_OPCODE_NSCREATE,
                                 cs,
@@ -131,11 +124,12 @@ libdbrCreate (DBR_Name_t db_name,
 
   dbrRemove_request( cs, rctx );
 
-  BIGLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)cs );
+  NSLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)cs );
 error:
   dbrRemove_request( cs, rctx );
+  dbrTag_release( cs->_reverse, tag ); // in case the request never made it into the table
   if( local_result == DBR_SUCCESS )
     dbrMain_delete( ctx, cs );
 
-  BIGLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)NULL );
+  NSLOCK_UNLOCKRETURN( ctx, (DBR_Handle_t)NULL );
 }
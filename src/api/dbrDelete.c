@@ -39,33 +39,25 @@ libdbrDelete(DBR_Name_t db_name)
     return DBR_ERR_GENERIC;
   }
 
-  BIGLOCK_LOCK( ctx );
+  NSLOCK_LOCK( ctx );
 
   // check if this name is tracked in the in-mem table
-  uint32_t idx = dbrMain_find( ctx, db_name );
-  if( idx == dbrERROR_INDEX )
-  {
-    errno = ENOENT;
-    BIGLOCK_UNLOCKRETURN( ctx, DBR_ERR_NSINVAL );
-  }
-
-  // did we find a valid entry?
-  dbrName_space_t *cs = ctx->_cs_list[ idx ];
+  dbrName_space_t *cs = dbrMain_find( ctx, db_name );
   if( cs == NULL )
   {
     errno = ENOENT;
-    BIGLOCK_UNLOCKRETURN( ctx, DBR_ERR_NSINVAL );
+    NSLOCK_UNLOCKRETURN( ctx, DBR_ERR_NSINVAL );
   }
 
   if( ctx->_be_ctx == NULL )
   {
     errno = ENOTCONN;
-    BIGLOCK_UNLOCKRETURN( ctx, DBR_ERR_NOCONNECT );
+    NSLOCK_UNLOCKRETURN( ctx, DBR_ERR_NOCONNECT );
   }
 
   DBR_Tag_t tag = dbrTag_get( cs->_reverse );
   if( tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( ctx, DBR_ERR_TAGERROR );
+    NSLOCK_UNLOCKRETURN( ctx, DBR_ERR_TAGERROR );
 
   DBR_Errorcode_t rc = DBR_SUCCESS;
   dbrRequestContext_t *rctx = dbrCreate_request_ctx( DBBE_OPCODE_NSDELETE,
@@ -110,17 +102,18 @@ libdbrDelete(DBR_Name_t db_name)
     delrc = DBR_ERR_NSINVAL;
 
   // detach after marking deleted (regardless of current rc)
-  BIGLOCK_UNLOCK( ctx );
+  NSLOCK_UNLOCK( ctx );
   rc = libdbrDetach( cs );
-  BIGLOCK_LOCK( ctx );
+  NSLOCK_LOCK( ctx );
 
   // retrieve any errors that might have appeared from the delete
   if( delrc != DBR_SUCCESS )
     rc = delrc;
 
-  BIGLOCK_UNLOCKRETURN( ctx, rc );
+  NSLOCK_UNLOCKRETURN( ctx, rc );
 
 error:
   dbrRemove_request( cs, rctx );
-  BIGLOCK_UNLOCKRETURN( ctx, rc );
+  dbrTag_release( cs->_reverse, tag ); // in case the request never made it into the table
+  NSLOCK_UNLOCKRETURN( ctx, rc );
 }
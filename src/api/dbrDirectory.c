@@ -35,11 +35,9 @@ libdbrDirectory( DBR_Handle_t cs_handle,
   if(( cs->_be_ctx == NULL ) || ( cs->_reverse == NULL ) || (cs->_status != dbrNS_STATUS_REFERENCED ))
     return DBR_ERR_NSINVAL;
 
-  BIGLOCK_LOCK( cs->_reverse );
-
   DBR_Tag_t tag = dbrTag_get( cs->_reverse );
   if( tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_TAGERROR );
+    return DBR_ERR_TAGERROR;
 
   dbBE_sge_t sge[2];
   sge[0].iov_base = result_buffer;
@@ -90,7 +88,8 @@ libdbrDirectory( DBR_Handle_t cs_handle,
 
 error:
   dbrRemove_request( cs, ctx );
+  dbrTag_release( cs->_reverse, tag ); // in case the request never made it into the table
 
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, rc );
+  return rc;
 }
 
@@ -18,17 +18,18 @@
 #include "util/lock_tools.h"
 #include "libdatabroker.h"
 #include "libdatabroker_int.h"
+#include "lib/stripe.h"
 
 #include <stdio.h>
 
 
 DBR_Errorcode_t
-libdbrGet (DBR_Handle_t cs_handle,
-           dbrDA_Request_chain_t *request,
-           int64_t *ret_size,
-           DBR_Tuple_template_t match_template,
-           DBR_Group_t group,
-           int flags)
+dbrGet_chain( dbrName_space_t *cs_handle,
+              dbrDA_Request_chain_t *request,
+              int64_t *ret_size,
+              DBR_Tuple_template_t match_template,
+              DBR_Group_t group,
+              int flags)
 {
   dbrName_space_t *cs = (dbrName_space_t*)cs_handle;
 
@@ -41,12 +42,10 @@ libdbrGet (DBR_Handle_t cs_handle,
   dbrDA_Request_chain_t *chain = request;
   int enable_timeout = ((flags & DBR_FLAGS_NOWAIT ) == 0 );
 
-  BIGLOCK_LOCK( cs->_reverse );
-
   // create a deletion request (to be appended to the get)
   DBR_Tag_t tag = dbrTag_get( cs->_reverse );
   if( tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_TAGERROR );
+    return DBR_ERR_TAGERROR;
 
 #ifdef DBR_DATA_ADAPTERS
   // read-path request pre-processing plugin
@@ -54,7 +53,10 @@ libdbrGet (DBR_Handle_t cs_handle,
   {
     chain = cs->_reverse->_data_adapter->pre_read( request );
     if( chain == NULL )
-      BIGLOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_PLUGIN );
+    {
+      dbrTag_release( cs->_reverse, tag );
+      return DBR_ERR_PLUGIN;
+    }
   }
 #endif
 
@@ -123,13 +125,31 @@ libdbrGet (DBR_Handle_t cs_handle,
   }
 
   dbrRemove_request( cs, head );
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, rc );
+  return rc;
 
 error:
   dbrRemove_request( cs, head );
+  dbrTag_release( cs->_reverse, tag ); // in case the request never made it into the table
 #ifdef DBR_DATA_ADAPTERS
   if( cs->_reverse->_data_adapter != NULL )
     rc = cs->_reverse->_data_adapter->error_handler( chain, DBRDA_READ, rc );
 #endif
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, rc );
+  return rc;
+}
+
+DBR_Errorcode_t
+libdbrGet( DBR_Handle_t cs_handle,
+           dbrDA_Request_chain_t *request,
+           int64_t *ret_size,
+           DBR_Tuple_template_t match_template,
+           DBR_Group_t group,
+           int flags )
+{
+  dbrName_space_t *cs = (dbrName_space_t*)cs_handle;
+  DBR_Errorcode_t rc = dbrGet_chain( cs, request, ret_size, match_template, group, flags );
+
+  // a striped value comes back as its manifest
+  if(( rc == DBR_SUCCESS ) && dbrStripe_get_candidate( cs, request ))
+    rc = dbrStripe_resolve( cs, DBBE_OPCODE_GET, request, group, flags );
+  return rc;
 }
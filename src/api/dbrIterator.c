@@ -35,7 +35,7 @@ libdbrIterator( DBR_Handle_t cs_handle,
 
   DBR_Tag_t tag = dbrTag_get( cs->_reverse );
   if( tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( cs->_reverse, NULL );
+    return NULL;
 
   DBR_Errorcode_t rc = DBR_SUCCESS;
 
@@ -81,9 +81,11 @@ libdbrIterator( DBR_Handle_t cs_handle,
   }
 
   dbrRemove_request( cs, ctx );
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, iterator );
+  return iterator;
 
 error:
+  dbrRemove_request( cs, ctx );
+  dbrTag_release( cs->_reverse, tag ); // in case the request never made it into the table
   tuple_name[0] = '\0';
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, NULL );
+  return NULL;
 }
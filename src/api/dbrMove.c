@@ -17,9 +17,76 @@
 #include "util/lock_tools.h"
 #include "libdatabroker.h"
 #include "libdatabroker_int.h"
+#include "lib/stripe.h"
 
 #include <stdio.h>
 
+DBR_Errorcode_t dbrMove_chain( dbrName_space_t *src_cs,
+                               DBR_Group_t src_group,
+                               dbrDA_Request_chain_t *request,
+                               DBR_Tuple_template_t match_template,
+                               dbrName_space_t *dst_cs,
+                               DBR_Group_t dst_group )
+{
+  if(( src_cs == NULL ) || ( dst_cs == NULL ) || ( request == NULL ))
+    return DBR_ERR_INVALID;
+
+  if(( src_cs->_be_ctx == NULL ) || ( dst_cs->_be_ctx == NULL ) || ( src_cs->_reverse == NULL ))
+    return DBR_ERR_NSINVAL;
+
+  DBR_Tag_t tag = dbrTag_get( src_cs->_reverse );
+  if( tag == DB_TAG_ERROR )
+    return DBR_ERR_TAGERROR;
+
+  DBR_Errorcode_t rc = DBR_SUCCESS;
+  dbrRequestContext_t *head =
+      dbrCreate_request_chain( DBBE_OPCODE_MOVE,
+                               src_cs,
+                               src_group,
+                               dst_cs,
+                               dst_group,
+                               request,
+                               match_template,
+                               0,
+                               tag );
+  if( head == NULL )
+  {
+    rc = DBR_ERR_NOMEMORY;
+    goto error;
+  }
+
+  if( dbrInsert_request( src_cs, head ) == DB_TAG_ERROR )
+  {
+    rc = DBR_ERR_TAGERROR;
+    goto error;
+  }
+
+  DBR_Request_handle_t req_handle = dbrPost_request( head );
+  if( req_handle == NULL )
+  {
+    rc = DBR_ERR_BE_POST;
+    goto error;
+  }
+
+  rc = dbrWait_request( src_cs, req_handle, 0 );
+  switch( rc ) {
+  case DBR_SUCCESS:
+    rc = dbrCheck_response( head );
+    break;
+  case DBR_ERR_INPROGRESS:
+    rc = DBR_ERR_TIMEOUT;
+    break;
+  default:
+    goto error;
+  }
+
+error:
+  dbrRemove_request( src_cs, head );
+  dbrTag_release( src_cs->_reverse, tag ); // in case the request never made it into the table
+
+  return rc;
+}
+
 
 DBR_Errorcode_t libdbrMove ( DBR_Handle_t src_cs_handle,
                              DBR_Group_t src_group,
@@ -48,13 +115,14 @@ DBR_Errorcode_t libdbrMove ( DBR_Handle_t src_cs_handle,
   if( src_cs == dst_cs )
     return DBR_SUCCESS;
 
-  BIGLOCK_LOCK( src_cs->_reverse );
-
+  // the chunks of striped values have to go along
+  if( dbrStripe_enabled( src_cs ) )
+    return dbrStripe_move( src_cs, src_group, tuple_name, match_template, dst_cs, dest_group );
 
   // src_cs->_reverse == dst_cs->_reverse
   DBR_Tag_t tag = dbrTag_get( src_cs->_reverse ); // reverse points always to the same dbrMain_context
   if( tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( src_cs->_reverse, DBR_ERR_TAGERROR );
+    return DBR_ERR_TAGERROR;
 
   dbrRequestContext_t *rctx = dbrCreate_request_ctx( DBBE_OPCODE_MOVE,
                                                     src_cs_handle,
@@ -101,6 +169,7 @@ DBR_Errorcode_t libdbrMove ( DBR_Handle_t src_cs_handle,
 
 error:
   dbrRemove_request( src_cs, rctx );
+  dbrTag_release( src_cs->_reverse, tag ); // in case the request never made it into the table
 
-  BIGLOCK_UNLOCKRETURN( src_cs->_reverse, rc );
+  return rc;
 }
@@ -18,13 +18,15 @@
 #include "util/lock_tools.h"
 #include "libdatabroker.h"
 #include "libdatabroker_int.h"
+#include "lib/stripe.h"
 
 #include <stdio.h>
 
 DBR_Errorcode_t
-libdbrPut( DBR_Handle_t cs_handle,
-           dbrDA_Request_chain_t *request,
-           DBR_Group_t group )
+dbrPut_chain_ext( dbrName_space_t *cs_handle,
+                  dbrDA_Request_chain_t *request,
+                  DBR_Group_t group,
+                  int flags )
 {
   if( cs_handle == NULL )
     return DBR_ERR_INVALID;
@@ -33,11 +35,9 @@ libdbrPut( DBR_Handle_t cs_handle,
   if(( cs->_be_ctx == NULL ) || (cs->_reverse == NULL ) || (cs->_status != dbrNS_STATUS_REFERENCED ))
     return DBR_ERR_NSINVAL;
 
-  BIGLOCK_LOCK( cs->_reverse );
-
   DBR_Tag_t tag = dbrTag_get( cs->_reverse );
   if( tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_TAGERROR );
+    return DBR_ERR_TAGERROR;
 
   dbrDA_Request_chain_t *chain = request;
 
@@ -47,7 +47,10 @@ libdbrPut( DBR_Handle_t cs_handle,
   {
     chain = cs->_reverse->_data_adapter->pre_write( request );
     if( chain == NULL )
-      BIGLOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_PLUGIN );
+    {
+      dbrTag_release( cs->_reverse, tag );
+      return DBR_ERR_PLUGIN;
+    }
   }
 #endif
 
@@ -60,7 +63,7 @@ libdbrPut( DBR_Handle_t cs_handle,
                                DBR_GROUP_EMPTY,
                                chain,
                                NULL,
-                               0,
+                               flags,
                                tag );
   if( head == NULL )
     goto error;
@@ -99,13 +102,35 @@ libdbrPut( DBR_Handle_t cs_handle,
   }
 
   dbrRemove_request( cs, head );
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, rc );
+  return rc;
 
 error:
   dbrRemove_request( cs, head );
+  dbrTag_release( cs->_reverse, tag ); // in case the request never made it into the table
 #ifdef DBR_DATA_ADAPTERS
   if( cs->_reverse->_data_adapter != NULL )
     rc = cs->_reverse->_data_adapter->error_handler( chain, DBRDA_WRITE, rc );
 #endif
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, rc );
+  return rc;
+}
+
+DBR_Errorcode_t
+dbrPut_chain( dbrName_space_t *cs,
+              dbrDA_Request_chain_t *request,
+              DBR_Group_t group )
+{
+  return dbrPut_chain_ext( cs, request, group, DBBE_OPCODE_FLAGS_NONE );
+}
+
+DBR_Errorcode_t
+libdbrPut( DBR_Handle_t cs_handle,
+           dbrDA_Request_chain_t *request,
+           DBR_Group_t group )
+{
+  dbrName_space_t *cs = (dbrName_space_t*)cs_handle;
+  if(( cs != NULL ) && ( cs->_reverse != NULL ) && ( cs->_status == dbrNS_STATUS_REFERENCED ) &&
+     dbrStripe_put_eligible( cs, request ))
+    return dbrStripe_put( cs, request, group );
+
+  return dbrPut_chain( cs, request, group );
 }
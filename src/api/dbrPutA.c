@@ -24,7 +24,9 @@
 
 DBR_Tag_t libdbrPutA (DBR_Handle_t cs_handle,
                       dbrDA_Request_chain_t *request,
-                      DBR_Group_t group)
+                      DBR_Group_t group,
+                      DBR_Completion_cb_t callback,
+                      void *cb_context )
 {
   dbrName_space_t *cs = (dbrName_space_t*)cs_handle;
   if(( cs == NULL ) || ( cs->_be_ctx == NULL ) || ( cs->_reverse == NULL ) || (cs->_status != dbrNS_STATUS_REFERENCED ))
@@ -35,11 +37,9 @@ DBR_Tag_t libdbrPutA (DBR_Handle_t cs_handle,
 
   dbrDA_Request_chain_t *chain = request;
 
-  BIGLOCK_LOCK( cs->_reverse );
-
   DBR_Tag_t tag = dbrTag_get( cs->_reverse );
   if( tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( cs->_reverse, DB_TAG_ERROR );
+    return DB_TAG_ERROR;
 
 #ifdef DBR_DATA_ADAPTERS
   // write-path data pre-processing plugin
@@ -47,7 +47,10 @@ DBR_Tag_t libdbrPutA (DBR_Handle_t cs_handle,
   {
     chain = cs->_reverse->_data_adapter->pre_write( request );
     if( chain == NULL )
-      BIGLOCK_UNLOCKRETURN( cs->_reverse, DB_TAG_ERROR );
+    {
+      dbrTag_release( cs->_reverse, tag );
+      return DB_TAG_ERROR;
+    }
   }
 #endif
 
@@ -62,7 +65,10 @@ DBR_Tag_t libdbrPutA (DBR_Handle_t cs_handle,
                                0,
                                tag );
   if( head == NULL )
+  {
+    dbrTag_release( cs->_reverse, tag );
     return DB_TAG_ERROR;
+  }
 
   head->_rchain = chain; // potentially modified chain after plugin
   head->_ochain = request; // actual request chain from user
@@ -73,18 +79,25 @@ DBR_Tag_t libdbrPutA (DBR_Handle_t cs_handle,
     goto error;
   }
 
+  if(( callback != NULL ) && ( dbrCallback_register( head, callback, cb_context ) != DBR_SUCCESS ))
+    goto error;
+
   DBR_Request_handle_t put_handle = dbrPost_request_ext( head, 0 );
   if( put_handle == NULL )
     goto error;
 
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, head->_tag );
+  // with a callback, the request may be gone as soon as it's armed
+  dbrCallback_arm( head );
+  return tag;
 
 error:
+  dbrCallback_release( head );
   dbrRemove_request( cs, head );
+  dbrTag_release( cs->_reverse, tag ); // in case the request never made it into the table
 #ifdef DBR_DATA_ADAPTERS
   if( cs->_reverse->_data_adapter != NULL )
     cs->_reverse->_data_adapter->error_handler( chain, DBRDA_WRITE, DBR_ERR_TAGERROR );
 #endif
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, DB_TAG_ERROR );
+  return DB_TAG_ERROR;
 }
 
@@ -39,11 +39,9 @@ libdbrQuery (DBR_Handle_t cs_handle,
   if(( cs == NULL ) || ( cs->_be_ctx == NULL ) || ( cs->_reverse == NULL ) || (cs->_status != dbrNS_STATUS_REFERENCED ))
     return DBR_ERR_NSINVAL;
 
-  BIGLOCK_LOCK( cs->_reverse );
-
   DBR_Tag_t tag = dbrTag_get( cs->_reverse );
   if( tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_TAGERROR );
+    return DBR_ERR_TAGERROR;
 
   // check the redis main space for db_name
   dbr_Name_meta_t meta;
@@ -97,13 +95,14 @@ libdbrQuery (DBR_Handle_t cs_handle,
   if( rctx->_cpl._rc == 0 )
   {
     printf("db_name doesn't exist: %s\n", cs->_db_name );
-    BIGLOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_NSINVAL );
+    rc = DBR_ERR_NSINVAL;
   }
   else
     LOG( DBG_INFO, stdout, "found db_name: %s\n", meta.id );
 
 error:
   dbrRemove_request( cs, rctx );
+  dbrTag_release( cs->_reverse, tag ); // in case the request never made it into the table
 
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, rc );
+  return rc;
 }
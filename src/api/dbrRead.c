@@ -18,53 +18,19 @@
 #include "util/lock_tools.h"
 #include "libdatabroker.h"
 #include "libdatabroker_int.h"
+#include "lib/stripe.h"
 #include "libdbrAPI.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 
 DBR_Errorcode_t
-libdbrTestKey( DBR_Handle_t cs_handle,
-               DBR_Tuple_name_t tuple_name,
+dbrRead_chain( dbrName_space_t *cs_handle,
+               dbrDA_Request_chain_t *request,
+               int64_t *ret_size,
                DBR_Tuple_template_t match_template,
-               DBR_Group_t group )
-{
-  if( cs_handle == NULL )
-    return DBR_ERR_INVALID;
-
-  dbrName_space_t *cs = (dbrName_space_t*)cs_handle;
-  if(( cs->_be_ctx == NULL ) || ( cs->_reverse == NULL ) || (cs->_status != dbrNS_STATUS_REFERENCED ))
-    return DBR_ERR_NSINVAL;
-
-  int64_t retsize;
-
-  dbrDA_Request_chain_t *req = (dbrDA_Request_chain_t*)calloc( 1, sizeof( dbrDA_Request_chain_t ) + sizeof( dbBE_sge_t ) );;
-  req->_key = tuple_name;
-  req->_sge_count = 1;
-  req->_value_sge[0].iov_base = cs->_reverse->_tmp_testkey_buf;
-  req->_value_sge[0].iov_len = DBR_TMP_BUFFER_LEN;
-
-  DBR_Errorcode_t rc;
-  rc = libdbrRead( cs_handle,
-                   req,
-                   &retsize,
-                   match_template,
-                   group,
-                   DBBE_OPCODE_FLAGS_IMMEDIATE );
-  free( req );
-  return rc;
-}
-
-
-
-
-DBR_Errorcode_t
-libdbrRead(DBR_Handle_t cs_handle,
-           dbrDA_Request_chain_t *request,
-           int64_t *ret_size,
-           DBR_Tuple_template_t match_template,
-           DBR_Group_t group,
-           int flags)
+               DBR_Group_t group,
+               int flags)
 {
   if(( cs_handle == NULL ) || ( request == NULL ))
     return DBR_ERR_INVALID;
@@ -75,13 +41,11 @@ libdbrRead(DBR_Handle_t cs_handle,
 
   dbrDA_Request_chain_t *chain = request;
 
-  BIGLOCK_LOCK( cs->_reverse );
-
   int enable_timeout = ((flags & DBR_FLAGS_NOWAIT ) == 0 );
 
   DBR_Tag_t tag = dbrTag_get( cs->_reverse );
   if( tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_TAGERROR );
+    return DBR_ERR_TAGERROR;
 
 #ifdef DBR_DATA_ADAPTERS
   // read-path request pre-processing plugin
@@ -89,7 +53,10 @@ libdbrRead(DBR_Handle_t cs_handle,
   {
     chain = cs->_reverse->_data_adapter->pre_read( request );
     if( chain == NULL )
-      BIGLOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_PLUGIN );
+    {
+      dbrTag_release( cs->_reverse, tag );
+      return DBR_ERR_PLUGIN;
+    }
   }
 #endif
 
@@ -158,14 +125,31 @@ libdbrRead(DBR_Handle_t cs_handle,
   }
 
   dbrRemove_request( cs, head );
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, rc );
+  return rc;
 
 error:
   dbrRemove_request( cs, head );
+  dbrTag_release( cs->_reverse, tag ); // in case the request never made it into the table
 #ifdef DBR_DATA_ADAPTERS
   if( cs->_reverse->_data_adapter != NULL )
     rc = cs->_reverse->_data_adapter->error_handler( chain, DBRDA_READ, rc );
 #endif
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, rc );
+  return rc;
 }
 
+DBR_Errorcode_t
+libdbrRead( DBR_Handle_t cs_handle,
+            dbrDA_Request_chain_t *request,
+            int64_t *ret_size,
+            DBR_Tuple_template_t match_template,
+            DBR_Group_t group,
+            int flags )
+{
+  dbrName_space_t *cs = (dbrName_space_t*)cs_handle;
+  DBR_Errorcode_t rc = dbrRead_chain( cs, request, ret_size, match_template, group, flags );
+
+  // a striped value comes back as its manifest
+  if(( rc == DBR_SUCCESS ) && dbrStripe_get_candidate( cs, request ))
+    rc = dbrStripe_resolve( cs, DBBE_OPCODE_READ, request, group, flags );
+  return rc;
+}
@@ -28,7 +28,9 @@ DBR_Tag_t libdbrReadA(DBR_Handle_t cs_handle,
                       DBR_Tuple_template_t match_template,
                       DBR_Group_t group,
                       int flags,
-                      int64_t *ret_size )
+                      int64_t *ret_size,
+                      DBR_Completion_cb_t callback,
+                      void *cb_context )
 {
   dbrName_space_t *cs = (dbrName_space_t*)cs_handle;
   if(( cs == NULL ) || ( cs->_be_ctx == NULL ) || ( cs->_reverse == NULL ) || (cs->_status != dbrNS_STATUS_REFERENCED ))
@@ -36,11 +38,9 @@ DBR_Tag_t libdbrReadA(DBR_Handle_t cs_handle,
 
   dbrDA_Request_chain_t *chain = request;
 
-  BIGLOCK_LOCK( cs->_reverse );
-
   DBR_Tag_t tag = dbrTag_get( cs->_reverse );
   if( tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( cs->_reverse, DB_TAG_ERROR );
+    return DB_TAG_ERROR;
 
 #ifdef DBR_DATA_ADAPTERS
   // read-path request pre-processing plugin
@@ -48,7 +48,10 @@ DBR_Tag_t libdbrReadA(DBR_Handle_t cs_handle,
   {
     chain = cs->_reverse->_data_adapter->pre_read( request );
     if( chain == NULL )
-      BIGLOCK_UNLOCKRETURN( cs->_reverse, DB_TAG_ERROR );
+    {
+      dbrTag_release( cs->_reverse, tag );
+      return DB_TAG_ERROR;
+    }
   }
 #endif
 
@@ -63,7 +66,10 @@ DBR_Tag_t libdbrReadA(DBR_Handle_t cs_handle,
                                flags,
                                tag );
   if( head == NULL )
+  {
+    dbrTag_release( cs->_reverse, tag );
     return DB_TAG_ERROR;
+  }
 
   head->_rchain = chain;
   head->_ochain = request;
@@ -71,14 +77,21 @@ DBR_Tag_t libdbrReadA(DBR_Handle_t cs_handle,
   if( rtag == DB_TAG_ERROR )
     goto error;
 
+  if(( callback != NULL ) && ( dbrCallback_register( head, callback, cb_context ) != DBR_SUCCESS ))
+    goto error;
+
   DBR_Request_handle_t read_handle = dbrPost_request_ext( head, 0 );
   if( read_handle == NULL )
     goto error;
 
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, head->_tag );
+  // with a callback, the request may be gone as soon as it's armed
+  dbrCallback_arm( head );
+  return tag;
 
 error:
+  dbrCallback_release( head );
   dbrRemove_request( cs, head );
+  dbrTag_release( cs->_reverse, tag ); // in case the request never made it into the table
   if(ret_size)
     *ret_size = 0;
 
@@ -86,5 +99,5 @@ error:
   if( cs->_reverse->_data_adapter != NULL )
     cs->_reverse->_data_adapter->error_handler( chain, DBRDA_READ, DBR_ERR_TAGERROR );
 #endif
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, DB_TAG_ERROR );
+  return DB_TAG_ERROR;
 }
@@ -17,9 +17,75 @@
 #include "util/lock_tools.h"
 #include "libdatabroker.h"
 #include "libdatabroker_int.h"
+#include "lib/stripe.h"
 
 #include <stdio.h>
 
+DBR_Errorcode_t
+dbrRemove_chain( dbrName_space_t *cs,
+                 dbrDA_Request_chain_t *request,
+                 DBR_Tuple_template_t match_template,
+                 DBR_Group_t group )
+{
+  if(( cs == NULL ) || ( request == NULL ))
+    return DBR_ERR_INVALID;
+
+  if(( cs->_be_ctx == NULL ) || ( cs->_reverse == NULL ) || (cs->_status != dbrNS_STATUS_REFERENCED ))
+    return DBR_ERR_NSINVAL;
+
+  DBR_Tag_t tag = dbrTag_get( cs->_reverse );
+  if( tag == DB_TAG_ERROR )
+    return DBR_ERR_TAGERROR;
+
+  DBR_Errorcode_t rc = DBR_SUCCESS;
+  dbrRequestContext_t *head =
+      dbrCreate_request_chain( DBBE_OPCODE_REMOVE,
+                               cs,
+                               group,
+                               NULL,
+                               DBR_GROUP_EMPTY,
+                               request,
+                               match_template,
+                               0,
+                               tag );
+  if( head == NULL )
+  {
+    rc = DBR_ERR_NOMEMORY;
+    goto error;
+  }
+
+  if( dbrInsert_request( cs, head ) == DB_TAG_ERROR )
+  {
+    rc = DBR_ERR_TAGERROR;
+    goto error;
+  }
+
+  DBR_Request_handle_t req_handle = dbrPost_request( head );
+  if( req_handle == NULL )
+  {
+    rc = DBR_ERR_BE_POST;
+    goto error;
+  }
+
+  rc = dbrWait_request( cs, req_handle, 0 );
+  switch( rc ) {
+  case DBR_SUCCESS:
+    rc = dbrCheck_response( head );
+    break;
+  case DBR_ERR_INPROGRESS:
+    rc = DBR_ERR_TIMEOUT;
+    break;
+  default:
+    goto error;
+  }
+
+error:
+  dbrRemove_request( cs, head );
+  dbrTag_release( cs->_reverse, tag ); // in case the request never made it into the table
+
+  return rc;
+}
+
 DBR_Errorcode_t
 libdbrRemove( DBR_Handle_t cs_handle,
               DBR_Group_t group,
@@ -33,11 +99,13 @@ libdbrRemove( DBR_Handle_t cs_handle,
   if(( cs->_be_ctx == NULL ) || ( cs->_reverse == NULL ) || (cs->_status != dbrNS_STATUS_REFERENCED ))
     return DBR_ERR_NSINVAL;
 
-  BIGLOCK_LOCK( cs->_reverse );
+  // striped values leave their chunks behind otherwise
+  if( dbrStripe_enabled( cs ) )
+    return dbrStripe_remove( cs, group, tuple_name, match_template );
 
   DBR_Tag_t tag = dbrTag_get( cs->_reverse );
   if( tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_TAGERROR );
+    return DBR_ERR_TAGERROR;
 
   DBR_Errorcode_t rc = DBR_SUCCESS;
   dbrRequestContext_t *ctx = dbrCreate_request_ctx( DBBE_OPCODE_REMOVE,
@@ -84,7 +152,26 @@ libdbrRemove( DBR_Handle_t cs_handle,
 
 error:
   dbrRemove_request( cs, ctx );
+  dbrTag_release( cs->_reverse, tag ); // in case the request never made it into the table
 
-  BIGLOCK_UNLOCKRETURN( cs->_reverse, rc );
+  return rc;
 }
 
+DBR_Errorcode_t
+libdbrRemoveOrphans( DBR_Handle_t cs_handle,
+                     DBR_Group_t group,
+                     DBR_Tuple_name_t tuple_name )
+{
+  if(( cs_handle == NULL ) || ( tuple_name == NULL ))
+    return DBR_ERR_INVALID;
+
+  dbrName_space_t *cs = (dbrName_space_t*)cs_handle;
+  if(( cs->_be_ctx == NULL ) || ( cs->_reverse == NULL ) || (cs->_status != dbrNS_STATUS_REFERENCED ))
+    return DBR_ERR_NSINVAL;
+
+  // without striping there are no chunks to leave behind
+  if( ! dbrStripe_enabled( cs ) )
+    return DBR_SUCCESS;
+
+  return dbrStripe_remove_orphans( cs, group, tuple_name );
+}
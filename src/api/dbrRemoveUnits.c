@@ -77,5 +77,6 @@ DBR_Errorcode_t libdbrRemoveUnits( DBR_Handle_t cs_handle,
 
 error:
   dbrRemove_request( cs, pctx );
+  dbrTag_release( cs->_reverse, tag ); // in case the request never made it into the table
   return rc;
 }
@@ -18,6 +18,7 @@
 #include "util/lock_tools.h"
 #include "libdatabroker.h"
 #include "libdatabroker_int.h"
+#include "lib/stripe.h"
 
 #include <stddef.h>
 #include <string.h>
@@ -46,47 +47,94 @@ DBR_Errorcode_t csPostProcessRequest( dbrRequestContext_t *rctx )
   return rc_out;
 }
 
+/*
+ * final step of a completed request chain:
+ * data adapter post-processing, cleanup of the user chain and release of the tag
+ */
+static
+DBR_Errorcode_t dbrFinalize_request( dbrRequestContext_t *rctx, DBR_Errorcode_t rc )
+{
+#ifdef DBR_DATA_ADAPTERS
+  dbrName_space_t* cs = rctx->_ctx;
+  // data post-processing plugins
+  if( cs->_reverse->_data_adapter != NULL )
+  {
+    if( rctx->_ochain == NULL )
+    {
+      LOG( DBG_ERR, stderr, "BUG: User request in context is NULL. Chained request check issue?\n" );
+      dbrRemove_request( rctx->_ctx, rctx );
+      return DBR_ERR_HANDLE;
+    }
+    dbrDA_Request_chain_t *rchain = rctx->_rchain;
+    switch( rctx->_req._opcode )
+    {
+      case DBBE_OPCODE_PUT:
+        rc = cs->_reverse->_data_adapter->post_write( rchain, rc );
+        break;
+      case DBBE_OPCODE_READ:
+      case DBBE_OPCODE_GET:
+      {
+        rc = cs->_reverse->_data_adapter->post_read( rchain, rctx->_ochain, rc );
+        *rctx->_ochain->_ret_size = rctx->_ochain->_size;
+        break;
+      }
+      default:
+        LOG( DBG_ERR, stderr, "dbrTest() of an unsupported operation\n" );
+        rc = DBR_ERR_INVALIDOP;
+        break;
+    }
+  }
+
+#endif
+  // a striped value comes back as its manifest
+  if((( rctx->_req._opcode == DBBE_OPCODE_GET ) || ( rctx->_req._opcode == DBBE_OPCODE_READ )) &&
+     ( rc == DBR_SUCCESS ) && dbrStripe_get_candidate( rctx->_ctx, rctx->_ochain ))
+    rc = dbrStripe_resolve( rctx->_ctx, rctx->_req._opcode, rctx->_ochain, rctx->_req._group, rctx->_req._flags );
+
+  // clean up the user's request chain
+  dbrDA_Request_chain_t *ochain = rctx->_ochain;
+  while( ochain != NULL )
+  {
+    dbrDA_Request_chain_t *next = ochain->_next;
+    dbrRequest_chain_release( rctx->_ctx->_reverse, ochain );
+    ochain = next;
+  }
+
+  dbrRemove_request( rctx->_ctx, rctx );
+
+  return rc;
+}
+
 DBR_Errorcode_t
 libdbrTest( DBR_Tag_t req_tag)
 {
-#ifdef DBR_INTTAG
-
-  if(( req_tag < 0 ) || ( req_tag >= dbrMAX_TAGS ))
+  if( dbrValidateTag( NULL, req_tag ) != DBR_SUCCESS )
     return DBR_ERR_TAGERROR;
 
   dbrMain_context_t *main_ctx = dbrCheckCreateMainCTX();
   if( main_ctx == NULL )
     return DBR_ERR_INVALID;
 
-  BIGLOCK_LOCK( main_ctx );
-
-  dbrRequestContext_t *rctx = main_ctx->_cs_wq[ req_tag ];
+  TAGLOCK_LOCK( main_ctx );
+  dbrRequestContext_t *rctx = dbrTag_lookup( main_ctx, req_tag );
+  TAGLOCK_UNLOCK( main_ctx );
   if( rctx == NULL )
   {
     LOG( DBG_WARN, stderr, "Request entry for tag %"PRId64" is deleted\n", req_tag );
-    BIGLOCK_UNLOCKRETURN( main_ctx, DBR_ERR_TAGERROR );
+    return DBR_ERR_TAGERROR;
   }
 
-#else
-#error "Currently not supported because of lack of access to main context and locking"
-  if( req_tag == NULL
-      || req_tag == DB_TAG_ERROR )
-    BIGLOCK_UNLOCKRETURN( main_ctx, DBR_ERR_TAGERROR );
-
-  dbrRequestContext_t *rctx = *(dbrRequestContext_t**)req_tag;
-  if( rctx == NULL )
-    BIGLOCK_UNLOCKRETURN( main_ctx, DBR_ERR_TAGERROR );
-
-#endif
-
-
   DBR_Errorcode_t rc = dbrValidateTag( rctx, req_tag );
   if( rc != DBR_SUCCESS )
-    BIGLOCK_UNLOCKRETURN( main_ctx, rc );
+    return rc;
+
+  // completion is reported via callback and the request is owned by the library
+  if( rctx->_callback != NULL )
+    return DBR_ERR_INVALIDOP;
 
   dbrName_space_t* cs = rctx->_ctx;
   if( cs->_be_ctx == NULL )
-    BIGLOCK_UNLOCKRETURN( main_ctx, DBR_ERR_NSINVAL );
+    return DBR_ERR_NSINVAL;
 
   dbrRequestContext_t *chain = rctx;
 
@@ -113,7 +161,7 @@ libdbrTest( DBR_Tag_t req_tag)
         // but let outside know that it is pending!
 
         // todo: for now keeping this case separate despite being empty
-        BIGLOCK_UNLOCKRETURN( main_ctx, DBR_ERR_INPROGRESS );
+        return DBR_ERR_INPROGRESS;
 
       default:
         break;
@@ -122,48 +170,209 @@ libdbrTest( DBR_Tag_t req_tag)
     chain = chain->_next;
   }
 
+  // another thread may be finalizing the same tag
+  TAGLOCK_LOCK( main_ctx );
+  int claimed = ( dbrTag_claim( main_ctx, req_tag ) == rctx );
+  TAGLOCK_UNLOCK( main_ctx );
+  if( ! claimed )
+    return DBR_ERR_TAGERROR;
 
-#ifdef DBR_DATA_ADAPTERS
-  // data post-processing plugins
-  if( cs->_reverse->_data_adapter != NULL )
+  return dbrFinalize_request( rctx, rc );
+}
+
+/*
+ * collect the results of a request chain that is known to be complete
+ * same as the loop in libdbrTest() without driving the back-end
+ */
+DBR_Errorcode_t dbrCollect_request( dbrRequestContext_t *rctx )
+{
+  DBR_Errorcode_t rc = DBR_SUCCESS;
+  dbrRequestContext_t *chain;
+  for( chain = rctx; chain != NULL; chain = chain->_next )
   {
-    if( rctx->_ochain == NULL )
+    if( chain->_status == dbrSTATUS_CLOSED )
+      continue;
+    rc = chain->_cpl._status;
+    if( rc == DBR_SUCCESS )
+      rc = csPostProcessRequest( chain );
+  }
+  return dbrFinalize_request( rctx, rc );
+}
+
+/*
+ * check a list of tags with a single pass over the back-end completions
+ * all available completions are processed first, then every listed request
+ * that is complete gets finalized and its tag is replaced by DB_TAG_ERROR.
+ * Entries that are DB_TAG_ERROR already are skipped.
+ * returns the number of tags that completed in this pass and
+ * sets *active to the number of tags that were still listed
+ */
+static
+int dbrTest_tag_list( dbrMain_context_t *ctx,
+                      DBR_Tag_t *tags,
+                      const int count,
+                      DBR_Errorcode_t *results,
+                      int *active )
+{
+  int n;
+  int completed = 0;
+  *active = 0;
+
+  // one acquisition of the locks to drain the back-end and find the complete requests
+  TAGLOCK_LOCK( ctx );
+  BELOCK_LOCK( ctx );
+  dbrDrain_completions( ctx );
+  for( n = 0; n < count; ++n )
+  {
+    if( tags[ n ] == DB_TAG_ERROR )
+      continue;
+    ++(*active);
+    dbrRequestContext_t *chain = dbrTag_lookup( ctx, tags[ n ] );
+    if( chain == NULL )
     {
-      LOG( DBG_ERR, stderr, "BUG: User request in context is NULL. Chained request check issue?\n" );
-      dbrRemove_request( rctx->_ctx, rctx );
-      BIGLOCK_UNLOCKRETURN( main_ctx, DBR_ERR_HANDLE );
+      results[ n ] = DBR_ERR_TAGERROR;
+      continue;
     }
-    dbrDA_Request_chain_t *rchain = rctx->_rchain;
-    switch( rctx->_req._opcode )
+    if( chain->_callback != NULL )
     {
-      case DBBE_OPCODE_PUT:
-        rc = cs->_reverse->_data_adapter->post_write( rchain, rc );
-        break;
-      case DBBE_OPCODE_READ:
-      case DBBE_OPCODE_GET:
-      {
-        rc = cs->_reverse->_data_adapter->post_read( rchain, rctx->_ochain, rc );
-        *rctx->_ochain->_ret_size = rctx->_ochain->_size;
-        break;
-      }
-      default:
-        LOG( DBG_ERR, stderr, "dbrTest() of an unsupported operation\n" );
-        rc = DBR_ERR_INVALIDOP;
-        break;
+      results[ n ] = DBR_ERR_INVALIDOP;
+      continue;
     }
+
+    while(( chain != NULL ) &&
+          (( chain->_status == dbrSTATUS_READY ) || ( chain->_status == dbrSTATUS_CLOSED )))
+      chain = chain->_next;
+    // complete chains are marked with success for now, the actual status is collected below
+    results[ n ] = ( chain == NULL ) ? DBR_SUCCESS : DBR_ERR_INPROGRESS;
   }
+  BELOCK_UNLOCK( ctx );
+  TAGLOCK_UNLOCK( ctx );
+  dbrCallback_dispatch( ctx );
 
-#endif
-  // clean up the user's request chain
-  dbrDA_Request_chain_t *ochain = rctx->_ochain;
-  while( ochain != NULL )
+  for( n = 0; n < count; ++n )
   {
-    dbrDA_Request_chain_t *next = ochain->_next;
-    free( ochain );
-    ochain = next;
+    if(( tags[ n ] == DB_TAG_ERROR ) || ( results[ n ] == DBR_ERR_INPROGRESS ))
+      continue;
+    if( results[ n ] == DBR_SUCCESS )
+    {
+      // another thread may have tested or cancelled the tag since the locks were dropped
+      // or may be collecting it as well: only the one that claims it gets to finalize
+      TAGLOCK_LOCK( ctx );
+      dbrRequestContext_t *rctx = dbrTag_claim( ctx, tags[ n ] );
+      TAGLOCK_UNLOCK( ctx );
+      results[ n ] = ( rctx != NULL ) ? dbrCollect_request( rctx ) : DBR_ERR_TAGERROR;
+    }
+    tags[ n ] = DB_TAG_ERROR;
+    ++completed;
   }
+  return completed;
+}
 
-  dbrRemove_request( rctx->_ctx, rctx );
+/*
+ * drive the back-end until at least one (all == 0) or all listed requests are complete
+ */
+static
+DBR_Errorcode_t dbrWait_tag_list( DBR_Tag_t *tags,
+                                  const int count,
+                                  DBR_Errorcode_t *results,
+                                  int *completed,
+                                  const int all )
+{
+  if(( tags == NULL ) || ( results == NULL ) || ( count <= 0 ))
+    return DBR_ERR_INVALID;
+
+  dbrMain_context_t *main_ctx = dbrCheckCreateMainCTX();
+  if( main_ctx == NULL )
+    return DBR_ERR_INVALID;
+
+  dbrWait_state_t ws;
+  dbrWait_init( &ws, main_ctx, 1 );
+
+  int done = 0;
+  int active = 0;
+  int pending = 0;
+  DBR_Errorcode_t rc = DBR_SUCCESS;
+  while( 1 )
+  {
+    int newly = dbrTest_tag_list( main_ctx, tags, count, results, &active );
+    done += newly;
+    pending = active - newly;
+
+    if(( active == 0 ) && ( done == 0 ) && ( ! all ))
+    {
+      rc = DBR_ERR_TAGERROR; // nothing to wait for
+      break;
+    }
+    if(( pending == 0 ) || (( done > 0 ) && ( ! all )))
+      break;
+
+    if( newly > 0 )
+      dbrWait_reset( &ws ); // progress was made, go back to polling
+    else if( dbrWait_idle( &ws, NULL ) )
+    {
+      rc = DBR_ERR_TIMEOUT;
+      break;
+    }
+  }
+
+  if( completed != NULL )
+    *completed = done;
+  return rc;
+}
+
+DBR_Errorcode_t
+libdbrTestSome( DBR_Tag_t *tags,
+                const int count,
+                DBR_Errorcode_t *results,
+                int *completed )
+{
+  if(( tags == NULL ) || ( results == NULL ) || ( count <= 0 ))
+    return DBR_ERR_INVALID;
+
+  dbrMain_context_t *main_ctx = dbrCheckCreateMainCTX();
+  if( main_ctx == NULL )
+    return DBR_ERR_INVALID;
+
+  int active = 0;
+  int done = dbrTest_tag_list( main_ctx, tags, count, results, &active );
+  if( completed != NULL )
+    *completed = done;
+
+  if( active == 0 )
+    return DBR_ERR_TAGERROR;
+  return ( done > 0 ) ? DBR_SUCCESS : DBR_ERR_INPROGRESS;
+}
+
+DBR_Errorcode_t
+libdbrWaitAny( DBR_Tag_t *tags,
+               const int count,
+               DBR_Errorcode_t *results,
+               int *completed )
+{
+  return dbrWait_tag_list( tags, count, results, completed, 0 );
+}
+
+DBR_Errorcode_t
+libdbrWaitAll( DBR_Tag_t *tags,
+               const int count,
+               DBR_Errorcode_t *results )
+{
+  return dbrWait_tag_list( tags, count, results, NULL, 1 );
+}
+
+DBR_Errorcode_t
+libdbrProgress( int *completed )
+{
+  dbrMain_context_t *main_ctx = dbrCheckCreateMainCTX();
+  if( main_ctx == NULL )
+    return DBR_ERR_INVALID;
+
+  BELOCK_LOCK( main_ctx );
+  dbrDrain_completions( main_ctx );
+  BELOCK_UNLOCK( main_ctx );
 
-  BIGLOCK_UNLOCKRETURN( main_ctx, rc );
+  int count = dbrCallback_dispatch( main_ctx );
+  if( completed != NULL )
+    *completed = count;
+  return DBR_SUCCESS;
 }
@@ -20,6 +20,9 @@
 
 #include "common/dbbe_api.h"
 
+#include <stdlib.h>
+#include <errno.h>
+
 typedef struct dbrBackend
 {
   void *_library;               ///< library handle to the backend lib
@@ -31,4 +34,29 @@ typedef struct dbrBackend
 dbrBackend_t* dbrlib_backend_get_handle(void);
 int dbrlib_backend_delete( dbrBackend_t* be );
 
+/*
+ * hand a processed completion back to the backend for reuse
+ * (or free it if the backend doesn't recycle completions)
+ */
+static inline
+void dbrlib_backend_release( dbrBackend_t *be, dbBE_Completion_t *compl )
+{
+  if(( be != NULL ) && ( be->_api != NULL ) && ( be->_api->release != NULL ))
+    be->_api->release( be->_context, compl );
+  else
+    free( compl );
+}
+
+/*
+ * fd to block on until the backend may have new completions
+ * (-EAGAIN: drive the backend again, -ENOTSUP: not available)
+ */
+static inline
+int dbrlib_backend_event_fd( dbrBackend_t *be )
+{
+  if(( be == NULL ) || ( be->_api == NULL ) || ( be->_api->event_fd == NULL ))
+    return -ENOTSUP;
+  return be->_api->event_fd( be->_context );
+}
+
 #endif /* SRC_LIB_BACKEND_H_ */
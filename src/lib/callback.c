@@ -0,0 +1,209 @@
+/*
+ * Copyright © 2018-2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "logutil.h"
+#include "libdatabroker_int.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <pthread.h>
+
+/*
+ * Requests with a completion callback are not owned by a user thread.
+ * Whichever thread processes the last completion of the chain (under the backend lock)
+ * appends it to the ready list. The callbacks are then invoked outside of any lock
+ * by the next call to dbrCallback_dispatch() so that callbacks are free to post new requests.
+ *
+ * If the progress is driven by the caller, dispatching happens inside any
+ * call that drives the back-end (dbrTest*, dbrWait*, dbrProgress and blocking calls).
+ * If the back-end has its own progress thread, a dispatcher thread is started
+ * with the first callback request to pick up the completions.
+ */
+
+static
+void* dbrCallback_dispatcher( void *arg )
+{
+  dbrMain_context_t *ctx = (dbrMain_context_t*)arg;
+  dbrWait_state_t ws;
+  dbrWait_init( &ws, ctx, 0 );
+  ws._adaptive = 1; // never spin a full core while the back-end thread is busy
+
+  pthread_mutex_lock( &ctx->_cb_lock );
+  while( ctx->_cb_running )
+  {
+    if( ctx->_cb_outstanding == 0 )
+    {
+      pthread_cond_wait( &ctx->_cb_cond, &ctx->_cb_lock );
+      dbrWait_reset( &ws );
+      continue;
+    }
+    pthread_mutex_unlock( &ctx->_cb_lock );
+
+    BELOCK_LOCK( ctx );
+    int completed = dbrDrain_completions( ctx );
+    BELOCK_UNLOCK( ctx );
+    completed += dbrCallback_dispatch( ctx );
+
+    if( completed > 0 )
+      dbrWait_reset( &ws );
+    else
+      dbrWait_idle( &ws, NULL );
+
+    pthread_mutex_lock( &ctx->_cb_lock );
+  }
+  pthread_mutex_unlock( &ctx->_cb_lock );
+  return NULL;
+}
+
+DBR_Errorcode_t dbrCallback_register( dbrRequestContext_t *head,
+                                      DBR_Completion_cb_t callback,
+                                      void *context )
+{
+  if(( head == NULL ) || ( callback == NULL ) || ( head->_ctx == NULL ) || ( head->_ctx->_reverse == NULL ))
+    return DBR_ERR_INVALID;
+
+  dbrMain_context_t *ctx = head->_ctx->_reverse;
+  head->_callback = callback;
+  head->_cb_context = context;
+  head->_cb_armed = 0;
+  head->_cb_next = NULL;
+
+  DBR_Errorcode_t rc = DBR_SUCCESS;
+  pthread_mutex_lock( &ctx->_cb_lock );
+  ++ctx->_cb_outstanding;
+  if(( ctx->_config._progress_thread ) && ( ! ctx->_cb_running ))
+  {
+    ctx->_cb_running = 1;
+    if( pthread_create( &ctx->_cb_thread, NULL, dbrCallback_dispatcher, (void*)ctx ) != 0 )
+    {
+      LOG( DBG_ERR, stderr, "Failed to create callback dispatcher thread\n" );
+      ctx->_cb_running = 0;
+      --ctx->_cb_outstanding;
+      head->_callback = NULL;
+      rc = DBR_ERR_GENERIC;
+    }
+  }
+  pthread_cond_signal( &ctx->_cb_cond );
+  pthread_mutex_unlock( &ctx->_cb_lock );
+  return rc;
+}
+
+void dbrCallback_release( dbrRequestContext_t *head )
+{
+  if(( head == NULL ) || ( head->_callback == NULL ))
+    return;
+
+  dbrMain_context_t *ctx = head->_ctx->_reverse;
+  pthread_mutex_lock( &ctx->_cb_lock );
+  --ctx->_cb_outstanding;
+  pthread_mutex_unlock( &ctx->_cb_lock );
+  head->_callback = NULL;
+}
+
+void dbrCallback_arm( dbrRequestContext_t *head )
+{
+  if(( head == NULL ) || ( head->_callback == NULL ))
+    return;
+
+  dbrMain_context_t *ctx = head->_ctx->_reverse;
+  BELOCK_LOCK( ctx );
+  head->_cb_armed = 1;
+  // completions that arrived while posting haven't been queued
+  dbrCallback_queue( head );
+  BELOCK_UNLOCK( ctx );
+}
+
+void dbrCallback_queue( dbrRequestContext_t *rctx )
+{
+  if(( rctx == NULL ) || ( rctx->_head == NULL ))
+    return;
+
+  dbrRequestContext_t *head = rctx->_head;
+  if(( head->_callback == NULL ) || ( ! head->_cb_armed ))
+    return;
+
+  dbrRequestContext_t *chain;
+  for( chain = head; chain != NULL; chain = chain->_next )
+    if(( chain->_status != dbrSTATUS_READY ) && ( chain->_status != dbrSTATUS_CLOSED ))
+      return;
+
+  // prevent double queueing
+  head->_cb_armed = 0;
+
+  dbrMain_context_t *ctx = head->_ctx->_reverse;
+  head->_cb_next = NULL;
+  if( ctx->_cb_ready_tail != NULL )
+    ctx->_cb_ready_tail->_cb_next = head;
+  else
+    ctx->_cb_ready_head = head;
+  ctx->_cb_ready_tail = head;
+}
+
+int dbrCallback_dispatch( dbrMain_context_t *ctx )
+{
+  if( ctx == NULL )
+    return 0;
+
+  // cheap unlocked check first; a stale result only delays the callback until the next call
+  if( ctx->_cb_ready_head == NULL )
+    return 0;
+
+  BELOCK_LOCK( ctx );
+  dbrRequestContext_t *ready = ctx->_cb_ready_head;
+  ctx->_cb_ready_head = NULL;
+  ctx->_cb_ready_tail = NULL;
+  BELOCK_UNLOCK( ctx );
+
+  int count = 0;
+  while( ready != NULL )
+  {
+    dbrRequestContext_t *next = ready->_cb_next;
+    DBR_Completion_cb_t callback = ready->_callback;
+    void *context = ready->_cb_context;
+    DBR_Tag_t tag = ready->_tag;
+
+    // releases the tag and the request
+    DBR_Errorcode_t status = dbrCollect_request( ready );
+    callback( tag, status, context );
+
+    pthread_mutex_lock( &ctx->_cb_lock );
+    --ctx->_cb_outstanding;
+    pthread_mutex_unlock( &ctx->_cb_lock );
+
+    ready = next;
+    ++count;
+  }
+  return count;
+}
+
+int dbrCallback_stop( dbrMain_context_t *ctx )
+{
+  if( ctx == NULL )
+    return -1;
+
+  pthread_mutex_lock( &ctx->_cb_lock );
+  if( ! ctx->_cb_running )
+  {
+    pthread_mutex_unlock( &ctx->_cb_lock );
+    return 0;
+  }
+  ctx->_cb_running = 0;
+  pthread_cond_signal( &ctx->_cb_cond );
+  pthread_mutex_unlock( &ctx->_cb_lock );
+
+  return pthread_join( ctx->_cb_thread, NULL );
+}
@@ -23,7 +23,22 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <sys/time.h>
+#include <time.h>
 #include <errno.h>
+#include <poll.h>
+
+/*
+ * wake up threads that wait for completions to be processed by another thread
+ * caller has to hold the backend lock
+ */
+static inline
+void dbrWait_signal( dbrMain_context_t *ctx )
+{
+  if( ctx->_cpl_waiters > 0 )
+    pthread_cond_broadcast( &ctx->_cpl_cond );
+  if( ctx->_fd_waiting )
+    dbBE_Wakeup_signal( &ctx->_cpl_wakeup );
+}
 
 DBR_Errorcode_t dbrCheck_response( dbrRequestContext_t *rctx )
 {
@@ -93,6 +108,7 @@ DBR_Errorcode_t dbrCheck_response( dbrRequestContext_t *rctx )
         break;
 
       case DBBE_OPCODE_REMOVE:
+      case DBBE_OPCODE_TESTKEY:
         rc = cpl->_status;
         break;
 
@@ -173,6 +189,9 @@ DBR_Errorcode_t dbrProcess_completion( dbrRequestContext_t *rctx,
   }
 
   rctx->_status = dbrSTATUS_READY;
+  // requests with callbacks are picked up by dbrCallback_dispatch()
+  if(( rctx->_head != NULL ) && ( rctx->_head->_callback != NULL ))
+    dbrCallback_queue( rctx );
   return DBR_SUCCESS;
 }
 
@@ -183,7 +202,9 @@ DBR_Errorcode_t dbrCancel_request( dbrName_space_t *cs, dbrRequestContext_t *req
 {
   if(( cs == NULL ) || ( req_rctx == NULL ))
     return DBR_ERR_INVALID;
-  return cs->_be_ctx->_api->cancel( cs->_be_ctx->_context, req_rctx->_be_request_hdl );
+  BELOCK_LOCK( cs->_reverse );
+  int rc = cs->_be_ctx->_api->cancel( cs->_be_ctx->_context, req_rctx->_be_request_hdl );
+  BELOCK_UNLOCKRETURN( cs->_reverse, rc );
 }
 
 /*
@@ -204,6 +225,9 @@ DBR_Errorcode_t dbrTest_request( dbrName_space_t *cs, dbrRequestContext_t *req_r
   DBR_Errorcode_t ret = DBR_ERR_INPROGRESS;
 
   // first, try to drive the backend and see if we can complete anything (else)
+  // any thread may pick up and process the completion of another thread's request,
+  // so the request status is only touched while holding the backend lock
+  BELOCK_LOCK( cs->_reverse );
   dbBE_Completion_t *compl = cs->_be_ctx->_api->test_any( cs->_be_ctx->_context );
   if( compl != NULL )
   {
@@ -211,10 +235,12 @@ DBR_Errorcode_t dbrTest_request( dbrName_space_t *cs, dbrRequestContext_t *req_r
     if( cmpl_rctx == NULL )
     {
       fprintf( stderr, "BUG in interaction with system library. Empty user-ptr in completion.\n" );
-      return DBR_ERR_BE_GENERAL; // if there was no user ptr attached, then we have a serious problem
+      BELOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_BE_GENERAL ); // if there was no user ptr attached, then we have a serious problem
     }
     dbrProcess_completion( cmpl_rctx, compl );
-    free( compl ); // clean up
+    dbrlib_backend_release( cs->_be_ctx, compl ); // clean up
+    // wake up threads that block in dbrWait_request() so they can check their request
+    dbrWait_signal( cs->_reverse );
   }
 
   // then see if we completed this request
@@ -223,10 +249,191 @@ DBR_Errorcode_t dbrTest_request( dbrName_space_t *cs, dbrRequestContext_t *req_r
     // this guy is complete - clean up and return status
     ret = req_rctx->_cpl._status;
   }
+  BELOCK_UNLOCK( cs->_reverse );
+
+  dbrCallback_dispatch( cs->_reverse );
 
   return ret;
 }
 
+/*
+ * drives the back-end and processes all completions that are currently available
+ * caller has to hold the backend lock
+ * returns the number of processed completions
+ */
+int dbrDrain_completions( dbrMain_context_t *ctx )
+{
+  if(( ctx == NULL ) || ( ctx->_be_ctx == NULL ))
+    return 0;
+
+  int count = 0;
+  dbBE_Completion_t *compl;
+  // limited per call to not starve other threads waiting for the lock
+  while(( count < DBR_POSTED_QUEUE_DEPTH ) &&
+        (( compl = ctx->_be_ctx->_api->test_any( ctx->_be_ctx->_context )) != NULL ))
+  {
+    dbrRequestContext_t *cmpl_rctx = (dbrRequestContext_t*)compl->_user;
+    if( cmpl_rctx == NULL )
+      fprintf( stderr, "BUG in interaction with system library. Empty user-ptr in completion.\n" );
+    else
+      dbrProcess_completion( cmpl_rctx, compl );
+    dbrlib_backend_release( ctx->_be_ctx, compl );
+    ++count;
+  }
+  if( count > 0 )
+    dbrWait_signal( ctx );
+  return count;
+}
+
+/*
+ * current time of the monotonic clock in microseconds
+ */
+static inline
+int64_t dbrWait_now_usec( void )
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/*
+ * block the calling thread until new completions may be available or until usec expired.
+ * One thread at a time polls the back-end event fd together with the wake-up fd that
+ * is signalled when another thread processed completions. Other threads wait until
+ * completions got processed or the polling thread returns.
+ * Without a back-end event fd, the block is limited to backoff_usec because there's
+ * no guarantee that any other thread drives the back-end.
+ * The caller is expected to drive the back-end again afterwards.
+ * if rctx is given, there's no blocking if it's already complete
+ */
+static
+void dbrWait_block( dbrMain_context_t *ctx, dbrRequestContext_t *rctx, int64_t usec, int64_t backoff_usec )
+{
+  BELOCK_LOCK( ctx );
+  if(( rctx != NULL ) && ( rctx->_status == dbrSTATUS_READY ))
+  {
+    BELOCK_UNLOCK( ctx );
+    return;
+  }
+
+  if( ! ctx->_fd_waiting )
+  {
+    int fd = ( dbBE_Wakeup_fd( &ctx->_cpl_wakeup ) >= 0 ) ? dbrlib_backend_event_fd( ctx->_be_ctx ) : -ENOTSUP;
+    if( fd == -EAGAIN )
+    {
+      BELOCK_UNLOCK( ctx );
+      return;
+    }
+    if( fd >= 0 )
+    {
+      ctx->_fd_waiting = 1;
+      dbBE_Wakeup_drain( &ctx->_cpl_wakeup );
+      BELOCK_UNLOCK( ctx );
+
+      struct pollfd pfd[ 2 ];
+      pfd[ 0 ].fd = fd;
+      pfd[ 0 ].events = POLLIN;
+      pfd[ 1 ].fd = dbBE_Wakeup_fd( &ctx->_cpl_wakeup );
+      pfd[ 1 ].events = POLLIN;
+      pfd[ 0 ].revents = pfd[ 1 ].revents = 0;
+      poll( pfd, 2, (int)(( usec + 999 ) / 1000 ));
+
+      BELOCK_LOCK( ctx );
+      ctx->_fd_waiting = 0;
+      // one of the waiting threads takes over the back-end event fd
+      if( ctx->_cpl_waiters > 0 )
+        pthread_cond_broadcast( &ctx->_cpl_cond );
+      BELOCK_UNLOCK( ctx );
+      return;
+    }
+    usec = ( usec < backoff_usec ) ? usec : backoff_usec;
+  }
+
+  struct timespec until;
+#ifdef __APPLE__
+  clock_gettime( CLOCK_REALTIME, &until ); // no monotonic condvars available
+#else
+  clock_gettime( CLOCK_MONOTONIC, &until );
+#endif
+  int64_t nsec = until.tv_nsec + usec * 1000;
+  until.tv_sec += nsec / 1000000000;
+  until.tv_nsec = nsec % 1000000000;
+
+  ++ctx->_cpl_waiters;
+  pthread_cond_timedwait( &ctx->_cpl_cond, &ctx->_be_lock, &until );
+  --ctx->_cpl_waiters;
+  BELOCK_UNLOCK( ctx );
+}
+
+/*
+ * Waiting is done by repeatedly driving the backend and calling dbrWait_idle() if there was no progress.
+ * Only reads the clock every N loops to keep the polling loop short.
+ * The adaptive policy checks more frequently because it needs to notice the end
+ * of the spin period and then alternates between driving the back-end and blocking
+ * until the deadline (ended early by back-end events or completions). Without
+ * a back-end event fd, the blocking intervals increase exponentially instead.
+ */
+
+#ifndef DEVMODE
+#define DBR_TIMEOUT_CHECKLOOPS ( 0x3FFF )
+#define DBR_ADAPTIVE_CHECKLOOPS ( 0x3F )
+#else
+#define DBR_TIMEOUT_CHECKLOOPS ( 0x1 )
+#define DBR_ADAPTIVE_CHECKLOOPS ( 0x1 )
+#endif
+
+void dbrWait_init( dbrWait_state_t *ws,
+                   dbrMain_context_t *ctx,
+                   int enable_timeout )
+{
+  ws->_ctx = ctx;
+  ws->_enable_timeout = enable_timeout;
+  ws->_adaptive = ( ctx->_config._wait_policy == dbrWAIT_POLICY_ADAPTIVE );
+  ws->_deadline = 0;
+  dbrWait_reset( ws );
+}
+
+void dbrWait_reset( dbrWait_state_t *ws )
+{
+  ws->_loops = 0;
+  ws->_spin_until = 0;
+  ws->_block_usec = 0;
+}
+
+int dbrWait_idle( dbrWait_state_t *ws, dbrRequestContext_t *rctx )
+{
+  const dbrConfig_t *config = &ws->_ctx->_config;
+  const uint64_t checkloops = ws->_adaptive ? DBR_ADAPTIVE_CHECKLOOPS : DBR_TIMEOUT_CHECKLOOPS;
+
+  // once blocking has started, the clock is checked after every wakeup
+  if(( ws->_block_usec == 0 ) && ((( ++ws->_loops ) & checkloops ) != 0 ))
+    return 0;
+
+  int64_t now = dbrWait_now_usec();
+  // the deadline starts with the first clock check
+  if( ws->_deadline == 0 )
+    ws->_deadline = now + (int64_t)config->_timeout_sec * 1000000;
+  else if( ws->_enable_timeout && ( now >= ws->_deadline ))
+    return 1;
+
+  if( ! ws->_adaptive )
+    return 0;
+
+  if( ws->_spin_until == 0 )
+    ws->_spin_until = now + config->_wait_spin_usec;
+  else if( now >= ws->_spin_until )
+  {
+    ws->_block_usec = ( ws->_block_usec == 0 ) ? DBR_WAIT_BLOCK_USEC_MIN : ws->_block_usec * 2;
+    if( ws->_block_usec > DBR_WAIT_BLOCK_USEC_MAX )
+      ws->_block_usec = DBR_WAIT_BLOCK_USEC_MAX;
+    int64_t usec = DBR_WAIT_BLOCK_USEC_IDLE;
+    if( ws->_enable_timeout && ( now + usec > ws->_deadline ))
+      usec = ws->_deadline - now + 1;
+    dbrWait_block( ws->_ctx, rctx, usec, ws->_block_usec );
+  }
+  return 0;
+}
+
 DBR_Errorcode_t dbrWait_request( dbrName_space_t *cs,
                                  DBR_Request_handle_t hdl,
                                  int enable_timeout )
@@ -234,59 +441,32 @@ DBR_Errorcode_t dbrWait_request( dbrName_space_t *cs,
   if(( hdl == NULL ) || ( cs == NULL ))
     return DBR_ERR_INVALID;
 
-  DBR_Errorcode_t rc;
-  struct timeval start_time, now, elapsed;
-  start_time.tv_sec = 0;
-  elapsed.tv_sec = 0;
+  DBR_Errorcode_t rc = DBR_SUCCESS;
+  int timed_out = 0;
+  dbrWait_state_t ws;
+  dbrWait_init( &ws, cs->_reverse, enable_timeout );
 
   DBR_Request_handle_t chain = hdl;
 
   /*
    * This loop should allow to drive the backend while waiting for completions
    * Reduces the requirement for a backend to make independent progress in a separate thread
-   * Only uses gettimeofday every N loops to reduce the number of syscalls
+   * The timeout covers the whole chain
    */
-
-#ifndef DEVMODE
-#define DBR_TIMEOUT_CHECKLOOPS ( 0x3FFF )
-#else
-#define DBR_TIMEOUT_CHECKLOOPS ( 0x1 )
-#endif
-
-  // check the full chain of requests before returning
   while( chain != NULL )
   {
-    /*
-     * have a loop count to reduce the amount of gettimeofday calls
-     * start with negative offset to prevent the syscall for the first N iterations
-     */
-    uint64_t timeloops = (uint64_t)-100;
-    uint64_t timecalls = 0;
-    do
+    dbrWait_reset( &ws );
+    while( 1 )
     {
       rc = dbrTest_request( cs, chain );
-      if((rc == DBR_ERR_INPROGRESS)
-         && enable_timeout)
-      {
-        if( ((++timeloops) & DBR_TIMEOUT_CHECKLOOPS ) == 0 )
-        {
-          gettimeofday( &now, NULL );
-          ++timecalls;
-          if( start_time.tv_sec == 0 )
-          {
-            start_time.tv_sec = now.tv_sec;
-            start_time.tv_usec = now.tv_usec;
-          }
-          elapsed.tv_sec = (now.tv_sec * 1e6 + now.tv_usec) - (start_time.tv_sec * 1e6 + start_time.tv_usec);
-          elapsed.tv_sec /= 1e6;
-        }
-      }
-    } while( rc == DBR_ERR_INPROGRESS
-             && ( elapsed.tv_sec < cs->_reverse->_config._timeout_sec ));
+      if(( rc != DBR_ERR_INPROGRESS ) || timed_out )
+        break;
+      timed_out = dbrWait_idle( &ws, chain );
+    }
 
-    // ToDo: if Timeout -> send first a cancel and wait for acknowledge.
-    //       otherwise internal structures could be in danger.
-    if(( rc == DBR_ERR_INPROGRESS )&& (elapsed.tv_sec >= cs->_reverse->_config._timeout_sec))
+    // if Timeout -> send first a cancel and wait for acknowledge.
+    // otherwise internal structures could be in danger.
+    if(( rc == DBR_ERR_INPROGRESS ) && timed_out )
     {
       dbrCancel_request( cs, chain );
       rc = DBR_ERR_INPROGRESS;
@@ -294,7 +474,6 @@ DBR_Errorcode_t dbrWait_request( dbrName_space_t *cs,
         rc = dbrTest_request( cs, chain );
     }
 
-
     chain = chain->_next;
   }
   return rc;
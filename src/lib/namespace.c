@@ -19,6 +19,7 @@
 #include "libdatabroker_int.h"
 #include "lib/backend.h"
 #include "memutil.h"
+#include "common/utility.h"
 
 #include <stddef.h>
 #include <errno.h>
@@ -30,19 +31,101 @@
 #include <string.h>
 
 
-uint32_t dbrMain_find( dbrMain_context_t *libctx, DBR_Name_t name )
+int dbrMain_ns_table_init( dbrName_space_table_t *table )
 {
-  if( libctx == NULL )
-    return dbrERROR_INDEX;
+  if( table == NULL )
+    return -EINVAL;
+
+  table->_buckets = (dbrName_space_t**)calloc( dbrNS_TABLE_SIZE_MIN, sizeof( dbrName_space_t* ) );
+  if( table->_buckets == NULL )
+    return -ENOMEM;
+  table->_size = dbrNS_TABLE_SIZE_MIN;
+  table->_count = 0;
+  return 0;
+}
+
+void dbrMain_ns_table_exit( dbrName_space_table_t *table )
+{
+  if( table == NULL )
+    return;
+  if( table->_buckets != NULL )
+    free( table->_buckets );
+  memset( table, 0, sizeof( dbrName_space_table_t ) );
+}
+
+static inline
+dbrName_space_t** dbrMain_ns_bucket( dbrName_space_table_t *table, const uint64_t hash )
+{
+  return &table->_buckets[ hash & ( table->_size - 1 ) ];
+}
+
+/*
+ * double the number of buckets and rehash all entries
+ * the table stays usable with the old size if the allocation fails
+ */
+static
+int dbrMain_ns_table_grow( dbrName_space_table_t *table )
+{
+  uint32_t new_size = table->_size << 1;
+  if( new_size <= table->_size )
+    return -ENOSPC;
+
+  dbrName_space_t **buckets = (dbrName_space_t**)calloc( new_size, sizeof( dbrName_space_t* ) );
+  if( buckets == NULL )
+    return -ENOMEM;
+
+  uint32_t b;
+  for( b = 0; b < table->_size; ++b )
+  {
+    dbrName_space_t *cs = table->_buckets[ b ];
+    while( cs != NULL )
+    {
+      dbrName_space_t *next = cs->_ns_next;
+      dbrName_space_t **bucket = &buckets[ cs->_hash & ( new_size - 1 ) ];
+      cs->_ns_next = *bucket;
+      *bucket = cs;
+      cs = next;
+    }
+  }
+  free( table->_buckets );
+  table->_buckets = buckets;
+  table->_size = new_size;
+  return 0;
+}
+
+/*
+ * unlink cs from its bucket; returns -ENOENT if it's not in the table
+ */
+static
+int dbrMain_ns_table_remove( dbrName_space_table_t *table, dbrName_space_t *cs )
+{
+  dbrName_space_t **link = dbrMain_ns_bucket( table, cs->_hash );
+  while(( *link != NULL ) && ( *link != cs ))
+    link = &(*link)->_ns_next;
+  if( *link == NULL )
+    return -ENOENT;
 
-  uint32_t n;
-  for( n=0; (n<dbrNUM_DB_MAX); ++n )
-    if( ( libctx->_cs_list[ n ] != NULL ) &&
-        ( libctx->_cs_list[ n ]->_db_name != NULL ) &&
-        ( strncmp( libctx->_cs_list[ n ]->_db_name, name, DBR_MAX_KEY_LEN ) == 0 ))
-      return n;
+  *link = cs->_ns_next;
+  cs->_ns_next = NULL;
+  cs->_in_table = 0;
+  --table->_count;
+  return 0;
+}
 
-  return dbrERROR_INDEX;
+dbrName_space_t* dbrMain_find( dbrMain_context_t *libctx, DBR_Name_t name )
+{
+  if(( libctx == NULL ) || ( name == NULL ) || ( libctx->_cs_table._buckets == NULL ))
+    return NULL;
+
+  uint64_t hash = dbBE_String_hash( name, DBR_MAX_KEY_LEN );
+  dbrName_space_t *cs;
+  for( cs = *dbrMain_ns_bucket( &libctx->_cs_table, hash ); cs != NULL; cs = cs->_ns_next )
+    if(( cs->_hash == hash ) &&
+        ( cs->_db_name != NULL ) &&
+        ( strncmp( cs->_db_name, name, DBR_MAX_KEY_LEN ) == 0 ))
+      return cs;
+
+  return NULL;
 }
 
 dbrName_space_t* dbrMain_create_local( DBR_Name_t db_name )
@@ -60,12 +143,13 @@ dbrName_space_t* dbrMain_create_local( DBR_Name_t db_name )
   cs->_reverse = dbrCheckCreateMainCTX();
   cs->_be_ctx = dbrlib_backend_get_handle();
   cs->_status = dbrNS_STATUS_CREATED;
-  cs->_idx = dbrERROR_INDEX;
+  cs->_hash = dbBE_String_hash( db_name, DBR_MAX_KEY_LEN );
   cs->_be_ns_hdl = NULL;
 
-  if( dbrMain_insert( cs->_reverse, cs ) == dbrERROR_INDEX )
+  if( dbrMain_insert( cs->_reverse, cs ) != 0 )
   {
-    LOG( DBG_ERR, stderr, "Reference count error detected while creating namespace.\n" );
+    LOG( DBG_ERR, stderr, "Failed to insert namespace into the namespace table.\n" );
+    free( cs->_db_name );
     memset( cs, 0, sizeof( dbrName_space_t ) );
     free(cs);
     cs = NULL;
@@ -73,45 +157,30 @@ dbrName_space_t* dbrMain_create_local( DBR_Name_t db_name )
   return cs;
 }
 
-// inserts cs into an empty slot (idempotent if already inserted before)
-uint32_t dbrMain_insert( dbrMain_context_t *libctx, dbrName_space_t *cs )
+// inserts cs into the name space table (idempotent if already inserted before)
+int dbrMain_insert( dbrMain_context_t *libctx, dbrName_space_t *cs )
 {
-  if(( libctx == NULL ) || ( cs == NULL ))
-    return dbrERROR_INDEX;
+  if(( libctx == NULL ) || ( cs == NULL ) || ( libctx->_cs_table._buckets == NULL ))
+    return -EINVAL;
 
-  uint32_t idx = 0;
-  if( cs->_idx == dbrERROR_INDEX ) // not yet inserted?
-  {
-    // find the first hole in the context list
-    // todo: current search has O(N) complexity, improve that later!!!
-    while((idx<dbrNUM_DB_MAX) && ( libctx->_cs_list[ idx ] != NULL ))
-      ++idx;
-
-    // if we hit the end, then everything is occupied
-    // todo: for now just return error, later maybe extend the list
-    if( idx == dbrNUM_DB_MAX )
-      return dbrERROR_INDEX;
-  }
-  else
-    idx = cs->_idx;
+  // do nothing if already inserted
+  if( cs->_in_table )
+    return 0;
 
-  // insert
-  if(( libctx->_cs_list[ idx ] != NULL ) && ( libctx->_cs_list[ idx ] != cs ))
-  {
-    LOG( DBG_ERR, stderr, "Inconsistent namespace table.\n" );
-    return dbrERROR_INDEX;
-  }
+  dbrName_space_table_t *table = &libctx->_cs_table;
+  if( table->_count >= table->_size )
+    dbrMain_ns_table_grow( table ); // keeps working with longer chains if growing fails
 
-  // do nothing if already inserted
-  if( libctx->_cs_list[ idx ] == cs )
-    return idx;
+  dbrName_space_t **bucket = dbrMain_ns_bucket( table, cs->_hash );
+  cs->_ns_next = *bucket;
+  *bucket = cs;
+  ++table->_count;
 
-  libctx->_cs_list[ idx ] = cs;
+  cs->_in_table = 1;
   cs->_ref_count = 1;
-  cs->_idx = idx;
   cs->_status = dbrNS_STATUS_REFERENCED;
 
-  return idx;
+  return 0;
 }
 
 int dbrMain_attach( dbrMain_context_t *libctx, dbrName_space_t *cs )
@@ -120,8 +189,7 @@ int dbrMain_attach( dbrMain_context_t *libctx, dbrName_space_t *cs )
     return -EINVAL;
 
   // check consistency
-  uint32_t idx = cs->_idx;
-  if(( libctx->_cs_list[ idx ] == NULL ) || ( cs != libctx->_cs_list[ idx ] ))
+  if( ! cs->_in_table )
   {
     LOG( DBG_ERR, stderr, "Inconsistent Namespace table.\n" );
     return -ENOENT;
@@ -150,7 +218,12 @@ dbrMain_delete_local( dbrMain_context_t *libctx, dbrName_space_t *cs )
     LOG( DBG_ERR, stderr, "Reference count error: expected namespace status DELETED.\n" );
   }
 
-  uint32_t idx = cs->_idx;
+  if( dbrMain_ns_table_remove( &libctx->_cs_table, cs ) != 0 )
+  {
+    LOG( DBG_ERR, stderr, "Inconsistent Namespace table.\n" );
+    rc = -ENOENT;
+  }
+
   if( memzero( cs->_db_name, 0, strlen( cs->_db_name ) ) == NULL )
     rc = -EFAULT;
 
@@ -160,7 +233,6 @@ dbrMain_delete_local( dbrMain_context_t *libctx, dbrName_space_t *cs )
     rc = -EFAULT;
 
   free( cs );
-  libctx->_cs_list[ idx ] = NULL;
 
   return rc;
 }
@@ -171,8 +243,7 @@ int dbrMain_detach( dbrMain_context_t *libctx, dbrName_space_t *cs )
     return -EINVAL;
 
   // check consistency
-  uint32_t idx = cs->_idx;
-  if(( libctx->_cs_list[ idx ] == NULL ) || ( cs != libctx->_cs_list[ idx ] ))
+  if( ! cs->_in_table )
   {
     LOG( DBG_ERR, stderr, "Inconsistent Namespace table.\n" );
     return -ENOENT;
@@ -29,6 +29,7 @@
 #include "logutil.h"
 #include "libdatabroker.h"
 #include "libdatabroker_int.h"
+#include "libdbrAPI.h"
 
 
 dbrRequestContext_t* dbrCreate_request_ctx(dbBE_Opcode op,
@@ -82,7 +83,19 @@ dbrRequestContext_t* dbrCreate_request_ctx(dbBE_Opcode op,
       break;
   }
 
-  dbrRequestContext_t *req = (dbrRequestContext_t*)calloc( 1, sizeof( dbrRequestContext_t ) + sge_count * sizeof(dbBE_sge_t) );
+  dbrRequestContext_t *req = NULL;
+  if( sge_count <= DBR_POOL_SGE_MAX )
+  {
+    // small requests always get the full pool object size so they can be recycled
+    size_t size = sizeof( dbrRequestContext_t ) + DBR_POOL_SGE_MAX * sizeof(dbBE_sge_t);
+    req = (dbrRequestContext_t*)dbBE_Object_pool_get( cs->_reverse ? cs->_reverse->_rctx_pool : NULL );
+    if( req == NULL )
+      req = (dbrRequestContext_t*)malloc( size );
+    if( req != NULL )
+      memset( req, 0, size );
+  }
+  else
+    req = (dbrRequestContext_t*)calloc( 1, sizeof( dbrRequestContext_t ) + sge_count * sizeof(dbBE_sge_t) );
   if( req == NULL )
     return NULL;
 
@@ -102,6 +115,7 @@ dbrRequestContext_t* dbrCreate_request_ctx(dbBE_Opcode op,
   req->_be_request_hdl = NULL;
   req->_rc = rc;
   req->_tag = tag;
+  req->_head = req;
 
   return req;
 }
@@ -110,11 +124,57 @@ DBR_Errorcode_t dbrDestroy_request( dbrRequestContext_t *rctx )
 {
   if( rctx == NULL )
     return DBR_ERR_INVALID;
+  dbBE_Object_pool_t *pool = NULL;
+  if(( rctx->_req._sge_count <= DBR_POOL_SGE_MAX ) && ( rctx->_ctx != NULL ) && ( rctx->_ctx->_reverse != NULL ))
+    pool = rctx->_ctx->_reverse->_rctx_pool;
   memset( rctx, 0, sizeof( dbrRequestContext_t ) + rctx->_req._sge_count * sizeof(dbBE_sge_t) );
-  free( rctx );
+  dbBE_Object_pool_put( pool, rctx );
   return DBR_SUCCESS;
 }
 
+dbrDA_Request_chain_t* dbrRequest_chain_alloc( dbrMain_context_t *ctx, int sge_count )
+{
+  if( sge_count < 0 )
+    return NULL;
+
+  size_t size = sizeof( dbrDA_Request_chain_t ) + sge_count * sizeof( dbBE_sge_t );
+  dbrDA_Request_chain_t *chain = NULL;
+  if(( sge_count == 1 ) && ( ctx != NULL ))
+    chain = (dbrDA_Request_chain_t*)dbBE_Object_pool_get( ctx->_chain_pool );
+  if( chain == NULL )
+    chain = (dbrDA_Request_chain_t*)malloc( size );
+  if( chain == NULL )
+    return NULL;
+
+  memset( chain, 0, size );
+  chain->_sge_count = sge_count;
+  return chain;
+}
+
+void dbrRequest_chain_release( dbrMain_context_t *ctx, dbrDA_Request_chain_t *chain )
+{
+  if( chain == NULL )
+    return;
+  if(( chain->_sge_count == 1 ) && ( ctx != NULL ))
+    dbBE_Object_pool_put( ctx->_chain_pool, chain );
+  else
+    free( chain );
+}
+
+dbrDA_Request_chain_t* libdbrRequest_chain_alloc( DBR_Handle_t cs_handle,
+                                                  int sge_count )
+{
+  dbrName_space_t *cs = (dbrName_space_t*)cs_handle;
+  return dbrRequest_chain_alloc( cs ? cs->_reverse : NULL, sge_count );
+}
+
+void libdbrRequest_chain_release( DBR_Handle_t cs_handle,
+                                  dbrDA_Request_chain_t *chain )
+{
+  dbrName_space_t *cs = (dbrName_space_t*)cs_handle;
+  dbrRequest_chain_release( cs ? cs->_reverse : NULL, chain );
+}
+
 dbrRequestContext_t* dbrCreate_request_chain( dbBE_Opcode op,
                                               dbrName_space_t *ns,
                                               DBR_Group_t group,
@@ -153,6 +213,7 @@ dbrRequestContext_t* dbrCreate_request_chain( dbBE_Opcode op,
       prev->_next = ctx;
     else
       head = ctx; // remember the first one
+    ctx->_head = head;
 
     prev = ctx;
     // some basic sanity check because we're processing a data structure from the plugin
@@ -190,36 +251,20 @@ DBR_Tag_t dbrInsert_request( dbrName_space_t *cs, dbrRequestContext_t *rctx )
       || rctx == NULL || cs->_reverse == NULL )
     return DB_TAG_ERROR;
 
-  dbrRequestContext_t** cs_wq = cs->_reverse->_cs_wq;
-
   DBR_Tag_t tag = rctx->_tag;
 
   if( dbrValidateTag( rctx, tag ) != DBR_SUCCESS )
     return DB_TAG_ERROR;
 
-#ifdef DBR_INTTAG
-  unsigned int tag_idx = tag;
+  // the slot is owned by the thread that got the tag until dbrRemove_request()
+  // so it's an error if the tag is stale or anything else occupies it
+  TAGLOCK_LOCK( cs->_reverse );
+  dbrTag_slot_t *slot = dbrTag_table_lookup( &cs->_reverse->_tags, tag );
+  if(( slot == NULL ) || ( slot->_rctx != NULL ))
+    TAGLOCK_UNLOCKRETURN( cs->_reverse, DB_TAG_ERROR );
 
-#else
-  dbrRequestContext_t** p_rctx = (dbrRequestContext_t**)tag;
-  if( p_rctx < cs_wq
-      || &cs_wq[ dbrMAX_TAGS ] <= p_rctx )
-    return DB_TAG_ERROR;
-
-  unsigned int tag_idx = p_rctx - cs_wq;
-#endif
-
-  if( cs_wq[ tag_idx ] != NULL )
-  {
-    if( cs_wq[ tag_idx ]->_status != dbrSTATUS_CLOSED )
-    {
-      return DB_TAG_ERROR;
-    }
-    free( cs_wq[ tag_idx ] );
-    cs_wq[ tag_idx ] = NULL;
-  }
-
-  cs_wq[ tag_idx ] = rctx;
+  slot->_rctx = rctx;
+  TAGLOCK_UNLOCK( cs->_reverse );
   return tag;
 }
 
@@ -229,50 +274,38 @@ DBR_Errorcode_t dbrRemove_request( dbrName_space_t *cs, dbrRequestContext_t *rct
       || rctx == NULL || cs->_reverse == NULL )
     return DBR_ERR_INVALID;
 
-  dbrRequestContext_t** cs_wq = cs->_reverse->_cs_wq;
-
   DBR_Tag_t tag = rctx->_tag;
 
   if( dbrValidateTag( rctx, tag ) != DBR_SUCCESS )
     return DBR_ERR_TAGERROR;
 
-#ifdef DBR_INTTAG
-  unsigned int tag_idx = tag;
-
-#else
-  dbrRequestContext_t** p_rctx = (dbrRequestContext_t**)tag;
-  if( p_rctx < cs_wq
-      || &cs_wq[ dbrMAX_TAGS ] <= p_rctx )
-    return DBR_ERR_TAGERROR;
-
-  unsigned int tag_idx = p_rctx - cs_wq;
-#endif
-
-  DBR_Errorcode_t rc = DBR_ERR_HANDLE; // assume the rctx-handle is not in the WQ-list until we actually find it
-  while( cs_wq[ tag_idx ] != NULL )
+  // detach the chain from the request table and release the tag first; clean up outside of the lock
+  // only remove the entry if it actually belongs to this request
+  TAGLOCK_LOCK( cs->_reverse );
+  dbrTag_slot_t *slot = dbrTag_table_lookup( &cs->_reverse->_tags, tag );
+  if(( slot == NULL ) || ( slot->_rctx != rctx ))
+    TAGLOCK_UNLOCKRETURN( cs->_reverse, DBR_ERR_HANDLE );
+  dbrRequestContext_t *head = slot->_rctx;
+  dbrTag_table_release( &cs->_reverse->_tags, tag );
+  TAGLOCK_UNLOCK( cs->_reverse );
+
+  DBR_Errorcode_t rc = DBR_SUCCESS;
+  while( head != NULL )
   {
-    dbrRequestContext_t *chain = cs_wq[ tag_idx ]->_next;
+    dbrRequestContext_t *chain = head->_next;
     if(( chain != NULL )&&( chain->_tag != tag ))
     {
       printf( "BUG: chained request with different tag.\n" );
       return DBR_ERR_INVALID;
     }
     // todo: if there's a backend handle reference, we might have to clean it up
-    if( cs_wq[ tag_idx ]->_be_request_hdl != NULL )
+    if( head->_be_request_hdl != NULL )
       LOG( DBG_VERBOSE, stderr, "TODO: cleanup backend handle?\n" );
 
-    if( rctx == cs_wq[ tag_idx ] )
-    {
-      LOG( DBG_VERBOSE, stdout, "Found the requested context\n" );
-      rc = DBR_SUCCESS;
-    }
-
-    // todo: to prevent request deletion caused by an invalid rctx, move the requests to tmp deletion queue instead until we're sure the correct stuff is deleted
-    dbrDestroy_request( cs_wq[ tag_idx ] );
-    cs_wq[ tag_idx ] = chain;
+    dbrDestroy_request( head );
+    head = chain;
   }
 
-  cs_wq[ tag_idx ] = NULL;
   return rc;
 }
 
@@ -289,7 +322,10 @@ DBR_Request_handle_t dbrPost_request_ext( dbrRequestContext_t *rctx, const int w
     if( dbrValidateTag( chain, chain->_tag ) != DBR_SUCCESS )
       return NULL;
 
-    if( chain->_ctx->_reverse->_cs_wq[ chain->_tag ] == NULL )
+    TAGLOCK_LOCK( chain->_ctx->_reverse );
+    int inserted = ( dbrTag_lookup( chain->_ctx->_reverse, chain->_tag ) != NULL );
+    TAGLOCK_UNLOCK( chain->_ctx->_reverse );
+    if( ! inserted )
     {
       LOG( DBG_ERR, stderr, "Request not inserted in namespace request list.\n" );
       return NULL;
@@ -306,8 +342,11 @@ DBR_Request_handle_t dbrPost_request_ext( dbrRequestContext_t *rctx, const int w
     rcount = ((rcount+1) % 128 );
     int trigger = (( chain->_next == NULL ) && ( with_trigger )) || ( rcount == 0 );
     dbBE_Request_handle_t be_handle = NULL;
+    // drop the lock between retries to let other threads drain the back-end queues
     do {
+      BELOCK_LOCK( rctx->_ctx->_reverse );
       be_handle = be->_api->post( be->_context, &chain->_req, trigger );
+      BELOCK_UNLOCK( rctx->_ctx->_reverse );
     } while(( be_handle == NULL ) && ( errno == EAGAIN ));
 
       if( be_handle == NULL )
@@ -0,0 +1,891 @@
+/*
+ * Copyright © 2018-2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdio.h>
+#ifdef __APPLE__
+#include <stdlib.h>
+#else
+#include <malloc.h>
+#endif
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "logutil.h"
+#include "libdatabroker.h"
+#include "libdatabroker_int.h"
+#include "libdbrAPI.h"
+#include "lib/stripe.h"
+
+#define DBR_STRIPE_FNV_OFFSET ( 0xcbf29ce484222325ull )
+#define DBR_STRIPE_FNV_PRIME ( 0x100000001b3ull )
+
+static uint64_t gStripe_origin = 0;
+static uint64_t gStripe_sequence = 0;
+
+
+static inline
+void dbrStripe_put_u64( char *buf, uint64_t val )
+{
+  int n;
+  for( n = 0; n < 8; ++n, val >>= 8 )
+    buf[ n ] = (char)( val & 0xff );
+}
+
+static inline
+uint64_t dbrStripe_get_u64( const char *buf )
+{
+  uint64_t val = 0;
+  int n;
+  for( n = 7; n >= 0; --n )
+    val = ( val << 8 ) | (uint8_t)buf[ n ];
+  return val;
+}
+
+static inline
+uint64_t dbrStripe_checksum( const char *buf, const size_t len )
+{
+  uint64_t hash = DBR_STRIPE_FNV_OFFSET;
+  size_t n;
+  for( n = 0; n < len; ++n )
+  {
+    hash ^= (uint8_t)buf[ n ];
+    hash *= DBR_STRIPE_FNV_PRIME;
+  }
+  return hash;
+}
+
+static inline
+uint64_t dbrStripe_mix( uint64_t x )
+{
+  x += 0x9e3779b97f4a7c15ull;
+  x = ( x ^ ( x >> 30 )) * 0xbf58476d1ce4e5b9ull;
+  x = ( x ^ ( x >> 27 )) * 0x94d049bb133111ebull;
+  return x ^ ( x >> 31 );
+}
+
+static inline
+int64_t dbrStripe_sge_size( dbrDA_Request_chain_t *request )
+{
+  int64_t size = 0;
+  int n;
+  for( n = 0; n < request->_sge_count; ++n )
+    size += request->_value_sge[ n ].iov_len;
+  return size;
+}
+
+static inline
+int64_t dbrStripe_chunk_len( const dbrStripe_manifest_t *manifest, const int64_t index )
+{
+  int64_t remain = manifest->_total - index * manifest->_chunk_size;
+  return ( remain < manifest->_chunk_size ) ? remain : manifest->_chunk_size;
+}
+
+/*
+ * copy the first DBR_STRIPE_MANIFEST_SIZE bytes out of the request SGEs
+ */
+static
+int dbrStripe_gather( dbrDA_Request_chain_t *request, char *buf )
+{
+  size_t copied = 0;
+  int n;
+  for( n = 0; ( n < request->_sge_count ) && ( copied < DBR_STRIPE_MANIFEST_SIZE ); ++n )
+  {
+    size_t len = request->_value_sge[ n ].iov_len;
+    if( len > DBR_STRIPE_MANIFEST_SIZE - copied )
+      len = DBR_STRIPE_MANIFEST_SIZE - copied;
+    if(( len > 0 ) && ( request->_value_sge[ n ].iov_base == NULL ))
+      return -1;
+    memcpy( buf + copied, request->_value_sge[ n ].iov_base, len );
+    copied += len;
+  }
+  return ( copied == DBR_STRIPE_MANIFEST_SIZE ) ? 0 : -1;
+}
+
+/*
+ * map len bytes starting at the SGE position (*sge, *offset) of request into out
+ * returns the number of SGEs needed (out may be NULL to only count) or -1 if the SGEs are too short
+ */
+static
+int dbrStripe_map( dbrDA_Request_chain_t *request,
+                   int *sge,
+                   size_t *offset,
+                   int64_t len,
+                   dbBE_sge_t *out )
+{
+  int count = 0;
+  while( len > 0 )
+  {
+    if( *sge >= request->_sge_count )
+      return -1;
+    dbBE_sge_t *src = &request->_value_sge[ *sge ];
+    size_t take = src->iov_len - *offset;
+    if( take > (size_t)len )
+      take = len;
+    if( take > 0 )
+    {
+      if( out != NULL )
+      {
+        out[ count ].iov_base = (char*)src->iov_base + *offset;
+        out[ count ].iov_len = take;
+      }
+      ++count;
+      len -= take;
+      *offset += take;
+    }
+    if( *offset >= src->iov_len )
+    {
+      ++(*sge);
+      *offset = 0;
+    }
+  }
+  return count;
+}
+
+void dbrStripe_manifest_encode( const dbrStripe_manifest_t *manifest, char *buf )
+{
+  memcpy( buf, DBR_STRIPE_MAGIC, DBR_STRIPE_MAGIC_LEN );
+  dbrStripe_put_u64( buf + 8, (uint64_t)manifest->_total );
+  dbrStripe_put_u64( buf + 16, (uint64_t)manifest->_chunk_size );
+  dbrStripe_put_u64( buf + 24, (uint64_t)manifest->_chunk_count );
+  dbrStripe_put_u64( buf + 32, manifest->_id );
+  dbrStripe_put_u64( buf + 40, dbrStripe_checksum( buf, 40 ) );
+}
+
+int dbrStripe_manifest_decode( const char *buf, dbrStripe_manifest_t *manifest )
+{
+  if(( buf == NULL ) || ( manifest == NULL ))
+    return -1;
+  if( memcmp( buf, DBR_STRIPE_MAGIC, DBR_STRIPE_MAGIC_LEN ) != 0 )
+    return -1;
+  if( dbrStripe_get_u64( buf + 40 ) != dbrStripe_checksum( buf, 40 ) )
+    return -1;
+
+  dbrStripe_manifest_t m;
+  m._total = (int64_t)dbrStripe_get_u64( buf + 8 );
+  m._chunk_size = (int64_t)dbrStripe_get_u64( buf + 16 );
+  m._chunk_count = (int64_t)dbrStripe_get_u64( buf + 24 );
+  m._id = dbrStripe_get_u64( buf + 32 );
+
+  if(( m._total <= 0 ) || ( m._chunk_size <= 0 ) ||
+     ( m._chunk_count < 2 ) || ( m._chunk_count > DBR_STRIPE_MAX_CHUNKS ) ||
+     ( m._chunk_count != ( m._total + m._chunk_size - 1 ) / m._chunk_size ))
+    return -1;
+
+  *manifest = m;
+  return 0;
+}
+
+int64_t dbrStripe_plan( const int64_t total, const int64_t stripe_size, dbrStripe_manifest_t *manifest )
+{
+  if(( manifest == NULL ) || ( total <= 0 ) || ( stripe_size <= 0 ))
+    return 0;
+
+  int64_t chunk = stripe_size;
+  int64_t count = ( total + chunk - 1 ) / chunk;
+  if( count > DBR_STRIPE_MAX_CHUNKS )
+  {
+    chunk = ( total + DBR_STRIPE_MAX_CHUNKS - 1 ) / DBR_STRIPE_MAX_CHUNKS;
+    count = ( total + chunk - 1 ) / chunk;
+  }
+
+  manifest->_total = total;
+  manifest->_chunk_size = chunk;
+  manifest->_chunk_count = count;
+  manifest->_id = 0;
+  return count;
+}
+
+/*
+ * unique across threads, processes and hosts that share a name space
+ */
+uint64_t dbrStripe_write_id( void )
+{
+  uint64_t origin = __atomic_load_n( &gStripe_origin, __ATOMIC_RELAXED );
+  if( origin == 0 )
+  {
+    origin = dbrStripe_mix( ((uint64_t)gethostid() << 32 ) ^ (uint64_t)getpid() ) | 1;
+    __atomic_store_n( &gStripe_origin, origin, __ATOMIC_RELAXED );
+  }
+
+  struct timespec ts;
+  clock_gettime( CLOCK_REALTIME, &ts );
+  uint64_t seq = __atomic_add_fetch( &gStripe_sequence, 1, __ATOMIC_RELAXED );
+  uint64_t now = (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+  return dbrStripe_mix( dbrStripe_mix( origin + now ) + seq );
+}
+
+int dbrStripe_chunk_key( char *buf, const char *key, const uint64_t id, const int64_t index )
+{
+  int len = snprintf( buf, DBR_STRIPE_KEY_MAX, "%s" DBR_STRIPE_KEY_INFIX "%016" PRIx64 ".%" PRId64,
+                      key, id, index );
+  return (( len < 0 ) || ( len >= DBR_STRIPE_KEY_MAX )) ? -1 : 0;
+}
+
+int dbrStripe_chunk_pattern( char *buf, const size_t size, const char *key )
+{
+  if(( buf == NULL ) || ( key == NULL ))
+    return -1;
+
+  // glob characters in the key must only match themselves
+  size_t len = 0;
+  for( ; *key != '\0'; ++key )
+  {
+    if( len + 2 >= size )
+      return -1;
+    if( strchr( "*?[]\\", *key ) != NULL )
+      buf[ len++ ] = '\\';
+    buf[ len++ ] = *key;
+  }
+  int rc = snprintf( buf + len, size - len, "%s*", DBR_STRIPE_KEY_INFIX );
+  return (( rc < 0 ) || ( (size_t)rc >= size - len )) ? -1 : 0;
+}
+
+int dbrStripe_chunk_match( const char *name, const char *key )
+{
+  if(( name == NULL ) || ( key == NULL ))
+    return 0;
+
+  size_t len = strlen( key );
+  size_t infix_len = strlen( DBR_STRIPE_KEY_INFIX );
+  if(( strncmp( name, key, len ) != 0 ) || ( strncmp( name + len, DBR_STRIPE_KEY_INFIX, infix_len ) != 0 ))
+    return 0;
+
+  // the pattern also matches chunks of keys that start with <key>.dbrstripe.
+  const char *p = name + len + infix_len;
+  int n;
+  for( n = 0; n < 16; ++n, ++p )
+    if(( *p == '\0' ) || ( strchr( "0123456789abcdef", *p ) == NULL ))
+      return 0;
+  if( *p++ != '.' )
+    return 0;
+  if( *p == '\0' )
+    return 0;
+  for( ; *p != '\0'; ++p )
+    if(( *p < '0' ) || ( *p > '9' ))
+      return 0;
+  return 1;
+}
+
+dbrStripe_chain_t* dbrStripe_chain_create( dbrMain_context_t *ctx,
+                                           dbrDA_Request_chain_t *request,
+                                           const dbrStripe_manifest_t *manifest,
+                                           const int64_t limit )
+{
+  if(( request == NULL ) || ( request->_key == NULL ) || ( manifest == NULL ) ||
+     ( manifest->_chunk_size <= 0 ) || ( limit < 0 ))
+  {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  int64_t covered = ( limit < manifest->_total ) ? limit : manifest->_total;
+  if( dbrStripe_sge_size( request ) < covered )
+  {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  dbrStripe_chain_t *chain = (dbrStripe_chain_t*)calloc( 1, sizeof( dbrStripe_chain_t ) );
+  if( chain == NULL )
+    return NULL;
+  chain->_count = ( covered + manifest->_chunk_size - 1 ) / manifest->_chunk_size;
+  if( chain->_count == 0 )
+    return chain;
+
+  chain->_keys = (char*)malloc( chain->_count * DBR_STRIPE_KEY_MAX );
+  chain->_ret_sizes = (int64_t*)calloc( chain->_count, sizeof( int64_t ) );
+  if(( chain->_keys == NULL ) || ( chain->_ret_sizes == NULL ))
+    goto error;
+
+  dbrDA_Request_chain_t **link = &chain->_head;
+  int sge = 0;
+  size_t offset = 0;
+  int64_t n;
+  for( n = 0; n < chain->_count; ++n )
+  {
+    int64_t len = dbrStripe_chunk_len( manifest, n );
+    if( len > covered - n * manifest->_chunk_size )
+      len = covered - n * manifest->_chunk_size;
+
+    int count_sge = sge;
+    size_t count_offset = offset;
+    int sge_count = dbrStripe_map( request, &count_sge, &count_offset, len, NULL );
+    if( sge_count <= 0 )
+      goto error;
+
+    dbrDA_Request_chain_t *element = dbrRequest_chain_alloc( ctx, sge_count );
+    if( element == NULL )
+      goto error;
+    *link = element;
+    link = &element->_next;
+
+    element->_key = chain->_keys + n * DBR_STRIPE_KEY_MAX;
+    if( dbrStripe_chunk_key( element->_key, request->_key, manifest->_id, n ) != 0 )
+    {
+      errno = EINVAL;
+      goto error;
+    }
+    element->_ret_size = &chain->_ret_sizes[ n ];
+    element->_size = len;
+    dbrStripe_map( request, &sge, &offset, len, element->_value_sge );
+  }
+  return chain;
+
+error:
+  dbrStripe_chain_destroy( ctx, chain );
+  return NULL;
+}
+
+void dbrStripe_chain_destroy( dbrMain_context_t *ctx, dbrStripe_chain_t *chain )
+{
+  if( chain == NULL )
+    return;
+  while( chain->_head != NULL )
+  {
+    dbrDA_Request_chain_t *element = chain->_head;
+    chain->_head = element->_next;
+    dbrRequest_chain_release( ctx, element );
+  }
+  free( chain->_keys );
+  free( chain->_ret_sizes );
+  free( chain );
+}
+
+/*
+ * chain of count elements without SGEs for requests that only need the keys
+ * the elements point to keys[] or, if keys is NULL, to key buffers of the chain for the caller to fill in
+ */
+static
+dbrStripe_chain_t* dbrStripe_key_chain_create( dbrMain_context_t *ctx,
+                                               char **keys,
+                                               const int64_t count )
+{
+  dbrStripe_chain_t *chain = (dbrStripe_chain_t*)calloc( 1, sizeof( dbrStripe_chain_t ) );
+  if( chain == NULL )
+    return NULL;
+  chain->_count = count;
+  if(( keys == NULL ) && (( chain->_keys = (char*)malloc( count * DBR_STRIPE_KEY_MAX )) == NULL ))
+    goto error;
+
+  dbrDA_Request_chain_t **link = &chain->_head;
+  int64_t n;
+  for( n = 0; n < count; ++n )
+  {
+    dbrDA_Request_chain_t *element = dbrRequest_chain_alloc( ctx, 0 );
+    if( element == NULL )
+      goto error;
+    *link = element;
+    link = &element->_next;
+    element->_key = ( keys != NULL ) ? keys[ n ] : chain->_keys + n * DBR_STRIPE_KEY_MAX;
+  }
+  return chain;
+
+error:
+  dbrStripe_chain_destroy( ctx, chain );
+  return NULL;
+}
+
+int dbrStripe_enabled( dbrName_space_t *cs )
+{
+  if(( cs == NULL ) || ( cs->_reverse == NULL ) || ( cs->_reverse->_config._stripe_threshold <= 0 ))
+    return 0;
+
+#ifdef DBR_DATA_ADAPTERS
+  // adapters transform the value; leave it to them how to store it
+  if( cs->_reverse->_data_adapter != NULL )
+    return 0;
+#endif
+  return 1;
+}
+
+int dbrStripe_put_eligible( dbrName_space_t *cs, dbrDA_Request_chain_t *request )
+{
+  if(( ! dbrStripe_enabled( cs ) ) || ( request == NULL ) ||
+     ( request->_next != NULL ) || ( request->_key == NULL ))
+    return 0;
+
+  dbrConfig_t *config = &cs->_reverse->_config;
+  int64_t size = dbrStripe_sge_size( request );
+  if(( size < config->_stripe_threshold ) || ( size <= config->_stripe_size ))
+    return 0;
+
+  return ( strnlen( request->_key, DBR_MAX_KEY_LEN ) + DBR_STRIPE_KEY_SUFFIX_MAX <= DBR_MAX_KEY_LEN );
+}
+
+int dbrStripe_get_candidate( dbrName_space_t *cs, dbrDA_Request_chain_t *request )
+{
+  // without striping configured, nothing is a manifest: this keeps ordinary 48-byte values safe
+  if(( ! dbrStripe_enabled( cs ) ) || ( request == NULL ) || ( request->_next != NULL ) || ( request->_key == NULL ) ||
+     ( request->_ret_size == NULL ) || ( *request->_ret_size != DBR_STRIPE_MANIFEST_SIZE ))
+    return 0;
+  return 1;
+}
+
+static
+DBR_Errorcode_t dbrStripe_put_manifest( dbrName_space_t *cs,
+                                        DBR_Tuple_name_t key,
+                                        char *raw,
+                                        DBR_Group_t group,
+                                        int flags )
+{
+  dbrDA_Request_chain_t *element = dbrRequest_chain_alloc( cs->_reverse, 1 );
+  if( element == NULL )
+    return DBR_ERR_NOMEMORY;
+  element->_key = key;
+  element->_size = DBR_STRIPE_MANIFEST_SIZE;
+  element->_value_sge[ 0 ].iov_base = raw;
+  element->_value_sge[ 0 ].iov_len = DBR_STRIPE_MANIFEST_SIZE;
+
+  DBR_Errorcode_t rc = dbrPut_chain_ext( cs, element, group, flags );
+  dbrRequest_chain_release( cs->_reverse, element );
+  return rc;
+}
+
+/*
+ * remove (dst_cs == NULL) or move the listed keys in parallel
+ */
+static
+DBR_Errorcode_t dbrStripe_keys_apply( dbrName_space_t *cs,
+                                      DBR_Group_t group,
+                                      char **keys,
+                                      const int64_t count,
+                                      DBR_Tuple_template_t match_template,
+                                      dbrName_space_t *dst_cs,
+                                      DBR_Group_t dst_group )
+{
+  dbrStripe_chain_t *chain = dbrStripe_key_chain_create( cs->_reverse, keys, count );
+  if( chain == NULL )
+    return DBR_ERR_NOMEMORY;
+
+  DBR_Errorcode_t rc;
+  if( dst_cs == NULL )
+    rc = dbrRemove_chain( cs, chain->_head, match_template, group );
+  else
+    rc = dbrMove_chain( cs, group, chain->_head, match_template, dst_cs, dst_group );
+  dbrStripe_chain_destroy( cs->_reverse, chain );
+  return rc;
+}
+
+/*
+ * remove all chunks of a manifest in parallel; chunks that don't exist are skipped
+ */
+static
+DBR_Errorcode_t dbrStripe_remove_chunks( dbrName_space_t *cs,
+                                         DBR_Tuple_name_t key,
+                                         const dbrStripe_manifest_t *manifest,
+                                         DBR_Group_t group )
+{
+  dbrStripe_chain_t *chain = dbrStripe_key_chain_create( cs->_reverse, NULL, manifest->_chunk_count );
+  if( chain == NULL )
+    return DBR_ERR_NOMEMORY;
+
+  DBR_Errorcode_t rc = DBR_SUCCESS;
+  dbrDA_Request_chain_t *element = chain->_head;
+  int64_t n;
+  for( n = 0; ( rc == DBR_SUCCESS ) && ( element != NULL ); ++n, element = element->_next )
+    if( dbrStripe_chunk_key( element->_key, key, manifest->_id, n ) != 0 )
+      rc = DBR_ERR_INVALID;
+
+  if( rc == DBR_SUCCESS )
+    rc = dbrRemove_chain( cs, chain->_head, NULL, group );
+  dbrStripe_chain_destroy( cs->_reverse, chain );
+  return ( rc == DBR_ERR_UNAVAIL ) ? DBR_SUCCESS : rc;
+}
+
+/*
+ * put a manifest that a get took back in front of the list where it came from
+ * if that fails, the chunks are unreferenced and get removed
+ */
+static
+void dbrStripe_restore( dbrName_space_t *cs,
+                        DBR_Tuple_name_t key,
+                        char *raw,
+                        const dbrStripe_manifest_t *manifest,
+                        DBR_Group_t group )
+{
+  DBR_Errorcode_t rc = dbrStripe_put_manifest( cs, key, raw, group, DBBE_OPCODE_FLAGS_HEAD );
+  if( rc != DBR_SUCCESS )
+  {
+    LOG( DBG_ERR, stderr, "libdatabroker: failed to restore manifest of striped %s (rc=%d). Removing chunks.\n", key, rc );
+    dbrStripe_remove_chunks( cs, key, manifest, group );
+  }
+}
+
+DBR_Errorcode_t dbrStripe_put( dbrName_space_t *cs,
+                               dbrDA_Request_chain_t *request,
+                               DBR_Group_t group )
+{
+  dbrMain_context_t *ctx = cs->_reverse;
+  dbrStripe_manifest_t manifest;
+  int64_t total = dbrStripe_sge_size( request );
+  if( dbrStripe_plan( total, ctx->_config._stripe_size, &manifest ) < 2 )
+    return dbrPut_chain( cs, request, group );
+  manifest._id = dbrStripe_write_id();
+
+  dbrStripe_chain_t *chunks = dbrStripe_chain_create( ctx, request, &manifest, total );
+  if( chunks == NULL )
+    return ( errno == EINVAL ) ? DBR_ERR_INVALID : DBR_ERR_NOMEMORY;
+
+  // all chunks in parallel; the manifest only goes out once every chunk is stored
+  DBR_Errorcode_t rc = dbrPut_chain( cs, chunks->_head, group );
+  if( rc == DBR_SUCCESS )
+  {
+    char raw[ DBR_STRIPE_MANIFEST_SIZE ];
+    dbrStripe_manifest_encode( &manifest, raw );
+    rc = dbrStripe_put_manifest( cs, request->_key, raw, group, DBBE_OPCODE_FLAGS_NONE );
+  }
+
+  if( rc != DBR_SUCCESS )
+  {
+    LOG( DBG_ERR, stderr, "libdatabroker: striped put of %s failed (rc=%d). Removing chunks.\n", request->_key, rc );
+    dbrStripe_remove_chunks( cs, request->_key, &manifest, group );
+  }
+
+  dbrStripe_chain_destroy( ctx, chunks );
+  return rc;
+}
+
+DBR_Errorcode_t dbrStripe_resolve( dbrName_space_t *cs,
+                                   dbBE_Opcode op,
+                                   dbrDA_Request_chain_t *request,
+                                   DBR_Group_t group,
+                                   int flags )
+{
+  char raw[ DBR_STRIPE_MANIFEST_SIZE ];
+  dbrStripe_manifest_t manifest;
+  if(( dbrStripe_gather( request, raw ) != 0 ) || ( dbrStripe_manifest_decode( raw, &manifest ) != 0 ))
+    return DBR_SUCCESS;
+
+  dbrMain_context_t *ctx = cs->_reverse;
+  int64_t limit = dbrStripe_sge_size( request );
+  if( limit > manifest._total )
+    limit = manifest._total;
+
+  if(( limit < manifest._total ) && (( flags & DBR_FLAGS_PARTIAL ) == 0 ))
+  {
+    // the get already took the manifest: put it back in front to keep the value and its position for a retry
+    if( op == DBBE_OPCODE_GET )
+      dbrStripe_restore( cs, request->_key, raw, &manifest, group );
+    *request->_ret_size = manifest._total;
+    return DBR_ERR_UBUFFER;
+  }
+
+  DBR_Errorcode_t rc = DBR_SUCCESS;
+  int64_t found = 0;
+  dbrStripe_chain_t *chunks = dbrStripe_chain_create( ctx, request, &manifest, limit );
+  if( chunks == NULL )
+    rc = DBR_ERR_NOMEMORY;
+  else if( chunks->_count > 0 )
+  {
+    // chunks are complete once the manifest is visible: no need to wait for them
+    // a get only reads them too and removes them once the value is complete
+    // (the last chunk of a partial get may only fit partially)
+    int64_t ret_size = 0;
+    rc = dbrRead_chain( cs, chunks->_head, &ret_size, NULL, group, DBR_FLAGS_NOWAIT | ( flags & DBR_FLAGS_PARTIAL ));
+    if(( rc == DBR_ERR_UBUFFER ) && ( limit < manifest._total ))
+      rc = DBR_SUCCESS;
+
+    int64_t n;
+    for( n = 0; n < chunks->_count; ++n )
+      if( chunks->_ret_sizes[ n ] == dbrStripe_chunk_len( &manifest, n ) )
+        ++found;
+    // missing chunks or chunks of the wrong size
+    if((( rc == DBR_SUCCESS ) || ( rc == DBR_ERR_UBUFFER )) && ( found < chunks->_count ))
+      rc = DBR_ERR_UNAVAIL;
+  }
+  dbrStripe_chain_destroy( ctx, chunks );
+
+  switch( rc )
+  {
+    case DBR_SUCCESS:
+      // the value is consumed: the chunks go with it
+      if(( op == DBBE_OPCODE_GET ) && (( rc = dbrStripe_remove_chunks( cs, request->_key, &manifest, group )) != DBR_SUCCESS ))
+      {
+        LOG( DBG_WARN, stderr, "libdatabroker: failed to remove chunks of striped %s (rc=%d)\n", request->_key, rc );
+      }
+      *request->_ret_size = manifest._total;
+      return ( limit < manifest._total ) ? DBR_ERR_UBUFFER : DBR_SUCCESS;
+
+    case DBR_ERR_UNAVAIL:
+      // a read lost against a get that consumed the value
+      if( op == DBBE_OPCODE_READ )
+        return DBR_ERR_UNAVAIL;
+
+      // chunks are gone (e.g. a concurrent remove): the value can't be restored anymore
+      LOG( DBG_ERR, stderr, "libdatabroker: striped %s is missing chunks (%"PRId64" of %"PRId64" found)\n",
+           request->_key, found, manifest._chunk_count );
+      dbrStripe_remove_chunks( cs, request->_key, &manifest, group );
+      return DBR_ERR_BE_GENERAL;
+
+    default:
+      // the chunks are still complete: keep the value for a retry
+      LOG( DBG_ERR, stderr, "libdatabroker: failed to fetch chunks of striped %s (rc=%d)\n", request->_key, rc );
+      if( op == DBBE_OPCODE_GET )
+        dbrStripe_restore( cs, request->_key, raw, &manifest, group );
+      return rc;
+  }
+}
+
+/*
+ * keys of chunks that were moved, kept for a roll-back
+ */
+typedef struct
+{
+  char *_buf;     ///< '\0'-terminated keys back to back
+  size_t _len;
+  size_t _size;
+  int64_t _count;
+} dbrStripe_names_t;
+
+static
+int dbrStripe_names_add( dbrStripe_names_t *names, const char *name )
+{
+  size_t len = strlen( name ) + 1;
+  if( names->_len + len > names->_size )
+  {
+    size_t size = names->_size ? names->_size * 2 : DBR_STRIPE_SCAN_BATCH * DBR_STRIPE_KEY_MAX;
+    while( size < names->_len + len )
+      size *= 2;
+    char *buf = (char*)realloc( names->_buf, size );
+    if( buf == NULL )
+      return -1;
+    names->_buf = buf;
+    names->_size = size;
+  }
+  memcpy( names->_buf + names->_len, name, len );
+  names->_len += len;
+  ++names->_count;
+  return 0;
+}
+
+/*
+ * split the '\n'-separated directory result into the chunk keys of key
+ * drops duplicates because a scan may return a key more than once
+ * returns the number of keys
+ */
+static
+int dbrStripe_split_names( char *names, const char *key, char **keys )
+{
+  int count = 0;
+  char *save = NULL;
+  char *name;
+  for( name = strtok_r( names, "\n", &save ); name != NULL; name = strtok_r( NULL, "\n", &save ))
+  {
+    if( ! dbrStripe_chunk_match( name, key ))
+      continue;
+    int n;
+    for( n = 0; ( n < count ) && ( strcmp( keys[ n ], name ) != 0 ); ++n ) {}
+    if(( n == count ) && ( count < DBR_STRIPE_SCAN_BATCH ))
+      keys[ count++ ] = name;
+  }
+  return count;
+}
+
+/*
+ * remove (dst_cs == NULL) or move the chunks of all striped values under key
+ * a directory scan finds up to DBR_STRIPE_SCAN_BATCH of them at a time;
+ * repeats until none are left or a batch makes no progress
+ * keys of moved chunks are appended to moved (if not NULL)
+ */
+static
+DBR_Errorcode_t dbrStripe_chunks_apply( dbrName_space_t *cs,
+                                        DBR_Group_t group,
+                                        const char *key,
+                                        dbrName_space_t *dst_cs,
+                                        DBR_Group_t dst_group,
+                                        dbrStripe_names_t *moved )
+{
+  char pattern[ DBR_STRIPE_PATTERN_MAX ];
+  if( dbrStripe_chunk_pattern( pattern, DBR_STRIPE_PATTERN_MAX, key ) != 0 )
+    return DBR_ERR_INVALID;
+
+  // room for a full batch of the longest keys, so no key gets truncated
+  size_t size = DBR_STRIPE_SCAN_BATCH * DBR_STRIPE_KEY_MAX + 1;
+  char *names = (char*)malloc( size );
+  char **keys = (char**)malloc( DBR_STRIPE_SCAN_BATCH * sizeof( char* ) );
+  if(( names == NULL ) || ( keys == NULL ))
+  {
+    free( names );
+    free( keys );
+    return DBR_ERR_NOMEMORY;
+  }
+
+  DBR_Errorcode_t rc = DBR_SUCCESS;
+  int stale = 0;
+  while( rc == DBR_SUCCESS )
+  {
+    int64_t len = 0;
+    names[ 0 ] = '\0';
+    rc = libdbrDirectory( cs, pattern, group, DBR_STRIPE_SCAN_BATCH, names, size - 1, &len );
+    if( rc != DBR_SUCCESS )
+      break;
+    names[ size - 1 ] = '\0';
+
+    int count = dbrStripe_split_names( names, key, keys );
+    if( count == 0 )
+      break;
+
+    rc = dbrStripe_keys_apply( cs, group, keys, count, NULL, dst_cs, dst_group );
+    // chunks that are gone already were taken care of by someone else,
+    // but a scan that keeps returning them would never end
+    if( rc == DBR_ERR_UNAVAIL )
+    {
+      rc = DBR_SUCCESS;
+      if( ++stale > 1 )
+        break;
+    }
+    else
+      stale = 0;
+
+    int n;
+    for( n = 0; ( rc == DBR_SUCCESS ) && ( moved != NULL ) && ( n < count ); ++n )
+      if( dbrStripe_names_add( moved, keys[ n ] ) != 0 )
+        rc = DBR_ERR_NOMEMORY;
+  }
+
+  free( names );
+  free( keys );
+  return rc;
+}
+
+/*
+ * take the value at the front of key with a manifest-sized buffer
+ * a manifest taken this way belongs to the caller, a concurrent get that was first keeps its chunks
+ * returns 1 if the value was a manifest, 0 if it was something else, -1 if nothing was taken
+ */
+static
+int dbrStripe_take_manifest( dbrName_space_t *cs,
+                             DBR_Group_t group,
+                             DBR_Tuple_name_t key,
+                             dbrStripe_manifest_t *manifest )
+{
+  dbrDA_Request_chain_t *element = dbrRequest_chain_alloc( cs->_reverse, 1 );
+  if( element == NULL )
+    return -1;
+
+  char raw[ DBR_STRIPE_MANIFEST_SIZE ];
+  int64_t ret_size = 0;
+  element->_key = key;
+  element->_size = DBR_STRIPE_MANIFEST_SIZE;
+  element->_ret_size = &ret_size;
+  element->_value_sge[ 0 ].iov_base = raw;
+  element->_value_sge[ 0 ].iov_len = DBR_STRIPE_MANIFEST_SIZE;
+
+  DBR_Errorcode_t rc = dbrGet_chain( cs, element, &ret_size, NULL, group, DBR_FLAGS_NOWAIT | DBR_FLAGS_PARTIAL );
+  dbrRequest_chain_release( cs->_reverse, element );
+
+  if(( rc != DBR_SUCCESS ) && ( rc != DBR_ERR_UBUFFER ))
+    return -1;
+  if(( ret_size != DBR_STRIPE_MANIFEST_SIZE ) || ( dbrStripe_manifest_decode( raw, manifest ) != 0 ))
+    return 0;
+  return 1;
+}
+
+DBR_Errorcode_t dbrStripe_remove( dbrName_space_t *cs,
+                                  DBR_Group_t group,
+                                  DBR_Tuple_name_t key,
+                                  DBR_Tuple_template_t match_template )
+{
+  if( key == NULL )
+    return DBR_ERR_INVALID;
+
+  // manifests at the front are taken one at a time and only their chunks are removed (by write id);
+  // the first value that isn't a manifest ends this and the rest of the tuple goes in one remove
+  dbrStripe_manifest_t manifest;
+  int taken = 0;
+  int got;
+  while(( got = dbrStripe_take_manifest( cs, group, key, &manifest )) >= 0 )
+  {
+    ++taken;
+    if( got == 0 )
+      break;
+    DBR_Errorcode_t crc = dbrStripe_remove_chunks( cs, key, &manifest, group );
+    if( crc != DBR_SUCCESS )
+    {
+      LOG( DBG_ERR, stderr, "libdatabroker: failed to remove chunks of %s (rc=%d)\n", key, crc );
+    }
+  }
+
+  DBR_Errorcode_t rc = dbrStripe_keys_apply( cs, group, &key, 1, match_template, NULL, DBR_GROUP_EMPTY );
+  // taking the values may have emptied the tuple already
+  if(( rc == DBR_ERR_UNAVAIL ) && ( taken > 0 ))
+    rc = DBR_SUCCESS;
+  return rc;
+}
+
+DBR_Errorcode_t dbrStripe_remove_orphans( dbrName_space_t *cs,
+                                          DBR_Group_t group,
+                                          DBR_Tuple_name_t key )
+{
+  if( key == NULL )
+    return DBR_ERR_INVALID;
+
+  // chunks of an existing tuple can't be told apart from leftovers
+  DBR_Errorcode_t rc = libdbrTestKey( cs, key, NULL, group );
+  if( rc == DBR_SUCCESS )
+    return DBR_ERR_EXISTS;
+  if( rc != DBR_ERR_UNAVAIL )
+    return rc;
+
+  return dbrStripe_chunks_apply( cs, group, key, NULL, DBR_GROUP_EMPTY, NULL );
+}
+
+DBR_Errorcode_t dbrStripe_move( dbrName_space_t *src_cs,
+                                DBR_Group_t src_group,
+                                DBR_Tuple_name_t key,
+                                DBR_Tuple_template_t match_template,
+                                dbrName_space_t *dst_cs,
+                                DBR_Group_t dst_group )
+{
+  if( key == NULL )
+    return DBR_ERR_INVALID;
+
+  dbrStripe_names_t moved;
+  memset( &moved, 0, sizeof( moved ) );
+
+  // the chunks first: a manifest in the destination always finds its chunks
+  DBR_Errorcode_t rc = dbrStripe_chunks_apply( src_cs, src_group, key, dst_cs, dst_group, &moved );
+  if( rc == DBR_SUCCESS )
+    rc = dbrStripe_keys_apply( src_cs, src_group, &key, 1, match_template, dst_cs, dst_group );
+
+  if(( rc != DBR_SUCCESS ) && ( moved._count > 0 ))
+  {
+    // back to where their manifests still are
+    DBR_Errorcode_t brc = DBR_ERR_NOMEMORY;
+    char **keys = (char**)malloc( moved._count * sizeof( char* ) );
+    if( keys != NULL )
+    {
+      char *name = moved._buf;
+      int64_t n;
+      for( n = 0; n < moved._count; ++n, name += strlen( name ) + 1 )
+        keys[ n ] = name;
+      brc = dbrStripe_keys_apply( dst_cs, dst_group, keys, moved._count, NULL, src_cs, src_group );
+      free( keys );
+    }
+    if( brc != DBR_SUCCESS )
+    {
+      LOG( DBG_ERR, stderr, "libdatabroker: failed to move chunks of %s back after a failed move (rc=%d)\n", key, brc );
+    }
+  }
+
+  free( moved._buf );
+  return rc;
+}
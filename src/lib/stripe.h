@@ -0,0 +1,170 @@
+/*
+ * Copyright © 2018-2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef SRC_LIB_STRIPE_H_
+#define SRC_LIB_STRIPE_H_
+
+#include "libdatabroker.h"
+#include "libdatabroker_int.h"
+
+#include <inttypes.h>
+
+/*
+ * Striped storage of large values
+ *
+ * A value above the configured threshold is split into chunks that are stored
+ * under their own keys (spread across hash slots) and written in parallel.
+ * Only after all chunks are stored, a small manifest is put under the user key.
+ * The manifest is the visibility point: a get/read that finds it knows that
+ * all chunks are complete and reads them in parallel into the user buffer.
+ * A get pops the manifest first, so competing consumers never get the same
+ * chunks and nobody sees a partially written value. The chunks are removed
+ * only after the whole value is copied; if that fails, or the buffer is too
+ * small, the manifest goes back in front of the list.
+ * Values are only recognized as manifests if striping is configured.
+ * Remove takes the manifests at the front of a key and removes their chunks by write id.
+ * Move and the explicit orphan cleanup find the chunks of a key with directory scans.
+ *
+ * Manifest layout (little endian, DBR_STRIPE_MANIFEST_SIZE bytes):
+ *   magic[8] | total | chunk_size | chunk_count | write id | checksum
+ */
+
+#define DBR_STRIPE_MAGIC "DBRSTRP1"
+#define DBR_STRIPE_MAGIC_LEN ( 8 )
+#define DBR_STRIPE_MANIFEST_SIZE ( 48 )
+
+#define DBR_STRIPE_SIZE_DEFAULT ( 16 * 1024 * 1024 )
+#define DBR_STRIPE_SIZE_MIN ( 64 * 1024 )
+#define DBR_STRIPE_MAX_CHUNKS ( 1024 )   ///< larger values get larger chunks
+
+/*
+ * chunk keys are <key>.dbrstripe.<write id>.<chunk index>
+ */
+#define DBR_STRIPE_KEY_INFIX ".dbrstripe."
+#define DBR_STRIPE_KEY_SUFFIX_MAX ( 32 )  ///< infix + 16 hex digits + '.' + index
+#define DBR_STRIPE_KEY_MAX ( DBR_MAX_KEY_LEN + 1 )
+#define DBR_STRIPE_PATTERN_MAX ( 2 * DBR_MAX_KEY_LEN + DBR_STRIPE_KEY_SUFFIX_MAX )  ///< escaped key + infix + '*'
+#define DBR_STRIPE_SCAN_BATCH ( 256 )  ///< chunk keys per directory scan of a move/orphan cleanup
+
+typedef struct
+{
+  int64_t _total;         ///< size of the complete value
+  int64_t _chunk_size;    ///< size of all but the last chunk
+  int64_t _chunk_count;
+  uint64_t _id;           ///< unique id of the write, part of the chunk keys
+} dbrStripe_manifest_t;
+
+/*
+ * request chain covering the chunks of a striped value
+ * keys and returned sizes are owned by the chain
+ */
+typedef struct
+{
+  dbrDA_Request_chain_t *_head;
+  int64_t _count;         ///< number of chain elements (may be fewer than chunks for partial reads)
+  int64_t *_ret_sizes;
+  char *_keys;            ///< _count * DBR_STRIPE_KEY_MAX
+} dbrStripe_chain_t;
+
+
+void dbrStripe_manifest_encode( const dbrStripe_manifest_t *manifest, char *buf );
+/*
+ * returns 0 if buf holds a valid manifest, -1 otherwise
+ */
+int dbrStripe_manifest_decode( const char *buf, dbrStripe_manifest_t *manifest );
+
+/*
+ * fill in size, chunk size and count for a value of total bytes
+ * returns the number of chunks; less than 2 means the value isn't worth striping
+ */
+int64_t dbrStripe_plan( const int64_t total, const int64_t stripe_size, dbrStripe_manifest_t *manifest );
+
+uint64_t dbrStripe_write_id( void );
+int dbrStripe_chunk_key( char *buf, const char *key, const uint64_t id, const int64_t index );
+/*
+ * directory pattern that matches the chunk keys of all striped values under key
+ * returns 0 on success, -1 if buf is too small
+ */
+int dbrStripe_chunk_pattern( char *buf, const size_t size, const char *key );
+/*
+ * returns 1 if name is a chunk key of a striped value under key
+ */
+int dbrStripe_chunk_match( const char *name, const char *key );
+
+/*
+ * build the chain for the chunks of manifest that are covered by the first limit bytes
+ * of the SGEs in request; chunks span SGE boundaries as needed
+ */
+dbrStripe_chain_t* dbrStripe_chain_create( dbrMain_context_t *ctx,
+                                           dbrDA_Request_chain_t *request,
+                                           const dbrStripe_manifest_t *manifest,
+                                           const int64_t limit );
+void dbrStripe_chain_destroy( dbrMain_context_t *ctx, dbrStripe_chain_t *chain );
+
+/*
+ * returns 1 if striping is configured for the name space
+ */
+int dbrStripe_enabled( dbrName_space_t *cs );
+/*
+ * returns 1 if the put of request should be striped
+ */
+int dbrStripe_put_eligible( dbrName_space_t *cs, dbrDA_Request_chain_t *request );
+/*
+ * returns 1 if the value returned for request might be a manifest
+ */
+int dbrStripe_get_candidate( dbrName_space_t *cs, dbrDA_Request_chain_t *request );
+
+DBR_Errorcode_t dbrStripe_put( dbrName_space_t *cs,
+                               dbrDA_Request_chain_t *request,
+                               DBR_Group_t group );
+/*
+ * replace a returned manifest with the striped value it describes
+ * op is DBBE_OPCODE_GET or DBBE_OPCODE_READ; values that aren't manifests are left untouched
+ * works for blocking and completed asynchronous requests alike
+ */
+DBR_Errorcode_t dbrStripe_resolve( dbrName_space_t *cs,
+                                   dbBE_Opcode op,
+                                   dbrDA_Request_chain_t *request,
+                                   DBR_Group_t group,
+                                   int flags );
+
+/*
+ * remove key together with the chunks of the manifests at its front
+ * returns the result of removing the key; failures to remove chunks are only logged
+ */
+DBR_Errorcode_t dbrStripe_remove( dbrName_space_t *cs,
+                                  DBR_Group_t group,
+                                  DBR_Tuple_name_t key,
+                                  DBR_Tuple_template_t match_template );
+/*
+ * remove all chunks under key that are left without a manifest (scans the name space)
+ * returns DBR_ERR_EXISTS if key holds values
+ */
+DBR_Errorcode_t dbrStripe_remove_orphans( dbrName_space_t *cs,
+                                          DBR_Group_t group,
+                                          DBR_Tuple_name_t key );
+/*
+ * move key together with the chunks of all striped values under it
+ */
+DBR_Errorcode_t dbrStripe_move( dbrName_space_t *src_cs,
+                                DBR_Group_t src_group,
+                                DBR_Tuple_name_t key,
+                                DBR_Tuple_template_t match_template,
+                                dbrName_space_t *dst_cs,
+                                DBR_Group_t dst_group );
+
+#endif /* SRC_LIB_STRIPE_H_ */
@@ -0,0 +1,200 @@
+/*
+ * Copyright © 2018-2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef SRC_LIB_TAG_TABLE_H_
+#define SRC_LIB_TAG_TABLE_H_
+
+#include "libdatabroker.h"
+
+#include <stddef.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef DBR_INTTAG
+#error "The tag table requires integer tags (DBR_INTTAG)"
+#endif
+
+/*
+ * Tags identify posted requests in the request table.
+ * A tag combines the index of a table slot (lower DBR_TAG_INDEX_BITS) with the
+ * generation of the slot. The generation is bumped every time a slot is released,
+ * so a stale tag of a completed request never matches the slot after reuse.
+ *
+ * The table grows in chunks of DBR_TAG_CHUNK_SIZE slots as needed. Chunks never
+ * move once allocated, so slot lookup stays O(1) without reallocation of the table.
+ * Free slots are kept in a LIFO list to reuse warm slots first.
+ *
+ * None of these functions are thread-safe, the caller has to hold TAGLOCK.
+ */
+#define DBR_TAG_INDEX_BITS ( 24 )
+#define DBR_TAG_INDEX_MASK ( ( (int64_t)1 << DBR_TAG_INDEX_BITS ) - 1 )
+#define DBR_TAG_GENERATION_MASK ( INT64_MAX >> DBR_TAG_INDEX_BITS )
+#define DBR_TAG_CHUNK_SIZE ( DBR_POSTED_QUEUE_DEPTH )
+#define DBR_TAG_CHUNKS_MAX ( ( DBR_TAG_INDEX_MASK + 1 ) / DBR_TAG_CHUNK_SIZE )
+
+struct dbrRequestContext;
+
+typedef struct dbrTag_slot
+{
+  struct dbrRequestContext *_rctx;  ///< head of the request chain (NULL while the tag is only reserved)
+  int64_t _generation;              ///< generation of the currently or next issued tag
+  int64_t _next_free;               ///< next free slot index (-1: end of list)
+  int _in_use;                      ///< 1 between reserve and release
+} dbrTag_slot_t;
+
+typedef struct dbrTag_table
+{
+  dbrTag_slot_t **_chunks;          ///< DBR_TAG_CHUNKS_MAX chunk pointers, allocated on demand
+  int64_t _size;                    ///< number of available slots (all allocated chunks)
+  int64_t _used;                    ///< number of reserved slots
+  int64_t _free_head;               ///< first free slot (-1: no free slot left)
+} dbrTag_table_t;
+
+
+static inline
+int64_t dbrTag_index( const DBR_Tag_t tag )
+{
+  return tag & DBR_TAG_INDEX_MASK;
+}
+
+static inline
+int64_t dbrTag_generation( const DBR_Tag_t tag )
+{
+  return ( tag >> DBR_TAG_INDEX_BITS ) & DBR_TAG_GENERATION_MASK;
+}
+
+static inline
+dbrTag_slot_t* dbrTag_table_slot( dbrTag_table_t *table, const int64_t idx )
+{
+  return &table->_chunks[ idx / DBR_TAG_CHUNK_SIZE ][ idx % DBR_TAG_CHUNK_SIZE ];
+}
+
+/*
+ * add another chunk of free slots to the table
+ */
+static inline
+int dbrTag_table_grow( dbrTag_table_t *table )
+{
+  int64_t chunk = table->_size / DBR_TAG_CHUNK_SIZE;
+  if( chunk >= DBR_TAG_CHUNKS_MAX )
+    return -ENOSPC;
+
+  dbrTag_slot_t *slots = (dbrTag_slot_t*)calloc( DBR_TAG_CHUNK_SIZE, sizeof( dbrTag_slot_t ) );
+  if( slots == NULL )
+    return -ENOMEM;
+
+  // chain the new slots in index order in front of the free list
+  int64_t n;
+  for( n = 0; n < DBR_TAG_CHUNK_SIZE; ++n )
+    slots[ n ]._next_free = table->_size + n + 1;
+  slots[ DBR_TAG_CHUNK_SIZE - 1 ]._next_free = table->_free_head;
+
+  table->_chunks[ chunk ] = slots;
+  table->_free_head = table->_size;
+  table->_size += DBR_TAG_CHUNK_SIZE;
+  return 0;
+}
+
+static inline
+int dbrTag_table_init( dbrTag_table_t *table )
+{
+  if( table == NULL )
+    return -EINVAL;
+
+  memset( table, 0, sizeof( dbrTag_table_t ) );
+  table->_free_head = -1;
+  table->_chunks = (dbrTag_slot_t**)calloc( DBR_TAG_CHUNKS_MAX, sizeof( dbrTag_slot_t* ) );
+  if( table->_chunks == NULL )
+    return -ENOMEM;
+  return dbrTag_table_grow( table );
+}
+
+static inline
+void dbrTag_table_exit( dbrTag_table_t *table )
+{
+  if(( table == NULL ) || ( table->_chunks == NULL ))
+    return;
+
+  int64_t chunk;
+  for( chunk = 0; chunk < table->_size / DBR_TAG_CHUNK_SIZE; ++chunk )
+    free( table->_chunks[ chunk ] );
+  free( table->_chunks );
+  memset( table, 0, sizeof( dbrTag_table_t ) );
+}
+
+/*
+ * reserve a free slot and return its tag
+ * returns DB_TAG_ERROR if the table can't grow any further
+ */
+static inline
+DBR_Tag_t dbrTag_table_reserve( dbrTag_table_t *table )
+{
+  if(( table->_free_head < 0 ) && ( dbrTag_table_grow( table ) != 0 ))
+    return DB_TAG_ERROR;
+
+  int64_t idx = table->_free_head;
+  dbrTag_slot_t *slot = dbrTag_table_slot( table, idx );
+  table->_free_head = slot->_next_free;
+  slot->_next_free = -1;
+  slot->_in_use = 1;
+  slot->_rctx = NULL;
+  ++table->_used;
+  return ( slot->_generation << DBR_TAG_INDEX_BITS ) | idx;
+}
+
+/*
+ * return the slot of a currently issued tag
+ * returns NULL for malformed, unknown or stale tags
+ */
+static inline
+dbrTag_slot_t* dbrTag_table_lookup( dbrTag_table_t *table, const DBR_Tag_t tag )
+{
+  if( tag < 0 )
+    return NULL;
+
+  int64_t idx = dbrTag_index( tag );
+  if( idx >= table->_size )
+    return NULL;
+
+  dbrTag_slot_t *slot = dbrTag_table_slot( table, idx );
+  if(( ! slot->_in_use ) || ( slot->_generation != dbrTag_generation( tag ) ))
+    return NULL;
+  return slot;
+}
+
+/*
+ * release the slot of a tag, any further use of the tag will be detected as stale
+ */
+static inline
+int dbrTag_table_release( dbrTag_table_t *table, const DBR_Tag_t tag )
+{
+  dbrTag_slot_t *slot = dbrTag_table_lookup( table, tag );
+  if( slot == NULL )
+    return -EINVAL;
+
+  slot->_rctx = NULL;
+  slot->_in_use = 0;
+  slot->_generation = ( slot->_generation + 1 ) & DBR_TAG_GENERATION_MASK;
+  slot->_next_free = table->_free_head;
+  table->_free_head = dbrTag_index( tag );
+  --table->_used;
+  return 0;
+}
+
+#endif /* SRC_LIB_TAG_TABLE_H_ */
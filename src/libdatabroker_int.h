@@ -23,13 +23,14 @@
 
 #include "util/lock_tools.h"
 #include "common/dbbe_api.h"
+#include "common/object_pool.h"
+#include "common/wakeup.h"
 #include "dbrda_api.h"
 #include "lib/backend.h"
+#include "lib/tag_table.h"
 
-#define dbrMAX_TAGS ( DBR_POSTED_QUEUE_DEPTH )
-#define dbrNUM_DB_MAX ( 1024 )
-#define dbrERROR_INDEX ( (uint32_t)-1)
-#define DBR_TMP_BUFFER_LEN ( 128 * 1024 * 1024 )
+#define dbrNS_TABLE_SIZE_MIN ( 64 )  ///< initial number of buckets of the name space table (power of 2)
+#define DBR_POOL_SGE_MAX ( 2 )  ///< requests with up to this many SGEs are recycled through the object pools
 
 
 #include "lib/sge.h"
@@ -66,10 +67,12 @@ typedef enum
  * @brief Internal local representation of a name space
  * @typedef
  */
-typedef struct
+typedef struct dbrName_space
 {
   struct dbrMain_context *_reverse;  ///< something to reverse lookup of several name space data depending on DB_handle_t type definition
-  uint32_t _idx;                     ///< index into name space table
+  uint64_t _hash;                    ///< hash of the name (bucket selection in the name space table)
+  struct dbrName_space *_ns_next;    ///< next entry in the same bucket of the name space table
+  int _in_table;                     ///< 1 while the name space is in the name space table
   int _ref_count;                    ///< local reference counter
   DBR_Name_t _db_name;               ///< name of the name space
   dbrBackend_t *_be_ctx;             ///< back end access context
@@ -77,6 +80,17 @@ typedef struct
   dbrName_space_status_t _status;    ///< status of the name space for local status tracking
 } dbrName_space_t;
 
+/**
+ * name spaces by name: a chained hash table that doubles its
+ * bucket count when the number of entries exceeds the number of buckets
+ */
+typedef struct dbrName_space_table
+{
+  dbrName_space_t **_buckets;        ///< bucket heads (_size entries)
+  uint32_t _size;                    ///< number of buckets (power of 2)
+  uint32_t _count;                   ///< number of name spaces in the table
+} dbrName_space_table_t;
+
 typedef struct
 {
   char id[ DBR_MAX_KEY_LEN ];
@@ -118,14 +132,41 @@ typedef struct dbrRequestContext
   dbrDA_Request_chain_t *_rchain;  ///< actual request chain, potentially modified after plugin call
   dbrDA_Request_chain_t *_ochain;  ///< original request chain from user
   struct dbrRequestContext *_next;
+  struct dbrRequestContext *_head;     ///< first request of the chain
+  DBR_Completion_cb_t _callback;       ///< user completion callback (only set in the head of the chain)
+  void *_cb_context;                   ///< user context for the callback
+  int _cb_armed;                       ///< callback may be invoked (the chain is completely posted)
+  struct dbrRequestContext *_cb_next;  ///< link in the list of requests with pending callbacks
+  int _collecting;                     ///< a thread is finalizing the chain (only set in the head of the chain)
   dbBE_Request_t _req;     ///< dynamic length
 } dbrRequestContext_t;
 
 typedef dbrRequestContext_t* DBR_Request_handle_t;
 
+/**
+ * how a thread waits for the completion of its request in dbrWait_request()
+ */
+typedef enum
+{
+  dbrWAIT_POLICY_SPIN,      ///< keep driving the back-end until completion or timeout (default)
+  dbrWAIT_POLICY_ADAPTIVE,  ///< drive the back-end for a short time, then block with increasing intervals
+  dbrWAIT_POLICY_MAX
+} dbrWait_policy_t;
+
+#define DBR_WAIT_POLICY_DEFAULT ( dbrWAIT_POLICY_SPIN )
+#define DBR_WAIT_SPIN_USEC_DEFAULT ( 50 )    ///< adaptive: time to spin before the first block
+#define DBR_WAIT_BLOCK_USEC_MIN ( 8 )        ///< adaptive: first blocking interval
+#define DBR_WAIT_BLOCK_USEC_MAX ( 1024 )     ///< adaptive: upper limit of the blocking interval (without back-end event fd)
+#define DBR_WAIT_BLOCK_USEC_IDLE ( 1000000 ) ///< adaptive: upper limit of a single block on the back-end event fd
+
 typedef struct dbrConfig
 {
   long int _timeout_sec;
+  dbrWait_policy_t _wait_policy;
+  long int _wait_spin_usec;
+  int _progress_thread;    ///< back-end makes progress in its own thread
+  int64_t _stripe_threshold;  ///< puts of at least this many bytes are striped (0 = off)
+  int64_t _stripe_size;       ///< chunk size of striped values
 } dbrConfig_t;
 
 // global context data
@@ -133,14 +174,25 @@ typedef struct dbrMain_context
 {
   dbrConfig_t _config;                        ///< configuration data
   dbrBackend_t *_be_ctx;                      ///< back-end context/plugin handle
-  dbrName_space_t *_cs_list[dbrNUM_DB_MAX];   ///< CS handles array keeping track of all name spaces locally
-  dbrRequestContext_t *_cs_wq[ dbrMAX_TAGS ]; ///< request queue by tag
-
-  // todo: we'll need an array of head/tail tags to track responses from each node in a cluster
-  uint64_t _tag_head;                     ///< tag for the next request
-  uint64_t _tag_tail;                     ///< tag of the next expected completion
-  pthread_mutex_t _biglock;               ///< initial step to thread-safe lib; starting with big lock in main context
-  void* _tmp_testkey_buf;                 ///< a tmp buffer that holds return values for testkey command
+  dbrName_space_table_t _cs_table;            ///< name spaces known locally by name
+  dbrTag_table_t _tags;                       ///< request table by tag (grows with the number of requests in flight)
+
+  pthread_mutex_t _ns_lock;               ///< protects the name space table (see util/lock_tools.h)
+  pthread_mutex_t _tag_lock;              ///< protects tag allocation and the request table _tags
+  pthread_mutex_t _be_lock;               ///< serializes back-end calls and completion processing
+  pthread_cond_t _cpl_cond;               ///< signalled with _be_lock held when completions got processed
+  int _cpl_waiters;                       ///< number of threads blocked on _cpl_cond (protected by _be_lock)
+  int _fd_waiting;                        ///< 1 while a thread blocks on the back-end event fd (protected by _be_lock)
+  dbBE_Wakeup_t _cpl_wakeup;              ///< ends the wait of that thread when others processed completions
+  dbrRequestContext_t *_cb_ready_head;    ///< completed requests waiting for their callback (protected by _be_lock)
+  dbrRequestContext_t *_cb_ready_tail;
+  pthread_mutex_t _cb_lock;               ///< protects the callback dispatcher state below
+  pthread_cond_t _cb_cond;                ///< signalled when callback requests are posted or the dispatcher stops
+  pthread_t _cb_thread;                   ///< dispatcher thread (only with a back-end progress thread)
+  int _cb_running;                        ///< 1 while the dispatcher thread is active
+  int64_t _cb_outstanding;                ///< posted callback requests whose callback hasn't been invoked yet
+  dbBE_Object_pool_t *_rctx_pool;         ///< recycled request contexts with up to DBR_POOL_SGE_MAX SGEs
+  dbBE_Object_pool_t *_chain_pool;        ///< recycled single-SGE user request chain elements
 #ifdef DBR_DATA_ADAPTERS
   void *_da_library;                        ///< library handle to the data adapter library
   dbrDA_api_t *_data_adapter;               ///< if there's a data adapter library loaded, it's referenced here
@@ -154,10 +206,16 @@ int dbrMain_exit(void);
 //////////////////////////////////////////////////////////////////////
 // local in-mem name space maintenance
 
+int dbrMain_ns_table_init( dbrName_space_table_t *table );
+void dbrMain_ns_table_exit( dbrName_space_table_t *table );
+
 dbrName_space_t* dbrMain_create_local( DBR_Name_t db_name );
 
-uint32_t dbrMain_find( dbrMain_context_t *libctx, DBR_Name_t name );
-uint32_t dbrMain_insert( dbrMain_context_t *libctx, dbrName_space_t *cs );
+/*
+ * find a name space by name (caller holds NSLOCK); NULL if not found
+ */
+dbrName_space_t* dbrMain_find( dbrMain_context_t *libctx, DBR_Name_t name );
+int dbrMain_insert( dbrMain_context_t *libctx, dbrName_space_t *cs );
 int dbrMain_detach( dbrMain_context_t *libctx, dbrName_space_t *cs );
 int dbrMain_delete( dbrMain_context_t *libctx, dbrName_space_t *cs );
 int dbrMain_attach( dbrMain_context_t *libctx, dbrName_space_t *cs );
@@ -165,7 +223,24 @@ int dbrMain_attach( dbrMain_context_t *libctx, dbrName_space_t *cs );
 //////////////////////////////////////////////////////////////////////
 // request creation/posting
 
+/*
+ * reserve a tag for a new request
+ * the tag is released by dbrRemove_request() once the request got inserted
+ * or by dbrTag_release() if the request never made it into the table
+ */
 DBR_Tag_t dbrTag_get( dbrMain_context_t *ctx );
+DBR_Errorcode_t dbrTag_release( dbrMain_context_t *ctx, DBR_Tag_t tag );
+/*
+ * find the request of a tag; NULL for unknown or stale tags or if no request is inserted yet
+ * caller has to hold TAGLOCK
+ */
+dbrRequestContext_t* dbrTag_lookup( dbrMain_context_t *ctx, DBR_Tag_t tag );
+/*
+ * find the request of a tag and claim it for collection by the calling thread
+ * NULL if the lookup fails or another thread claimed it already
+ * caller has to hold TAGLOCK
+ */
+dbrRequestContext_t* dbrTag_claim( dbrMain_context_t *ctx, DBR_Tag_t tag );
 DBR_Errorcode_t dbrValidateTag( dbrRequestContext_t *rctx, DBR_Tag_t req_tag );
 
 dbrRequestContext_t* dbrCreate_request_ctx(dbBE_Opcode op,
@@ -192,12 +267,58 @@ dbrRequestContext_t* dbrCreate_request_chain( dbBE_Opcode op,
                                               DBR_Tag_t tag );
 DBR_Errorcode_t dbrDestroy_request_chain( dbrRequestContext_t *chain );
 
+/*
+ * allocate/release zeroed user request chain elements
+ * single-SGE elements are recycled through the pool of the main context
+ */
+dbrDA_Request_chain_t* dbrRequest_chain_alloc( dbrMain_context_t *ctx, int sge_count );
+void dbrRequest_chain_release( dbrMain_context_t *ctx, dbrDA_Request_chain_t *chain );
+
 DBR_Tag_t dbrInsert_request( dbrName_space_t *cs, dbrRequestContext_t *rctx );
 DBR_Errorcode_t dbrRemove_request( dbrName_space_t *cs, dbrRequestContext_t *rctx );
 DBR_Request_handle_t dbrPost_request_ext( dbrRequestContext_t *rctx, const int with_trigger );
 DBR_Request_handle_t dbrPost_request( dbrRequestContext_t *rctx );
 
 
+/*
+ * blocking put/get/read/remove/move of a request chain without striping
+ * (libdbrPut/libdbrGet/libdbrRead/libdbrRemove/libdbrMove add striping of large values on top)
+ * all elements of a chain are in flight at the same time
+ */
+DBR_Errorcode_t dbrPut_chain( dbrName_space_t *cs,
+                              dbrDA_Request_chain_t *request,
+                              DBR_Group_t group );
+/*
+ * flags: DBBE_OPCODE_FLAGS_HEAD puts the values in front of existing ones
+ */
+DBR_Errorcode_t dbrPut_chain_ext( dbrName_space_t *cs,
+                                  dbrDA_Request_chain_t *request,
+                                  DBR_Group_t group,
+                                  int flags );
+DBR_Errorcode_t dbrGet_chain( dbrName_space_t *cs,
+                              dbrDA_Request_chain_t *request,
+                              int64_t *ret_size,
+                              DBR_Tuple_template_t match_template,
+                              DBR_Group_t group,
+                              int flags );
+DBR_Errorcode_t dbrRead_chain( dbrName_space_t *cs,
+                               dbrDA_Request_chain_t *request,
+                               int64_t *ret_size,
+                               DBR_Tuple_template_t match_template,
+                               DBR_Group_t group,
+                               int flags );
+DBR_Errorcode_t dbrRemove_chain( dbrName_space_t *cs,
+                                 dbrDA_Request_chain_t *request,
+                                 DBR_Tuple_template_t match_template,
+                                 DBR_Group_t group );
+DBR_Errorcode_t dbrMove_chain( dbrName_space_t *src_cs,
+                               DBR_Group_t src_group,
+                               dbrDA_Request_chain_t *request,
+                               DBR_Tuple_template_t match_template,
+                               dbrName_space_t *dst_cs,
+                               DBR_Group_t dst_group );
+
+
 //////////////////////////////////////////////////////////////////////
 // request tracking/completion
 
@@ -207,6 +328,62 @@ DBR_Errorcode_t dbrTest_request( dbrName_space_t *cs, DBR_Request_handle_t hdl )
 DBR_Errorcode_t dbrWait_request( dbrName_space_t *cs,
                                  DBR_Request_handle_t hdl,
                                  int enable_timeout );
+int dbrDrain_completions( dbrMain_context_t *ctx );
+DBR_Errorcode_t dbrCollect_request( dbrRequestContext_t *rctx );
+
+//////////////////////////////////////////////////////////////////////
+// completion callbacks
+
+/*
+ * attach a callback to a request chain before it's inserted and posted
+ * starts the dispatcher thread if the back-end has its own progress thread
+ */
+DBR_Errorcode_t dbrCallback_register( dbrRequestContext_t *head,
+                                      DBR_Completion_cb_t callback,
+                                      void *context );
+/*
+ * undo the registration if the request couldn't be posted
+ */
+void dbrCallback_release( dbrRequestContext_t *head );
+/*
+ * allow the callback to be invoked once the chain is completely posted
+ */
+void dbrCallback_arm( dbrRequestContext_t *head );
+/*
+ * queue the request chain for its callback if it's complete (caller holds the backend lock)
+ */
+void dbrCallback_queue( dbrRequestContext_t *rctx );
+/*
+ * finalize queued requests and invoke their callbacks (no lock must be held)
+ * returns the number of invoked callbacks
+ */
+int dbrCallback_dispatch( dbrMain_context_t *ctx );
+/*
+ * stop the dispatcher thread if running
+ */
+int dbrCallback_stop( dbrMain_context_t *ctx );
+
+/**
+ * state of a thread waiting for completions according to the configured wait policy
+ */
+typedef struct dbrWait_state
+{
+  dbrMain_context_t *_ctx;
+  int _enable_timeout;
+  int _adaptive;
+  uint64_t _loops;        ///< polling loops since the last clock check
+  int64_t _deadline;      ///< monotonic time in usec when the wait times out (0: not started)
+  int64_t _spin_until;    ///< end of the spin period (0: not started)
+  int64_t _block_usec;    ///< current backoff interval if the back-end has no event fd (0: still spinning)
+} dbrWait_state_t;
+
+void dbrWait_init( dbrWait_state_t *ws, dbrMain_context_t *ctx, int enable_timeout );
+void dbrWait_reset( dbrWait_state_t *ws );
+/*
+ * to be called after an attempt to make progress didn't complete what the caller waits for
+ * returns 1 if the timeout expired
+ */
+int dbrWait_idle( dbrWait_state_t *ws, dbrRequestContext_t *rctx );
 
 
 #endif /* SRC_LIBDATABROKER_INT_H_ */
@@ -59,6 +59,19 @@ libdbrRemoveUnits( DBR_Handle_t cs_handle,
  * data broker data access functions to insert and retrieve data items
  */
 
+/*
+ * allocate/release zeroed request chain elements with sge_count SGEs
+ * single-SGE elements are recycled by the library
+ * chains that were handed to an async call are released by the library
+ */
+dbrDA_Request_chain_t*
+libdbrRequest_chain_alloc( DBR_Handle_t cs_handle,
+                           int sge_count );
+
+void
+libdbrRequest_chain_release( DBR_Handle_t cs_handle,
+                             dbrDA_Request_chain_t *chain );
+
 DBR_Errorcode_t
 libdbrPut( DBR_Handle_t cs_handle,
            dbrDA_Request_chain_t *request,
@@ -67,7 +80,9 @@ libdbrPut( DBR_Handle_t cs_handle,
 DBR_Tag_t
 libdbrPutA( DBR_Handle_t cs_handle,
             dbrDA_Request_chain_t *request,
-            DBR_Group_t group );
+            DBR_Group_t group,
+            DBR_Completion_cb_t callback,
+            void *cb_context );
 
 DBR_Errorcode_t
 libdbrGet( DBR_Handle_t cs_handle,
@@ -83,7 +98,9 @@ libdbrGetA(DBR_Handle_t cs_handle,
            DBR_Tuple_template_t match_template,
            DBR_Group_t group,
            int flags,
-           int64_t *ret_size );
+           int64_t *ret_size,
+           DBR_Completion_cb_t callback,
+           void *cb_context );
 
 DBR_Errorcode_t
 libdbrRead( DBR_Handle_t cs_handle,
@@ -99,7 +116,9 @@ libdbrReadA(DBR_Handle_t cs_handle,
             DBR_Tuple_template_t match_template,
             DBR_Group_t group,
             int flags,
-            int64_t *ret_size );
+            int64_t *ret_size,
+            DBR_Completion_cb_t callback,
+            void *cb_context );
 
 DBR_Errorcode_t
 libdbrTestKey( DBR_Handle_t cs_handle,
@@ -121,6 +140,11 @@ libdbrRemove( DBR_Handle_t cs_handle,
               DBR_Tuple_name_t tuple_name,
               DBR_Tuple_template_t match_template );
 
+DBR_Errorcode_t
+libdbrRemoveOrphans( DBR_Handle_t cs_handle,
+                     DBR_Group_t group,
+                     DBR_Tuple_name_t tuple_name );
+
 DBR_Errorcode_t
 libdbrDirectory( DBR_Handle_t cs_handle,
                  DBR_Tuple_template_t match_template,
@@ -148,5 +172,25 @@ libdbrTest( DBR_Tag_t req_tag );
 DBR_Errorcode_t
 libdbrCancel( DBR_Tag_t req_tag );
 
+DBR_Errorcode_t
+libdbrTestSome( DBR_Tag_t *tags,
+                const int count,
+                DBR_Errorcode_t *results,
+                int *completed );
+
+DBR_Errorcode_t
+libdbrWaitAny( DBR_Tag_t *tags,
+               const int count,
+               DBR_Errorcode_t *results,
+               int *completed );
+
+DBR_Errorcode_t
+libdbrWaitAll( DBR_Tag_t *tags,
+               const int count,
+               DBR_Errorcode_t *results );
+
+DBR_Errorcode_t
+libdbrProgress( int *completed );
+
 
 #endif /* SRC_LIBDBRAPI_H_ */
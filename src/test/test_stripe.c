@@ -0,0 +1,278 @@
+/*
+ * Copyright © 2018-2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#ifdef __APPLE__
+#include <stdlib.h>
+#else
+#include <malloc.h>
+#endif
+#include <string.h>
+
+#include "libdatabroker.h"
+#include "../libdatabroker_int.h"
+#include "../lib/stripe.h"
+#include "../../test/test_utils.h"
+
+#define TEST_STRIPE_CHUNK ( 1000 )
+
+
+int Manifest_test()
+{
+  int rc = 0;
+  dbrStripe_manifest_t m, d;
+  char raw[ DBR_STRIPE_MANIFEST_SIZE ];
+
+  rc += TEST( dbrStripe_plan( 0, TEST_STRIPE_CHUNK, &m ), 0 );
+  rc += TEST( dbrStripe_plan( 100, 0, &m ), 0 );
+  rc += TEST( dbrStripe_plan( TEST_STRIPE_CHUNK, TEST_STRIPE_CHUNK, &m ), 1 );
+
+  rc += TEST( dbrStripe_plan( 2 * TEST_STRIPE_CHUNK + 1, TEST_STRIPE_CHUNK, &m ), 3 );
+  rc += TEST( m._chunk_size, TEST_STRIPE_CHUNK );
+  rc += TEST( m._total, 2 * TEST_STRIPE_CHUNK + 1 );
+
+  // too many chunks: the chunk size grows instead
+  int64_t total = (int64_t)DBR_STRIPE_MAX_CHUNKS * 10 * TEST_STRIPE_CHUNK + 7;
+  int64_t count = dbrStripe_plan( total, TEST_STRIPE_CHUNK, &m );
+  rc += TEST_NOT( count > DBR_STRIPE_MAX_CHUNKS, 1 );
+  rc += TEST_NOT( m._chunk_size * count < total, 1 );
+  rc += TEST_NOT( m._chunk_size * ( count - 1 ) >= total, 1 );
+
+  // encode/decode round trip
+  m._id = 0x0123456789abcdefull;
+  dbrStripe_manifest_encode( &m, raw );
+  rc += TEST( memcmp( raw, DBR_STRIPE_MAGIC, DBR_STRIPE_MAGIC_LEN ), 0 );
+  rc += TEST( dbrStripe_manifest_decode( raw, &d ), 0 );
+  rc += TEST( d._total, m._total );
+  rc += TEST( d._chunk_size, m._chunk_size );
+  rc += TEST( d._chunk_count, m._chunk_count );
+  rc += TEST( d._id, m._id );
+
+  // any modification invalidates it
+  int n;
+  for( n = 0; n < DBR_STRIPE_MANIFEST_SIZE; ++n )
+  {
+    raw[ n ] ^= 0x10;
+    rc += TEST( dbrStripe_manifest_decode( raw, &d ), -1 );
+    raw[ n ] ^= 0x10;
+  }
+
+  // inconsistent content with a valid checksum
+  m._chunk_count = 1;
+  dbrStripe_manifest_encode( &m, raw );
+  rc += TEST( dbrStripe_manifest_decode( raw, &d ), -1 );
+
+  memset( raw, 0, DBR_STRIPE_MANIFEST_SIZE );
+  rc += TEST( dbrStripe_manifest_decode( raw, &d ), -1 );
+  rc += TEST( dbrStripe_manifest_decode( NULL, &d ), -1 );
+
+  LOG( DBG_INFO, stdout, "Manifest test: rc=%d\n", rc );
+  return rc;
+}
+
+int Key_test()
+{
+  int rc = 0;
+  char key[ DBR_STRIPE_KEY_MAX ];
+
+  rc += TEST( dbrStripe_chunk_key( key, "tuple", 0xabcull, 12 ), 0 );
+  rc += TEST( strcmp( key, "tuple.dbrstripe.0000000000000abc.12" ), 0 );
+
+  // the suffix limit covers the longest suffix
+  rc += TEST_NOT( strlen( key ) - strlen( "tuple" ) > DBR_STRIPE_KEY_SUFFIX_MAX, 1 );
+
+  char long_key[ DBR_MAX_KEY_LEN + 1 ];
+  memset( long_key, 'k', DBR_MAX_KEY_LEN );
+  long_key[ DBR_MAX_KEY_LEN ] = '\0';
+  rc += TEST( dbrStripe_chunk_key( key, long_key, 1, 1 ), -1 );
+
+  // write ids don't repeat
+  uint64_t ids[ 64 ];
+  int n, m;
+  for( n = 0; n < 64; ++n )
+  {
+    ids[ n ] = dbrStripe_write_id();
+    for( m = 0; m < n; ++m )
+      rc += TEST_NOT( ids[ n ], ids[ m ] );
+  }
+
+  LOG( DBG_INFO, stdout, "Key test: rc=%d\n", rc );
+  return rc;
+}
+
+int Pattern_test()
+{
+  int rc = 0;
+  char pattern[ DBR_STRIPE_PATTERN_MAX ];
+
+  rc += TEST( dbrStripe_chunk_pattern( pattern, DBR_STRIPE_PATTERN_MAX, "tuple" ), 0 );
+  rc += TEST( strcmp( pattern, "tuple.dbrstripe.*" ), 0 );
+
+  // glob characters are escaped
+  rc += TEST( dbrStripe_chunk_pattern( pattern, DBR_STRIPE_PATTERN_MAX, "a*b?[c]\\" ), 0 );
+  rc += TEST( strcmp( pattern, "a\\*b\\?\\[c\\]\\\\.dbrstripe.*" ), 0 );
+  rc += TEST( dbrStripe_chunk_pattern( pattern, 8, "tuple" ), -1 );
+
+  char key[ DBR_STRIPE_KEY_MAX ];
+  rc += TEST( dbrStripe_chunk_key( key, "tuple", 0xabcull, 12 ), 0 );
+  rc += TEST( dbrStripe_chunk_match( key, "tuple" ), 1 );
+  rc += TEST( dbrStripe_chunk_match( key, "tupl" ), 0 );
+  rc += TEST( dbrStripe_chunk_match( "tuple", "tuple" ), 0 );
+  rc += TEST( dbrStripe_chunk_match( "tuple.dbrstripe.0000000000000abc.", "tuple" ), 0 );
+  rc += TEST( dbrStripe_chunk_match( "tuple.dbrstripe.0000000000000abc.1x", "tuple" ), 0 );
+  rc += TEST( dbrStripe_chunk_match( "tuple.dbrstripe.abc.1", "tuple" ), 0 );
+
+  // chunks of another key that happens to match the pattern
+  rc += TEST( dbrStripe_chunk_key( key, "tuple.dbrstripe.x", 0xabcull, 1 ), 0 );
+  rc += TEST( dbrStripe_chunk_match( key, "tuple" ), 0 );
+  rc += TEST( dbrStripe_chunk_match( key, "tuple.dbrstripe.x" ), 1 );
+
+  LOG( DBG_INFO, stdout, "Pattern test: rc=%d\n", rc );
+  return rc;
+}
+
+int Candidate_test()
+{
+  int rc = 0;
+  dbrMain_context_t *ctx = (dbrMain_context_t*)calloc( 1, sizeof( dbrMain_context_t ) );
+  rc += TEST_NOT( ctx, NULL );
+  TEST_BREAK( rc, "Failed to allocate context\n" );
+
+  dbrName_space_t cs;
+  memset( &cs, 0, sizeof( cs ) );
+  cs._reverse = ctx;
+
+  dbrDA_Request_chain_t *request = dbrRequest_chain_alloc( NULL, 1 );
+  rc += TEST_NOT( request, NULL );
+  TEST_BREAK( rc, "Failed to allocate request\n" );
+  int64_t size = DBR_STRIPE_MANIFEST_SIZE;
+  request->_key = "value";
+  request->_ret_size = &size;
+
+  // values are never taken for manifests without striping configured
+  rc += TEST( dbrStripe_enabled( &cs ), 0 );
+  rc += TEST( dbrStripe_get_candidate( &cs, request ), 0 );
+
+  ctx->_config._stripe_threshold = DBR_STRIPE_SIZE_MIN;
+  rc += TEST( dbrStripe_enabled( &cs ), 1 );
+  rc += TEST( dbrStripe_get_candidate( &cs, request ), 1 );
+  size = DBR_STRIPE_MANIFEST_SIZE + 1;
+  rc += TEST( dbrStripe_get_candidate( &cs, request ), 0 );
+
+  dbrRequest_chain_release( NULL, request );
+  free( ctx );
+
+  LOG( DBG_INFO, stdout, "Candidate test: rc=%d\n", rc );
+  return rc;
+}
+
+int Chain_test()
+{
+  int rc = 0;
+  dbrStripe_manifest_t m;
+
+  // 3 user SGEs of 700, 1500, 301 bytes -> 2501 bytes in chunks of 1000
+  static const size_t sge_len[] = { 700, 1500, 301 };
+  char *data = (char*)malloc( 2501 );
+  rc += TEST_NOT( data, NULL );
+  TEST_BREAK( rc, "Failed to allocate data\n" );
+
+  dbrDA_Request_chain_t *request = dbrRequest_chain_alloc( NULL, 3 );
+  rc += TEST_NOT( request, NULL );
+  TEST_BREAK( rc, "Failed to allocate request\n" );
+  request->_key = "value";
+  size_t offset = 0;
+  int n;
+  for( n = 0; n < 3; ++n )
+  {
+    request->_value_sge[ n ].iov_base = data + offset;
+    request->_value_sge[ n ].iov_len = sge_len[ n ];
+    offset += sge_len[ n ];
+  }
+
+  rc += TEST( dbrStripe_plan( 2501, TEST_STRIPE_CHUNK, &m ), 3 );
+  m._id = 42;
+
+  rc += TEST( dbrStripe_chain_create( NULL, NULL, &m, 2501 ), NULL );
+  rc += TEST( dbrStripe_chain_create( NULL, request, &m, -1 ), NULL );
+
+  dbrStripe_chain_t *chain = dbrStripe_chain_create( NULL, request, &m, 2501 );
+  rc += TEST_NOT( chain, NULL );
+  TEST_BREAK( rc, "Failed to create chain\n" );
+  rc += TEST( chain->_count, 3 );
+
+  // chunk 0: 700 + 300; chunk 1: 1000 from the second SGE; chunk 2: 200 + 301
+  dbrDA_Request_chain_t *c = chain->_head;
+  rc += TEST( c->_sge_count, 2 );
+  rc += TEST( c->_size, 1000 );
+  rc += TEST( c->_value_sge[ 0 ].iov_base, data );
+  rc += TEST( c->_value_sge[ 0 ].iov_len, 700 );
+  rc += TEST( c->_value_sge[ 1 ].iov_base, data + 700 );
+  rc += TEST( c->_value_sge[ 1 ].iov_len, 300 );
+  rc += TEST( strcmp( c->_key, "value.dbrstripe.000000000000002a.0" ), 0 );
+  rc += TEST( c->_ret_size, &chain->_ret_sizes[ 0 ] );
+
+  c = c->_next;
+  rc += TEST( c->_sge_count, 1 );
+  rc += TEST( c->_value_sge[ 0 ].iov_base, data + 1000 );
+  rc += TEST( c->_value_sge[ 0 ].iov_len, 1000 );
+
+  c = c->_next;
+  rc += TEST( c->_sge_count, 2 );
+  rc += TEST( c->_size, 501 );
+  rc += TEST( c->_value_sge[ 0 ].iov_base, data + 2000 );
+  rc += TEST( c->_value_sge[ 0 ].iov_len, 200 );
+  rc += TEST( c->_value_sge[ 1 ].iov_base, data + 2200 );
+  rc += TEST( c->_value_sge[ 1 ].iov_len, 301 );
+  rc += TEST( strcmp( c->_key, "value.dbrstripe.000000000000002a.2" ), 0 );
+  rc += TEST( c->_next, NULL );
+  dbrStripe_chain_destroy( NULL, chain );
+
+  // partial: only chunks covered by the limit, the last one truncated
+  chain = dbrStripe_chain_create( NULL, request, &m, 1200 );
+  rc += TEST_NOT( chain, NULL );
+  TEST_BREAK( rc, "Failed to create partial chain\n" );
+  rc += TEST( chain->_count, 2 );
+  rc += TEST( chain->_head->_next->_size, 200 );
+  rc += TEST( chain->_head->_next->_next, NULL );
+  dbrStripe_chain_destroy( NULL, chain );
+
+  // SGEs shorter than the limit
+  request->_value_sge[ 2 ].iov_len = 100;
+  rc += TEST( dbrStripe_chain_create( NULL, request, &m, 2501 ), NULL );
+
+  dbrRequest_chain_release( NULL, request );
+  free( data );
+
+  LOG( DBG_INFO, stdout, "Chain test: rc=%d\n", rc );
+  return rc;
+}
+
+int main( int argc, char ** argv )
+{
+  int rc = 0;
+
+  rc += Manifest_test();
+  rc += Key_test();
+  rc += Pattern_test();
+  rc += Candidate_test();
+  rc += Chain_test();
+
+  printf( "Test exiting with rc=%d\n", rc );
+  return rc;
+}
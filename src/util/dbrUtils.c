@@ -21,6 +21,7 @@
 
 #include "lib/sge.h"
 #include "lib/backend.h"
+#include "lib/stripe.h"
 
 #ifdef __APPLE__
 #include <stdlib.h>
@@ -33,6 +34,7 @@
 #include <limits.h>
 #include <stdio.h>
 #include <pthread.h>
+#include <time.h>
 #include <dlfcn.h>
 
 static dbrMain_context_t *gMain_context = NULL;
@@ -64,13 +66,60 @@ dbrMain_context_t* dbrCheckCreateMainCTX(void)
     if( gMain_context->_config._timeout_sec == 0 )
       gMain_context->_config._timeout_sec = INT_MAX;
 
-    gMain_context->_tmp_testkey_buf = malloc( DBR_TMP_BUFFER_LEN );
-    if( gMain_context->_tmp_testkey_buf == NULL )
+    gMain_context->_config._wait_policy = DBR_WAIT_POLICY_DEFAULT;
+    to_str = getenv(DBR_WAIT_POLICY_ENV);
+    if( to_str != NULL )
     {
-      LOG( DBG_ERR, stderr, "libdatabroker: failed to allocate tmp key buffer.\n" );
-      free( gMain_context );
-      gMain_context = NULL;
+      if( strcmp( to_str, "adaptive" ) == 0 )
+        gMain_context->_config._wait_policy = dbrWAIT_POLICY_ADAPTIVE;
+      else if( strcmp( to_str, "spin" ) == 0 )
+        gMain_context->_config._wait_policy = dbrWAIT_POLICY_SPIN;
+      else
+        LOG( DBG_ERR, stderr, "libdatabroker: unknown wait policy '%s'. Using default.\n", to_str );
+    }
+
+    gMain_context->_config._wait_spin_usec = DBR_WAIT_SPIN_USEC_DEFAULT;
+    to_str = getenv(DBR_WAIT_SPIN_ENV);
+    if( to_str != NULL )
+    {
+      long int spin = strtol( to_str, NULL, 10 );
+      if(( spin >= 0 ) && ( spin != LONG_MAX ))
+        gMain_context->_config._wait_spin_usec = spin;
+    }
+
+    to_str = getenv(DBR_PROGRESS_THREAD_ENV);
+    gMain_context->_config._progress_thread = (( to_str != NULL ) && ( strtol( to_str, NULL, 10 ) != 0 ));
+
+    to_str = getenv(DBR_STRIPE_THRESHOLD_ENV);
+    if( to_str != NULL )
+    {
+      long long threshold = strtoll( to_str, NULL, 10 );
+      if(( threshold > 0 ) && ( threshold != LLONG_MAX ))
+        gMain_context->_config._stripe_threshold = threshold;
+    }
+
+    gMain_context->_config._stripe_size = DBR_STRIPE_SIZE_DEFAULT;
+    to_str = getenv(DBR_STRIPE_SIZE_ENV);
+    if( to_str != NULL )
+    {
+      long long stripe_size = strtoll( to_str, NULL, 10 );
+      if(( stripe_size > 0 ) && ( stripe_size != LLONG_MAX ))
+        gMain_context->_config._stripe_size = ( stripe_size < DBR_STRIPE_SIZE_MIN ) ? DBR_STRIPE_SIZE_MIN : stripe_size;
+    }
+
+    if( dbrTag_table_init( &gMain_context->_tags ) != 0 )
+    {
+      LOG( DBG_ERR, stderr, "libdatabroker: failed to allocate request table.\n" );
       pthread_mutex_unlock( &gMain_creation_lock );
+      dbrMain_exit();
+      return NULL;
+    }
+
+    if( dbrMain_ns_table_init( &gMain_context->_cs_table ) != 0 )
+    {
+      LOG( DBG_ERR, stderr, "libdatabroker: failed to allocate namespace table.\n" );
+      pthread_mutex_unlock( &gMain_creation_lock );
+      dbrMain_exit();
       return NULL;
     }
 
@@ -108,7 +157,31 @@ dbrMain_context_t* dbrCheckCreateMainCTX(void)
       }
     }
 #endif
-    pthread_mutex_init( &gMain_context->_biglock, NULL );
+    pthread_mutex_init( &gMain_context->_ns_lock, NULL );
+    pthread_mutex_init( &gMain_context->_tag_lock, NULL );
+    pthread_mutex_init( &gMain_context->_be_lock, NULL );
+
+    // completion waits use relative deadlines on the monotonic clock
+    pthread_condattr_t cattr;
+    pthread_condattr_init( &cattr );
+#ifndef __APPLE__
+    pthread_condattr_setclock( &cattr, CLOCK_MONOTONIC );
+#endif
+    pthread_cond_init( &gMain_context->_cpl_cond, &cattr );
+    pthread_condattr_destroy( &cattr );
+    if( dbBE_Wakeup_init( &gMain_context->_cpl_wakeup ) != 0 )
+    {
+      LOG( DBG_WARN, stderr, "libdatabroker: no wake-up fd, blocking waits use bounded intervals\n" );
+    }
+
+    pthread_mutex_init( &gMain_context->_cb_lock, NULL );
+    pthread_cond_init( &gMain_context->_cb_cond, NULL );
+
+    // pools are optional, allocations fall back to the heap if they are missing
+    gMain_context->_rctx_pool = dbBE_Object_pool_create( sizeof( dbrRequestContext_t ) + DBR_POOL_SGE_MAX * sizeof( dbBE_sge_t ),
+                                                         DBR_POSTED_QUEUE_DEPTH );
+    gMain_context->_chain_pool = dbBE_Object_pool_create( sizeof( dbrDA_Request_chain_t ) + sizeof( dbBE_sge_t ),
+                                                          DBR_POSTED_QUEUE_DEPTH );
   }
 
   pthread_mutex_unlock( &gMain_creation_lock );
@@ -124,16 +197,9 @@ int dbrMain_exit(void)
     return 0;
   }
 
+  dbrCallback_stop( gMain_context );
   int rc = dbrlib_backend_delete( gMain_context->_be_ctx );
 
-  if( gMain_context->_tmp_testkey_buf != NULL )
-  {
-    LOG( DBG_VERBOSE, stdout, "Cleaning up temporary buffer\n");
-    memset( gMain_context->_tmp_testkey_buf, 0, DBR_TMP_BUFFER_LEN );
-    free( gMain_context->_tmp_testkey_buf );
-    gMain_context->_tmp_testkey_buf = NULL;
-  }
-
 #ifdef DBR_DATA_ADAPTERS
   if( gMain_context->_da_library != NULL )
   {
@@ -142,7 +208,21 @@ int dbrMain_exit(void)
   }
 #endif
 
-  pthread_mutex_destroy( &gMain_context->_biglock );
+  dbrTag_table_exit( &gMain_context->_tags );
+  dbrMain_ns_table_exit( &gMain_context->_cs_table );
+
+  if( gMain_context->_rctx_pool != NULL )
+    dbBE_Object_pool_destroy( gMain_context->_rctx_pool );
+  if( gMain_context->_chain_pool != NULL )
+    dbBE_Object_pool_destroy( gMain_context->_chain_pool );
+
+  pthread_cond_destroy( &gMain_context->_cb_cond );
+  pthread_mutex_destroy( &gMain_context->_cb_lock );
+  pthread_cond_destroy( &gMain_context->_cpl_cond );
+  dbBE_Wakeup_exit( &gMain_context->_cpl_wakeup );
+  pthread_mutex_destroy( &gMain_context->_be_lock );
+  pthread_mutex_destroy( &gMain_context->_tag_lock );
+  pthread_mutex_destroy( &gMain_context->_ns_lock );
   memset( gMain_context, 0, sizeof( dbrMain_context_t ) );
   free( gMain_context );
   gMain_context = NULL;
@@ -157,58 +237,53 @@ DBR_Tag_t dbrTag_get( dbrMain_context_t *ctx )
   if( ctx == NULL )
     return DB_TAG_ERROR;
 
-  typeof(ctx->_tag_head) t = ctx->_tag_head;
-
-  // hop through the work entries to check for available tags
-  while( ctx->_cs_wq[ t ] != NULL )
-  {
-    // while we're at it: clean up any closed request entries
-    // !! make sure the whole chain is in closed state !!
+  TAGLOCK_LOCK( ctx );
+  DBR_Tag_t tag = dbrTag_table_reserve( &ctx->_tags );
+  TAGLOCK_UNLOCK( ctx );
 
-    dbrRequestContext_t *rctx = ctx->_cs_wq[ t ];
-    dbrRequest_status_t st = rctx->_status;
-    while(( st == dbrSTATUS_CLOSED ) && ( rctx->_next != NULL ))
-    {
-      rctx = rctx->_next;
-      st = rctx->_status;
-    }
+  if( tag == DB_TAG_ERROR )
+    LOG( DBG_ERR, stderr, "No more tags available for async op\n" );
+  return tag;
+}
 
-    if( st == dbrSTATUS_CLOSED )
-    {
-      dbrRequestContext_t *r = ctx->_cs_wq[ t ];
-      memset( r, 0, sizeof( dbrRequestContext_t ) + r->_req._sge_count * sizeof(dbBE_sge_t) );
-      free( r );
-      ctx->_cs_wq[ t ] = NULL;
-      break;
-    }
+DBR_Errorcode_t dbrTag_release( dbrMain_context_t *ctx, DBR_Tag_t tag )
+{
+  if(( ctx == NULL ) || ( tag == DB_TAG_ERROR ))
+    return DBR_ERR_INVALID;
 
-    t = ( t + 1 ) % dbrMAX_TAGS;
-    if( t == ctx->_tag_head )
-    {
-      LOG( DBG_ERR, stderr, "No more tags available for async op\n" );
-      return DB_TAG_ERROR;
-    }
-  }
+  DBR_Errorcode_t rc = DBR_SUCCESS;
+  TAGLOCK_LOCK( ctx );
+  dbrTag_slot_t *slot = dbrTag_table_lookup( &ctx->_tags, tag );
+  // tags with an inserted request are released by dbrRemove_request()
+  if(( slot == NULL ) || ( slot->_rctx != NULL ))
+    rc = DBR_ERR_TAGERROR;
+  else
+    dbrTag_table_release( &ctx->_tags, tag );
+  TAGLOCK_UNLOCK( ctx );
+  return rc;
+}
 
-  ctx->_tag_head = ( t + 1 ) % dbrMAX_TAGS;
+dbrRequestContext_t* dbrTag_lookup( dbrMain_context_t *ctx, DBR_Tag_t tag )
+{
+  dbrTag_slot_t *slot = dbrTag_table_lookup( &ctx->_tags, tag );
+  if( slot == NULL )
+    return NULL;
+  return slot->_rctx;
+}
 
-#ifdef DBR_INTTAG
-//  LOG( DBG_INFO, stdout, "Returning Tag: %d\n", t );
-  return (DBR_Tag_t)t;
-#else
-  // needs to point into the array!
-  // -> otherwise there is no index calculation afterwards
-  return (DBR_Tag_t)&ctx->_cs_wq[ t ];
-#endif
+dbrRequestContext_t* dbrTag_claim( dbrMain_context_t *ctx, DBR_Tag_t tag )
+{
+  dbrRequestContext_t *rctx = dbrTag_lookup( ctx, tag );
+  if(( rctx == NULL ) || ( rctx->_collecting ))
+    return NULL;
+  rctx->_collecting = 1;
+  return rctx;
 }
 
 DBR_Errorcode_t dbrValidateTag( dbrRequestContext_t *rctx, DBR_Tag_t req_tag )
 {
-#ifdef DBR_INTTAG
-  if(( req_tag >= 0 ) && ( req_tag < dbrMAX_TAGS ))
-#else
-  if(( req_tag != NULL ) && ( req_tag != DB_TAG_ERROR ))
-#endif
+  // only checks the format; whether the tag is current is checked by the table lookup
+  if( req_tag >= 0 )
     return DBR_SUCCESS;
   else
     return DBR_ERR_TAGERROR;
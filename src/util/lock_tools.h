@@ -19,11 +19,35 @@
 #define SRC_UTIL_LOCK_TOOLS_H_
 
 
-#define BIGLOCK_LOCK( ctx ) pthread_mutex_lock( &(ctx)->_biglock )
+/*
+ * The main context is protected by a set of independent locks with short
+ * critical sections instead of a single library-wide lock:
+ *   - NSLOCK:  name space table (create/attach/detach/delete of name spaces)
+ *   - TAGLOCK: tag allocation and the request table (_tags)
+ *   - BELOCK:  calls into the back-end (post/test/cancel) and completion processing
+ * No lock is held while a thread waits for the completion of its request.
+ * Lock order (if nested): NSLOCK -> TAGLOCK -> BELOCK
+ * The callback dispatcher lock (_cb_lock) is never held while taking any other lock.
+ */
+#define NSLOCK_LOCK( ctx ) pthread_mutex_lock( &(ctx)->_ns_lock )
+
+#define NSLOCK_UNLOCK( ctx ) pthread_mutex_unlock( &(ctx)->_ns_lock )
+
+#define NSLOCK_UNLOCKRETURN( ctx, rc ) { NSLOCK_UNLOCK( ctx ); return (rc); }
+
+
+#define TAGLOCK_LOCK( ctx ) pthread_mutex_lock( &(ctx)->_tag_lock )
+
+#define TAGLOCK_UNLOCK( ctx ) pthread_mutex_unlock( &(ctx)->_tag_lock )
+
+#define TAGLOCK_UNLOCKRETURN( ctx, rc ) { TAGLOCK_UNLOCK( ctx ); return (rc); }
+
+
+#define BELOCK_LOCK( ctx ) pthread_mutex_lock( &(ctx)->_be_lock )
 
-#define BIGLOCK_UNLOCK( ctx ) pthread_mutex_unlock( &(ctx)->_biglock )
+#define BELOCK_UNLOCK( ctx ) pthread_mutex_unlock( &(ctx)->_be_lock )
 
-#define BIGLOCK_UNLOCKRETURN( ctx, rc ) { BIGLOCK_UNLOCK( ctx ); return (rc); }
+#define BELOCK_UNLOCKRETURN( ctx, rc ) { BELOCK_UNLOCK( ctx ); return (rc); }
 
 
 #endif /* SRC_UTIL_LOCK_TOOLS_H_ */
@@ -28,12 +28,46 @@
 #include <unistd.h>
 #include <string.h>
 #include <sys/time.h>
+#include <pthread.h>
 
 #include <libdatabroker.h>
 #include "test_utils.h"
 
 #define TEST_REQUEST_TIMEOUT ( 2 )
 
+typedef struct
+{
+  int _count;
+  int _errors;
+} test_cb_state_t;
+
+void test_completion_cb( DBR_Tag_t tag, DBR_Errorcode_t status, void *context )
+{
+  test_cb_state_t *state = (test_cb_state_t*)context;
+  if( status != DBR_SUCCESS )
+    ++state->_errors;
+  ++state->_count;
+}
+
+#define TEST_BATCH_SIZE ( 64 )
+
+/*
+ * one of two threads that wait for the same list of tags
+ */
+typedef struct
+{
+  DBR_Tag_t _tags[ TEST_BATCH_SIZE ];
+  DBR_Errorcode_t _results[ TEST_BATCH_SIZE ];
+  DBR_Errorcode_t _rc;
+} test_waiter_t;
+
+void* test_wait_overlap( void *arg )
+{
+  test_waiter_t *w = (test_waiter_t*)arg;
+  w->_rc = dbrWaitAll( w->_tags, TEST_BATCH_SIZE, w->_results );
+  return NULL;
+}
+
 int main( int argc, char ** argv )
 {
   int rc = 0;
@@ -208,6 +242,137 @@ int main( int argc, char ** argv )
 
   fprintf( stderr, "TEST: Completed check of late test for putA completion rc=%d\n", rc );
 
+  // batch of puts and gets completed with the batch test/wait calls
+  DBR_Tag_t btags[ TEST_BATCH_SIZE ];
+  DBR_Errorcode_t bresults[ TEST_BATCH_SIZE ];
+  char bname[ 32 ];
+  int b;
+  for( b = 0; b < TEST_BATCH_SIZE; ++b )
+  {
+    snprintf( bname, 32, "batchTup%d", b );
+    btags[ b ] = dbrPutA( cs_hdl, in, in_size, bname, DBR_GROUP_EMPTY );
+    rc += TEST_NOT( DB_TAG_ERROR, btags[ b ] );
+  }
+  rc += TEST( DBR_SUCCESS, dbrWaitAll( btags, TEST_BATCH_SIZE, bresults ) );
+  for( b = 0; b < TEST_BATCH_SIZE; ++b )
+  {
+    rc += TEST( DB_TAG_ERROR, btags[ b ] );
+    rc += TEST( DBR_SUCCESS, bresults[ b ] );
+  }
+  // nothing left to wait for
+  rc += TEST( DBR_SUCCESS, dbrWaitAll( btags, TEST_BATCH_SIZE, bresults ) );
+  rc += TEST( DBR_ERR_TAGERROR, dbrWaitAny( btags, TEST_BATCH_SIZE, bresults, NULL ) );
+  rc += TEST( DBR_ERR_TAGERROR, dbrTestSome( btags, TEST_BATCH_SIZE, bresults, NULL ) );
+  rc += TEST( DBR_ERR_INVALID, dbrTestSome( NULL, TEST_BATCH_SIZE, bresults, NULL ) );
+
+  int64_t bsizes[ TEST_BATCH_SIZE ];
+  char *bout = (char*)calloc( TEST_BATCH_SIZE, 1024 );
+  for( b = 0; b < TEST_BATCH_SIZE; ++b )
+  {
+    snprintf( bname, 32, "batchTup%d", b );
+    bsizes[ b ] = 1024;
+    btags[ b ] = dbrGetA( cs_hdl, &bout[ b * 1024 ], &bsizes[ b ], bname, "", DBR_GROUP_EMPTY, DBR_FLAGS_NONE );
+    rc += TEST_NOT( DB_TAG_ERROR, btags[ b ] );
+  }
+  int done = 0;
+  int completed = 0;
+  while( done < TEST_BATCH_SIZE )
+  {
+    state = dbrWaitAny( btags, TEST_BATCH_SIZE, bresults, &completed );
+    rc += TEST( DBR_SUCCESS, state );
+    if( state != DBR_SUCCESS )
+      break;
+    rc += TEST_NOT( 0, completed );
+    done += completed;
+  }
+  rc += TEST( TEST_BATCH_SIZE, done );
+  for( b = 0; b < TEST_BATCH_SIZE; ++b )
+  {
+    rc += TEST( DBR_SUCCESS, bresults[ b ] );
+    rc += TEST( in_size, bsizes[ b ] );
+    rc += TEST( strncmp( in, &bout[ b * 1024 ], 1024 ), 0 );
+  }
+  free( bout );
+
+  fprintf( stderr, "TEST: Completed check of batch test/wait rc=%d\n", rc );
+
+  // two threads waiting for the same tags: each request is collected exactly once
+  test_waiter_t waiters[ 2 ];
+  memset( waiters, 0, sizeof( waiters ) );
+  for( b = 0; b < TEST_BATCH_SIZE; ++b )
+  {
+    snprintf( bname, 32, "overlapTup%d", b );
+    waiters[ 0 ]._tags[ b ] = dbrPutA( cs_hdl, in, in_size, bname, DBR_GROUP_EMPTY );
+    waiters[ 1 ]._tags[ b ] = waiters[ 0 ]._tags[ b ];
+    rc += TEST_NOT( DB_TAG_ERROR, waiters[ 0 ]._tags[ b ] );
+  }
+  pthread_t waiter_thread[ 2 ];
+  int w;
+  for( w = 0; w < 2; ++w )
+    rc += TEST( 0, pthread_create( &waiter_thread[ w ], NULL, test_wait_overlap, &waiters[ w ] ) );
+  for( w = 0; w < 2; ++w )
+  {
+    rc += TEST( 0, pthread_join( waiter_thread[ w ], NULL ) );
+    rc += TEST( DBR_SUCCESS, waiters[ w ]._rc );
+  }
+  for( b = 0; b < TEST_BATCH_SIZE; ++b )
+  {
+    int collected = ( waiters[ 0 ]._results[ b ] == DBR_SUCCESS ) + ( waiters[ 1 ]._results[ b ] == DBR_SUCCESS );
+    int lost = ( waiters[ 0 ]._results[ b ] == DBR_ERR_TAGERROR ) + ( waiters[ 1 ]._results[ b ] == DBR_ERR_TAGERROR );
+    rc += TEST( 1, collected );
+    rc += TEST( 1, lost );
+  }
+  for( b = 0; b < TEST_BATCH_SIZE; ++b )
+  {
+    snprintf( bname, 32, "overlapTup%d", b );
+    rc += TEST( DBR_SUCCESS, dbrRemove( cs_hdl, DBR_GROUP_EMPTY, bname, "" ) );
+  }
+
+  fprintf( stderr, "TEST: Completed check of overlapping waits rc=%d\n", rc );
+
+  // completion callbacks instead of tags
+  test_cb_state_t cb_state = { 0, 0 };
+  for( b = 0; b < TEST_BATCH_SIZE; ++b )
+  {
+    snprintf( bname, 32, "cbTup%d", b );
+    rc += TEST_NOT( DB_TAG_ERROR, dbrPutA_cb( cs_hdl, in, in_size, bname, DBR_GROUP_EMPTY, test_completion_cb, &cb_state ) );
+  }
+  gettimeofday( &start_time, NULL );
+  now = start_time;
+  while(( cb_state._count < TEST_BATCH_SIZE ) && ( ( now.tv_sec - start_time.tv_sec ) <= TEST_REQUEST_TIMEOUT ))
+  {
+    rc += TEST( DBR_SUCCESS, dbrProgress( NULL ) );
+    gettimeofday( &now, NULL );
+  }
+  rc += TEST( TEST_BATCH_SIZE, cb_state._count );
+  rc += TEST( 0, cb_state._errors );
+
+  cb_state._count = 0;
+  bout = (char*)calloc( TEST_BATCH_SIZE, 1024 );
+  for( b = 0; b < TEST_BATCH_SIZE; ++b )
+  {
+    snprintf( bname, 32, "cbTup%d", b );
+    bsizes[ b ] = 1024;
+    rc += TEST_NOT( DB_TAG_ERROR, dbrGetA_cb( cs_hdl, &bout[ b * 1024 ], &bsizes[ b ], bname, "", DBR_GROUP_EMPTY, DBR_FLAGS_NONE, test_completion_cb, &cb_state ) );
+  }
+  gettimeofday( &start_time, NULL );
+  now = start_time;
+  while(( cb_state._count < TEST_BATCH_SIZE ) && ( ( now.tv_sec - start_time.tv_sec ) <= TEST_REQUEST_TIMEOUT ))
+  {
+    rc += TEST( DBR_SUCCESS, dbrProgress( NULL ) );
+    gettimeofday( &now, NULL );
+  }
+  rc += TEST( TEST_BATCH_SIZE, cb_state._count );
+  rc += TEST( 0, cb_state._errors );
+  for( b = 0; b < TEST_BATCH_SIZE; ++b )
+  {
+    rc += TEST( in_size, bsizes[ b ] );
+    rc += TEST( strncmp( in, &bout[ b * 1024 ], 1024 ), 0 );
+  }
+  free( bout );
+
+  fprintf( stderr, "TEST: Completed check of completion callbacks rc=%d\n", rc );
+
   // delete the name space
   ret = dbrDelete( name );
   rc += TEST( DBR_SUCCESS, ret );
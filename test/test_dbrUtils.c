@@ -30,85 +30,161 @@
 #include "test_utils.h"
 
 
+static
+dbrRequestContext_t* dbrTag_test_insert( dbrMain_context_t *mc, DBR_Tag_t tag )
+{
+  dbrRequestContext_t *r = (dbrRequestContext_t *)malloc( sizeof (dbrRequestContext_t) + 5 * sizeof(dbBE_sge_t)  );
+  memset( r, 0, sizeof( dbrRequestContext_t ) + 5 * sizeof(dbBE_sge_t) );
+  r->_req._sge_count = 5;
+  r->_status = dbrSTATUS_PENDING;
+  r->_tag = tag;
+  dbrTag_slot_t *slot = dbrTag_table_lookup( &mc->_tags, tag );
+  if( slot == NULL )
+  {
+    free( r );
+    return NULL;
+  }
+  slot->_rctx = r;
+  return r;
+}
+
+/*
+ * release a tag the same way dbrRemove_request() does
+ */
+static
+int dbrTag_test_remove( dbrMain_context_t *mc, DBR_Tag_t tag )
+{
+  dbrRequestContext_t *r = dbrTag_lookup( mc, tag );
+  if( r == NULL )
+    return -1;
+  dbrTag_table_release( &mc->_tags, tag );
+  dbrDestroy_request( r );
+  return 0;
+}
+
 int dbrTag_get_test( dbrMain_context_t *mc )
 {
   const int TAG_TEST_COUNT = 10000;
+  const int TAG_INFLIGHT = 3 * DBR_TAG_CHUNK_SIZE + 7;  // more than the initial table size
   int rc = 0;
   int n = 0;
   DBR_Tag_t tag;
+  DBR_Tag_t *tags = (DBR_Tag_t*)calloc( TAG_INFLIGHT, sizeof( DBR_Tag_t ) );
 
   if( mc == NULL )
     return 1;
-  while(( tag = dbrTag_get( mc ) ) != DB_TAG_ERROR )
+
+  // the table grows beyond the initial size and hands out unique slots
+  for( n = 0; n < TAG_INFLIGHT; ++n )
   {
-    ++n;
-    dbrRequestContext_t *r = (dbrRequestContext_t *)malloc( sizeof (dbrRequestContext_t) + 5 * sizeof(dbBE_sge_t)  );
-    memset( r, 0, sizeof( dbrRequestContext_t ) + 5 * sizeof(dbBE_sge_t) );
-    r->_req._sge_count = 5;
-    mc->_cs_wq[ tag ] = r;
-
-    rc += TEST_NOT( mc->_cs_wq[ tag ], NULL );
-    LOG( DBG_INFO, stdout, "Freeing %p\n", mc->_cs_wq[ tag ] );
+    tags[ n ] = dbrTag_get( mc );
+    rc += TEST_NOT( tags[ n ], DB_TAG_ERROR );
+    TEST_BREAK( rc, "Tag allocation failure" );
+    rc += TEST_NOT( dbrTag_test_insert( mc, tags[ n ] ), NULL );
     TEST_BREAK( rc, "Allocation failure" );
-    mc->_cs_wq[ tag ]->_status = dbrSTATUS_PENDING;
-    LOG( DBG_INFO, stdout, "Allocated tag: %"PRId64"\n", tag );
+    LOG( DBG_INFO, stdout, "Allocated tag: %"PRId64"\n", tags[ n ] );
   }
-  rc += TEST( n < dbrMAX_TAGS, 0 );
-
-  LOG( DBG_INFO, stdout, "Allocated tag count: %d\n", n );
-  rc += TEST( n, dbrMAX_TAGS );
+  rc += TEST( mc->_tags._used, TAG_INFLIGHT );
+  rc += TEST( mc->_tags._size >= TAG_INFLIGHT, 1 );
+  for( n = 1; n < TAG_INFLIGHT; ++n )
+    rc += TEST_NOT( dbrTag_index( tags[ n ] ), dbrTag_index( tags[ n-1 ] ) );
+  TEST_LOG( rc, "Tag table growth" );
 
+  // released slots are reused with a new generation, stale tags are detected
   for( n = 0; n<TAG_TEST_COUNT; ++n )
   {
-    int p = random() % dbrMAX_TAGS;
-    LOG( DBG_INFO, stdout, "Testing tag %d; wqe[]=%p\n", p, mc->_cs_wq[ p ] );
-    rc += TEST( dbrValidateTag( NULL, p ), DBR_SUCCESS );
-    if( mc->_cs_wq[ p ] != NULL )
-      mc->_cs_wq[ p ]->_status = dbrSTATUS_CLOSED;
+    int p = random() % TAG_INFLIGHT;
+    DBR_Tag_t old = tags[ p ];
+    rc += TEST( dbrValidateTag( NULL, old ), DBR_SUCCESS );
+    rc += TEST( dbrTag_test_remove( mc, old ), 0 );
+    rc += TEST( dbrTag_lookup( mc, old ), NULL );
+
     tag = dbrTag_get( mc );
-    rc += TEST( tag, p );
+    rc += TEST( dbrTag_index( tag ), dbrTag_index( old ) );
+    rc += TEST_NOT( tag, old );
+    rc += TEST( dbrTag_lookup( mc, old ), NULL );
+    rc += TEST( dbrTag_release( mc, old ), DBR_ERR_TAGERROR );
 
-    dbrRequestContext_t *r = (dbrRequestContext_t *)malloc( sizeof (dbrRequestContext_t) + 5 * sizeof(dbBE_sge_t)  );
-    memset( r, 0, sizeof( dbrRequestContext_t ) + 5 * sizeof(dbBE_sge_t) );
-    r->_req._sge_count = 5;
-    mc->_cs_wq[ tag ] = r;
-    rc += TEST_NOT( mc->_cs_wq[ tag ], NULL );
+    rc += TEST_NOT( dbrTag_test_insert( mc, tag ), NULL );
     TEST_BREAK( rc, "Allocation failure" );
-    mc->_cs_wq[ tag ]->_status = dbrSTATUS_PENDING;
-    LOG( DBG_INFO, stdout, "Allocated tag: %"PRId64"\n", tag );
-
+    tags[ p ] = tag;
   }
+  rc += TEST( mc->_tags._used, TAG_INFLIGHT );
+  TEST_LOG( rc, "Tag reuse" );
+
+  // reserved tags without a request can be released, tags with a request only by removal
+  tag = dbrTag_get( mc );
+  rc += TEST_NOT( tag, DB_TAG_ERROR );
+  rc += TEST( dbrTag_lookup( mc, tag ), NULL );
+  rc += TEST( dbrTag_release( mc, tag ), DBR_SUCCESS );
+  rc += TEST( dbrTag_release( mc, tag ), DBR_ERR_TAGERROR );
+  rc += TEST( dbrTag_release( mc, tags[ 0 ] ), DBR_ERR_TAGERROR );
+  rc += TEST( dbrTag_release( mc, DB_TAG_ERROR ), DBR_ERR_INVALID );
+  rc += TEST( dbrTag_release( NULL, tags[ 0 ] ), DBR_ERR_INVALID );
+
+  // tags outside of the table
+  rc += TEST( dbrTag_lookup( mc, mc->_tags._size ), NULL );
+  rc += TEST( dbrTag_lookup( mc, DB_TAG_ERROR ), NULL );
+
+  rc += TEST( dbrValidateTag( NULL, 0 ), DBR_SUCCESS );
+  rc += TEST( dbrValidateTag( NULL, DB_TAG_ERROR ), DBR_ERR_TAGERROR );
 
-  for( n=0; n<dbrMAX_TAGS; ++n )
+  // test cleanup any remaining
+  for( n = 0; n < TAG_INFLIGHT; ++n )
+    rc += TEST( dbrTag_test_remove( mc, tags[ n ] ), 0 );
+  rc += TEST( mc->_tags._used, 0 );
+  free( tags );
+
+  return rc;
+}
+
+int dbrMain_ns_test( dbrMain_context_t *mc )
+{
+  const int NS_TEST_COUNT = 2048;  // more than the initial table size and the former limit of 1024
+  int rc = 0;
+  int n;
+  char name[ 32 ];
+  dbrName_space_t **ns = (dbrName_space_t**)calloc( NS_TEST_COUNT, sizeof( dbrName_space_t* ) );
+
+  rc += TEST( dbrMain_find( NULL, "ns0" ), NULL );
+  rc += TEST( dbrMain_find( mc, "ns0" ), NULL );
+  rc += TEST( dbrMain_insert( mc, NULL ), -EINVAL );
+
+  for( n = 0; n < NS_TEST_COUNT; ++n )
   {
-    if( mc->_cs_wq[ n ] != NULL )
-      mc->_cs_wq[ n ]->_status = dbrSTATUS_CLOSED;
+    snprintf( name, 32, "ns%d", n );
+    ns[ n ] = dbrMain_create_local( name );
+    rc += TEST_NOT( ns[ n ], NULL );
+    TEST_BREAK( rc, "Failed to create local namespace" );
   }
+  rc += TEST( mc->_cs_table._count, (uint32_t)NS_TEST_COUNT );
+  rc += TEST( mc->_cs_table._size >= (uint32_t)NS_TEST_COUNT, 1 );
 
-  // note because of status closed, this does cleanup of request entries
-  rc += TEST_NOT( dbrTag_get( mc ), DB_TAG_ERROR );
+  for( n = 0; n < NS_TEST_COUNT; ++n )
+  {
+    snprintf( name, 32, "ns%d", n );
+    rc += TEST( dbrMain_find( mc, name ), ns[ n ] );
+  }
+  rc += TEST( dbrMain_find( mc, "ns" ), NULL );
 
-  dbrRequestContext_t rctx;
-  rc += TEST( dbrValidateTag( NULL, 0 ), DBR_SUCCESS );
+  // inserting again is a no-op
+  rc += TEST( dbrMain_insert( mc, ns[ 0 ] ), 0 );
+  rc += TEST( mc->_cs_table._count, (uint32_t)NS_TEST_COUNT );
 
-#ifdef DBR_INTTAG
-  rc += TEST( dbrValidateTag( &rctx, 0 ), DBR_SUCCESS );
-  rc += TEST( dbrValidateTag( &rctx, DB_TAG_ERROR ), DBR_ERR_TAGERROR );
-  rc += TEST( dbrValidateTag( &rctx, dbrMAX_TAGS - 1 ), DBR_SUCCESS );
-  rc += TEST( dbrValidateTag( &rctx, dbrMAX_TAGS ), DBR_ERR_TAGERROR );
-#else
-  rc += TEST( dbrValidateTag( &rctx, NULL ), DBR_ERR_TAGERROR );
-  rc += TEST( dbrValidateTag( &rctx, DB_TAG_ERROR ), DBR_ERR_TAGERROR );
-#endif
+  // attached namespaces stay until the last detach
+  rc += TEST( dbrMain_attach( mc, ns[ 0 ] ), 0 );
+  rc += TEST( dbrMain_detach( mc, ns[ 0 ] ), 0 );
+  rc += TEST( dbrMain_find( mc, "ns0" ), ns[ 0 ] );
 
-  // test cleanup any remaining
-  for( n=0; n<dbrMAX_TAGS; ++n )
+  for( n = 0; n < NS_TEST_COUNT; ++n )
   {
-    if( mc->_cs_wq[ n ] != NULL )
-      rc += TEST( dbrDestroy_request( mc->_cs_wq[ n ] ), DBR_SUCCESS );
-    mc->_cs_wq[ n ] = NULL;
+    rc += TEST( dbrMain_delete( mc, ns[ n ] ), 0 );
+    rc += TEST( dbrMain_detach( mc, ns[ n ] ), 0 );
   }
+  rc += TEST( mc->_cs_table._count, 0 );
+  rc += TEST( dbrMain_find( mc, "ns0" ), NULL );
 
+  free( ns );
   return rc;
 }
 
@@ -134,6 +210,7 @@ int main( int argc, char ** argv )
 
   mc = dbrCheckCreateMainCTX();
   rc += dbrTag_get_test( mc );
+  rc += dbrMain_ns_test( mc );
 
 
   printf( "Test exiting with rc=%d\n", rc );
@@ -0,0 +1,188 @@
+/*
+ * Copyright © 2018-2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Measures heap allocator round-trips per operation and throughput
+ * for small (64 Byte default) tuples.
+ * The allocator calls of the whole process (including the library and
+ * the dlopen'ed back-end) are counted by interposing malloc & friends
+ * and forwarding them to the glibc implementation.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+
+#include "timing.h"
+#include "commandline.h"
+#include "resultdata.h"
+#include "requestdata.h"
+
+#include "libdatabroker.h"
+#include "benchmark.h"
+
+#define MAX_TEST_MEMORY_USE ( 2 * 1024ull * 1024ull * 1024ull )
+
+static std::atomic<uint64_t> gAllocCount( 0 );
+static std::atomic<uint64_t> gFreeCount( 0 );
+
+#ifdef __GLIBC__
+extern "C" {
+extern void* __libc_malloc( size_t size );
+extern void* __libc_calloc( size_t n, size_t size );
+extern void* __libc_realloc( void *ptr, size_t size );
+extern void __libc_free( void *ptr );
+
+void* malloc( size_t size )
+{
+  gAllocCount.fetch_add( 1, std::memory_order_relaxed );
+  return __libc_malloc( size );
+}
+
+void* calloc( size_t n, size_t size )
+{
+  gAllocCount.fetch_add( 1, std::memory_order_relaxed );
+  return __libc_calloc( n, size );
+}
+
+void* realloc( void *ptr, size_t size )
+{
+  gAllocCount.fetch_add( 1, std::memory_order_relaxed );
+  return __libc_realloc( ptr, size );
+}
+
+void free( void *ptr )
+{
+  if( ptr != NULL )
+    gFreeCount.fetch_add( 1, std::memory_order_relaxed );
+  __libc_free( ptr );
+}
+}
+#define ALLOC_COUNTING ( 1 )
+#else
+#define ALLOC_COUNTING ( 0 )
+#endif
+
+static
+void PrintAllocLine( dbr::config *cfg,
+                     int testcase,
+                     double actual_time,
+                     uint64_t allocs,
+                     uint64_t frees )
+{
+  double actual_req = cfg->_iterations - cfg->_inflight - cfg->_inflight;
+  double total_req = cfg->_iterations; // allocations are counted including warmup and cooldown
+  std::cout << std::setw(10) << cfg->_datasize
+      << std::setw(12) << actual_req
+      << std::setw(14) << (actual_req)/(actual_time/1000000.)
+      << std::setw(12) << (double)allocs/total_req
+      << std::setw(12) << (double)frees/total_req
+      << std::setw(6) << dbr::case_str[ testcase ]
+      << std::endl;
+}
+
+int main( int argc, char **argv )
+{
+  std::string extraHelp = "\
+  -p <inflight>      number of requests that are kept in-flight at the same time (1)\n\
+  -t <PUT|GET|READ>  comma separated list which command to test (PUT,GET)\n\
+  -b                 use the blocking API calls instead of async calls + dbrTest (off)\n\
+";
+
+  dbr::config *config = dbr::ParseCommandline( argc, argv, "bd:hk:Kn:p:t:", dbr::par_single_common::extraParse, extraHelp, true );
+  if( config == NULL )
+  {
+    std::cerr << "Failed to create configuration." << std::endl;
+    return -1;
+  }
+  if( config->_testcase == dbr::test_case_to_int("PUT,READ,GET") )
+    config->_testcase = dbr::test_case_to_int("PUT,GET");
+  if( config->_blocking && ( config->_inflight > 1 ))
+  {
+    config->_inflight = 1;
+    std::cout << "WARN: blocking calls only work with -p 1. Adjusting" << std::endl;
+  }
+  if( ! ALLOC_COUNTING )
+    std::cout << "WARN: allocation counting is only supported with glibc" << std::endl;
+
+  dbr::test_start = dbr::myTime();
+
+  dbr::requestdata *reqd = dbr::InitializeRequest( config );
+  char *data = dbr::generateLongMsg( config->_datasize );
+
+  size_t n = 0;
+  if( config->_iterations * config->_keylen < MAX_TEST_MEMORY_USE )
+  {
+    for( n=0; n<config->_iterations; ++n )
+      dbr::RandomizeData( reqd, n, (config->_variable_key * random() % config->_keylen ) + config->_keylen );
+  }
+
+  DBR_Handle_t h = dbrCreate((DBR_Name_t)TEST_NAMESPACE, DBR_PERST_VOLATILE_SIMPLE, DBR_GROUP_LIST_EMPTY );
+  if( h == NULL )
+  {
+    std::cerr << "Failed to create namespace" << std::endl;
+    exit( -1 );
+  }
+
+  std::cout << std::setw(10) << "Datasize"
+      << std::setw(12) << "Requests"
+      << std::setw(14) << "Ops/s"
+      << std::setw(12) << "Allocs/Op"
+      << std::setw(12) << "Frees/Op"
+      << std::setw(6) << "Case"
+      << std::endl;
+
+  int rc = 0;
+  const int cases[] = { dbr::TEST_CASE_PUT, dbr::TEST_CASE_READ, dbr::TEST_CASE_GET };
+  // READ and GET need existing data
+  if(( config->_testcase & dbr::TEST_CASE_PUT ) == 0 )
+    for( n=0; n<config->_iterations; ++n )
+      dbrPut( h, data, config->_datasize, reqd->_names[n], DBR_GROUP_EMPTY );
+
+  // GET removes the tuples, so it has to run last
+  for( auto testcase : cases )
+  {
+    if(( config->_testcase & testcase ) == 0 )
+      continue;
+
+    dbr::resultdata *res = dbr::InitializeResult( config );
+    uint64_t allocs = gAllocCount.load();
+    uint64_t frees = gFreeCount.load();
+    double actual_time = dbr::benchmark( config, testcase, res, reqd, h, data );
+    allocs = gAllocCount.load() - allocs;
+    frees = gFreeCount.load() - frees;
+    dbr::DestroyResult( res );
+
+    if( actual_time < 0 )
+    {
+      rc = -1;
+      break;
+    }
+    PrintAllocLine( config, testcase, actual_time, allocs, frees );
+  }
+
+  DBR_Errorcode_t res = dbrDelete( (DBR_Name_t)TEST_NAMESPACE );
+
+  dbr::DestroyRequest( reqd );
+  delete config;
+
+  if( res != DBR_SUCCESS )
+  {
+    std::cerr << "There were errors. You might want to check for remaining data in the databroker." << std::endl;
+  }
+  return rc;
+}
@@ -32,6 +32,70 @@ static const char* TEST_NAMESPACE = "pn";
 
 namespace dbr {
 
+/*
+ * same as benchmark() but with the blocking API calls
+ * one request at a time, the library waits for each completion internally
+ */
+static
+double benchmark_blocking( config *config,
+                           int testcase,
+                           resultdata *resd,
+                           requestdata *reqd,
+                           DBR_Handle_t h,
+                           char *data )
+{
+  size_t n;
+  int64_t retsize;
+  char match[] = "";
+  double start = 0.0;
+  double end = 0.0;
+  DBR_Errorcode_t rc = DBR_SUCCESS;
+
+  for( n=0; n<config->_iterations; ++n )
+  {
+    // first and last iteration are warmup/cooldown to match the async version
+    if( n == config->_inflight )
+    {
+      start = dbr::myTime();
+      resd->_cpu_time = -dbr::myCPUTime();
+    }
+
+    resd->_latency[n] = -dbr::myTime();
+    switch( testcase )
+    {
+      case dbr::TEST_CASE_PUT:
+        rc = dbrPut( h, data, config->_datasize, reqd->_names[n], DBR_GROUP_EMPTY );
+        break;
+      case dbr::TEST_CASE_GET:
+        retsize = config->_datasize;
+        rc = dbrGet( h, data, &retsize, reqd->_names[n], match, DBR_GROUP_EMPTY, DBR_FLAGS_NONE );
+        break;
+      case dbr::TEST_CASE_READ:
+        retsize = config->_datasize;
+        rc = dbrRead( h, data, &retsize, reqd->_names[n], match, DBR_GROUP_EMPTY, DBR_FLAGS_NONE );
+        break;
+      default:
+        std::cerr << "Undefined test case: " << testcase << std::endl;
+        exit(1);
+        break;
+    }
+    resd->_latency[n] += dbr::myTime();
+    if( rc != DBR_SUCCESS )
+    {
+      std::cerr << "Failed to request: " << n << " (key=" << reqd->_names[ n ] << ") rc=" << rc << std::endl;
+      return -1;
+    }
+
+    if( n == config->_iterations - config->_inflight - 1 )
+    {
+      end = dbr::myTime();
+      resd->_cpu_time += dbr::myCPUTime();
+    }
+  }
+
+  return end-start;
+}
+
 static
 double benchmark( config *config,
                   int testcase,
@@ -44,6 +108,9 @@ double benchmark( config *config,
   int64_t retsize[ config->_inflight ];
   char match[] = "";
 
+  if( config->_blocking )
+    return benchmark_blocking( config, testcase, resd, reqd, h, data );
+
   char *base_data = strdup( data );
   bool validation_needed = ( config->_validate &&( testcase & dbr::TEST_CASE_PUT ));
 
@@ -80,6 +147,7 @@ double benchmark( config *config,
 
   // measuring phase
   double start = dbr::myTime();
+  resd->_cpu_time = -dbr::myCPUTime();
   //  std::cout << "StartStamp: " << start << std::endl;
 
   for( ; n<config->_iterations; ++n )
@@ -123,6 +191,7 @@ double benchmark( config *config,
   }
 
   double end = dbr::myTime();
+  resd->_cpu_time += dbr::myCPUTime();
   //  std::cout << "EndStamp: " << end << std::endl;
 
   // cooldown
@@ -36,6 +36,7 @@ struct config
   size_t _memlimit;
   bool _filldata;
   bool _validate;
+  bool _blocking;
   int _testcase;
 };
 
@@ -81,6 +82,9 @@ int extraParse( const int opt, dbr::config *cfg )
     case 'v': // validation
       cfg->_validate = true;
       break;
+    case 'b': // blocking API calls
+      cfg->_blocking = true;
+      break;
     default:
       return -1;  // there are no extra options for this
   }
@@ -121,6 +125,7 @@ ParseCommandline( int argc, char **argv,
   cfg->_memlimit = 0; // no memory limit
   cfg->_filldata = false; // no floodfill of data
   cfg->_validate = false; // no validation (slows down the operation)
+  cfg->_blocking = false; // async API calls + dbrTest()
 
   int option;
   while(( option = getopt(argc, argv, options)) != -1 )
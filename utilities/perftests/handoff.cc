@@ -0,0 +1,175 @@
+/*
+ * Copyright © 2018-2020 IBM Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Measures the hand-off latency of a tuple from a producer to a consumer
+ * that is already waiting for it.
+ * The consumer thread calls the blocking dbrGet() for a tuple that does not
+ * exist yet; the producer thread puts it after a delay. Reported are the
+ * average, median and 99th percentile time from the return of dbrPut() to
+ * the return of dbrGet() and the CPU time of the process per hand-off.
+ * Run with DBR_BLOCKING_POP=1 (server-side wait, default) and
+ * DBR_BLOCKING_POP=0 (client-side polling) to compare the two.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <cstring>
+#include <unistd.h>
+
+#include "timing.h"
+#include "commandline.h"
+
+#include "libdatabroker.h"
+
+static const char* TEST_NAMESPACE = "pn";
+
+static long gDelay = 1000;
+
+static
+int HandoffParse( const int opt, dbr::config *cfg )
+{
+  switch( opt )
+  {
+    case 'w': // delay before the put
+      gDelay = std::strtol( optarg, NULL, 10 );
+      break;
+    default:
+      return -1;
+  }
+  return 0;
+}
+
+static
+std::string HandoffKey( const size_t n )
+{
+  return "handoff" + std::to_string( n );
+}
+
+int main( int argc, char **argv )
+{
+  std::string extraHelp = "\
+  -w <usec>          delay between the start of the get and the put (1000)\n\
+";
+
+  dbr::config *config = dbr::ParseCommandline( argc, argv, "d:hn:w:", HandoffParse, extraHelp, true );
+  if( config == NULL )
+  {
+    std::cerr << "Failed to create configuration." << std::endl;
+    return -1;
+  }
+  if( gDelay < 0 )
+    gDelay = 0;
+
+  dbr::test_start = dbr::myTime();
+
+  size_t iterations = config->_iterations;
+  char *data = new char[ config->_datasize ];
+  memset( data, 'x', config->_datasize );
+
+  DBR_Handle_t h = dbrCreate((DBR_Name_t)TEST_NAMESPACE, DBR_PERST_VOLATILE_SIMPLE, DBR_GROUP_LIST_EMPTY );
+  if( h == NULL )
+  {
+    std::cerr << "Failed to create namespace" << std::endl;
+    exit( -1 );
+  }
+
+  std::vector<double> put_done( iterations, 0.0 );
+  std::vector<double> get_done( iterations, 0.0 );
+  std::atomic<size_t> waiting( 0 );
+  std::atomic<int> failed( 0 );
+
+  double cpu_start = dbr::myCPUTime();
+  double time_start = dbr::myTime();
+
+  std::thread consumer( [&]() {
+    char *buf = new char[ config->_datasize ];
+    char match[] = "";
+    for( size_t n = 0; n < iterations; ++n )
+    {
+      std::string key = HandoffKey( n );
+      int64_t size = config->_datasize;
+      waiting.store( n + 1, std::memory_order_release );
+      if( dbrGet( h, buf, &size, (DBR_Tuple_name_t)key.c_str(), match, DBR_GROUP_EMPTY, DBR_FLAGS_NONE ) != DBR_SUCCESS )
+        failed.fetch_add( 1 );
+      get_done[ n ] = dbr::myTime();
+    }
+    delete [] buf;
+  } );
+
+  for( size_t n = 0; n < iterations; ++n )
+  {
+    // let the consumer enter dbrGet() first
+    while( waiting.load( std::memory_order_acquire ) <= n )
+      usleep( 1 );
+    usleep( gDelay );
+    std::string key = HandoffKey( n );
+    if( dbrPut( h, data, config->_datasize, (DBR_Tuple_name_t)key.c_str(), DBR_GROUP_EMPTY ) != DBR_SUCCESS )
+      failed.fetch_add( 1 );
+    put_done[ n ] = dbr::myTime();
+  }
+  consumer.join();
+
+  double time_total = dbr::myTime() - time_start;
+  double cpu_total = dbr::myCPUTime() - cpu_start;
+
+  std::vector<double> latency( iterations );
+  double sum = 0.0;
+  for( size_t n = 0; n < iterations; ++n )
+  {
+    // the get can return before the put call does
+    latency[ n ] = std::max( 0.0, get_done[ n ] - put_done[ n ] );
+    sum += latency[ n ];
+  }
+  std::sort( latency.begin(), latency.end() );
+
+  std::cout << std::setw(10) << "Datasize"
+      << std::setw(10) << "Delay"
+      << std::setw(12) << "Handoffs"
+      << std::setw(12) << "Avg_us"
+      << std::setw(12) << "P50_us"
+      << std::setw(12) << "P99_us"
+      << std::setw(14) << "CPU_us/Op"
+      << std::setw(14) << "CPU_load"
+      << std::endl;
+  std::cout << std::setw(10) << config->_datasize
+      << std::setw(10) << gDelay
+      << std::setw(12) << iterations
+      << std::setw(12) << sum / iterations
+      << std::setw(12) << latency[ iterations / 2 ]
+      << std::setw(12) << latency[ ( iterations * 99 ) / 100 ]
+      << std::setw(14) << cpu_total / iterations
+      << std::setw(14) << cpu_total / time_total
+      << std::endl;
+
+  DBR_Errorcode_t res = dbrDelete( (DBR_Name_t)TEST_NAMESPACE );
+
+  delete [] data;
+  delete config;
+
+  if(( failed.load() != 0 ) || ( res != DBR_SUCCESS ))
+  {
+    std::cerr << "There were errors. You might want to check for remaining data in the databroker." << std::endl;
+    return -1;
+  }
+  return 0;
+}
@@ -24,6 +24,7 @@ namespace dbr {
 
 struct resultdata {
   double *_latency;
+  double _cpu_time;
   bool _validation_failed;
 };
 
@@ -31,6 +32,7 @@ resultdata* InitializeResult( config *cfg )
 {
   resultdata *rd = new resultdata();
   rd->_latency = new double[ cfg->_iterations ];
+  rd->_cpu_time = 0.0;
   rd->_validation_failed = false;
   return rd;
 }
@@ -66,6 +68,7 @@ void PrintHeader( config *cfg, int argc, char **argv )
       << std::setw(12) << "avg/req"
       << std::setw(12) << "min"
       << std::setw(12) << "max"
+      << std::setw(12) << "CPU"
       << std::endl;
   std::cout << std::setw(10) << "[byte] "
       << std::setw(12) << "[ms] "
@@ -74,7 +77,8 @@ void PrintHeader( config *cfg, int argc, char **argv )
       << std::setw(12) << "[MB/s] "
       << std::setw(12) << "[ms] "
       << std::setw(12) << "[ms] "
-      << std::setw(12) << "[ms] " << std::endl;
+      << std::setw(12) << "[ms] "
+      << std::setw(12) << "[%] " << std::endl;
 }
 
 static std::string case_str[5] = { "UNDEF", "PUT", "GET", "", "READ" }; // mind the gap
@@ -114,6 +118,7 @@ void PrintResultLine( config *cfg,
       << std::setw(12) << (actual_time/1000./actual_req)
       << std::setw(12) << minlat/1000.
       << std::setw(12) << maxlat/1000.
+      << std::setw(12) << resd->_cpu_time/actual_time*100.
       << std::setw(6) << case_str[ testcase ]
       << (resd->_validation_failed ? " f" : "")
       << std::endl;
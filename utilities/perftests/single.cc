@@ -35,9 +35,10 @@ int main( int argc, char **argv )
   -p <inflight>      number of requests that are kept in-flight at the same time (1)\n\
   -t <PUT|GET|READ>  comma separated list which command to test (PUT,READ,GET)\n\
   -v                 enable result validation (off)\n\
+  -b                 use the blocking API calls instead of async calls + dbrTest (off)\n\
 ";
 
-  dbr::config *config = dbr::ParseCommandline( argc, argv, "d:hk:Kn:p:t:v", dbr::par_single_common::extraParse, extraHelp, true );
+  dbr::config *config = dbr::ParseCommandline( argc, argv, "bd:hk:Kn:p:t:v", dbr::par_single_common::extraParse, extraHelp, true );
   if( config == NULL )
   {
     std::cerr << "Failed to create configuration." << std::endl;
@@ -49,6 +50,11 @@ int main( int argc, char **argv )
     config->_validate = false;
     std::cout << "WARN: validation only works with -p 1. Disabling" << std::endl;
   }
+  if( config->_blocking && ( config->_inflight > 1 ))
+  {
+    config->_inflight = 1;
+    std::cout << "WARN: blocking calls only work with -p 1. Adjusting" << std::endl;
+  }
 
   int rc = 0;
 
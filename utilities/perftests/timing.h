@@ -19,6 +19,7 @@
 #define IBM_PERFTEST_TIMING_H_
 
 #include <sys/time.h>
+#include <sys/resource.h>
 
 namespace dbr {
 
@@ -31,6 +32,15 @@ static inline double myTime()
   return ((double)t.tv_sec*1000000.) + (double)t.tv_usec - test_start;
 }
 
+// user+system CPU time of all threads of the process in usec
+static inline double myCPUTime()
+{
+  struct rusage r;
+  getrusage( RUSAGE_SELF, &r );
+  return ((double)(r.ru_utime.tv_sec + r.ru_stime.tv_sec)*1000000.)
+      + (double)(r.ru_utime.tv_usec + r.ru_stime.tv_usec);
+}
+
 }
 
 #endif /* IBM_PERFTEST_TIMING_H_ */